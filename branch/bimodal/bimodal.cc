@@ -1,5 +1,7 @@
 #include "bimodal.h"
 
+#include "msl/checkpoint.h"
+
 bool bimodal::predict_branch(champsim::address ip)
 {
   auto value = bimodal_table[hash(ip)];
@@ -10,3 +12,13 @@ void bimodal::last_branch_result(champsim::address ip, champsim::address branch_
 {
   bimodal_table[hash(ip)] += taken ? 1 : -1;
 }
+
+void bimodal::branch_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, bimodal_table);
+}
+
+void bimodal::branch_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, bimodal_table);
+}
@@ -2,6 +2,7 @@
 #define BRANCH_BIMODAL_H
 
 #include <array>
+#include <iosfwd>
 
 #include "address.h"
 #include "modules.h"
@@ -23,6 +24,8 @@ public:
   // void initialize_branch_predictor();
   bool predict_branch(champsim::address ip);
   void last_branch_result(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+  void branch_checkpoint_save(std::ostream& os) const;
+  void branch_checkpoint_load(std::istream& is);
 };
 
 #endif
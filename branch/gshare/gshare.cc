@@ -1,5 +1,7 @@
 #include "gshare.h"
 
+#include "msl/checkpoint.h"
+
 std::size_t gshare::gs_table_hash(champsim::address ip, std::bitset<GLOBAL_HISTORY_LENGTH> bh_vector)
 {
   constexpr champsim::data::bits LOG2_HISTORY_TABLE_SIZE{champsim::lg2(GS_HISTORY_TABLE_SIZE)};
@@ -29,3 +31,15 @@ void gshare::last_branch_result(champsim::address ip, champsim::address branch_t
   branch_history_vector <<= 1;
   branch_history_vector[0] = taken;
 }
+
+void gshare::branch_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, branch_history_vector);
+  champsim::msl::checkpoint_save(os, gs_history_table);
+}
+
+void gshare::branch_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, branch_history_vector);
+  champsim::msl::checkpoint_load(is, gs_history_table);
+}
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <bitset>
+#include <iosfwd>
 
 #include "modules.h"
 #include "msl/fwcounter.h"
@@ -20,6 +21,8 @@ struct gshare : champsim::modules::branch_predictor {
   static std::size_t gs_table_hash(champsim::address ip, std::bitset<GLOBAL_HISTORY_LENGTH> bh_vector);
   bool predict_branch(champsim::address ip);
   void last_branch_result(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+  void branch_checkpoint_save(std::ostream& os) const;
+  void branch_checkpoint_load(std::istream& is);
 };
 
 #endif
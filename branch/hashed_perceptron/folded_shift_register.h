@@ -5,6 +5,7 @@
 
 #include "modules.h"
 #include "msl/bits.h"
+#include "msl/checkpoint.h"
 #include "msl/fwcounter.h"
 #include "util/bit_enum.h"
 
@@ -39,6 +40,9 @@ public:
    *  Insert this value into the shift register
    **/
   void push_back(bool ins);
+
+  void checkpoint_save(std::ostream& os) const { champsim::msl::checkpoint_save(os, words); }
+  void checkpoint_load(std::istream& is) { champsim::msl::checkpoint_load(is, words); }
 };
 
 template <champsim::data::bits WORD_LEN>
@@ -49,6 +49,8 @@ sources for you to plagiarize.
 
 #include <numeric>
 
+#include "msl/checkpoint.h"
+
 bool hashed_perceptron::predict_branch(champsim::address pc)
 {
   auto get_index = [pc_slice = pc.slice_lower<TABLE_INDEX_BITS>().to<uint64_t>()](const auto& hist) {
@@ -100,3 +102,21 @@ void hashed_perceptron::adjust_threshold(bool correct)
     }
   }
 }
+
+void hashed_perceptron::branch_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, tables);
+  champsim::msl::checkpoint_save(os, ghist_words);
+  champsim::msl::checkpoint_save(os, theta);
+  champsim::msl::checkpoint_save(os, tc);
+  champsim::msl::checkpoint_save(os, last_result);
+}
+
+void hashed_perceptron::branch_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, tables);
+  champsim::msl::checkpoint_load(is, ghist_words);
+  champsim::msl::checkpoint_load(is, theta);
+  champsim::msl::checkpoint_load(is, tc);
+  champsim::msl::checkpoint_load(is, last_result);
+}
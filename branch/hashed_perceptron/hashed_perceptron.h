@@ -3,6 +3,7 @@
 
 #include <array>
 #include <cstdint>
+#include <iosfwd>
 #include <tuple>
 #include <vector>
 
@@ -50,6 +51,8 @@ public:
   using branch_predictor::branch_predictor;
   bool predict_branch(champsim::address pc);
   void last_branch_result(champsim::address pc, champsim::address branch_target, bool taken, uint8_t branch_type);
+  void branch_checkpoint_save(std::ostream& os) const;
+  void branch_checkpoint_load(std::istream& is);
   void adjust_threshold(bool correct);
 };
 
@@ -40,6 +40,8 @@
 
 #include <cmath>
 
+#include "msl/checkpoint.h"
+
 bool perceptron::predict_branch(champsim::address ip)
 {
   // hash the address to get an index into the table of perceptrons
@@ -86,3 +88,19 @@ void perceptron::last_branch_result(champsim::address ip, champsim::address bran
     perceptrons[index].update(taken, history);
   }
 }
+
+void perceptron::branch_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, perceptrons);
+  champsim::msl::checkpoint_save(os, perceptron_state_buf);
+  champsim::msl::checkpoint_save(os, spec_global_history);
+  champsim::msl::checkpoint_save(os, global_history);
+}
+
+void perceptron::branch_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, perceptrons);
+  champsim::msl::checkpoint_load(is, perceptron_state_buf);
+  champsim::msl::checkpoint_load(is, spec_global_history);
+  champsim::msl::checkpoint_load(is, global_history);
+}
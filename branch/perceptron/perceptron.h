@@ -4,6 +4,7 @@
 #include <array>
 #include <bitset>
 #include <deque>
+#include <iosfwd>
 
 #include "modules.h"
 #include "msl/fwcounter.h"
@@ -49,6 +50,8 @@ struct perceptron : champsim::modules::branch_predictor {
 
   bool predict_branch(champsim::address ip);
   void last_branch_result(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+  void branch_checkpoint_save(std::ostream& os) const;
+  void branch_checkpoint_load(std::istream& is);
 };
 
 template <std::size_t HISTLEN, std::size_t BITS>
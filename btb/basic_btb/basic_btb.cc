@@ -9,6 +9,7 @@
 #include "basic_btb.h"
 
 #include "instruction.h"
+#include "msl/checkpoint.h"
 
 std::pair<champsim::address, bool> basic_btb::btb_prediction(champsim::address ip)
 {
@@ -46,3 +47,21 @@ void basic_btb::update_btb(champsim::address ip, champsim::address branch_target
 
   direct.update(ip, branch_target, branch_type);
 }
+
+void basic_btb::btb_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, ras.stack);
+  champsim::msl::checkpoint_save(os, ras.call_size_trackers);
+  champsim::msl::checkpoint_save(os, indirect.predictor);
+  champsim::msl::checkpoint_save(os, indirect.conditional_history);
+  champsim::msl::checkpoint_save(os, direct.BTB);
+}
+
+void basic_btb::btb_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, ras.stack);
+  champsim::msl::checkpoint_load(is, ras.call_size_trackers);
+  champsim::msl::checkpoint_load(is, indirect.predictor);
+  champsim::msl::checkpoint_load(is, indirect.conditional_history);
+  champsim::msl::checkpoint_load(is, direct.BTB);
+}
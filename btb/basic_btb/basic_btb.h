@@ -1,6 +1,8 @@
 #ifndef BTB_BASIC_BTB_H
 #define BTB_BASIC_BTB_H
 
+#include <iosfwd>
+
 #include "address.h"
 #include "direct_predictor.h"
 #include "indirect_predictor.h"
@@ -20,6 +22,8 @@ public:
   // void initialize_btb();
   std::pair<champsim::address, bool> btb_prediction(champsim::address ip);
   void update_btb(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+  void btb_checkpoint_save(std::ostream& os) const;
+  void btb_checkpoint_load(std::istream& is);
 };
 
 #endif
@@ -1,5 +1,7 @@
 #include "return_stack.h"
 
+#include <atomic>
+
 std::pair<champsim::address, bool> return_stack::prediction()
 {
   if (std::empty(stack))
@@ -26,7 +28,7 @@ void return_stack::calibrate_call_size(champsim::address branch_target)
     auto call_ip = stack.back();
     stack.pop_back();
 
-    static int num_times_returned_backwards = 0;
+    static std::atomic<int> num_times_returned_backwards = 0;
     if (call_ip > branch_target && num_times_returned_backwards < 10) {
       ++num_times_returned_backwards;
       fmt::print("[BTB] WARNING: target of return is a lower address than the corresponding call. This is usually a problem with your trace.\n");
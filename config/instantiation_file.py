@@ -88,6 +88,8 @@ cache_builder_parts = {
     'frequency': '.clock_period(champsim::chrono::picoseconds{{{^clock_period}}})'
 }
 
+shadow_builder_parts = {k: cache_builder_parts[k] for k in ('size', 'log2_size', 'sets', 'log2_sets', 'ways', 'log2_ways', '_replacement_data')}
+
 ptw_builder_parts = {
     'name': '.name("{name}")',
     'cpu': '.cpu({cpu})',
@@ -176,6 +178,41 @@ def get_cache_builder(elem, ul_pairs):
     ), indent=1, line_end=''))
     yield from (part.format(**elem, **local_params) for part in builder_parts)
 
+def get_shadow_builder(shadow, parent):
+    '''
+    Generate a champsim::cache_builder for a shadow of a cache.
+    The shadows are built after the caches, so the sets and ways that the shadow does not determine are taken from its parent.
+
+    :param shadow: The shadow element
+    :param parent: A C++ expression that refers to the parent cache
+    '''
+    def has_key(key):
+        return key in shadow or f'log2_{key}' in shadow
+
+    required_parts = [
+        '.name("{name}")',
+        '.offset_bits({^parent}.OFFSET_BITS)'
+    ]
+
+    inherited_parts = []
+    if not has_key('sets') and not has_key('size'):
+        inherited_parts.append('.sets({^parent}.NUM_SET)')
+    if not has_key('ways') and not (has_key('size') and has_key('sets')):
+        inherited_parts.append('.ways({^parent}.NUM_WAY)')
+
+    local_params = {
+        '^parent': parent,
+        '^replacement_string': ', '.join(f'class {k["class"]}' for k in shadow.get('_replacement_data',[]))
+    }
+
+    builder_parts = itertools.chain(util.multiline(itertools.chain(
+        ('champsim::cache_builder{{}}',),
+        required_parts,
+        inherited_parts,
+        (v for k,v in shadow_builder_parts.items() if k in shadow)
+    ), indent=1, line_end=''))
+    yield from (part.format(**shadow, **local_params) for part in builder_parts)
+
 def get_ptw_builder(ptw, ul_pairs):
     '''
     Generate a champsim::ptw_builder
@@ -226,6 +263,10 @@ def get_ref_vector_function(rtype, func_name, basename):
     yield from cxx.function(func_name, wrapped, rtype=wrapped_rtype)
     yield ''
 
+def forward_list_element(basename, index, length):
+    ''' Refer to an element of a std::forward_list made by build(), which places the elements in the reverse of the order of its builders '''
+    return f'(*std::next(std::begin({basename}), {length-1-index}))'
+
 def get_builder_function_call(class_name, builders):
     '''
     Generate a call to a function that consumes builders.
@@ -324,7 +365,8 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
         *(c['_branch_predictor_data'] for c in cores),
         *(c['_btb_data'] for c in cores),
         *(c['_prefetcher_data'] for c in caches),
-        *(c['_replacement_data'] for c in caches)
+        *(c['_replacement_data'] for c in caches),
+        *(s['_replacement_data'] for c in caches for s in c.get('_shadows', []))
     ))
     yield from module_include_files(datas)
 
@@ -374,6 +416,21 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
         '},'
     )
 
+    shadows = [(i, s) for i,c in enumerate(caches) for s in c.get('_shadows', [])]
+    shadow_instantiation_body = (
+        'shadows {',
+        *get_builder_function_call('CACHE', (get_shadow_builder(s, forward_list_element('caches', i, len(caches))) for i,s in shadows)),
+        '},'
+    ) if shadows else ()
+
+    def shadow_attachment(parent_index, group):
+        shadow_ptrs = ', '.join('&'+forward_list_element('shadows', j, len(shadows)) for j,_ in group)
+        return f'{forward_list_element("caches", parent_index, len(caches))}.shadows = {{{shadow_ptrs}}};'
+
+    shadow_attachments = itertools.starmap(shadow_attachment, (
+        (k, list(g)) for k,g in itertools.groupby(enumerate(i for i,_ in shadows), key=operator.itemgetter(1))
+    ))
+
     core_instantiation_body = (
         'cores {',
         *get_builder_function_call('O3_CPU',
@@ -389,8 +446,10 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
     yield from vmem_instantiation_body
     yield from ptw_instantiation_body
     yield from cache_instantiation_body
+    yield from shadow_instantiation_body
     yield from core_instantiation_body
     yield '{'
+    yield from shadow_attachments
     yield '}'
     yield ''
 
@@ -429,6 +488,7 @@ def get_instantiation_header(num_cpus, env, build_id):
         'VirtualMemory vmem;',
         'std::forward_list<PageTableWalker> ptws;',
         'std::forward_list<CACHE> caches;',
+        'std::forward_list<CACHE> shadows;',
         'std::forward_list<O3_CPU> cores;',
 
         'public:',
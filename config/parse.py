@@ -365,6 +365,16 @@ class NormalizedConfiguration:
                 '_is_instruction_prefetcher': cache.get('_is_instruction_cache', False),
                 **module_parse(mod_name, prefetcher_context)
             }
+        def shadow_parse(shadow, index, cache):
+            ''' Name a shadow of the given cache. Unless it is given, the replacement policy of the shadow is that of the cache. '''
+            return util.chain(
+                transform_for_keys(shadow, ('size',), int_or_prefixed_size),
+                shadow,
+                {
+                    'name': f'{cache["name"]}_shadow{index}',
+                    '_replacement_data': list(map(replacement_parse, util.wrap_list(shadow.get('replacement', cache.get('replacement', 'lru')))))
+                }
+            )
 
         tlb_path = itertools.chain(*(util.iter_system(caches, name) for name in itertools.chain(*path_root_names[2:])))
         data_path = itertools.chain(*(util.iter_system(caches, name) for name in itertools.chain(*path_root_names[:2])))
@@ -404,7 +414,11 @@ class NormalizedConfiguration:
 
                 # Get module path names and unique module names
                '_replacement_data': list(map(replacement_parse, util.wrap_list(cache.get('replacement', 'lru')))),
-               '_prefetcher_data': [*map(functools.partial(prefetcher_parse, cache=cache), util.wrap_list(cache.get('prefetcher', 'no')))]
+               '_prefetcher_data': [*map(functools.partial(prefetcher_parse, cache=cache), util.wrap_list(cache.get('prefetcher', 'no')))],
+
+                # Tag-only copies of the cache with other geometries
+                # These are read from the configuration, because lists are joined as the caches are merged with their defaults
+               '_shadows': [shadow_parse(shadow, i, cache) for i,shadow in enumerate(util.wrap_list(self.caches.get(k, {}).get('shadows', [])))]
             } for k,cache in caches.items())
         )
 
@@ -437,7 +451,11 @@ class NormalizedConfiguration:
             'vmem': vmem
         }
         module_info = {
-            'repl': util.combine_named(*(c['_replacement_data'] for c in caches.values()), replacement_context.find_all()),
+            'repl': util.combine_named(
+                *(c['_replacement_data'] for c in caches.values()),
+                *(s['_replacement_data'] for c in caches.values() for s in c['_shadows']),
+                replacement_context.find_all()
+            ),
             'pref': util.combine_named(*(c['_prefetcher_data'] for c in caches.values()), prefetcher_context.find_all()),
             'branch': util.combine_named(*(c['_branch_predictor_data'] for c in cores), branch_context.find_all()),
             'btb': util.combine_named(*(c['_btb_data'] for c in cores), btb_context.find_all())
@@ -491,6 +509,7 @@ def parse_config(*configs, module_dir=None, branch_dir=None, btb_dir=None, pref_
     else:
         modules_to_compile = [*set(d['name'] for d in itertools.chain(
             *(c['_replacement_data'] for c in elements['caches']),
+            *(s['_replacement_data'] for c in elements['caches'] for s in c['_shadows']),
             *(c['_prefetcher_data'] for c in elements['caches']),
             *(c['_branch_predictor_data'] for c in elements['cores']),
             *(c['_btb_data'] for c in elements['cores'])
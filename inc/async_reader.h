@@ -0,0 +1,234 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ASYNC_READER_H
+#define ASYNC_READER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+#include "spsc_ring.h"
+#include "util/detect.h"
+
+namespace champsim
+{
+/**
+ * Reads from a generator on a background thread, ahead of the caller.
+ *
+ * The values are produced in the same order, and the reader ends at the same point, as if the generator were called directly.
+ * The background thread waits while Capacity values are waiting to be read, and ends when the generator reaches its end.
+ */
+template <typename T, std::size_t Capacity = 4096>
+class async_reader
+{
+public:
+  using value_type = std::invoke_result_t<T&>;
+
+private:
+  template <typename U>
+  using has_eof = decltype(std::declval<U>().eof());
+
+  template <typename U>
+  using has_seek = decltype(std::declval<U&>().seek(uint64_t{}, uint64_t{}));
+
+  struct shared_state {
+    T intern_;
+    spsc_ring<value_type> ring{Capacity};
+    std::optional<value_type> pending{}; // A value that was produced, but did not fit in the ring before the thread was stopped
+
+    std::atomic<bool> done = false;
+    std::atomic<bool> stopping = false;
+    std::atomic<bool> producer_waiting = false;
+    std::atomic<bool> consumer_waiting = false;
+    std::exception_ptr error{};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+
+    template <typename... Args>
+    explicit shared_state(Args&&... args) : intern_(std::forward<Args>(args)...)
+    {
+    }
+
+    shared_state(const shared_state&) = delete;
+    shared_state& operator=(const shared_state&) = delete;
+    ~shared_state() { stop(); }
+
+    [[nodiscard]] bool at_end() const
+    {
+      if constexpr (champsim::is_detected_v<has_eof, T>) {
+        return intern_.eof();
+      }
+      return false;
+    }
+
+    template <typename Pred>
+    void wait(std::atomic<bool>& waiting, Pred pred)
+    {
+      std::unique_lock lock{mutex};
+      waiting.store(true);
+      cv.wait(lock, pred);
+      waiting.store(false);
+    }
+
+    void wake(const std::atomic<bool>& waiting)
+    {
+      if (waiting.load()) {
+        std::lock_guard lock{mutex};
+        cv.notify_all();
+      }
+    }
+
+    void produce()
+    {
+      bool finished = false;
+      try {
+        while (!stopping.load(std::memory_order_relaxed)) {
+          if (!pending.has_value()) {
+            finished = at_end();
+            if (finished) {
+              break;
+            }
+            pending.emplace(intern_());
+          }
+
+          if (ring.try_push(std::move(*pending))) {
+            pending.reset();
+            wake(consumer_waiting);
+          } else {
+            // Wait until half of the ring is free, so that the threads do not wake each other for every value
+            wait(producer_waiting, [this] { return stopping.load() || ring.size() <= ring.capacity() / 2; });
+          }
+        }
+      } catch (...) {
+        error = std::current_exception();
+        finished = true;
+      }
+
+      if (finished) {
+        done.store(true);
+        wake(consumer_waiting);
+      }
+    }
+
+    void start()
+    {
+      if (!worker.joinable() && !done.load()) {
+        worker = std::thread{&shared_state::produce, this};
+      }
+    }
+
+    void stop()
+    {
+      if (worker.joinable()) {
+        {
+          std::lock_guard lock{mutex};
+          stopping.store(true);
+          cv.notify_all();
+        }
+        worker.join();
+        stopping.store(false);
+      }
+    }
+
+    // Block until a value can be read, or until the generator has ended
+    void await_value()
+    {
+      start();
+      if (ring.empty() && !done.load()) {
+        wait(consumer_waiting, [this] { return !ring.empty() || done.load(); });
+      }
+    }
+  };
+
+  std::unique_ptr<shared_state> state_;
+
+public:
+  template <typename... Args, std::enable_if_t<std::is_constructible_v<T, Args...>, bool> = true>
+  explicit async_reader(Args&&... args) : state_(std::make_unique<shared_state>(std::forward<Args>(args)...))
+  {
+    state_->start();
+  }
+
+  value_type operator()()
+  {
+    state_->await_value();
+    if (auto value = state_->ring.try_pop(); value.has_value()) {
+      if (state_->ring.size() <= state_->ring.capacity() / 2) {
+        state_->wake(state_->producer_waiting);
+      }
+      return *std::move(value);
+    }
+
+    // The background thread has finished, so the generator may be used directly
+    state_->stop();
+    if (state_->error) {
+      std::rethrow_exception(state_->error);
+    }
+    return state_->intern_();
+  }
+
+  [[nodiscard]] bool eof() const
+  {
+    state_->await_value();
+    return state_->ring.empty() && state_->at_end();
+  }
+
+  /**
+   * Stop the background thread. It is started again by the next read.
+   *
+   * The thread is not copied into a child process, so this must be called before the process forks.
+   */
+  void pause() { state_->stop(); }
+
+  /**
+   * Ask the generator to skip from the current position to the target, if it can. The values that were read ahead are discarded
+   * if the generator moves, and the background thread is started again by the next read.
+   *
+   * \return the position that the generator reached
+   */
+  template <typename U = T, typename = has_seek<U>>
+  uint64_t seek(uint64_t current, uint64_t target)
+  {
+    state_->stop();
+
+    // The generator is ahead of the caller by the values that were read ahead
+    auto ahead = current + state_->ring.size() + (state_->pending.has_value() ? 1 : 0);
+    auto retval = state_->intern_.seek(ahead, target);
+    if (retval == ahead) {
+      return current;
+    }
+
+    while (state_->ring.try_pop().has_value()) {
+    }
+    state_->pending.reset();
+    state_->done.store(false);
+    state_->error = nullptr;
+    return retval;
+  }
+};
+} // namespace champsim
+
+#endif
@@ -26,9 +26,11 @@
 #include <cstddef> // for size_t
 #include <cstdint> // for uint64_t, uint32_t, uint8_t
 #include <deque>
+#include <istream>
 #include <iterator> // for size
 #include <limits>   // for numeric_limits
 #include <memory>
+#include <ostream>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -78,7 +80,7 @@ class CACHE : public champsim::operable
     champsim::chrono::clock::time_point event_cycle = champsim::chrono::clock::time_point::max();
 
     std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    std::vector<channel_type*> to_return{};
 
     explicit tag_lookup_type(request_type req) : tag_lookup_type(req, false, false) {}
     tag_lookup_type(const request_type& req, bool local_pref, bool skip);
@@ -106,7 +108,7 @@ public:
     champsim::chrono::clock::time_point time_enqueued;
 
     std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    std::vector<channel_type*> to_return{};
 
     mshr_type(const tag_lookup_type& req, champsim::chrono::clock::time_point _time_enqueued);
     static mshr_type merge(mshr_type predecessor, mshr_type successor);
@@ -117,10 +119,19 @@ private:
   bool handle_fill(const mshr_type& fill_mshr);
   bool handle_miss(const tag_lookup_type& handle_pkt);
   bool handle_write(const tag_lookup_type& handle_pkt);
+  bool handle_tag_miss(const tag_lookup_type& handle_pkt);
   void finish_packet(const response_type& packet);
   void finish_translation(const response_type& packet);
 
   void issue_translation(tag_lookup_type& q_entry) const;
+  static request_type translation_request(const tag_lookup_type& q_entry);
+
+  champsim::address functional_tag_check(tag_lookup_type handle_pkt);
+  void functional_fill(const tag_lookup_type& handle_pkt, champsim::address data);
+
+  bool shadow_tag_check(const tag_lookup_type& handle_pkt);
+  void shadow_fill(const mshr_type& fill_mshr);
+  void update_shadows(const tag_lookup_type& handle_pkt, bool hit);
 
 public:
   using BLOCK = champsim::cache_block;
@@ -138,6 +149,16 @@ private:
 
   template <bool>
   auto initiate_tag_check(champsim::channel* ul = nullptr);
+  [[nodiscard]] champsim::bandwidth::maximum_type tag_check_initiation_bandwidth() const;
+
+  /**
+   * Whether a tag check would miss, and then fail to allocate an MSHR or to reach the lower level. Such a check is retried on every cycle, with the same
+   * result, until a fill frees an MSHR or the lower level takes a request from its queue.
+   */
+  [[nodiscard]] bool tag_check_blocked(const tag_lookup_type& handle_pkt) const;
+
+  // Repeat the attempts that the blocked tag checks and translations make on a cycle in which nothing else happens
+  void retry_blocked();
 
   template <typename T>
   champsim::address module_address(const T& element) const;
@@ -154,6 +175,9 @@ public:
   channel_type* lower_level;
   channel_type* lower_translate;
 
+  // Tag-only caches that observe the accesses to this cache without affecting its timing, so that the miss rates of other geometries can be estimated
+  std::vector<CACHE*> shadows{};
+
   uint32_t cpu = 0;
   std::string NAME;
   uint32_t NUM_SET, NUM_WAY, MSHR_SIZE;
@@ -180,6 +204,11 @@ public:
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
 
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+  void idle(long cycles) final;
+  [[nodiscard]] std::vector<champsim::channel*> lower_channels() const final;
+  champsim::address functional_access(const request_type& packet) final;
+
   [[deprecated]] std::size_t get_occupancy(uint8_t queue_type, champsim::address address) const;
   [[deprecated]] std::size_t get_size(uint8_t queue_type, champsim::address address) const;
 
@@ -218,6 +247,8 @@ public:
   prefetch_line(uint64_t ip, uint64_t base_addr, uint64_t pf_addr, bool fill_this_level, uint32_t prefetch_metadata);
 
   void print_deadlock() final;
+  void checkpoint_save(std::ostream& os) const final;
+  void checkpoint_load(std::istream& is) final;
 
 #include "module_decl.inc"
 
@@ -232,7 +263,10 @@ public:
     virtual uint32_t impl_prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr,
                                                 uint32_t metadata_in) = 0;
     virtual void impl_prefetcher_cycle_operate() = 0;
+    [[nodiscard]] virtual bool impl_prefetcher_operates_every_cycle() const = 0;
     virtual void impl_prefetcher_final_stats() = 0;
+    virtual void impl_prefetcher_checkpoint_save(std::ostream& os) = 0;
+    virtual void impl_prefetcher_checkpoint_load(std::istream& is) = 0;
     virtual void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) = 0;
   };
 
@@ -249,6 +283,8 @@ public:
     virtual void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                              champsim::address victim_addr, access_type type) = 0;
     virtual void impl_replacement_final_stats() = 0;
+    virtual void impl_replacement_checkpoint_save(std::ostream& os) = 0;
+    virtual void impl_replacement_checkpoint_load(std::istream& is) = 0;
   };
 
   template <typename... Ps>
@@ -266,7 +302,13 @@ public:
     [[nodiscard]] uint32_t impl_prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr,
                                                       uint32_t metadata_in) final;
     void impl_prefetcher_cycle_operate() final;
+    [[nodiscard]] bool impl_prefetcher_operates_every_cycle() const final
+    {
+      return (false || ... || champsim::modules::prefetcher::has_cycle_operate<Ps&>);
+    }
     void impl_prefetcher_final_stats() final;
+    void impl_prefetcher_checkpoint_save(std::ostream& os) final;
+    void impl_prefetcher_checkpoint_load(std::istream& is) final;
     void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) final;
   };
 
@@ -290,6 +332,8 @@ public:
     void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                      champsim::address victim_addr, access_type type) final;
     void impl_replacement_final_stats() final;
+    void impl_replacement_checkpoint_save(std::ostream& os) final;
+    void impl_replacement_checkpoint_load(std::istream& is) final;
   };
 
   std::unique_ptr<prefetcher_module_concept> pref_module_pimpl;
@@ -530,6 +574,54 @@ void CACHE::replacement_module_model<Rs...>::impl_replacement_final_stats()
   std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
 }
 
+template <typename... Ps>
+void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_checkpoint_save(std::ostream& os)
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (prefetcher::has_checkpoint_save<decltype(p), std::ostream&>)
+      p.prefetcher_checkpoint_save(os);
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
+template <typename... Ps>
+void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_checkpoint_load(std::istream& is)
+{
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (prefetcher::has_checkpoint_load<decltype(p), std::istream&>)
+      p.prefetcher_checkpoint_load(is);
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
+template <typename... Rs>
+void CACHE::replacement_module_model<Rs...>::impl_replacement_checkpoint_save(std::ostream& os)
+{
+  [[maybe_unused]] auto process_one = [&](auto& r) {
+    using namespace champsim::modules;
+    if constexpr (replacement::has_checkpoint_save<decltype(r), std::ostream&>)
+      r.replacement_checkpoint_save(os);
+  };
+
+  std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
+}
+
+template <typename... Rs>
+void CACHE::replacement_module_model<Rs...>::impl_replacement_checkpoint_load(std::istream& is)
+{
+  [[maybe_unused]] auto process_one = [&](auto& r) {
+    using namespace champsim::modules;
+    if constexpr (replacement::has_checkpoint_load<decltype(r), std::istream&>)
+      r.replacement_checkpoint_load(is);
+  };
+
+  std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
+}
+
 #ifdef SET_ASIDE_CHAMPSIM_MODULE
 #undef SET_ASIDE_CHAMPSIM_MODULE
 #define CHAMPSIM_MODULE
@@ -5,6 +5,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "channel.h"
 #include "event_counter.h"
@@ -24,8 +25,15 @@ struct cache_stats {
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_return = {};
 
   long total_miss_latency_cycles{};
+
+  // cycles accounted through operable::idle() rather than operate()
+  uint64_t skipped_operates = 0;
+
+  // the statistics of the shadow tags of this cache, in the order they were attached
+  std::vector<cache_stats> shadows{};
 };
 
 cache_stats operator-(cache_stats lhs, cache_stats rhs);
+cache_stats operator+(cache_stats lhs, cache_stats rhs);
 
 #endif
@@ -30,6 +30,7 @@
 
 namespace champsim
 {
+class operable;
 
 struct cache_queue_stats {
   uint64_t RQ_ACCESS = 0;
@@ -102,12 +103,29 @@ public:
 
   stats_type sim_stats{}, roi_stats{};
 
+  // The operables to wake when a request is added to this channel, or when a response is returned through it or room is made in its queues
+  champsim::operable* request_sink = nullptr;
+  champsim::operable* response_sink = nullptr;
+
   channel() = default;
   channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset);
 
   bool add_rq(const request_type& packet);
   bool add_wq(const request_type& packet);
   bool add_pq(const request_type& packet);
+  void add_returned(const response_type& resp);
+
+  /**
+   * Wake the operable that sends requests through this channel. The receiver calls this after it removes requests from the queues,
+   * so that a sender blocked on a full queue may retry.
+   */
+  void notify_drained() const;
+
+  /**
+   * Pass a request directly to the operable that receives the requests of this channel, bypassing the queues.
+   * :returns: The data of the response.
+   */
+  champsim::address functional_access(const request_type& packet) const;
 
   [[nodiscard]] std::size_t rq_occupancy() const;
   [[nodiscard]] std::size_t wq_occupancy() const;
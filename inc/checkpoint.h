@@ -0,0 +1,55 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <functional>
+#include <iosfwd>
+#include <string_view>
+
+namespace champsim
+{
+struct environment;
+
+/**
+ * Write the warmed state of every component in the environment to the stream.
+ * This includes the contents of the caches and predictors, the page tables, and the number of instructions each core has retired.
+ * Instructions that are still in flight are not saved.
+ */
+void save_checkpoint(environment& env, std::ostream& os);
+
+/**
+ * Restore the state written by save_checkpoint() into an initialized environment.
+ * Throws std::runtime_error if the checkpoint was written by a machine with a different configuration.
+ */
+void load_checkpoint(environment& env, std::istream& is);
+
+/**
+ * Write a section of a checkpoint, tagged with the identity of the object that produced it.
+ */
+void checkpoint_save_section(std::ostream& os, std::string_view identity, const std::function<void(std::ostream&)>& save);
+
+/**
+ * Read a section of a checkpoint. If the section was written by an object with the same identity, it is passed to the load function.
+ * Otherwise, it is skipped, so that, for example, the contents of a cache can be restored under a different prefetcher than the one it was warmed with.
+ *
+ * :returns: true if the section was loaded.
+ */
+bool checkpoint_load_section(std::istream& is, std::string_view identity, const std::function<void(std::istream&)>& load);
+} // namespace champsim
+
+#endif
@@ -0,0 +1,469 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COLUMNAR_TRACE_H
+#define COLUMNAR_TRACE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "trace_index.h"
+#include "trace_instruction.h"
+#include "util/detect.h"
+
+/*
+ * The columnar trace format stores the same instructions as a stream of input_instr or cloudsuite_instr records, in a fraction of the space
+ * before compression. A file begins with a 16-byte header:
+ *
+ *   8 bytes   the characters "CHAMPCOL"
+ *   4 bytes   the format version
+ *   1 byte    the number of destination operands of each kind in the record type
+ *   1 byte    the number of source operands of each kind in the record type
+ *   1 byte    1 if the records have an ASID, otherwise 0
+ *   1 byte    reserved
+ *
+ * It is followed by blocks of up to block_instructions instructions. Each block begins with the number of instructions and the size of each
+ * column in bytes, and then holds each column in turn. All integers are little-endian.
+ *
+ *   ip               The difference from the previous IP, as a zigzag varint
+ *   branch           One byte: bit 0 is is_branch, and bit 1 is branch_taken
+ *   register counts  One byte: the number of destination registers, and the number of source registers in the upper four bits
+ *   registers        The destination registers, then the source registers
+ *   memory counts    One byte: the number of destination addresses, and the number of source addresses in the upper four bits
+ *   memory           Each address, as a zigzag varint of its difference from the last address of the same operand of the same IP
+ *   asid             Two bytes, if the records have an ASID
+ *
+ * Registers and addresses that are zero are not stored, and the others are packed to the front of their arrays when the records are decoded.
+ * The simulator ignores zeros in these arrays, so it reads the same instructions from either format. Each block is decoded independently
+ * of the others.
+ */
+namespace champsim::detail
+{
+/**
+ * Whether the name of a trace ends in the given extension, followed by the extension of any compression.
+ */
+inline bool has_format_extension(std::string_view name, std::string_view extension)
+{
+  auto ends_with = [](std::string_view str, std::string_view suffix) {
+    return std::size(str) >= std::size(suffix) && str.substr(std::size(str) - std::size(suffix)) == suffix;
+  };
+
+  for (std::string_view compression : {".gz", ".xz", ".bz2", ".zst"}) {
+    if (ends_with(name, compression)) {
+      name.remove_suffix(std::size(compression));
+      break;
+    }
+  }
+  return ends_with(name, extension);
+}
+} // namespace champsim::detail
+
+namespace champsim::columnar
+{
+constexpr std::array<char, 8> magic{'C', 'H', 'A', 'M', 'P', 'C', 'O', 'L'};
+constexpr uint32_t version = 1;
+constexpr std::size_t header_size = 16;
+constexpr std::size_t block_instructions = 1 << 16;
+constexpr std::size_t history_size = 1 << 12; // The number of address histories. IPs that share a history still decode correctly.
+
+enum column : std::size_t { IP, BRANCH, REGISTER_COUNTS, REGISTERS, MEMORY_COUNTS, MEMORY, ASID, NUM_COLUMNS };
+constexpr std::size_t block_header_size = 4 * (1 + NUM_COLUMNS);
+
+/**
+ * Whether a trace is in the columnar format, which is given by its name: *.cols, followed by the extension of any compression.
+ */
+inline bool is_columnar_trace(std::string_view name) { return champsim::detail::has_format_extension(name, ".cols"); }
+
+template <typename T>
+using has_asid = decltype(std::declval<T>().asid);
+
+template <typename T>
+struct record_layout {
+  constexpr static std::size_t destinations = std::extent_v<decltype(T::destination_registers)>;
+  constexpr static std::size_t sources = std::extent_v<decltype(T::source_registers)>;
+  constexpr static bool asid = champsim::is_detected_v<has_asid, T>;
+};
+
+namespace detail
+{
+inline void put_le(std::vector<uint8_t>& out, uint64_t value, std::size_t bytes)
+{
+  for (std::size_t i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+inline uint64_t get_le(const uint8_t* in, std::size_t bytes)
+{
+  uint64_t retval = 0;
+  for (std::size_t i = 0; i < bytes; ++i) {
+    retval |= uint64_t{in[i]} << (8 * i);
+  }
+  return retval;
+}
+
+inline void put_varint(std::vector<uint8_t>& out, int64_t value)
+{
+  auto zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  while (zigzag >= 0x80) {
+    out.push_back(static_cast<uint8_t>(zigzag | 0x80));
+    zigzag >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(zigzag));
+}
+
+inline int64_t get_varint(const uint8_t*& it, const uint8_t* end)
+{
+  uint64_t zigzag = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (it == end) {
+      throw std::runtime_error{"A columnar trace block ends in the middle of a value"};
+    }
+    auto byte = *it++;
+    zigzag |= uint64_t{byte & 0x7fu} << shift;
+    if ((byte & 0x80) == 0) {
+      return static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    }
+  }
+  throw std::runtime_error{"A columnar trace block contains a value that is too long"};
+}
+
+inline std::size_t history_index(uint64_t ip, std::size_t operand)
+{
+  return static_cast<std::size_t>(((ip + operand) * 0x9e3779b97f4a7c15ull) >> 52) & (history_size - 1);
+}
+
+template <typename It>
+std::size_t count_nonzero(It begin, It end)
+{
+  return static_cast<std::size_t>(std::count_if(begin, end, [](auto x) { return x != 0; }));
+}
+} // namespace detail
+
+/**
+ * The header that begins a columnar trace of records of type T.
+ */
+template <typename T>
+std::vector<uint8_t> header()
+{
+  std::vector<uint8_t> retval{std::begin(magic), std::end(magic)};
+  detail::put_le(retval, version, 4);
+  retval.push_back(static_cast<uint8_t>(record_layout<T>::destinations));
+  retval.push_back(static_cast<uint8_t>(record_layout<T>::sources));
+  retval.push_back(record_layout<T>::asid ? 1 : 0);
+  retval.push_back(0);
+  return retval;
+}
+
+/**
+ * Check that the given bytes begin a columnar trace of records of type T.
+ */
+template <typename T>
+void check_header(const std::array<uint8_t, header_size>& bytes)
+{
+  if (!std::equal(std::begin(magic), std::end(magic), std::begin(bytes))) {
+    throw std::runtime_error{"The trace is not in the columnar format"};
+  }
+  if (detail::get_le(std::next(std::data(bytes), std::size(magic)), 4) != version) {
+    throw std::runtime_error{"The columnar trace has an unsupported version"};
+  }
+  auto expected = header<T>();
+  if (!std::equal(std::next(std::begin(bytes), std::size(magic) + 4), std::end(bytes), std::next(std::begin(expected), std::size(magic) + 4))) {
+    throw std::runtime_error{"The columnar trace holds a different kind of record than was requested"};
+  }
+}
+
+/**
+ * Collects records of type T into columns, and encodes them as a block.
+ */
+template <typename T>
+class encoder
+{
+  std::array<std::vector<uint8_t>, NUM_COLUMNS> columns{};
+  std::array<uint64_t, history_size> history{};
+  uint64_t last_ip = 0;
+  std::size_t count = 0;
+
+  template <typename It>
+  void push_memory(uint64_t ip, std::size_t first_operand, It begin, It end)
+  {
+    std::size_t operand = first_operand;
+    for (auto it = begin; it != end; ++it) {
+      if (*it != 0) {
+        auto& last = history[detail::history_index(ip, operand++)];
+        detail::put_varint(columns[MEMORY], static_cast<int64_t>(*it - last));
+        last = *it;
+      }
+    }
+  }
+
+public:
+  void push(const T& record)
+  {
+    detail::put_varint(columns[IP], static_cast<int64_t>(record.ip - last_ip));
+    last_ip = record.ip;
+
+    columns[BRANCH].push_back(static_cast<uint8_t>((record.is_branch != 0 ? 1 : 0) | (record.branch_taken != 0 ? 2 : 0)));
+
+    auto num_dreg = detail::count_nonzero(std::begin(record.destination_registers), std::end(record.destination_registers));
+    auto num_sreg = detail::count_nonzero(std::begin(record.source_registers), std::end(record.source_registers));
+    columns[REGISTER_COUNTS].push_back(static_cast<uint8_t>(num_dreg | (num_sreg << 4)));
+    std::copy_if(std::begin(record.destination_registers), std::end(record.destination_registers), std::back_inserter(columns[REGISTERS]),
+                 [](auto x) { return x != 0; });
+    std::copy_if(std::begin(record.source_registers), std::end(record.source_registers), std::back_inserter(columns[REGISTERS]),
+                 [](auto x) { return x != 0; });
+
+    auto num_dmem = detail::count_nonzero(std::begin(record.destination_memory), std::end(record.destination_memory));
+    auto num_smem = detail::count_nonzero(std::begin(record.source_memory), std::end(record.source_memory));
+    columns[MEMORY_COUNTS].push_back(static_cast<uint8_t>(num_dmem | (num_smem << 4)));
+    push_memory(record.ip, 0, std::begin(record.destination_memory), std::end(record.destination_memory));
+    push_memory(record.ip, record_layout<T>::destinations, std::begin(record.source_memory), std::end(record.source_memory));
+
+    if constexpr (record_layout<T>::asid) {
+      columns[ASID].insert(std::end(columns[ASID]), std::begin(record.asid), std::end(record.asid));
+    }
+
+    ++count;
+  }
+
+  /**
+   * The number of records since the last block was encoded.
+   */
+  [[nodiscard]] std::size_t size() const { return count; }
+
+  /**
+   * Encode the records as a block, and begin a new block.
+   */
+  std::vector<uint8_t> flush()
+  {
+    std::vector<uint8_t> retval;
+    detail::put_le(retval, count, 4);
+    for (const auto& col : columns) {
+      detail::put_le(retval, std::size(col), 4);
+    }
+    for (auto& col : columns) {
+      retval.insert(std::end(retval), std::begin(col), std::end(col));
+      col.clear();
+    }
+
+    history.fill(0);
+    last_ip = 0;
+    count = 0;
+    return retval;
+  }
+};
+
+/**
+ * The number of instructions in a block, and the total size of its columns, from the block header.
+ */
+inline std::pair<std::size_t, std::size_t> block_size(const std::array<uint8_t, block_header_size>& bytes)
+{
+  auto count = static_cast<std::size_t>(detail::get_le(std::data(bytes), 4));
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < NUM_COLUMNS; ++i) {
+    size += static_cast<std::size_t>(detail::get_le(std::next(std::data(bytes), static_cast<std::ptrdiff_t>(4 * (i + 1))), 4));
+  }
+  return {count, size};
+}
+
+/**
+ * Decode a block, given its header and columns, and append its records to the given vector.
+ */
+template <typename T>
+void decode_block(const std::array<uint8_t, block_header_size>& block_header, const std::vector<uint8_t>& data, std::vector<T>& out)
+{
+  auto count = block_size(block_header).first;
+  std::array<const uint8_t*, NUM_COLUMNS> it{};
+  std::array<const uint8_t*, NUM_COLUMNS> end{};
+  auto next = std::data(data);
+  for (std::size_t i = 0; i < NUM_COLUMNS; ++i) {
+    it[i] = next;
+    next = std::next(next, static_cast<std::ptrdiff_t>(detail::get_le(std::next(std::data(block_header), static_cast<std::ptrdiff_t>(4 * (i + 1))), 4)));
+    end[i] = next;
+  }
+
+  auto fixed_width = [&](column col, std::size_t width) {
+    if (std::distance(it[col], end[col]) < static_cast<std::ptrdiff_t>(width)) {
+      throw std::runtime_error{"A columnar trace block ends in the middle of a record"};
+    }
+    auto retval = it[col];
+    it[col] = std::next(it[col], static_cast<std::ptrdiff_t>(width));
+    return retval;
+  };
+
+  auto counts = [&](column col) {
+    auto packed = *fixed_width(col, 1);
+    auto retval = std::pair{std::size_t{packed} & 0xf, std::size_t{packed} >> 4};
+    if (retval.first > record_layout<T>::destinations || retval.second > record_layout<T>::sources) {
+      throw std::runtime_error{"A columnar trace block has more operands than its records can hold"};
+    }
+    return retval;
+  };
+
+  std::array<uint64_t, history_size> history{};
+  uint64_t ip = 0;
+  out.reserve(std::size(out) + count);
+  for (std::size_t i = 0; i < count; ++i) {
+    T record{};
+
+    ip += static_cast<uint64_t>(detail::get_varint(it[IP], end[IP]));
+    record.ip = ip;
+
+    auto flags = *fixed_width(BRANCH, 1);
+    record.is_branch = flags & 1;
+    record.branch_taken = (flags >> 1) & 1;
+
+    auto [num_dreg, num_sreg] = counts(REGISTER_COUNTS);
+    std::copy_n(fixed_width(REGISTERS, num_dreg), num_dreg, std::begin(record.destination_registers));
+    std::copy_n(fixed_width(REGISTERS, num_sreg), num_sreg, std::begin(record.source_registers));
+
+    auto [num_dmem, num_smem] = counts(MEMORY_COUNTS);
+    for (std::size_t op = 0; op < num_dmem + num_smem; ++op) {
+      auto& last = history[detail::history_index(ip, (op < num_dmem) ? op : record_layout<T>::destinations + op - num_dmem)];
+      last += static_cast<uint64_t>(detail::get_varint(it[MEMORY], end[MEMORY]));
+      if (op < num_dmem) {
+        record.destination_memory[op] = last;
+      } else {
+        record.source_memory[op - num_dmem] = last;
+      }
+    }
+
+    if constexpr (record_layout<T>::asid) {
+      std::copy_n(fixed_width(ASID, std::size(record.asid)), std::size(record.asid), std::begin(record.asid));
+    }
+
+    out.push_back(record);
+  }
+}
+} // namespace champsim::columnar
+
+namespace champsim
+{
+/**
+ * Reads the blocks of a columnar trace from a stream of type F, which may decompress the file.
+ */
+template <typename F>
+class columnar_istream
+{
+  F underlying;
+  bool header_checked = false;
+  uint64_t offset = 0; // The number of bytes read from the decompressed trace
+
+  template <typename U>
+  using has_seekg = decltype(std::declval<U&>().seekg(std::streamoff{}));
+
+  // Read exactly the given number of bytes, or none at the end of the stream
+  bool read_exact(uint8_t* data, std::size_t size)
+  {
+    underlying.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+    auto bytes_read = static_cast<std::size_t>(underlying.gcount());
+    if (bytes_read != 0 && bytes_read != size) {
+      throw std::runtime_error{"The columnar trace ends in the middle of a block"};
+    }
+    offset += bytes_read;
+    return bytes_read == size;
+  }
+
+public:
+  explicit columnar_istream(std::string s) : underlying(s) {}
+  explicit columnar_istream(F&& str) : underlying(std::move(str)) {}
+
+  /**
+   * Decode the next block, and append its records to the given vector.
+   *
+   * \return false if the trace has no more blocks
+   */
+  template <typename T>
+  bool read_block(std::vector<T>& out)
+  {
+    if (!header_checked) {
+      std::array<uint8_t, columnar::header_size> file_header{};
+      if (!read_exact(std::data(file_header), std::size(file_header))) {
+        return false;
+      }
+      columnar::check_header<T>(file_header);
+      header_checked = true;
+    }
+
+    std::array<uint8_t, columnar::block_header_size> block_header{};
+    if (!read_exact(std::data(block_header), std::size(block_header))) {
+      return false;
+    }
+
+    std::vector<uint8_t> data(columnar::block_size(block_header).second);
+    if (!std::empty(data) && !read_exact(std::data(data), std::size(data))) {
+      throw std::runtime_error{"The columnar trace ends in the middle of a block"};
+    }
+
+    columnar::decode_block(block_header, data, out);
+    return true;
+  }
+
+  /**
+   * Move forward to the block that begins at the given offset into the decompressed trace. If the trace is compressed, decompression
+   * resumes at the last checkpoint of the index before the block, if that is ahead of the reader. Otherwise, the blocks in between are
+   * decompressed, but not decoded.
+   *
+   * \return false if the block has already been read
+   */
+  bool seek(const trace_index& index, uint64_t destination)
+  {
+    if (!header_checked || destination < offset) {
+      return false;
+    }
+
+    if constexpr (champsim::is_detected_v<has_checkpoint_seek, F>) {
+      if (const auto* point = index.checkpoint_before(destination); point != nullptr && point->decompressed_offset > offset) {
+        underlying.seek(*point, destination);
+        offset = destination;
+        return true;
+      }
+    }
+
+    if constexpr (champsim::is_detected_v<has_seekg, F>) {
+      if (destination == offset) {
+        return true;
+      }
+      underlying.clear();
+      underlying.seekg(static_cast<std::streamoff>(destination));
+    } else {
+      std::vector<char> skipped(1 << 16);
+      for (auto remaining = destination - offset; remaining > 0;) {
+        auto chunk = std::min<uint64_t>(remaining, std::size(skipped));
+        underlying.read(std::data(skipped), static_cast<std::streamsize>(chunk));
+        if (underlying.gcount() != static_cast<std::streamsize>(chunk)) {
+          throw std::runtime_error{"The columnar trace ends before a block in its index"};
+        }
+        remaining -= chunk;
+      }
+    }
+    offset = destination;
+    return true;
+  }
+};
+} // namespace champsim
+
+#endif
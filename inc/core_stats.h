@@ -14,6 +14,7 @@ struct cpu_stats {
   long long end_instrs = 0;
   long long end_cycles = 0;
   uint64_t total_rob_occupancy_at_branch_mispredict = 0;
+  uint64_t skipped_operates = 0;
 
   champsim::stats::event_counter<branch_type> total_branch_types = {};
   champsim::stats::event_counter<branch_type> branch_type_misses = {};
@@ -23,5 +24,6 @@ struct cpu_stats {
 };
 
 cpu_stats operator-(cpu_stats lhs, cpu_stats rhs);
+cpu_stats operator+(cpu_stats lhs, cpu_stats rhs);
 
 #endif
@@ -0,0 +1,395 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DICTIONARY_TRACE_H
+#define DICTIONARY_TRACE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "columnar_trace.h"
+#include "trace_instruction.h"
+
+/*
+ * The dictionary trace format stores the parts of an instruction that are the same in each of its executions only once, in a table of static
+ * instructions. Each dynamic instruction is then an index into the table, the branch direction, and the memory addresses. A file begins with
+ * a 16-byte header, which is laid out as in the columnar format, but begins with the characters "CHAMPDIC".
+ *
+ * It is followed by blocks of up to block_instructions instructions. Each block begins with the number of instructions and the size of the
+ * block in bytes, as 4-byte little-endian integers. Each instruction is
+ *
+ *   index        An unsigned varint of twice the index of the static instruction, plus one if the branch was taken
+ *   definition   If the index is the size of the table, a new static instruction follows:
+ *                  ip                The difference from the IP of the previous static instruction, as a zigzag varint
+ *                  flags             One byte: bit 0 is is_branch
+ *                  register counts   One byte: the number of destination registers, and the number of source registers in the upper four bits
+ *                  registers         The destination registers, then the source registers
+ *                  memory counts     One byte: the number of destination addresses, and the number of source addresses in the upper four bits
+ *   memory       Each address, as a zigzag varint of its difference from the last address of the same operand of the static instruction
+ *   asid         Two bytes, if the records have an ASID
+ *
+ * An IP has more than one static instruction if its operands differ between executions. The table grows through the whole trace, so the
+ * blocks must be decoded in order.
+ */
+namespace champsim::dictionary
+{
+constexpr std::array<char, 8> magic{'C', 'H', 'A', 'M', 'P', 'D', 'I', 'C'};
+constexpr uint32_t version = 1;
+constexpr std::size_t header_size = 16;
+constexpr std::size_t block_header_size = 8;
+constexpr std::size_t block_instructions = 1 << 16;
+
+/**
+ * Whether a trace is in the dictionary format, which is given by its name: *.dict, followed by the extension of any compression.
+ */
+inline bool is_dictionary_trace(std::string_view name) { return champsim::detail::has_format_extension(name, ".dict"); }
+
+template <typename T>
+using record_layout = champsim::columnar::record_layout<T>;
+
+namespace detail
+{
+inline void put_uvarint(std::vector<uint8_t>& out, uint64_t value)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+inline uint64_t get_uvarint(const uint8_t*& it, const uint8_t* end)
+{
+  uint64_t retval = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (it == end) {
+      throw std::runtime_error{"A dictionary trace block ends in the middle of a value"};
+    }
+    auto byte = *it++;
+    retval |= uint64_t{byte & 0x7fu} << shift;
+    if ((byte & 0x80) == 0) {
+      return retval;
+    }
+  }
+  throw std::runtime_error{"A dictionary trace block contains a value that is too long"};
+}
+
+template <typename T>
+constexpr std::size_t memory_operands = std::extent_v<decltype(T::destination_memory)> + std::extent_v<decltype(T::source_memory)>;
+} // namespace detail
+
+/**
+ * The header that begins a dictionary trace of records of type T.
+ */
+template <typename T>
+std::vector<uint8_t> header()
+{
+  auto retval = champsim::columnar::header<T>();
+  std::copy(std::begin(magic), std::end(magic), std::begin(retval));
+  return retval;
+}
+
+/**
+ * Check that the given bytes begin a dictionary trace of records of type T.
+ */
+template <typename T>
+void check_header(const std::array<uint8_t, header_size>& bytes)
+{
+  if (!std::equal(std::begin(magic), std::end(magic), std::begin(bytes))) {
+    throw std::runtime_error{"The trace is not in the dictionary format"};
+  }
+  if (champsim::columnar::detail::get_le(std::next(std::data(bytes), std::size(magic)), 4) != version) {
+    throw std::runtime_error{"The dictionary trace has an unsupported version"};
+  }
+  auto expected = header<T>();
+  if (!std::equal(std::next(std::begin(bytes), std::size(magic) + 4), std::end(bytes), std::next(std::begin(expected), std::size(magic) + 4))) {
+    throw std::runtime_error{"The dictionary trace holds a different kind of record than was requested"};
+  }
+}
+
+/**
+ * One execution of a static instruction, as it is decoded from the trace.
+ */
+template <typename T>
+struct instance {
+  std::size_t index = 0;
+  bool branch_taken = false;
+  std::array<uint64_t, detail::memory_operands<T>> memory{}; // The destination addresses, then the source addresses
+  std::array<unsigned char, 2> asid{};
+};
+
+/**
+ * Collects records of type T into blocks, and adds their static instructions to the table as they are first seen.
+ */
+template <typename T>
+class encoder
+{
+  std::unordered_map<std::string, std::size_t> table{};
+  std::vector<std::array<uint64_t, detail::memory_operands<T>>> history{};
+  std::vector<uint8_t> data{};
+  uint64_t last_ip = 0;
+  std::size_t count = 0;
+
+public:
+  void push(const T& record)
+  {
+    std::vector<uint8_t> definition;
+    champsim::columnar::detail::put_varint(definition, static_cast<int64_t>(record.ip - last_ip));
+    definition.push_back(record.is_branch != 0 ? 1 : 0);
+
+    auto num_dreg = champsim::columnar::detail::count_nonzero(std::begin(record.destination_registers), std::end(record.destination_registers));
+    auto num_sreg = champsim::columnar::detail::count_nonzero(std::begin(record.source_registers), std::end(record.source_registers));
+    definition.push_back(static_cast<uint8_t>(num_dreg | (num_sreg << 4)));
+    std::copy_if(std::begin(record.destination_registers), std::end(record.destination_registers), std::back_inserter(definition),
+                 [](auto x) { return x != 0; });
+    std::copy_if(std::begin(record.source_registers), std::end(record.source_registers), std::back_inserter(definition),
+                 [](auto x) { return x != 0; });
+
+    std::array<uint64_t, detail::memory_operands<T>> memory{};
+    auto mem_end = std::copy_if(std::begin(record.destination_memory), std::end(record.destination_memory), std::begin(memory), [](auto x) { return x != 0; });
+    auto num_dmem = static_cast<std::size_t>(std::distance(std::begin(memory), mem_end));
+    mem_end = std::copy_if(std::begin(record.source_memory), std::end(record.source_memory), mem_end, [](auto x) { return x != 0; });
+    auto num_mem = static_cast<std::size_t>(std::distance(std::begin(memory), mem_end));
+    definition.push_back(static_cast<uint8_t>(num_dmem | ((num_mem - num_dmem) << 4)));
+
+    // The key is the definition with the absolute IP, so that it does not depend on the previous static instruction
+    std::string key{reinterpret_cast<const char*>(&record.ip), sizeof(record.ip)};
+    key.append(std::next(std::begin(definition), static_cast<std::ptrdiff_t>(std::size(definition) - 3 - num_dreg - num_sreg)), std::end(definition));
+    auto [found, inserted] = table.try_emplace(key, std::size(table));
+    detail::put_uvarint(data, 2 * found->second + (record.branch_taken != 0 ? 1 : 0));
+    if (inserted) {
+      data.insert(std::end(data), std::begin(definition), std::end(definition));
+      history.emplace_back();
+      last_ip = record.ip;
+    }
+
+    auto& last = history.at(found->second);
+    for (std::size_t op = 0; op < num_mem; ++op) {
+      champsim::columnar::detail::put_varint(data, static_cast<int64_t>(memory[op] - last[op]));
+      last[op] = memory[op];
+    }
+
+    if constexpr (record_layout<T>::asid) {
+      data.insert(std::end(data), std::begin(record.asid), std::end(record.asid));
+    }
+
+    ++count;
+  }
+
+  /**
+   * The number of records since the last block was encoded.
+   */
+  [[nodiscard]] std::size_t size() const { return count; }
+
+  /**
+   * The number of static instructions in the table.
+   */
+  [[nodiscard]] std::size_t static_instructions() const { return std::size(table); }
+
+  /**
+   * Encode the records as a block, and begin a new block. The table is kept for the following blocks.
+   */
+  std::vector<uint8_t> flush()
+  {
+    std::vector<uint8_t> retval;
+    champsim::columnar::detail::put_le(retval, count, 4);
+    champsim::columnar::detail::put_le(retval, std::size(data), 4);
+    retval.insert(std::end(retval), std::begin(data), std::end(data));
+    data.clear();
+    count = 0;
+    return retval;
+  }
+};
+
+/**
+ * The number of instructions in a block, and its size, from the block header.
+ */
+inline std::pair<std::size_t, std::size_t> block_size(const std::array<uint8_t, block_header_size>& bytes)
+{
+  return {static_cast<std::size_t>(champsim::columnar::detail::get_le(std::data(bytes), 4)),
+          static_cast<std::size_t>(champsim::columnar::detail::get_le(std::next(std::data(bytes), 4), 4))};
+}
+
+/**
+ * Decodes the blocks of a dictionary trace in order, and keeps the table of static instructions.
+ * Each static instruction is kept as a record of type T with no memory addresses, and with its branch not taken.
+ */
+template <typename T>
+class decoder
+{
+  std::vector<T> table{};
+  std::vector<std::pair<std::size_t, std::size_t>> memory_counts{};
+  std::vector<std::array<uint64_t, detail::memory_operands<T>>> history{};
+  uint64_t last_ip = 0;
+
+public:
+  [[nodiscard]] const std::vector<T>& static_instructions() const { return table; }
+
+  /**
+   * The number of destination and source addresses of a static instruction.
+   */
+  [[nodiscard]] std::pair<std::size_t, std::size_t> memory_count(std::size_t index) const { return memory_counts.at(index); }
+
+  /**
+   * Decode a block, given its header and data, and append its instructions to the given vector.
+   */
+  void decode_block(const std::array<uint8_t, block_header_size>& block_header, const std::vector<uint8_t>& data, std::vector<instance<T>>& out)
+  {
+    auto it = std::data(data);
+    auto end = std::next(it, static_cast<std::ptrdiff_t>(std::size(data)));
+    auto next_byte = [&] {
+      if (it == end) {
+        throw std::runtime_error{"A dictionary trace block ends in the middle of an instruction"};
+      }
+      return *it++;
+    };
+
+    auto counts = [&](std::size_t max_destinations, std::size_t max_sources) {
+      auto packed = next_byte();
+      auto retval = std::pair{std::size_t{packed} & 0xf, std::size_t{packed} >> 4};
+      if (retval.first > max_destinations || retval.second > max_sources) {
+        throw std::runtime_error{"A dictionary trace has more operands than its records can hold"};
+      }
+      return retval;
+    };
+
+    auto count = block_size(block_header).first;
+    out.reserve(std::size(out) + count);
+    for (std::size_t i = 0; i < count; ++i) {
+      instance<T> inst{};
+      auto packed_index = detail::get_uvarint(it, end);
+      inst.index = static_cast<std::size_t>(packed_index >> 1);
+      inst.branch_taken = (packed_index & 1) != 0;
+
+      if (inst.index == std::size(table)) {
+        T record{};
+        last_ip += static_cast<uint64_t>(champsim::columnar::detail::get_varint(it, end));
+        record.ip = last_ip;
+        record.is_branch = next_byte() & 1;
+
+        auto [num_dreg, num_sreg] = counts(record_layout<T>::destinations, record_layout<T>::sources);
+        std::generate_n(std::begin(record.destination_registers), num_dreg, next_byte);
+        std::generate_n(std::begin(record.source_registers), num_sreg, next_byte);
+        memory_counts.push_back(counts(std::size(record.destination_memory), std::size(record.source_memory)));
+
+        table.push_back(record);
+        history.emplace_back();
+      } else if (inst.index > std::size(table)) {
+        throw std::runtime_error{"A dictionary trace refers to a static instruction that it has not defined"};
+      }
+
+      auto [num_dmem, num_smem] = memory_counts[inst.index];
+      auto& last = history[inst.index];
+      for (std::size_t op = 0; op < num_dmem + num_smem; ++op) {
+        last[op] += static_cast<uint64_t>(champsim::columnar::detail::get_varint(it, end));
+        inst.memory[op] = last[op];
+      }
+
+      if constexpr (record_layout<T>::asid) {
+        std::generate(std::begin(inst.asid), std::end(inst.asid), next_byte);
+      }
+
+      out.push_back(inst);
+    }
+  }
+
+  /**
+   * The record of type T for an instruction.
+   */
+  [[nodiscard]] T expand(const instance<T>& inst) const
+  {
+    auto retval = table.at(inst.index);
+    retval.branch_taken = inst.branch_taken;
+    auto [num_dmem, num_smem] = memory_counts.at(inst.index);
+    std::copy_n(std::begin(inst.memory), num_dmem, std::begin(retval.destination_memory));
+    std::copy_n(std::next(std::begin(inst.memory), static_cast<std::ptrdiff_t>(num_dmem)), num_smem, std::begin(retval.source_memory));
+    if constexpr (record_layout<T>::asid) {
+      std::copy(std::begin(inst.asid), std::end(inst.asid), std::begin(retval.asid));
+    }
+    return retval;
+  }
+};
+} // namespace champsim::dictionary
+
+namespace champsim
+{
+/**
+ * Reads the blocks of a dictionary trace from a stream of type F, which may decompress the file.
+ */
+template <typename F>
+class dictionary_istream
+{
+  F underlying;
+  bool header_checked = false;
+
+  // Read exactly the given number of bytes, or none at the end of the stream
+  bool read_exact(uint8_t* data, std::size_t size)
+  {
+    underlying.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+    auto bytes_read = static_cast<std::size_t>(underlying.gcount());
+    if (bytes_read != 0 && bytes_read != size) {
+      throw std::runtime_error{"The dictionary trace ends in the middle of a block"};
+    }
+    return bytes_read == size;
+  }
+
+public:
+  explicit dictionary_istream(std::string s) : underlying(s) {}
+  explicit dictionary_istream(F&& str) : underlying(std::move(str)) {}
+
+  /**
+   * Decode the next block with the given decoder, and append its instructions to the given vector.
+   *
+   * \return false if the trace has no more blocks
+   */
+  template <typename T>
+  bool read_block(dictionary::decoder<T>& decoder, std::vector<dictionary::instance<T>>& out)
+  {
+    if (!header_checked) {
+      std::array<uint8_t, dictionary::header_size> file_header{};
+      if (!read_exact(std::data(file_header), std::size(file_header))) {
+        return false;
+      }
+      dictionary::check_header<T>(file_header);
+      header_checked = true;
+    }
+
+    std::array<uint8_t, dictionary::block_header_size> block_header{};
+    if (!read_exact(std::data(block_header), std::size(block_header))) {
+      return false;
+    }
+
+    std::vector<uint8_t> data(dictionary::block_size(block_header).second);
+    if (!std::empty(data) && !read_exact(std::data(data), std::size(data))) {
+      throw std::runtime_error{"The dictionary trace ends in the middle of a block"};
+    }
+
+    decoder.decode_block(block_header, data, out);
+    return true;
+  }
+};
+} // namespace champsim
+
+#endif
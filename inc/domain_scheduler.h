@@ -0,0 +1,61 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DOMAIN_SCHEDULER_H
+#define DOMAIN_SCHEDULER_H
+
+#include <functional>
+#include <vector>
+
+#include "chrono.h"
+
+namespace champsim
+{
+class operable;
+
+/**
+ * Operates a fixed set of operables, grouped into clock domains by their clock period.
+ *
+ * Each domain records the time up to which its members have been operated. On each call to operate_on(), only the domains that lag the clock are
+ * dispatched. The members of the dispatched domains are operated in order of their current time. Ties are broken by the order the operables were
+ * given, so the order is deterministic.
+ */
+class domain_scheduler
+{
+  struct clock_domain {
+    champsim::chrono::picoseconds clock_period;
+    champsim::chrono::clock::time_point current_time;
+    std::vector<std::pair<std::size_t, std::reference_wrapper<operable>>> members{};
+    std::size_t next_member = 0;
+  };
+
+  std::vector<clock_domain> domains;
+
+public:
+  explicit domain_scheduler(const std::vector<std::reference_wrapper<operable>>& operables);
+
+  /**
+   * Operate every operable whose clock domain lags the given clock.
+   *
+   * :returns: The total progress of the operated operables.
+   */
+  long operate_on(const champsim::chrono::clock& clock);
+
+  [[nodiscard]] std::size_t num_domains() const;
+};
+} // namespace champsim
+
+#endif
@@ -109,7 +109,7 @@ struct DRAM_CHANNEL final : public champsim::operable {
     champsim::chrono::clock::time_point ready_time = champsim::chrono::clock::time_point::max();
 
     std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    std::vector<champsim::channel*> to_return{};
 
     explicit request_type(const typename champsim::channel::request_type& req);
   };
@@ -170,16 +170,21 @@ struct DRAM_CHANNEL final : public champsim::operable {
   void check_read_collision();
   long finish_dbus_request();
   long schedule_refresh();
+  [[nodiscard]] bool should_swap_write_mode() const;
   void swap_write_mode();
   long populate_dbus();
   DRAM_CHANNEL::queue_type::iterator schedule_packet();
+  [[nodiscard]] DRAM_CHANNEL::queue_type::const_iterator schedule_packet() const;
   long service_packet(DRAM_CHANNEL::queue_type::iterator pkt);
 
   void initialize() final;
   long operate() final;
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
   void print_deadlock() final;
+  void checkpoint_save(std::ostream& os) const final;
+  void checkpoint_load(std::istream& is) final;
 
   std::size_t bank_request_capacity() const;
   std::size_t bankgroup_request_capacity() const;
@@ -213,9 +218,13 @@ public:
 
   void initialize() final;
   long operate() final;
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+  void idle(long cycles) final;
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
   void print_deadlock() final;
+  void checkpoint_save(std::ostream& os) const final;
+  void checkpoint_load(std::istream& is) final;
 
   [[nodiscard]] champsim::data::bytes size() const;
 };
@@ -86,6 +86,10 @@ public:
 
   event_counter<key_type>& operator+=(const event_counter<key_type>& rhs)
   {
+    // Events that have only been counted in rhs are counted in the sum
+    for (auto key : rhs.keys) {
+      allocate(key);
+    }
     std::transform(std::begin(values), std::end(values), std::cbegin(keys), std::begin(values),
                    [&rhs](auto val, auto key) { return val + rhs.value_or(key, value_type{}); });
     return *this;
@@ -17,12 +17,25 @@
 #ifndef INF_STREAM_H
 #define INF_STREAM_H
 
+#include <algorithm>
+#include <array>
 #include <bzlib.h>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <lzma.h>
 #include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 #include <zlib.h>
+#include <zstd.h>
+
+#include "trace_index.h"
 
 namespace champsim
 {
@@ -40,6 +53,11 @@ struct end_deleter {
     delete s;
   }
 };
+
+template <typename State, typename R, R (*Free)(State*)>
+struct free_deleter {
+  void operator()(State* s) { Free(s); }
+};
 } // namespace detail
 
 struct bzip2_tag_t {
@@ -50,13 +68,13 @@ struct bzip2_tag_t {
   using inflate_state_type = std::unique_ptr<state_type, detail::end_deleter<state_type, int, ::BZ2_bzDecompressEnd>>;
   using status_type = status_t;
 
-  static status_type deflate(deflate_state_type& x, bool flush)
+  static status_type deflate(deflate_state_type& x, bool finish)
   {
-    auto ret = ::BZ2_bzCompress(x.get(), flush ? BZ_FLUSH : BZ_RUN);
-    if (ret == BZ_RUN_OK) {
+    auto ret = ::BZ2_bzCompress(x.get(), finish ? BZ_FINISH : BZ_RUN);
+    if (ret == BZ_RUN_OK || ret == BZ_FINISH_OK) {
       return status_type::CAN_CONTINUE;
     }
-    if (ret == BZ_FLUSH_OK) {
+    if (ret == BZ_STREAM_END) {
       return status_type::END;
     }
     return status_type::ERROR;
@@ -94,9 +112,9 @@ struct gzip_tag_t {
   using inflate_state_type = std::unique_ptr<state_type, detail::end_deleter<state_type, int, ::inflateEnd>>;
   using status_type = status_t;
 
-  static status_type deflate(deflate_state_type& x, bool flush)
+  static status_type deflate(deflate_state_type& x, bool finish)
   {
-    auto ret = ::deflate(x.get(), flush ? Z_FINISH : Z_NO_FLUSH);
+    auto ret = ::deflate(x.get(), finish ? Z_FINISH : Z_NO_FLUSH);
     if (ret == Z_OK) {
       return status_type::CAN_CONTINUE;
     }
@@ -108,7 +126,10 @@ struct gzip_tag_t {
 
   static status_type inflate(inflate_state_type& x)
   {
-    ::inflate(x.get(), Z_BLOCK);
+    if (::inflate(x.get(), Z_BLOCK) == Z_STREAM_END) {
+      x->avail_in = 0; // Anything after the end of the stream is not decompressed
+      return status_type::END;
+    }
     return status_type::CAN_CONTINUE;
   }
 
@@ -116,7 +137,7 @@ struct gzip_tag_t {
   {
     deflate_state_type state{new state_type};
     *state = state_type{Z_NULL, 0, 0, Z_NULL, 0, 0, NULL, NULL, Z_NULL, Z_NULL, Z_NULL, 0, 0UL, 0UL};
-    ::deflateInit(state.get(), compression);
+    ::deflateInit2(state.get(), compression, Z_DEFLATED, window, 8, Z_DEFAULT_STRATEGY);
     return state;
   }
 
@@ -127,20 +148,85 @@ struct gzip_tag_t {
     ::inflateInit2(state.get(), window);
     return state;
   }
+
+  /**
+   * Begin decompressing at a checkpoint, which is the boundary of a deflate block.
+   */
+  template <typename IStrm>
+  static inflate_state_type resume_inflate_state(const inflate_checkpoint& point, IStrm& file)
+  {
+    inflate_state_type state{new state_type};
+    *state = state_type{Z_NULL, 0, 0, Z_NULL, 0, 0, NULL, NULL, Z_NULL, Z_NULL, Z_NULL, 0, 0UL, 0UL};
+    ::inflateInit2(state.get(), -(window & 0xf)); // The checkpoint is within the raw deflate stream, after the header
+    if (point.bits > 0) {
+      file.seekg(static_cast<std::streamoff>(point.compressed_offset) - 1);
+      auto byte = file.get();
+      ::inflatePrime(state.get(), point.bits, byte >> (8 - point.bits));
+    }
+    ::inflateSetDictionary(state.get(), std::data(point.window), static_cast<uInt>(std::size(point.window)));
+    return state;
+  }
 };
 
+/**
+ * The number of threads that decompress each xz stream. A value of 0 selects one thread for each processor.
+ * Only streams that were compressed into several blocks can be decompressed in parallel.
+ */
+inline uint32_t lzma_decoder_threads = 1; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * The number of threads that compress each xz or zstd stream. A value of 0 selects one thread for each processor.
+ * An xz stream that is compressed on several threads is divided into blocks, so it can also be decompressed on several threads.
+ */
+inline uint32_t compression_threads = 1; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+namespace detail
+{
+inline uint32_t thread_count(uint32_t requested) { return (requested == 0) ? std::max(::lzma_cputhreads(), uint32_t{1}) : requested; }
+} // namespace detail
+
 template <uint32_t flags = 0>
 struct lzma_tag_t {
   using state_type = lzma_stream;
   using in_char_type = std::remove_const_t<std::remove_pointer_t<decltype(state_type::next_in)>>;
   using out_char_type = std::remove_pointer_t<decltype(state_type::next_out)>;
-  using deflate_state_type = std::unique_ptr<state_type, detail::end_deleter<state_type, void, ::lzma_end>>;
-  using inflate_state_type = std::unique_ptr<state_type, detail::end_deleter<state_type, void, ::lzma_end>>;
   using status_type = status_t;
 
-  static status_type deflate(deflate_state_type& x, bool flush)
+  struct inflate_state : state_type {
+    // When decompression resumes at a checkpoint, the blocks of the stream are decoded one at a time
+    bool by_block = false;
+    bool in_block = false;
+    bool ended = false;
+    lzma_check check = LZMA_CHECK_NONE;
+    std::array<uint8_t, LZMA_BLOCK_HEADER_SIZE_MAX> header{};
+    uint32_t header_filled = 0;
+    std::array<lzma_filter, LZMA_FILTERS_MAX + 1> filters{};
+    lzma_block block{};
+
+    inflate_state() : state_type(LZMA_STREAM_INIT) { filters.fill({LZMA_VLI_UNKNOWN, nullptr}); }
+    inflate_state(const inflate_state&) = delete;
+    inflate_state& operator=(const inflate_state&) = delete;
+    ~inflate_state()
+    {
+      free_filters();
+      ::lzma_end(this);
+    }
+
+    void free_filters()
+    {
+      for (auto& filter : filters) {
+        std::free(filter.options); // NOLINT(cppcoreguidelines-no-malloc): The options are allocated by liblzma
+        filter = {LZMA_VLI_UNKNOWN, nullptr};
+      }
+    }
+  };
+
+  using deflate_state_type = std::unique_ptr<state_type, detail::end_deleter<state_type, void, ::lzma_end>>;
+  using inflate_state_type = std::unique_ptr<inflate_state>;
+
+  static status_type deflate(deflate_state_type& x, bool finish)
   {
-    auto ret = ::lzma_code(x.get(), flush ? LZMA_FULL_FLUSH : LZMA_RUN);
+    auto ret = ::lzma_code(x.get(), finish ? LZMA_FINISH : LZMA_RUN);
     if (ret == LZMA_OK) {
       return status_type::CAN_CONTINUE;
     } else if (ret == LZMA_STREAM_END) {
@@ -152,6 +238,10 @@ struct lzma_tag_t {
 
   static status_type inflate(inflate_state_type& x)
   {
+    if (x->by_block) {
+      return inflate_block(*x);
+    }
+
     auto ret = ::lzma_code(x.get(), LZMA_RUN);
     if (ret == LZMA_OK) {
       return status_type::CAN_CONTINUE;
@@ -162,10 +252,67 @@ struct lzma_tag_t {
     }
   }
 
+  // Decode the blocks that follow a checkpoint, until the index at the end of the stream
+  static status_type inflate_block(inflate_state& x)
+  {
+    while (!x.in_block && !x.ended && x.avail_in > 0) {
+      if (x.header_filled == 0) {
+        constexpr uint8_t index_indicator = 0x00;
+        if (*x.next_in == index_indicator) {
+          x.ended = true;
+          break;
+        }
+        x.block.header_size = lzma_block_header_size_decode(*x.next_in);
+      }
+
+      auto count = std::min(static_cast<uint32_t>(std::min<std::size_t>(x.avail_in, LZMA_BLOCK_HEADER_SIZE_MAX)), x.block.header_size - x.header_filled);
+      std::copy_n(x.next_in, count, std::next(std::begin(x.header), x.header_filled));
+      x.next_in = std::next(x.next_in, count);
+      x.avail_in -= count;
+      x.header_filled += count;
+
+      if (x.header_filled == x.block.header_size) {
+        x.header_filled = 0;
+        x.free_filters();
+        x.block.version = 1;
+        x.block.check = x.check;
+        x.block.filters = std::data(x.filters);
+        if (::lzma_block_header_decode(&x.block, nullptr, std::data(x.header)) != LZMA_OK || ::lzma_block_decoder(&x, &x.block) != LZMA_OK) {
+          return status_type::ERROR;
+        }
+        x.in_block = true;
+      }
+    }
+
+    if (x.ended) {
+      x.avail_in = 0; // The index and the stream footer are not decompressed
+      return status_type::END;
+    }
+    if (!x.in_block) {
+      return status_type::CAN_CONTINUE;
+    }
+
+    auto ret = ::lzma_code(&x, LZMA_RUN);
+    if (ret == LZMA_STREAM_END) {
+      x.in_block = false;
+      return status_type::CAN_CONTINUE;
+    }
+    return (ret == LZMA_OK) ? status_type::CAN_CONTINUE : status_type::ERROR;
+  }
+
   static deflate_state_type new_deflate_state()
   {
     deflate_state_type state{new state_type};
     *state = LZMA_STREAM_INIT;
+    if (compression_threads != 1) {
+      lzma_mt options{};
+      options.threads = detail::thread_count(compression_threads);
+      options.preset = LZMA_PRESET_DEFAULT;
+      options.check = LZMA_CHECK_CRC64;
+      auto ret = ::lzma_stream_encoder_mt(state.get(), &options);
+      assert(ret == LZMA_OK);
+      return state;
+    }
     auto ret = ::lzma_easy_encoder(state.get(), LZMA_PRESET_DEFAULT, LZMA_CHECK_CRC64);
     assert(ret == LZMA_OK);
     return state;
@@ -173,15 +320,284 @@ struct lzma_tag_t {
 
   static inflate_state_type new_inflate_state()
   {
-    inflate_state_type state{new state_type};
-    *state = LZMA_STREAM_INIT;
+    auto state = std::make_unique<inflate_state>();
+#if LZMA_VERSION >= 50040002 // The multithreaded decoder is available from liblzma 5.4.0
+    if (lzma_decoder_threads != 1) {
+      lzma_mt options{};
+      options.flags = flags;
+      options.threads = detail::thread_count(lzma_decoder_threads);
+
+      // Limit the memory of the decoding threads as the xz utility does. If the limit would be exceeded, the decoder uses fewer threads.
+      auto physical_memory = ::lzma_physmem();
+      options.memlimit_threading = (physical_memory == 0) ? std::numeric_limits<uint64_t>::max() : physical_memory / 4;
+      options.memlimit_stop = std::numeric_limits<uint64_t>::max();
+
+      auto ret = ::lzma_stream_decoder_mt(state.get(), &options);
+      assert(ret == LZMA_OK);
+      return state;
+    }
+#endif
     auto ret = ::lzma_stream_decoder(state.get(), std::numeric_limits<uint64_t>::max(), flags);
     assert(ret == LZMA_OK);
     return state;
   }
+
+  /**
+   * Begin decompressing at a checkpoint, which is the beginning of a block. The blocks are decoded on one thread.
+   */
+  template <typename IStrm>
+  static inflate_state_type resume_inflate_state(const inflate_checkpoint& /*point*/, IStrm& file)
+  {
+    // The type of the check that ends each block is given in the stream header
+    std::array<char, LZMA_STREAM_HEADER_SIZE> header_bytes{};
+    file.seekg(0);
+    file.read(std::data(header_bytes), std::size(header_bytes));
+    lzma_stream_flags stream_flags{};
+    auto ret = ::lzma_stream_header_decode(&stream_flags, reinterpret_cast<const uint8_t*>(std::data(header_bytes)));
+    assert(ret == LZMA_OK);
+
+    auto state = std::make_unique<inflate_state>();
+    state->by_block = true;
+    state->check = stream_flags.check;
+    return state;
+  }
+};
+
+/**
+ * Zstandard streams are written in the seekable format: a sequence of independent frames, followed by a table of their sizes.
+ * A reader can use the table to begin decompressing at any frame. Streams without a table, and streams of several frames, can also be read.
+ *
+ * https://github.com/facebook/zstd/blob/dev/contrib/seekable_format/zstd_seekable_compression_format.md
+ */
+template <int compression = ZSTD_CLEVEL_DEFAULT, uint32_t max_frame_size = (1u << 22)>
+struct zstd_tag_t {
+  using in_char_type = uint8_t;
+  using out_char_type = uint8_t;
+  using status_type = status_t;
+
+  struct state_type {
+    const in_char_type* next_in = nullptr;
+    std::size_t avail_in = 0;
+    out_char_type* next_out = nullptr;
+    std::size_t avail_out = 0;
+    uint64_t total_out = 0;
+  };
+
+  struct inflate_state : state_type {
+    std::unique_ptr<ZSTD_DCtx, detail::free_deleter<ZSTD_DCtx, std::size_t, ::ZSTD_freeDCtx>> ctx{::ZSTD_createDCtx()};
+  };
+
+  struct deflate_state : state_type {
+    std::unique_ptr<ZSTD_CCtx, detail::free_deleter<ZSTD_CCtx, std::size_t, ::ZSTD_freeCCtx>> ctx{::ZSTD_createCCtx()};
+    uint32_t frame_in = 0;  // The bytes given to the current frame
+    uint32_t frame_out = 0; // The bytes written for the current frame
+    bool ending_frame = false;
+    std::vector<std::pair<uint32_t, uint32_t>> frames{}; // The compressed and decompressed sizes of each finished frame
+    std::vector<out_char_type> seek_table{};
+    std::size_t seek_table_written = 0;
+  };
+
+  using deflate_state_type = std::unique_ptr<deflate_state>;
+  using inflate_state_type = std::unique_ptr<inflate_state>;
+
+  constexpr static uint32_t skippable_magic = 0x184D2A5E;
+  constexpr static uint32_t seekable_magic = 0x8F92EAB1;
+
+  template <typename State>
+  static void advance(State& x, const ZSTD_inBuffer& in, const ZSTD_outBuffer& out)
+  {
+    x->next_in = std::next(x->next_in, static_cast<std::ptrdiff_t>(in.pos));
+    x->avail_in -= in.pos;
+    x->next_out = std::next(x->next_out, static_cast<std::ptrdiff_t>(out.pos));
+    x->avail_out -= out.pos;
+    x->total_out += out.pos;
+  }
+
+  static void append_le32(std::vector<out_char_type>& buf, uint32_t value)
+  {
+    for (unsigned i = 0; i < 4; ++i) {
+      buf.push_back(static_cast<out_char_type>(value >> (8 * i)));
+    }
+  }
+
+  static std::vector<out_char_type> make_seek_table(const std::vector<std::pair<uint32_t, uint32_t>>& frames)
+  {
+    constexpr uint32_t entry_size = 8;
+    constexpr uint32_t footer_size = 9;
+    std::vector<out_char_type> retval;
+    append_le32(retval, skippable_magic);
+    append_le32(retval, static_cast<uint32_t>(std::size(frames)) * entry_size + footer_size);
+    for (auto [compressed, decompressed] : frames) {
+      append_le32(retval, compressed);
+      append_le32(retval, decompressed);
+    }
+    append_le32(retval, static_cast<uint32_t>(std::size(frames)));
+    retval.push_back(0); // No checksums
+    append_le32(retval, seekable_magic);
+    return retval;
+  }
+
+  static status_type deflate(deflate_state_type& x, bool finish)
+  {
+    // Finish the current frame if it is full, or if the stream is finishing
+    if (x->ending_frame || x->frame_in == max_frame_size || (finish && x->frame_in > 0)) {
+      ZSTD_inBuffer in{nullptr, 0, 0};
+      ZSTD_outBuffer out{x->next_out, x->avail_out, 0};
+      auto remaining = ::ZSTD_compressStream2(x->ctx.get(), &out, &in, ZSTD_e_end);
+      if (::ZSTD_isError(remaining)) {
+        return status_type::ERROR;
+      }
+      advance(x, in, out);
+      x->frame_out += static_cast<uint32_t>(out.pos);
+      x->ending_frame = (remaining != 0);
+      if (!x->ending_frame) {
+        x->frames.emplace_back(x->frame_out, x->frame_in);
+        x->frame_in = 0;
+        x->frame_out = 0;
+      }
+      return status_type::CAN_CONTINUE;
+    }
+
+    if (!finish) {
+      auto frame_space = static_cast<std::size_t>(max_frame_size - x->frame_in);
+      ZSTD_inBuffer in{x->next_in, std::min(x->avail_in, frame_space), 0};
+      ZSTD_outBuffer out{x->next_out, x->avail_out, 0};
+      auto ret = ::ZSTD_compressStream2(x->ctx.get(), &out, &in, ZSTD_e_continue);
+      if (::ZSTD_isError(ret)) {
+        return status_type::ERROR;
+      }
+      advance(x, in, out);
+      x->frame_in += static_cast<uint32_t>(in.pos);
+      x->frame_out += static_cast<uint32_t>(out.pos);
+      return status_type::CAN_CONTINUE;
+    }
+
+    // Every frame is finished, so write the seek table
+    if (std::empty(x->seek_table)) {
+      x->seek_table = make_seek_table(x->frames);
+    }
+    auto count = std::min(x->avail_out, std::size(x->seek_table) - x->seek_table_written);
+    std::copy_n(std::next(std::cbegin(x->seek_table), static_cast<std::ptrdiff_t>(x->seek_table_written)), count, x->next_out);
+    x->seek_table_written += count;
+    ZSTD_outBuffer out{x->next_out, x->avail_out, count};
+    advance(x, ZSTD_inBuffer{nullptr, 0, 0}, out);
+    return (x->seek_table_written == std::size(x->seek_table)) ? status_type::END : status_type::CAN_CONTINUE;
+  }
+
+  static status_type inflate(inflate_state_type& x)
+  {
+    ZSTD_inBuffer in{x->next_in, x->avail_in, 0};
+    ZSTD_outBuffer out{x->next_out, x->avail_out, 0};
+    auto ret = ::ZSTD_decompressStream(x->ctx.get(), &out, &in);
+    if (::ZSTD_isError(ret)) {
+      return status_type::ERROR;
+    }
+    advance(x, in, out);
+    return (ret == 0) ? status_type::END : status_type::CAN_CONTINUE;
+  }
+
+  static deflate_state_type new_deflate_state()
+  {
+    auto state = std::make_unique<deflate_state>();
+    ::ZSTD_CCtx_setParameter(state->ctx.get(), ZSTD_c_compressionLevel, compression);
+    ::ZSTD_CCtx_setParameter(state->ctx.get(), ZSTD_c_checksumFlag, 1);
+    if (compression_threads != 1) {
+      // This has no effect if the library was built without support for threads
+      ::ZSTD_CCtx_setParameter(state->ctx.get(), ZSTD_c_nbWorkers, static_cast<int>(detail::thread_count(compression_threads)));
+    }
+    return state;
+  }
+
+  static inflate_state_type new_inflate_state() { return std::make_unique<inflate_state>(); }
+
+  /**
+   * Begin decompressing at a checkpoint, which is the beginning of a frame.
+   */
+  template <typename IStrm>
+  static inflate_state_type resume_inflate_state(const inflate_checkpoint& /*point*/, IStrm& /*file*/)
+  {
+    return new_inflate_state();
+  }
 };
 } // namespace decomp_tags
 
+/**
+ * The frames of a Zstandard stream that was written in the seekable format.
+ * Each frame can be decompressed independently, so a reader can begin at any frame by seeking to its compressed offset.
+ */
+struct zstd_seek_table {
+  struct frame {
+    uint64_t compressed_offset = 0;
+    uint64_t decompressed_offset = 0;
+    uint32_t compressed_size = 0;
+    uint32_t decompressed_size = 0;
+  };
+
+  std::vector<frame> frames{};
+
+  /**
+   * Read the seek table from the end of a stream. The position of the stream is not restored.
+   *
+   * :returns: The table, or std::nullopt if the stream does not end with a seek table.
+   */
+  static std::optional<zstd_seek_table> read(std::istream& in)
+  {
+    constexpr std::streamoff footer_size = 9;
+    constexpr std::streamoff header_size = 8;
+    constexpr uint8_t checksum_flag = 0x80;
+
+    auto read_le32 = [](const uint8_t* bytes) {
+      return uint32_t{bytes[0]} | (uint32_t{bytes[1]} << 8) | (uint32_t{bytes[2]} << 16) | (uint32_t{bytes[3]} << 24);
+    };
+
+    std::array<uint8_t, footer_size> footer{};
+    in.seekg(-footer_size, std::ios::end);
+    in.read(reinterpret_cast<char*>(std::data(footer)), footer_size);
+    if (!in || read_le32(std::next(std::data(footer), 5)) != decomp_tags::zstd_tag_t<>::seekable_magic) {
+      return std::nullopt;
+    }
+
+    auto num_frames = read_le32(std::data(footer));
+    std::streamoff entry_size = (footer[4] & checksum_flag) ? 12 : 8;
+    auto table_size = static_cast<std::streamoff>(num_frames) * entry_size + footer_size;
+
+    std::vector<uint8_t> table(static_cast<std::size_t>(table_size + header_size));
+    in.seekg(-(table_size + header_size), std::ios::end);
+    in.read(reinterpret_cast<char*>(std::data(table)), static_cast<std::streamsize>(std::size(table)));
+    if (!in || read_le32(std::data(table)) != decomp_tags::zstd_tag_t<>::skippable_magic
+        || read_le32(std::next(std::data(table), 4)) != static_cast<uint32_t>(table_size)) {
+      return std::nullopt;
+    }
+
+    zstd_seek_table retval;
+    frame next_frame{};
+    for (uint32_t i = 0; i < num_frames; ++i) {
+      auto entry = std::next(std::data(table), header_size + i * entry_size);
+      next_frame.compressed_size = read_le32(entry);
+      next_frame.decompressed_size = read_le32(std::next(entry, 4));
+      retval.frames.push_back(next_frame);
+      next_frame.compressed_offset += next_frame.compressed_size;
+      next_frame.decompressed_offset += next_frame.decompressed_size;
+    }
+    return retval;
+  }
+
+  /**
+   * The frame that holds the given offset into the decompressed stream.
+   *
+   * :returns: The frame, or std::nullopt if the offset is past the end of the stream.
+   */
+  [[nodiscard]] std::optional<frame> locate(uint64_t decompressed_offset) const
+  {
+    auto found = std::upper_bound(std::begin(frames), std::end(frames), decompressed_offset,
+                                  [](uint64_t offset, const frame& f) { return offset < f.decompressed_offset + f.decompressed_size; });
+    if (found == std::end(frames)) {
+      return std::nullopt;
+    }
+    return *found;
+  }
+};
+
 template <typename Tag, typename StreamType = std::ifstream>
 struct inf_istream {
   template <typename IStrm>
@@ -204,6 +620,7 @@ struct inf_istream {
   public:
     explicit inf_streambuf(IStrm* in) : src(in) {}
     explicit inf_streambuf(Tag /*tag*/, IStrm* in) : inf_streambuf(in) {}
+    inf_streambuf(IStrm* in, typename Tag::inflate_state_type state) : strm(std::move(state)), src(in) {}
 
     [[nodiscard]] std::size_t bytes_read() const { return strm->total_out - (this->egptr() - this->gptr()); }
 
@@ -228,10 +645,108 @@ struct inf_istream {
   [[nodiscard]] bool eof() const { return eof_; }
   [[nodiscard]] std::streamsize gcount() const { return gcount_; }
 
+  /**
+   * Begin decompressing again at a checkpoint, and discard the decompressed data before the given offset.
+   * This is only available for the compression formats that can resume at a checkpoint.
+   */
+  template <typename U = Tag, typename = decltype(U::resume_inflate_state(std::declval<const inflate_checkpoint&>(), std::declval<StreamType&>()))>
+  void seek(const inflate_checkpoint& point, uint64_t decompressed_offset)
+  {
+    underlying->clear();
+    auto state = Tag::resume_inflate_state(point, *underlying);
+    underlying->clear();
+    underlying->seekg(static_cast<std::streamoff>(point.compressed_offset));
+    buffer = std::make_unique<inf_streambuf<StreamType>>(underlying.get(), std::move(state));
+
+    std::istream inflated{buffer.get()};
+    inflated.ignore(static_cast<std::streamsize>(decompressed_offset - point.decompressed_offset));
+    gcount_ = 0;
+    eof_ = inflated.eof();
+  }
+
   explicit inf_istream(std::string s) : underlying(std::make_unique<StreamType>(s)) {}
   explicit inf_istream(StreamType&& str) : underlying(std::make_unique<StreamType>(std::move(str))) {}
 };
 
+template <typename Tag, typename StreamType = std::ofstream>
+struct inf_ostream {
+  constexpr static std::size_t CHUNK = (1 << 16);
+
+  std::unique_ptr<StreamType> underlying;
+  typename Tag::deflate_state_type strm = Tag::new_deflate_state();
+  bool finished = false;
+
+  inf_ostream& write(const char* s, std::streamsize count)
+  {
+    assert(!finished);
+    std::array<typename Tag::in_char_type, CHUNK> in_buf;
+    while (count > 0) {
+      auto chunk_size = std::min(static_cast<std::size_t>(count), std::size(in_buf));
+      std::memcpy(std::data(in_buf), s, chunk_size);
+      strm->next_in = std::data(in_buf);
+      strm->avail_in = static_cast<decltype(strm->avail_in)>(chunk_size);
+      while (strm->avail_in > 0) {
+        [[maybe_unused]] auto result = deflate_chunk(false);
+        assert(result == Tag::status_type::CAN_CONTINUE);
+      }
+
+      s = std::next(s, static_cast<std::ptrdiff_t>(chunk_size));
+      count -= static_cast<std::streamsize>(chunk_size);
+    }
+    return *this;
+  }
+
+  /**
+   * Compress any remaining data and end the compressed stream. Nothing more may be written.
+   */
+  void close()
+  {
+    if (underlying != nullptr && !finished) {
+      auto result = Tag::status_type::CAN_CONTINUE;
+      while (result == Tag::status_type::CAN_CONTINUE) {
+        result = deflate_chunk(true);
+      }
+      assert(result == Tag::status_type::END);
+      underlying->flush();
+      finished = true;
+    }
+  }
+
+  [[nodiscard]] bool good() const { return underlying != nullptr && underlying->good(); }
+
+  explicit inf_ostream(std::string s) : underlying(std::make_unique<StreamType>(s, std::ios::binary)) {}
+  explicit inf_ostream(StreamType&& str) : underlying(std::make_unique<StreamType>(std::move(str))) {}
+
+  inf_ostream(const inf_ostream&) = delete;
+  inf_ostream(inf_ostream&&) noexcept = default;
+  inf_ostream& operator=(const inf_ostream&) = delete;
+  inf_ostream& operator=(inf_ostream&& other) noexcept
+  {
+    close();
+    underlying = std::move(other.underlying);
+    strm = std::move(other.strm);
+    finished = other.finished;
+    return *this;
+  }
+
+  ~inf_ostream() { close(); }
+
+private:
+  typename Tag::status_type deflate_chunk(bool finish)
+  {
+    std::array<typename Tag::out_char_type, CHUNK> out_buf;
+    strm->next_out = std::data(out_buf);
+    strm->avail_out = static_cast<decltype(strm->avail_out)>(std::size(out_buf));
+    auto result = Tag::deflate(strm, finish);
+
+    std::array<char, CHUNK> sig_out_buf;
+    auto bytes_written = std::size(out_buf) - strm->avail_out;
+    std::memcpy(std::data(sig_out_buf), std::data(out_buf), bytes_written);
+    underlying->write(std::data(sig_out_buf), static_cast<std::streamsize>(bytes_written));
+    return result;
+  }
+};
+
 template <typename T, typename S>
 template <typename I>
 auto inf_istream<T, S>::inf_streambuf<I>::underflow() -> int_type
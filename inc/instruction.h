@@ -20,15 +20,22 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <string_view>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "address.h"
 #include "champsim.h"
 #include "chrono.h"
 #include "trace_instruction.h"
+#include "util/inplace_vector.h"
 
 // branch types
 enum branch_type {
@@ -91,46 +98,244 @@ struct program_ordered {
    * Return a functor that tests whether an instruction precededes the given instruction.
    */
   static auto precedes(const T& instr) { return precedes(instr.instr_id); }
+
+  /**
+   * Find the element with the given ID in a random-access range that is in program order.
+   * Each trace numbers its instructions consecutively, so the IDs in a core's ROB and fetch buffer are consecutive,
+   * and the element is found in constant time by its offset from the first. Other ranges are searched.
+   */
+  template <typename It>
+  static It find_id(It begin, It end, id_type id)
+  {
+    if (begin == end) {
+      return end;
+    }
+    if (auto offset = id - begin->instr_id; id >= begin->instr_id && offset < static_cast<id_type>(std::distance(begin, end))) {
+      if (auto candidate = std::next(begin, static_cast<typename std::iterator_traits<It>::difference_type>(offset)); candidate->instr_id == id) {
+        return candidate;
+      }
+    }
+    return std::find_if(begin, end, matches_id(id));
+  }
+};
+
+/**
+ * The memory operands of an instruction, up to a fixed number.
+ * The addresses are stored as raw integers, which take half the space of a champsim::address, and are read back as champsim::address.
+ */
+template <std::size_t N>
+class memory_operands
+{
+  using storage_type = inplace_vector<uint64_t, N>;
+  storage_type storage{};
+
+public:
+  class const_iterator
+  {
+    typename storage_type::const_iterator it{};
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = champsim::address;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = champsim::address;
+
+    const_iterator() = default;
+    explicit const_iterator(typename storage_type::const_iterator it_) : it(it_) {}
+
+    reference operator*() const { return champsim::address{*it}; }
+    const_iterator& operator++()
+    {
+      ++it;
+      return *this;
+    }
+    const_iterator operator++(int)
+    {
+      auto retval = *this;
+      ++it;
+      return retval;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) { return lhs.it == rhs.it; }
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) { return !(lhs == rhs); }
+  };
+
+  using value_type = champsim::address;
+  using size_type = std::size_t;
+  using iterator = const_iterator;
+
+  [[nodiscard]] const_iterator begin() const { return const_iterator{std::begin(storage)}; }
+  [[nodiscard]] const_iterator end() const { return const_iterator{std::end(storage)}; }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+
+  [[nodiscard]] size_type size() const { return std::size(storage); }
+  [[nodiscard]] bool empty() const { return std::empty(storage); }
+  [[nodiscard]] static constexpr size_type capacity() { return N; }
+
+  [[nodiscard]] champsim::address operator[](size_type pos) const { return champsim::address{storage[pos]}; }
+  [[nodiscard]] champsim::address front() const { return champsim::address{storage.front()}; }
+  [[nodiscard]] champsim::address back() const { return champsim::address{storage.back()}; }
+
+  void push_back(champsim::address value) { storage.push_back(value.to<uint64_t>()); }
+  void clear() { storage.clear(); }
+
+  friend bool operator==(const memory_operands& lhs, const memory_operands& rhs) { return lhs.storage == rhs.storage; }
+  friend bool operator!=(const memory_operands& lhs, const memory_operands& rhs) { return !(lhs == rhs); }
 };
 } // namespace champsim
 
-struct ooo_model_instr : champsim::program_ordered<ooo_model_instr> {
-  champsim::address ip{};
-  champsim::chrono::clock::time_point ready_time{};
+namespace champsim::detail
+{
+/**
+ * The registers of a trace record, packed into one vector: the destinations in the low eight bytes and the sources in the high eight bytes.
+ * Each mask has a bit for each byte of the vector.
+ */
+struct register_masks {
+  uint16_t present = 0;
+  uint16_t stack_pointer = 0;
+  uint16_t flags = 0;
+  uint16_t instruction_pointer = 0;
+};
 
-  bool is_branch = false;
-  bool branch_taken = false;
-  bool branch_prediction = false;
-  bool branch_mispredicted = false; // A branch can be mispredicted even if the direction prediction is correct when the predicted target is not correct
+constexpr unsigned register_lane_width = 8;
 
-  std::array<uint8_t, 2> asid = {std::numeric_limits<uint8_t>::max(), std::numeric_limits<uint8_t>::max()};
+template <typename T>
+register_masks mask_registers(const T& instr)
+{
+  static_assert(sizeof(T::destination_registers) <= register_lane_width);
+  static_assert(sizeof(T::source_registers) <= register_lane_width);
 
-  branch_type branch{NOT_BRANCH};
-  champsim::address branch_target{};
+  std::array<uint8_t, 2 * register_lane_width> lane{};
+  std::memcpy(std::data(lane), std::data(instr.destination_registers), sizeof(T::destination_registers));
+  std::memcpy(std::next(std::data(lane), register_lane_width), std::data(instr.source_registers), sizeof(T::source_registers));
+
+#if defined(__SSE2__)
+  auto regs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(std::data(lane)));
+  auto matches = [regs](char reg) {
+    return static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(regs, _mm_set1_epi8(reg))));
+  };
+  return {static_cast<uint16_t>(~matches(0)), matches(champsim::REG_STACK_POINTER), matches(champsim::REG_FLAGS),
+          matches(champsim::REG_INSTRUCTION_POINTER)};
+#else
+  register_masks retval;
+  for (unsigned i = 0; i < std::size(lane); ++i) {
+    auto bit = static_cast<uint16_t>(1u << i);
+    retval.present |= (lane[i] != 0) ? bit : 0;
+    retval.stack_pointer |= (lane[i] == champsim::REG_STACK_POINTER) ? bit : 0;
+    retval.flags |= (lane[i] == champsim::REG_FLAGS) ? bit : 0;
+    retval.instruction_pointer |= (lane[i] == champsim::REG_INSTRUCTION_POINTER) ? bit : 0;
+  }
+  return retval;
+#endif
+}
 
-  bool dib_checked = false;
-  bool fetch_issued = false;
-  bool fetch_completed = false;
-  bool decoded = false;
-  bool scheduled = false;
-  bool executed = false;
-  bool completed = false;
+// The uses of the special registers that determine the kind of branch, as an index into branch_classes
+enum register_use : unsigned { READS_SP = 1, READS_FLAGS = 2, READS_IP = 4, READS_OTHER = 8, WRITES_SP = 16, WRITES_IP = 32 };
+
+inline unsigned register_uses(register_masks masks)
+{
+  constexpr unsigned sources = 0xff00;
+  constexpr unsigned destinations = 0x00ff;
+  auto other = masks.present & ~(masks.stack_pointer | masks.flags | masks.instruction_pointer);
+  return ((masks.stack_pointer & sources) ? READS_SP : 0u) | ((masks.flags & sources) ? READS_FLAGS : 0u)
+         | ((masks.instruction_pointer & sources) ? READS_IP : 0u) | ((other & sources) ? READS_OTHER : 0u)
+         | ((masks.stack_pointer & destinations) ? WRITES_SP : 0u) | ((masks.instruction_pointer & destinations) ? WRITES_IP : 0u);
+}
+
+enum class branch_direction { not_taken, taken, from_trace };
+
+struct branch_class {
+  branch_type branch = NOT_BRANCH;
+  branch_direction direction = branch_direction::not_taken;
+};
+
+constexpr branch_class classify_branch(unsigned uses)
+{
+  bool reads_sp = uses & READS_SP;
+  bool reads_flags = uses & READS_FLAGS;
+  bool reads_ip = uses & READS_IP;
+  bool reads_other = uses & READS_OTHER;
+  bool writes_sp = uses & WRITES_SP;
+  bool writes_ip = uses & WRITES_IP;
+
+  if (!reads_sp && !reads_flags && writes_ip && !reads_other) {
+    return {BRANCH_DIRECT_JUMP, branch_direction::taken};
+  }
+  if (!reads_sp && !reads_ip && !reads_flags && writes_ip && reads_other) {
+    return {BRANCH_INDIRECT, branch_direction::taken};
+  }
+  if (!reads_sp && reads_ip && !writes_sp && writes_ip && (reads_flags || reads_other)) {
+    return {BRANCH_CONDITIONAL, branch_direction::from_trace};
+  }
+  if (reads_sp && reads_ip && writes_sp && writes_ip && !reads_flags && !reads_other) {
+    return {BRANCH_DIRECT_CALL, branch_direction::taken};
+  }
+  if (reads_sp && reads_ip && writes_sp && writes_ip && !reads_flags && reads_other) {
+    return {BRANCH_INDIRECT_CALL, branch_direction::taken};
+  }
+  if (reads_sp && !reads_ip && writes_sp && writes_ip) {
+    return {BRANCH_RETURN, branch_direction::taken};
+  }
+  if (writes_ip) {
+    return {BRANCH_OTHER, branch_direction::from_trace};
+  }
+  return {NOT_BRANCH, branch_direction::not_taken};
+}
+
+// The kind of branch for each combination of register uses, in the same order of precedence as the ooo_model_instr constructor
+inline constexpr auto branch_classes = [] {
+  std::array<branch_class, 2 * WRITES_IP> retval{};
+  for (unsigned uses = 0; uses < std::size(retval); ++uses) {
+    retval[uses] = classify_branch(uses);
+  }
+  return retval;
+}();
+} // namespace champsim::detail
+
+struct ooo_model_instr : champsim::program_ordered<ooo_model_instr> {
+  champsim::address ip{};
+  champsim::chrono::clock::time_point ready_time{};
+  champsim::address branch_target{};
 
   unsigned completed_mem_ops = 0;
   int num_reg_dependent = 0;
 
-  std::vector<PHYSICAL_REGISTER_ID> destination_registers = {}; // output registers
-  std::vector<PHYSICAL_REGISTER_ID> source_registers = {};      // input registers
+  branch_type branch{NOT_BRANCH};
+  std::array<uint8_t, 2> asid = {std::numeric_limits<uint8_t>::max(), std::numeric_limits<uint8_t>::max()};
+
+  // The flags are packed into bits, so that the buffers of the pipeline hold more instructions in each cache line
+  bool is_branch : 1;
+  bool branch_taken : 1;
+  bool branch_prediction : 1;
+  bool branch_mispredicted : 1; // A branch can be mispredicted even if the direction prediction is correct when the predicted target is not correct
+
+  bool dib_checked : 1;
+  bool fetch_issued : 1;
+  bool fetch_completed : 1;
+  bool decoded : 1;
+  bool scheduled : 1;
+  bool executed : 1;
+  bool completed : 1;
 
-  std::vector<champsim::address> destination_memory = {};
-  std::vector<champsim::address> source_memory = {};
+  // The operands are stored in place, with room for as many as either trace format holds
+  champsim::inplace_vector<PHYSICAL_REGISTER_ID, std::max(NUM_INSTR_DESTINATIONS, NUM_INSTR_DESTINATIONS_SPARC)> destination_registers = {}; // output registers
+  champsim::inplace_vector<PHYSICAL_REGISTER_ID, NUM_INSTR_SOURCES> source_registers = {};                                                   // input registers
 
-  // these are indices of instructions in the ROB that depend on me
-  std::vector<std::reference_wrapper<ooo_model_instr>> registers_instrs_depend_on_me;
+  champsim::memory_operands<std::max(NUM_INSTR_DESTINATIONS, NUM_INSTR_DESTINATIONS_SPARC)> destination_memory = {};
+  champsim::memory_operands<NUM_INSTR_SOURCES> source_memory = {};
 
 private:
+  // Bit-fields cannot have default member initializers until C++20, so every constructor delegates to this one
+  ooo_model_instr(champsim::address local_ip, bool local_is_branch, bool local_branch_taken, std::array<uint8_t, 2> local_asid)
+      : ip(local_ip), asid(local_asid), is_branch(local_is_branch), branch_taken(local_branch_taken), branch_prediction(false), branch_mispredicted(false),
+        dib_checked(false), fetch_issued(false), fetch_completed(false), decoded(false), scheduled(false), executed(false), completed(false)
+  {
+  }
+
   template <typename T>
-  ooo_model_instr(T instr, std::array<uint8_t, 2> local_asid) : ip(instr.ip), is_branch(instr.is_branch), branch_taken(instr.branch_taken), asid(local_asid)
+  ooo_model_instr(T instr, std::array<uint8_t, 2> local_asid) : ooo_model_instr(champsim::address{instr.ip}, instr.is_branch, instr.branch_taken, local_asid)
   {
     std::remove_copy(std::begin(instr.destination_registers), std::end(instr.destination_registers), std::back_inserter(this->destination_registers), 0);
     std::remove_copy(std::begin(instr.source_registers), std::end(instr.source_registers), std::back_inserter(this->source_registers), 0);
@@ -191,9 +396,67 @@ private:
     }
   }
 
+  // Construct from a record whose registers have already been found, without searching them again
+  template <typename T>
+  ooo_model_instr(const T& instr, std::array<uint8_t, 2> local_asid, champsim::detail::register_masks masks)
+      : ooo_model_instr(champsim::address{instr.ip}, instr.is_branch, false, local_asid)
+  {
+    constexpr auto num_dreg = sizeof(T::destination_registers);
+    constexpr auto num_sreg = sizeof(T::source_registers);
+    for (unsigned i = 0; i < num_dreg; ++i) {
+      if (masks.present & (1u << i)) {
+        destination_registers.push_back(instr.destination_registers[i]);
+      }
+    }
+    for (unsigned i = 0; i < num_sreg; ++i) {
+      if (masks.present & (1u << (champsim::detail::register_lane_width + i))) {
+        source_registers.push_back(instr.source_registers[i]);
+      }
+    }
+
+    auto copy_nonzero = [](const auto& from, auto& to) {
+      for (auto x : from) {
+        if (x != 0) {
+          to.push_back(champsim::address{x});
+        }
+      }
+    };
+    copy_nonzero(instr.destination_memory, destination_memory);
+    copy_nonzero(instr.source_memory, source_memory);
+
+    auto kind = champsim::detail::branch_classes[champsim::detail::register_uses(masks)];
+    branch = kind.branch;
+    is_branch = is_branch || (kind.branch != NOT_BRANCH);
+    branch_taken = (kind.direction == champsim::detail::branch_direction::taken)
+                   || (kind.direction == champsim::detail::branch_direction::from_trace && instr.branch_taken);
+  }
+
+  static std::array<uint8_t, 2> local_asid(uint8_t cpu, const input_instr& /*instr*/) { return {cpu, cpu}; }
+  static std::array<uint8_t, 2> local_asid(uint8_t /*cpu*/, const cloudsuite_instr& instr) { return {instr.asid[0], instr.asid[1]}; }
+
 public:
-  ooo_model_instr(uint8_t cpu, input_instr instr) : ooo_model_instr(instr, {cpu, cpu}) {}
-  ooo_model_instr(uint8_t /*cpu*/, cloudsuite_instr instr) : ooo_model_instr(instr, {instr.asid[0], instr.asid[1]}) {}
+  ooo_model_instr(uint8_t cpu, input_instr instr) : ooo_model_instr(instr, local_asid(cpu, instr)) {}
+  ooo_model_instr(uint8_t cpu, cloudsuite_instr instr) : ooo_model_instr(instr, local_asid(cpu, instr)) {}
+
+  /**
+   * Inflate a trace record into a core model instruction, as if it were constructed from the record.
+   * The registers of the record are compared against the special registers together, and the kind of branch is looked up in a table.
+   */
+  template <typename T>
+  static ooo_model_instr inflate(uint8_t cpu, const T& instr)
+  {
+    return ooo_model_instr{instr, local_asid(cpu, instr), champsim::detail::mask_registers(instr)};
+  }
+
+  /**
+   * Inflate a buffer of trace records into core model instructions.
+   * \overload
+   */
+  template <typename It, typename OutputIt>
+  static OutputIt inflate(uint8_t cpu, It begin, It end, OutputIt out)
+  {
+    return std::transform(begin, end, out, [cpu](const auto& instr) { return inflate(cpu, instr); });
+  }
 
   [[nodiscard]] std::size_t num_mem_ops() const { return std::size(destination_memory) + std::size(source_memory); }
 };
@@ -0,0 +1,58 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KNOB_H
+#define KNOB_H
+
+#include <string>
+#include <string_view>
+
+namespace champsim
+{
+/**
+ * A parameter of a module that can be changed after the simulator is built, for example to sweep it across processes that share a warmup.
+ * Each knob is registered under a name, such as "ip_stride.degree", and setting that name changes every knob that shares it.
+ * Knobs are not saved in checkpoints, since they are part of the configuration.
+ */
+class knob
+{
+  std::string name_;
+  long value_;
+
+public:
+  knob(std::string name, long default_value);
+  knob(const knob& other);
+  knob& operator=(const knob& other);
+  ~knob();
+
+  [[nodiscard]] const std::string& name() const { return name_; }
+  [[nodiscard]] long value() const { return value_; }
+
+  /**
+   * Set every knob with the given name.
+   *
+   * :returns: The number of knobs that were changed.
+   */
+  static std::size_t set(std::string_view name, long value);
+
+  /**
+   * Whether any knob is registered under the given name.
+   */
+  static bool is_registered(std::string_view name);
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MMAP_FILE_H
+#define MMAP_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace champsim
+{
+/**
+ * A read-only mapping of a whole file into memory.
+ *
+ * The mapping is shared, so processes that map the same file share its pages in the page cache.
+ * The kernel is advised that the file will be read sequentially, and that it may be backed with huge pages.
+ */
+class mmap_file
+{
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+
+public:
+  /**
+   * Map the named file. If the file cannot be opened or mapped, or is not a regular file, a std::system_error is thrown.
+   */
+  explicit mmap_file(const std::string& fname);
+
+  mmap_file(const mmap_file&) = delete;
+  mmap_file& operator=(const mmap_file&) = delete;
+  mmap_file(mmap_file&& other) noexcept;
+  mmap_file& operator=(mmap_file&& other) noexcept;
+  ~mmap_file();
+
+  [[nodiscard]] const char* data() const { return data_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  /**
+   * Whether the named file can be mapped. Only regular files can be. Pipes, FIFOs, and devices have no size to map, and must be read as streams.
+   */
+  static bool can_map(const std::string& fname);
+};
+} // namespace champsim
+
+#endif
@@ -61,6 +61,16 @@ struct branch_predictor : public bound_to<O3_CPU> {
   template <typename, typename...>
   static auto predict_branch_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto checkpoint_save_member_impl(int) -> decltype(std::declval<T>().branch_checkpoint_save(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_save_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto checkpoint_load_member_impl(int) -> decltype(std::declval<T>().branch_checkpoint_load(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_load_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initialize_member_impl<T, Args...>(0))::value;
 
@@ -69,6 +79,12 @@ struct branch_predictor : public bound_to<O3_CPU> {
 
   template <typename T, typename... Args>
   constexpr static bool has_predict_branch = decltype(predict_branch_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_save = decltype(checkpoint_save_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_load = decltype(checkpoint_load_member_impl<T, Args...>(0))::value;
 };
 
 struct btb : public bound_to<O3_CPU> {
@@ -89,6 +105,16 @@ struct btb : public bound_to<O3_CPU> {
   template <typename, typename...>
   static auto predict_branch_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto checkpoint_save_member_impl(int) -> decltype(std::declval<T>().btb_checkpoint_save(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_save_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto checkpoint_load_member_impl(int) -> decltype(std::declval<T>().btb_checkpoint_load(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_load_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initialize_member_impl<T, Args...>(0))::value;
 
@@ -97,6 +123,12 @@ struct btb : public bound_to<O3_CPU> {
 
   template <typename T, typename... Args>
   constexpr static bool has_btb_prediction = decltype(predict_branch_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_save = decltype(checkpoint_save_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_load = decltype(checkpoint_load_member_impl<T, Args...>(0))::value;
 };
 
 struct prefetcher : public bound_to<CACHE> {
@@ -134,6 +166,16 @@ struct prefetcher : public bound_to<CACHE> {
   template <typename, typename...>
   static auto branch_operate_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto checkpoint_save_member_impl(int) -> decltype(std::declval<T>().prefetcher_checkpoint_save(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_save_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto checkpoint_load_member_impl(int) -> decltype(std::declval<T>().prefetcher_checkpoint_load(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_load_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initiailize_memory_impl<T, Args...>(0))::value;
 
@@ -151,6 +193,12 @@ struct prefetcher : public bound_to<CACHE> {
 
   template <typename T, typename... Args>
   constexpr static bool has_branch_operate = decltype(branch_operate_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_save = decltype(checkpoint_save_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_load = decltype(checkpoint_load_member_impl<T, Args...>(0))::value;
 };
 
 struct replacement : public bound_to<CACHE> {
@@ -181,6 +229,16 @@ struct replacement : public bound_to<CACHE> {
   template <typename, typename...>
   static auto final_stats_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto checkpoint_save_member_impl(int) -> decltype(std::declval<T>().replacement_checkpoint_save(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_save_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto checkpoint_load_member_impl(int) -> decltype(std::declval<T>().replacement_checkpoint_load(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto checkpoint_load_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initialize_member_impl<T, Args...>(0))::value;
 
@@ -195,6 +253,12 @@ struct replacement : public bound_to<CACHE> {
 
   template <typename T, typename... Args>
   constexpr static bool has_final_stats = decltype(final_stats_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_save = decltype(checkpoint_save_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_checkpoint_load = decltype(checkpoint_load_member_impl<T, Args...>(0))::value;
 };
 } // namespace champsim::modules
 
@@ -0,0 +1,311 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MSL_CHECKPOINT_H
+#define MSL_CHECKPOINT_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "util/detect.h"
+
+namespace champsim::msl
+{
+/**
+ * Write a value to a binary checkpoint stream, in a form that checkpoint_load() can read back.
+ *
+ * A type may define the member functions ``void checkpoint_save(std::ostream&) const`` and ``void checkpoint_load(std::istream&)``, which are used if present.
+ * Otherwise, trivially copyable types are copied bytewise, and the standard containers, pairs, tuples, and optionals are written element by element.
+ * Checkpoints are not portable between machines or builds.
+ */
+template <typename T>
+void checkpoint_save(std::ostream& os, const T& value);
+
+/**
+ * Read a value written by checkpoint_save(). Throws std::runtime_error if the stream ends early.
+ */
+template <typename T>
+void checkpoint_load(std::istream& is, T& value);
+
+template <typename C, typename Tr, typename A>
+void checkpoint_save(std::ostream& os, const std::basic_string<C, Tr, A>& value);
+template <typename C, typename Tr, typename A>
+void checkpoint_load(std::istream& is, std::basic_string<C, Tr, A>& value);
+template <typename A>
+void checkpoint_save(std::ostream& os, const std::vector<bool, A>& value);
+template <typename A>
+void checkpoint_load(std::istream& is, std::vector<bool, A>& value);
+template <typename T, typename A>
+void checkpoint_save(std::ostream& os, const std::vector<T, A>& value);
+template <typename T, typename A>
+void checkpoint_load(std::istream& is, std::vector<T, A>& value);
+template <typename T, typename A>
+void checkpoint_save(std::ostream& os, const std::deque<T, A>& value);
+template <typename T, typename A>
+void checkpoint_load(std::istream& is, std::deque<T, A>& value);
+template <typename T, std::size_t N>
+void checkpoint_save(std::ostream& os, const std::array<T, N>& value);
+template <typename T, std::size_t N>
+void checkpoint_load(std::istream& is, std::array<T, N>& value);
+template <typename K, typename V, typename C, typename A>
+void checkpoint_save(std::ostream& os, const std::map<K, V, C, A>& value);
+template <typename K, typename V, typename C, typename A>
+void checkpoint_load(std::istream& is, std::map<K, V, C, A>& value);
+template <typename T, typename U>
+void checkpoint_save(std::ostream& os, const std::pair<T, U>& value);
+template <typename T, typename U>
+void checkpoint_load(std::istream& is, std::pair<T, U>& value);
+template <typename... Ts>
+void checkpoint_save(std::ostream& os, const std::tuple<Ts...>& value);
+template <typename... Ts>
+void checkpoint_load(std::istream& is, std::tuple<Ts...>& value);
+template <typename T>
+void checkpoint_save(std::ostream& os, const std::optional<T>& value);
+template <typename T>
+void checkpoint_load(std::istream& is, std::optional<T>& value);
+
+namespace detail
+{
+template <typename T>
+using checkpoint_save_member_t = decltype(std::declval<const T&>().checkpoint_save(std::declval<std::ostream&>()));
+
+template <typename T>
+using checkpoint_load_member_t = decltype(std::declval<T&>().checkpoint_load(std::declval<std::istream&>()));
+
+template <typename T>
+void checkpoint_save_raw(std::ostream& os, const T& value)
+{
+  static_assert(std::is_trivially_copyable_v<T>, "This type cannot be saved to a checkpoint. Give it checkpoint_save() and checkpoint_load() members.");
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <typename T>
+void checkpoint_load_raw(std::istream& is, T& value)
+{
+  static_assert(std::is_trivially_copyable_v<T>, "This type cannot be loaded from a checkpoint. Give it checkpoint_save() and checkpoint_load() members.");
+  is.read(reinterpret_cast<char*>(&value), sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (!is) {
+    throw std::runtime_error{"Checkpoint ended unexpectedly"};
+  }
+}
+
+inline std::size_t checkpoint_load_size(std::istream& is)
+{
+  uint64_t size{};
+  checkpoint_load_raw(is, size);
+  return static_cast<std::size_t>(size);
+}
+
+template <typename R>
+void checkpoint_save_range(std::ostream& os, const R& range)
+{
+  checkpoint_save_raw(os, static_cast<uint64_t>(std::size(range)));
+  for (const auto& elem : range) {
+    checkpoint_save(os, elem);
+  }
+}
+} // namespace detail
+
+template <typename T>
+void checkpoint_save(std::ostream& os, const T& value)
+{
+  if constexpr (champsim::is_detected_v<detail::checkpoint_save_member_t, T>) {
+    value.checkpoint_save(os);
+  } else {
+    detail::checkpoint_save_raw(os, value);
+  }
+}
+
+template <typename T>
+void checkpoint_load(std::istream& is, T& value)
+{
+  if constexpr (champsim::is_detected_v<detail::checkpoint_load_member_t, T>) {
+    value.checkpoint_load(is);
+  } else {
+    detail::checkpoint_load_raw(is, value);
+  }
+}
+
+template <typename C, typename Tr, typename A>
+void checkpoint_save(std::ostream& os, const std::basic_string<C, Tr, A>& value)
+{
+  detail::checkpoint_save_raw(os, static_cast<uint64_t>(std::size(value)));
+  const auto length = static_cast<std::streamsize>(std::size(value) * sizeof(C));
+  os.write(reinterpret_cast<const char*>(std::data(value)), length); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <typename C, typename Tr, typename A>
+void checkpoint_load(std::istream& is, std::basic_string<C, Tr, A>& value)
+{
+  value.resize(detail::checkpoint_load_size(is));
+  const auto length = static_cast<std::streamsize>(std::size(value) * sizeof(C));
+  is.read(reinterpret_cast<char*>(std::data(value)), length); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (!is) {
+    throw std::runtime_error{"Checkpoint ended unexpectedly"};
+  }
+}
+
+template <typename A>
+void checkpoint_save(std::ostream& os, const std::vector<bool, A>& value)
+{
+  detail::checkpoint_save_raw(os, static_cast<uint64_t>(std::size(value)));
+  for (bool elem : value) {
+    detail::checkpoint_save_raw(os, elem);
+  }
+}
+
+template <typename A>
+void checkpoint_load(std::istream& is, std::vector<bool, A>& value)
+{
+  value.resize(detail::checkpoint_load_size(is));
+  for (auto&& elem : value) {
+    bool loaded{};
+    detail::checkpoint_load_raw(is, loaded);
+    elem = loaded;
+  }
+}
+
+template <typename T, typename A>
+void checkpoint_save(std::ostream& os, const std::vector<T, A>& value)
+{
+  detail::checkpoint_save_range(os, value);
+}
+
+template <typename T, typename A>
+void checkpoint_load(std::istream& is, std::vector<T, A>& value)
+{
+  value.resize(detail::checkpoint_load_size(is));
+  for (auto& elem : value) {
+    checkpoint_load(is, elem);
+  }
+}
+
+template <typename T, typename A>
+void checkpoint_save(std::ostream& os, const std::deque<T, A>& value)
+{
+  detail::checkpoint_save_range(os, value);
+}
+
+template <typename T, typename A>
+void checkpoint_load(std::istream& is, std::deque<T, A>& value)
+{
+  value.resize(detail::checkpoint_load_size(is));
+  for (auto& elem : value) {
+    checkpoint_load(is, elem);
+  }
+}
+
+template <typename T, std::size_t N>
+void checkpoint_save(std::ostream& os, const std::array<T, N>& value)
+{
+  for (const auto& elem : value) {
+    checkpoint_save(os, elem);
+  }
+}
+
+template <typename T, std::size_t N>
+void checkpoint_load(std::istream& is, std::array<T, N>& value)
+{
+  for (auto& elem : value) {
+    checkpoint_load(is, elem);
+  }
+}
+
+template <typename K, typename V, typename C, typename A>
+void checkpoint_save(std::ostream& os, const std::map<K, V, C, A>& value)
+{
+  detail::checkpoint_save_raw(os, static_cast<uint64_t>(std::size(value)));
+  for (const auto& [key, mapped] : value) {
+    checkpoint_save(os, key);
+    checkpoint_save(os, mapped);
+  }
+}
+
+template <typename K, typename V, typename C, typename A>
+void checkpoint_load(std::istream& is, std::map<K, V, C, A>& value)
+{
+  value.clear();
+  for (auto size = detail::checkpoint_load_size(is); size > 0; --size) {
+    K key{};
+    V mapped{};
+    checkpoint_load(is, key);
+    checkpoint_load(is, mapped);
+    value.emplace_hint(std::end(value), std::move(key), std::move(mapped));
+  }
+}
+
+template <typename T, typename U>
+void checkpoint_save(std::ostream& os, const std::pair<T, U>& value)
+{
+  checkpoint_save(os, value.first);
+  checkpoint_save(os, value.second);
+}
+
+template <typename T, typename U>
+void checkpoint_load(std::istream& is, std::pair<T, U>& value)
+{
+  checkpoint_load(is, value.first);
+  checkpoint_load(is, value.second);
+}
+
+template <typename... Ts>
+void checkpoint_save(std::ostream& os, const std::tuple<Ts...>& value)
+{
+  std::apply([&os](const auto&... elem) { (..., checkpoint_save(os, elem)); }, value);
+}
+
+template <typename... Ts>
+void checkpoint_load(std::istream& is, std::tuple<Ts...>& value)
+{
+  std::apply([&is](auto&... elem) { (..., checkpoint_load(is, elem)); }, value);
+}
+
+template <typename T>
+void checkpoint_save(std::ostream& os, const std::optional<T>& value)
+{
+  detail::checkpoint_save_raw(os, value.has_value());
+  if (value.has_value()) {
+    checkpoint_save(os, *value);
+  }
+}
+
+template <typename T>
+void checkpoint_load(std::istream& is, std::optional<T>& value)
+{
+  bool has_value{};
+  detail::checkpoint_load_raw(is, has_value);
+  if (has_value) {
+    T loaded{};
+    checkpoint_load(is, loaded);
+    value = std::move(loaded);
+  } else {
+    value.reset();
+  }
+}
+} // namespace champsim::msl
+
+#endif
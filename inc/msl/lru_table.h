@@ -22,12 +22,14 @@
 #include <cstdint>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "extent.h"
 #include "msl/bits.h"
+#include "msl/checkpoint.h"
 #include "util/detect.h"
 #include "util/span.h"
 #include "util/type_traits.h"
@@ -165,6 +167,29 @@ public:
     return std::exchange(*hit, {}).data;
   }
 
+  void checkpoint_save(std::ostream& os) const
+  {
+    msl::checkpoint_save(os, access_count);
+    msl::checkpoint_save(os, static_cast<uint64_t>(std::size(block)));
+    for (const auto& entry : block) {
+      msl::checkpoint_save(os, entry.last_used);
+      msl::checkpoint_save(os, entry.data);
+    }
+  }
+
+  void checkpoint_load(std::istream& is)
+  {
+    msl::checkpoint_load(is, access_count);
+    uint64_t size{};
+    msl::checkpoint_load(is, size);
+    if (size != std::size(block))
+      throw std::runtime_error{"Checkpointed table has " + std::to_string(size) + " entries, expected " + std::to_string(std::size(block))};
+    for (auto& entry : block) {
+      msl::checkpoint_load(is, entry.last_used);
+      msl::checkpoint_load(is, entry.data);
+    }
+  }
+
   lru_table(std::size_t sets, std::size_t ways, SetProj set_proj, TagProj tag_proj)
       : set_projection(set_proj), tag_projection(tag_proj), NUM_SET(static_cast<diff_type>(sets)), NUM_WAY(static_cast<diff_type>(ways)), block(sets * ways)
   {
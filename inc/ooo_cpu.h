@@ -25,12 +25,17 @@
 #include <array>
 #include <bitset>
 #include <deque>
+#include <functional>
+#include <istream>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <queue>
+#include <set>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "bandwidth.h"
@@ -42,6 +47,7 @@
 #include "modules.h"
 #include "operable.h"
 #include "register_allocator.h"
+#include "util/circular_buffer.h"
 #include "util/lru_table.h"
 #include "util/to_underlying.h"
 
@@ -61,6 +67,8 @@ public:
   CacheBus(uint32_t cpu_idx, champsim::channel* ll) : lower_level(ll), cpu(cpu_idx) {}
   bool issue_read(request_type packet);
   bool issue_write(request_type packet);
+  champsim::address functional_read(request_type packet) const;
+  void functional_write(request_type packet) const;
 };
 
 struct LSQ_ENTRY : champsim::program_ordered<LSQ_ENTRY> {
@@ -76,7 +84,7 @@ struct LSQ_ENTRY : champsim::program_ordered<LSQ_ENTRY> {
 
   LSQ_ENTRY(champsim::address addr, champsim::program_ordered<LSQ_ENTRY>::id_type id, champsim::address ip, std::array<uint8_t, 2> asid);
   void finish(ooo_model_instr& rob_entry) const;
-  void finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const;
+  void finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const;
 };
 
 // cpu
@@ -111,15 +119,30 @@ public:
   dib_type DIB;
 
   // reorder buffer, load/store queue, register file
-  std::deque<ooo_model_instr> IFETCH_BUFFER;
-  std::deque<ooo_model_instr> DISPATCH_BUFFER;
-  std::deque<ooo_model_instr> DECODE_BUFFER;
-  std::deque<ooo_model_instr> ROB;
-  std::deque<ooo_model_instr> DIB_HIT_BUFFER;
+  // The frontend buffers and the ROB are preallocated to their configured sizes, and instructions leave them from the front
+  using instr_buffer_type = champsim::circular_buffer<ooo_model_instr>;
+  instr_buffer_type IFETCH_BUFFER;
+  instr_buffer_type DISPATCH_BUFFER;
+  instr_buffer_type DECODE_BUFFER;
+  instr_buffer_type ROB;
+  instr_buffer_type DIB_HIT_BUFFER;
+
+  // Scheduled instructions in the ROB whose source registers are all valid, in program order
+  std::vector<instr_buffer_type::iterator> ready_to_execute;
+
+  // Executed instructions in the ROB that have not completed, in program order
+  std::vector<instr_buffer_type::iterator> executing;
 
   std::vector<std::optional<LSQ_ENTRY>> LQ;
   std::deque<LSQ_ENTRY> SQ;
 
+  // Indices into the load and store queues, so that their upkeep does not grow with their sizes
+  std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> lq_free_slots; // The lowest free slot is allocated first
+  std::unordered_map<champsim::program_ordered<LSQ_ENTRY>::id_type, champsim::inplace_vector<std::size_t, NUM_INSTR_SOURCES>> lq_slots_by_instr;
+  std::unordered_map<uint64_t, std::vector<LSQ_ENTRY*>> sq_by_address; // The in-flight stores to each virtual address, in program order
+  std::unordered_map<uint64_t, std::vector<std::size_t>> lq_slots_by_block; // The issued loads that wait on each block, by LQ slot
+  std::set<std::size_t> lq_ready_slots; // The unissued loads whose address has been computed and which wait on no store, issued lowest slot first
+
   // Constants
   const std::size_t IFETCH_BUFFER_SIZE, DISPATCH_BUFFER_SIZE, DECODE_BUFFER_SIZE, REGISTER_FILE_SIZE, ROB_SIZE, SQ_SIZE, DIB_HIT_BUFFER_SIZE;
   champsim::bandwidth::maximum_type FETCH_WIDTH, DECODE_WIDTH, DISPATCH_WIDTH, SCHEDULER_SIZE, EXEC_WIDTH, DIB_INORDER_WIDTH;
@@ -149,6 +172,9 @@ public:
   long operate() final;
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+  void idle(long cycles) final;
+  [[nodiscard]] std::vector<champsim::channel*> lower_channels() const final;
 
   void initialize_instruction();
   long check_dib();
@@ -166,24 +192,43 @@ public:
   bool do_init_instruction(ooo_model_instr& instr);
   bool do_predict_branch(ooo_model_instr& instr);
   void do_check_dib(ooo_model_instr& instr);
-  bool do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end);
+  bool do_fetch_instruction(instr_buffer_type::iterator begin, instr_buffer_type::iterator end);
   void do_dib_update(const ooo_model_instr& instr);
   void do_scheduling(ooo_model_instr& instr);
+  void do_register_wakeup(instr_buffer_type::iterator rob_it);
+  void do_mark_ready(instr_buffer_type::iterator rob_it);
   void do_execution(ooo_model_instr& instr);
   void do_memory_scheduling(ooo_model_instr& instr);
   void do_complete_execution(ooo_model_instr& instr);
   void do_sq_forward_to_lq(LSQ_ENTRY& sq_entry, LSQ_ENTRY& lq_entry);
 
+  std::optional<LSQ_ENTRY>& allocate_lq_entry();
+  void release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry);
+
   void do_finish_store(const LSQ_ENTRY& sq_entry);
   bool do_complete_store(const LSQ_ENTRY& sq_entry);
   bool execute_load(const LSQ_ENTRY& lq_entry);
 
+  /**
+   * Warm the branch predictor, the BTB, the decoded instruction buffer, and the caches with an instruction, without simulating the pipeline.
+   * The instruction is counted as retired.
+   */
+  void functional_operate(ooo_model_instr& arch_instr);
+
+  /**
+   * Whether every instruction that was taken from the input queue has retired. Functional warming may only begin once this holds, since the
+   * instructions in the pipeline would otherwise retire after the ones that follow them.
+   */
+  [[nodiscard]] bool pipeline_empty() const;
+
   [[nodiscard]] auto roi_instr() const { return roi_stats.instrs(); }
   [[nodiscard]] auto roi_cycle() const { return roi_stats.cycles(); }
   [[nodiscard]] auto sim_instr() const { return num_retired - begin_phase_instr; }
   [[nodiscard]] auto sim_cycle() const { return (current_time.time_since_epoch() / clock_period) - sim_stats.begin_cycles; }
 
   void print_deadlock() final;
+  void checkpoint_save(std::ostream& os) const final;
+  void checkpoint_load(std::istream& is) final;
 
 #include "module_decl.inc"
 
@@ -193,6 +238,8 @@ public:
     virtual void impl_initialize_branch_predictor() = 0;
     virtual void impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) = 0;
     virtual bool impl_predict_branch(champsim::address ip, champsim::address predicted_target, bool always_taken, uint8_t branch_type) = 0;
+    virtual void impl_branch_checkpoint_save(std::ostream& os) = 0;
+    virtual void impl_branch_checkpoint_load(std::istream& is) = 0;
   };
 
   struct btb_module_concept {
@@ -201,6 +248,8 @@ public:
     virtual void impl_initialize_btb() = 0;
     virtual void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) = 0;
     virtual std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) = 0;
+    virtual void impl_btb_checkpoint_save(std::ostream& os) = 0;
+    virtual void impl_btb_checkpoint_load(std::istream& is) = 0;
   };
 
   template <typename... Bs>
@@ -211,6 +260,8 @@ public:
     void impl_initialize_branch_predictor() final;
     void impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) final;
     [[nodiscard]] bool impl_predict_branch(champsim::address ip, champsim::address predicted_target, bool always_taken, uint8_t branch_type) final;
+    void impl_branch_checkpoint_save(std::ostream& os) final;
+    void impl_branch_checkpoint_load(std::istream& is) final;
   };
 
   template <typename... Ts>
@@ -221,6 +272,8 @@ public:
     void impl_initialize_btb() final;
     void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) final;
     [[nodiscard]] std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) final;
+    void impl_btb_checkpoint_save(std::ostream& os) final;
+    void impl_btb_checkpoint_load(std::istream& is) final;
   };
 
   std::unique_ptr<branch_module_concept> branch_module_pimpl;
@@ -240,7 +293,9 @@ public:
   explicit O3_CPU(champsim::core_builder<champsim::core_builder_module_type_holder<Bs...>, champsim::core_builder_module_type_holder<Ts...>> b)
       : champsim::operable(b.m_clock_period), cpu(b.m_cpu),
         DIB(b.m_dib_set, b.m_dib_way, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}),
-        LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
+        IFETCH_BUFFER(b.m_ifetch_buffer_size), DISPATCH_BUFFER(b.m_dispatch_buffer_size), DECODE_BUFFER(b.m_decode_buffer_size), ROB(b.m_rob_size),
+        DIB_HIT_BUFFER(b.m_dib_hit_buffer_size), LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size),
+        DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
         REGISTER_FILE_SIZE(b.m_register_file_size), ROB_SIZE(b.m_rob_size), SQ_SIZE(b.m_sq_size), DIB_HIT_BUFFER_SIZE(b.m_dib_hit_buffer_size),
         FETCH_WIDTH(b.m_fetch_width), DECODE_WIDTH(b.m_decode_width), DISPATCH_WIDTH(b.m_dispatch_width), SCHEDULER_SIZE(b.m_schedule_width),
         EXEC_WIDTH(b.m_execute_width), DIB_INORDER_WIDTH(b.m_dib_inorder_width), LQ_WIDTH(b.m_lq_width), SQ_WIDTH(b.m_sq_width), RETIRE_WIDTH(b.m_retire_width),
@@ -251,6 +306,9 @@ public:
         L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), branch_module_pimpl(std::make_unique<branch_module_model<Bs...>>(this)),
         btb_module_pimpl(std::make_unique<btb_module_model<Ts...>>(this))
   {
+    for (std::size_t slot = 0; slot < std::size(LQ); ++slot) {
+      lq_free_slots.push(slot);
+    }
   }
 };
 
@@ -369,6 +427,54 @@ std::pair<champsim::address, bool> O3_CPU::btb_module_model<Ts...>::impl_btb_pre
   return return_type{};
 }
 
+template <typename... Bs>
+void O3_CPU::branch_module_model<Bs...>::impl_branch_checkpoint_save(std::ostream& os)
+{
+  [[maybe_unused]] auto process_one = [&](auto& b) {
+    using namespace champsim::modules;
+    if constexpr (branch_predictor::has_checkpoint_save<decltype(b), std::ostream&>)
+      b.branch_checkpoint_save(os);
+  };
+
+  std::apply([&](auto&... b) { (..., process_one(b)); }, intern_);
+}
+
+template <typename... Bs>
+void O3_CPU::branch_module_model<Bs...>::impl_branch_checkpoint_load(std::istream& is)
+{
+  [[maybe_unused]] auto process_one = [&](auto& b) {
+    using namespace champsim::modules;
+    if constexpr (branch_predictor::has_checkpoint_load<decltype(b), std::istream&>)
+      b.branch_checkpoint_load(is);
+  };
+
+  std::apply([&](auto&... b) { (..., process_one(b)); }, intern_);
+}
+
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_btb_checkpoint_save(std::ostream& os)
+{
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    using namespace champsim::modules;
+    if constexpr (btb::has_checkpoint_save<decltype(t), std::ostream&>)
+      t.btb_checkpoint_save(os);
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_btb_checkpoint_load(std::istream& is)
+{
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    using namespace champsim::modules;
+    if constexpr (btb::has_checkpoint_load<decltype(t), std::istream&>)
+      t.btb_checkpoint_load(is);
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
 #ifdef SET_ASIDE_CHAMPSIM_MODULE
 #undef SET_ASIDE_CHAMPSIM_MODULE
 #define CHAMPSIM_MODULE
@@ -17,6 +17,10 @@
 #ifndef OPERABLE_H
 #define OPERABLE_H
 
+#include <iosfwd>
+#include <vector>
+
+#include "channel.h"
 #include "chrono.h"
 
 namespace champsim
@@ -27,6 +31,7 @@ public:
   champsim::chrono::picoseconds clock_period{};
   champsim::chrono::clock::time_point current_time{};
   bool warmup = true;
+  bool idle_gating = false;
 
   operable();
   virtual ~operable() = default;
@@ -35,13 +40,58 @@ public:
   long _operate();
   long operate_on(const champsim::chrono::clock& clock);
 
+  long _idle(long cycles);
+  long idle_on(const champsim::chrono::clock& clock);
+  [[nodiscard]] champsim::chrono::clock::time_point idle_until() const;
+
+  /**
+   * An operable that is asleep is not operated. Its cycles are accounted through idle() instead, until some other component wakes it.
+   * When idle gating is enabled, an operable falls asleep on its own once it has nothing scheduled.
+   */
+  void sleep();
+  void wake();
+  [[nodiscard]] bool is_asleep() const;
+
   virtual void initialize() {} // LCOV_EXCL_LINE
   virtual long operate() = 0;
   virtual void begin_phase() {}                     // LCOV_EXCL_LINE
   virtual void end_phase(unsigned /*cpu index*/) {} // LCOV_EXCL_LINE
   virtual void print_deadlock() {}                  // LCOV_EXCL_LINE
 
+  /**
+   * The earliest time at which a call to operate() could change the state of this operable, assuming that no other operable changes state first.
+   * The default is the next cycle, which prevents any cycles from being skipped.
+   */
+  [[nodiscard]] virtual champsim::chrono::clock::time_point next_event_time() const;
+
+  /**
+   * Account for cycles that were skipped by idle_on(). Operables that change state on every cycle regardless of activity should replicate that here.
+   */
+  virtual void idle(long /*cycles*/) {} // LCOV_EXCL_LINE
+
+  /**
+   * The channels through which this operable sends requests toward memory. These determine which operables may be simulated apart from each other.
+   */
+  [[nodiscard]] virtual std::vector<champsim::channel*> lower_channels() const { return {}; } // LCOV_EXCL_LINE
+
+  /**
+   * Write the state that this operable accumulates over a warmup, such as the contents of its tables, to a checkpoint.
+   * Transient state, such as queued requests and scheduled events, is not saved. A restored operable begins with none outstanding.
+   */
+  virtual void checkpoint_save(std::ostream& /*os*/) const {} // LCOV_EXCL_LINE
+  virtual void checkpoint_load(std::istream& /*is*/) {}       // LCOV_EXCL_LINE
+
+  /**
+   * Handle a request at once, without queues or timing, for functional warming. The tables of this operable are updated as if the request were simulated,
+   * and any requests it would send toward memory are handled in the same way before this returns.
+   * An operable that does not implement this returns the data of the request unchanged.
+   */
+  virtual champsim::address functional_access(const champsim::channel::request_type& packet) { return packet.data; } // LCOV_EXCL_LINE
+
   [[deprecated]] uint64_t current_cycle() const;
+
+private:
+  bool asleep = false;
 };
 
 } // namespace champsim
@@ -0,0 +1,112 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARALLEL_ENGINE_H
+#define PARALLEL_ENGINE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "chrono.h"
+#include "domain_scheduler.h"
+
+class O3_CPU;
+
+namespace champsim
+{
+class operable;
+struct environment;
+
+/**
+ * Divide the operables into groups that can be operated independently between synchronization points.
+ * Group i holds roots[i] and every operable that can be reached from roots[i], and from no other root, by following lower_channels() to their
+ * request sinks.
+ * The final group holds every other operable. The relative order of the operables is preserved within each group.
+ *
+ * The request sinks are assigned in operable::initialize(), so this must be called after the operables are initialized.
+ */
+std::vector<std::vector<std::reference_wrapper<operable>>> partition_operables(const std::vector<std::reference_wrapper<operable>>& operables,
+                                                                               const std::vector<std::reference_wrapper<operable>>& roots);
+
+/**
+ * Operates each core and its private hierarchy on a pool of threads.
+ *
+ * Time advances in quanta of several cycles. In each quantum, the shared components (those reachable from more than one core) are operated first,
+ * on the calling thread. Then, each private partition is operated for the same span of cycles, on whichever thread it is assigned to.
+ * Because the two steps never overlap, the channels between the private and shared components are never accessed concurrently.
+ * Requests that cross into the shared partition are seen up to one quantum late, and responses that return from it up to one quantum early.
+ */
+class parallel_engine
+{
+  std::vector<domain_scheduler> partitions;
+  std::vector<std::vector<std::reference_wrapper<O3_CPU>>> partition_cpus;
+  std::size_t num_threads;
+  long quantum_cycles;
+
+  // The state of the quantum in progress
+  champsim::chrono::clock quantum_begin{};
+  champsim::chrono::clock::duration time_quantum{};
+  const std::function<void(O3_CPU&)>* fill_input = nullptr;
+  std::vector<long> partition_progress;
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  uint64_t generation = 0;
+  std::size_t outstanding = 0;
+  bool stopping = false;
+
+  long operate_partition(std::size_t index);
+  void operate_assigned(std::size_t thread_index);
+  void work(std::size_t thread_index);
+
+public:
+  /**
+   * :param env: The environment to simulate. Its operables must already be initialized.
+   * :param threads: The number of threads, including the calling thread.
+   * :param quantum: The number of cycles between synchronizations. If this is zero, it is taken from the shortest hit latency of the shared caches.
+   * :param time_quantum: The length of one cycle.
+   * :param deterministic: If true, physical pages are allocated separately for each core. Since each trace also numbers its own instructions,
+   * the results for a given quantum then do not depend on the number of threads or on their scheduling.
+   */
+  parallel_engine(environment& env, std::size_t threads, long quantum, champsim::chrono::clock::duration time_quantum, bool deterministic);
+  ~parallel_engine();
+
+  parallel_engine(const parallel_engine&) = delete;
+  parallel_engine& operator=(const parallel_engine&) = delete;
+  parallel_engine(parallel_engine&&) = delete;
+  parallel_engine& operator=(parallel_engine&&) = delete;
+
+  [[nodiscard]] long quantum() const;
+
+  /**
+   * Advance the global clock by one quantum, operating every partition up to it.
+   *
+   * :param global_clock: The clock to advance.
+   * :param fill_input_queue: Called for each core after each of its cycles, to refill its input queue.
+   *
+   * :returns: The total progress of all operables over the quantum.
+   */
+  long operate_quantum(champsim::chrono::clock& global_clock, const std::function<void(O3_CPU&)>& fill_input_queue);
+};
+} // namespace champsim
+
+#endif
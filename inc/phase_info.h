@@ -19,13 +19,15 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
-#include "cache_stats.h"
-#include "core_stats.h"
-#include "dram_stats.h"
+#include "cache.h"
+#include "dram_controller.h"
+#include "ooo_cpu.h"
+#include "sampling.h"
 
 namespace champsim
 {
@@ -36,11 +38,24 @@ struct phase_info {
   long long length;
   std::vector<std::size_t> trace_index;
   std::vector<std::string> trace_names;
+  bool skip_idle_cycles = false;
+  bool idle_gating = false;
+  std::size_t num_threads = 1;
+  long sync_quantum = 0;
+  bool deterministic = true;
+  std::string load_checkpoint_file{};            // If given, restore the machine from this checkpoint before the phase begins
+  std::string save_checkpoint_file{};            // If given, save the machine to this checkpoint after the phase ends
+  uint64_t fast_forward_to = 0;                  // Before the phase begins, discard records until each trace has been read this far
+  std::optional<double> weight{};                // The share of the whole program that this phase represents, if it is a sample
+  std::optional<sampling_parameters> sampling{}; // If given, the phase measures periodic samples instead of every instruction
+  bool functional_warming = false;               // If a warmup phase, train the components directly from the trace instead of simulating the pipeline
 };
 
 struct phase_stats {
   std::string name;
   std::vector<std::string> trace_names;
+  std::optional<double> weight{};
+  std::optional<sampling_summary> sampling{};
   std::vector<O3_CPU::stats_type> roi_cpu_stats, sim_cpu_stats;
   std::vector<CACHE::stats_type> roi_cache_stats, sim_cache_stats;
   std::vector<DRAM_CHANNEL::stats_type> roi_dram_stats, sim_dram_stats;
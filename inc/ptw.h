@@ -56,7 +56,7 @@ class PageTableWalker : public champsim::operable
     champsim::waitable<champsim::address> data{};
 
     std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    std::vector<channel_type*> to_return{};
 
     uint32_t pf_metadata = 0;
     uint32_t cpu = std::numeric_limits<uint32_t>::max();
@@ -74,12 +74,17 @@ class PageTableWalker : public champsim::operable
   std::vector<channel_type*> upper_levels;
   channel_type* lower_level;
 
+  mshr_type begin_walk(const request_type& pkt);
   std::optional<mshr_type> handle_read(const request_type& pkt, channel_type* ul);
   std::optional<mshr_type> handle_fill(const mshr_type& fill_mshr);
   std::optional<mshr_type> step_translation(const mshr_type& source);
+  static request_type step_request(const mshr_type& source);
 
   void finish_packet(const response_type& packet);
 
+  // Repeat the attempts that the reads and steps blocked on the lower level make on a cycle in which nothing else happens
+  void retry_blocked();
+
 public:
   const std::string NAME;
   const uint32_t MSHR_SIZE;
@@ -94,9 +99,16 @@ public:
   explicit PageTableWalker(champsim::ptw_builder builder);
 
   long operate() final;
+  [[nodiscard]] champsim::chrono::clock::time_point next_event_time() const final;
+  void idle(long cycles) final;
+  [[nodiscard]] std::vector<champsim::channel*> lower_channels() const final;
+  champsim::address functional_access(const request_type& packet) final;
 
+  void initialize() final;
   void begin_phase() final;
   void print_deadlock() final;
+  void checkpoint_save(std::ostream& os) const final;
+  void checkpoint_load(std::istream& is) final;
 };
 
 #endif
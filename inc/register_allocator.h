@@ -3,6 +3,7 @@
 #include <list>
 #include <optional>
 #include <queue>
+#include <vector>
 
 #ifndef REG_ALLOC_H
 #define REG_ALLOC_H
@@ -22,12 +23,25 @@ private:
   std::array<PHYSICAL_REGISTER_ID, std::numeric_limits<uint8_t>::max() + 1> frontend_RAT, backend_RAT;
   std::queue<PHYSICAL_REGISTER_ID> free_registers;
   std::vector<physical_register> physical_register_file;
+  std::vector<std::vector<champsim::program_ordered<ooo_model_instr>::id_type>> consumers; // The instructions waiting for each register to become valid
+  std::vector<champsim::program_ordered<ooo_model_instr>::id_type> woken;                  // Reused to return the consumers of a completed register
 
 public:
   RegisterAllocator(size_t num_physical_registers);
   PHYSICAL_REGISTER_ID rename_dest_register(int16_t reg, champsim::program_ordered<ooo_model_instr>::id_type producer_id);
   PHYSICAL_REGISTER_ID rename_src_register(int16_t reg);
-  void complete_dest_register(PHYSICAL_REGISTER_ID physreg);
+
+  /**
+   * Record that an instruction waits for a physical register to become valid.
+   */
+  void add_consumer(PHYSICAL_REGISTER_ID physreg, champsim::program_ordered<ooo_model_instr>::id_type consumer_id);
+
+  /**
+   * Mark a physical register as valid.
+   *
+   * \return the IDs of the instructions that were waiting for it, valid until the next call
+   */
+  const std::vector<champsim::program_ordered<ooo_model_instr>::id_type>& complete_dest_register(PHYSICAL_REGISTER_ID physreg);
   void retire_dest_register(PHYSICAL_REGISTER_ID physreg);
   void free_register(PHYSICAL_REGISTER_ID physreg);
   bool isValid(PHYSICAL_REGISTER_ID physreg) const;
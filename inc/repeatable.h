@@ -17,11 +17,13 @@
 #ifndef REPEATABLE_H
 #define REPEATABLE_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <fmt/ranges.h>
 
 #include "instruction.h"
+#include "util/detect.h"
 
 namespace champsim
 {
@@ -31,6 +33,7 @@ struct repeatable {
   static_assert(std::is_move_assignable_v<T>);
   std::tuple<Args...> args_;
   T intern_{std::apply([](auto... x) { return T{x...}; }, args_)};
+  bool repeated = false;
   explicit repeatable(Args... args) : args_(args...) {}
 
   auto operator()()
@@ -39,12 +42,37 @@ struct repeatable {
     if (intern_.eof()) {
       fmt::print("*** Reached end of trace: {}\n", args_);
       intern_ = T{std::apply([](auto... x) { return T{x...}; }, args_)};
+      repeated = true;
     }
 
     return intern_();
   }
 
   [[nodiscard]] bool eof() const { return false; }
+
+  template <typename U>
+  using has_pause = decltype(std::declval<U>().pause());
+
+  void pause()
+  {
+    if constexpr (champsim::is_detected_v<has_pause, T>) {
+      intern_.pause();
+    }
+  }
+
+  template <typename U>
+  using has_seek = decltype(std::declval<U&>().seek(uint64_t{}, uint64_t{}));
+
+  // Positions are counted from the beginning of the trace, so seeking is only possible before the trace repeats
+  uint64_t seek(uint64_t current, uint64_t target)
+  {
+    if constexpr (champsim::is_detected_v<has_seek, T>) {
+      if (!repeated) {
+        return intern_.seek(current, target);
+      }
+    }
+    return current;
+  }
 };
 } // namespace champsim
 
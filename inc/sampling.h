@@ -0,0 +1,77 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <vector>
+
+namespace champsim
+{
+/**
+ * The parameters of a periodically sampled phase. Each period begins with a stretch of functional warming, in which the components are warmed
+ * without timing, followed by a window of detailed warming, which fills the pipeline, and a window in which the CPI is measured.
+ */
+struct sampling_parameters {
+  long long period = 1'000'000;     // The number of instructions between the beginnings of consecutive samples
+  long long detailed_warmup = 2000; // The number of instructions simulated in detail before each measurement
+  long long measurement = 1000;     // The number of instructions measured in each sample
+  double confidence = 0.997;        // The confidence level of the reported error bound
+  double target_error = 0.03;       // The phase ends once the error bound, relative to the mean CPI, is this small
+  long long min_samples = 30;       // The phase does not end before this many samples have been measured
+
+  [[nodiscard]] long long functional_warmup() const;
+};
+
+/**
+ * An online estimate of the mean and variance of a sampled quantity.
+ */
+class sample_estimate
+{
+  long long n = 0;
+  double mean_ = 0;
+  double sum_sq_ = 0; // The sum of squared differences from the mean
+
+public:
+  void add(double value);
+
+  [[nodiscard]] long long count() const { return n; }
+  [[nodiscard]] double mean() const { return mean_; }
+  [[nodiscard]] double variance() const;
+
+  /**
+   * The half-width of the confidence interval of the mean, relative to the mean.
+   *
+   * :param z: The standard score of the confidence level, as given by z_score().
+   */
+  [[nodiscard]] double relative_error(double z) const;
+};
+
+/**
+ * The standard score of a two-sided confidence level for a normal distribution. For example, a confidence of 0.95 gives about 1.96.
+ */
+double z_score(double confidence);
+
+struct sampling_summary {
+  long long samples = 0;
+  double confidence = 0;
+  bool converged = false;      // Whether the target error was reached before the phase ran out of instructions
+  std::vector<double> cpi{};   // The mean CPI of the samples of each core
+  std::vector<double> error{}; // The relative error bound of the CPI of each core
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHARED_TRACE_H
+#define SHARED_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "instruction.h"
+#include "tracereader.h"
+
+namespace champsim
+{
+/**
+ * Decodes a trace once for all of the cores that run it.
+ *
+ * The decoded instructions are kept in chunks, which are shared by the cursors of the cores and released once every cursor has passed them.
+ * A cursor that falls further behind the others than the window of retained instructions opens a reader of its own, and continues from
+ * the same position.
+ */
+class shared_trace
+{
+public:
+  using chunk_type = std::vector<ooo_model_instr>;
+  constexpr static std::size_t chunk_size = 4096;
+  constexpr static std::size_t default_window = 64; // The number of chunks that may be retained, in addition to the spread of the cursors
+
+  class cursor;
+
+  /**
+   * Create a trace that is decoded by the reader from the given function.
+   * The function is also called for each cursor that falls behind the others.
+   */
+  shared_trace(std::function<tracereader()> open, std::size_t window_chunks);
+
+  /**
+   * Create a cursor that begins the given number of instructions into the trace.
+   * If the records of the trace do not carry their own address space, the instructions are given that of the CPU.
+   */
+  static cursor make_cursor(const std::shared_ptr<shared_trace>& trace, uint8_t cpu, bool stamp_asid, uint64_t offset);
+
+  void pause();
+
+private:
+  std::mutex mutex;
+  std::function<tracereader()> open;
+  tracereader reader;
+  std::size_t window;
+  std::deque<std::shared_ptr<const chunk_type>> chunks{};
+  uint64_t first_chunk = 0;
+  std::vector<uint64_t> cursor_chunks{}; // The chunk that each cursor reads next
+
+  constexpr static uint64_t detached = std::numeric_limits<uint64_t>::max();
+
+  /**
+   * Get the chunk with the given index for a cursor, decoding the trace as far as needed.
+   *
+   * \return the chunk, which holds fewer than chunk_size instructions at the end of the trace, or nullptr if it has been released
+   */
+  std::shared_ptr<const chunk_type> chunk(std::size_t cursor_id, uint64_t index);
+
+  // Record the chunk that a cursor reads next, so that the chunks before it may be released
+  void move_cursor(std::size_t cursor_id, uint64_t index);
+};
+
+/**
+ * A reader of a shared trace for one core. Its position is independent of the other cursors.
+ */
+class shared_trace::cursor
+{
+  std::shared_ptr<shared_trace> trace;
+  std::size_t id;
+  uint8_t cpu;
+  bool stamp_asid;
+  uint64_t position; // The index in the shared trace of the next instruction
+
+  // eof() may need to fetch the next chunk, so the chunk in use is cached in mutable members
+  mutable std::shared_ptr<const chunk_type> current{};
+  mutable uint64_t current_index = std::numeric_limits<uint64_t>::max();
+  mutable std::optional<tracereader> own_reader{};
+
+  void load() const;
+
+public:
+  cursor(std::shared_ptr<shared_trace> trace, std::size_t id, uint8_t cpu, bool stamp_asid, uint64_t position);
+
+  ooo_model_instr operator()();
+  [[nodiscard]] bool eof() const;
+  void pause();
+
+  /**
+   * Move to the target without reading the instructions in between. The shared trace skips the instructions that no cursor needs.
+   *
+   * \return the position of the cursor
+   */
+  uint64_t seek(uint64_t current_pos, uint64_t target);
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPOINT_H
+#define SIMPOINT_H
+
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+#include "phase_info.h"
+
+namespace champsim
+{
+struct simpoint {
+  long long interval; // The index of the interval in the trace
+  double weight;      // The share of the program's intervals in the same cluster
+};
+
+/**
+ * Read the output of the SimPoint tool.
+ * Each line of the simpoints stream has the form ``<interval> <cluster>``, and each line of the weights stream has the form ``<weight> <cluster>``.
+ * Throws std::runtime_error if a cluster appears in only one of the streams.
+ *
+ * :returns: The simulation points, in the order of their intervals.
+ */
+std::vector<simpoint> read_simpoints(std::istream& simpoints, std::istream& weights);
+
+/**
+ * Build the phases that simulate each simulation point. Each point is given a warmup phase, which fast-forwards the traces to the instructions
+ * preceding the interval, and a detailed phase over the interval, which carries the weight of the point. The warmup never overlaps the interval of the
+ * previous point, and is omitted if the intervals are adjacent.
+ *
+ * :param points: The simulation points, in the order of their intervals.
+ * :param interval_length: The number of instructions in each interval.
+ * :param warmup_length: The number of instructions to warm up before each interval.
+ * :param base: The phase from which the trace assignment and simulation options are copied.
+ */
+std::vector<phase_info> simpoint_phases(const std::vector<simpoint>& points, long long interval_length, long long warmup_length, const phase_info& base);
+
+struct weighted_summary {
+  double total_weight;
+  std::vector<double> cpi; // The weighted cycles per instruction of each core
+};
+
+/**
+ * Combine the statistics of the weighted phases into an estimate for the whole program. The weights of the phases present are normalized, so that
+ * the estimate is meaningful even if the trace ended before every point was simulated.
+ *
+ * :returns: The summary, or nothing if no phase has a weight.
+ */
+std::optional<weighted_summary> summarize_weighted(const std::vector<phase_stats>& stats);
+} // namespace champsim
+
+#endif
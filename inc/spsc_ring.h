@@ -0,0 +1,94 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * A bounded queue that one thread may push to while another pops from it, without locking.
+ *
+ * The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class spsc_ring
+{
+  std::vector<std::optional<T>> slots;
+  std::size_t mask;
+
+  // The head is written only by the consumer, and the tail only by the producer.
+  alignas(64) std::atomic<std::size_t> head{0};
+  alignas(64) std::atomic<std::size_t> tail{0};
+
+  static std::size_t round_capacity(std::size_t capacity)
+  {
+    std::size_t retval = 1;
+    while (retval < capacity) {
+      retval <<= 1;
+    }
+    return retval;
+  }
+
+public:
+  explicit spsc_ring(std::size_t capacity) : slots(round_capacity(capacity)), mask(std::size(slots) - 1) {}
+
+  /**
+   * Add an element to the back of the ring. This may only be called by the producer.
+   *
+   * \return false if the ring is full
+   */
+  bool try_push(T&& value)
+  {
+    auto t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == std::size(slots)) {
+      return false;
+    }
+
+    slots[t & mask].emplace(std::move(value));
+    tail.store(t + 1, std::memory_order_seq_cst);
+    return true;
+  }
+
+  /**
+   * Remove an element from the front of the ring. This may only be called by the consumer.
+   */
+  std::optional<T> try_pop()
+  {
+    auto h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+
+    std::optional<T> retval{std::move(slots[h & mask])};
+    slots[h & mask].reset();
+    head.store(h + 1, std::memory_order_seq_cst);
+    return retval;
+  }
+
+  [[nodiscard]] std::size_t size() const { return tail.load(std::memory_order_seq_cst) - head.load(std::memory_order_seq_cst); }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+  [[nodiscard]] bool full() const { return size() == capacity(); }
+  [[nodiscard]] std::size_t capacity() const { return std::size(slots); }
+};
+} // namespace champsim
+
+#endif
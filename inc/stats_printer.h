@@ -22,6 +22,7 @@
 #include "dram_controller.h"
 #include "ooo_cpu.h"
 #include "phase_info.h"
+#include "sweep.h"
 
 namespace champsim
 {
@@ -33,6 +34,7 @@ public:
   plain_printer(std::ostream& str) : stream(str) {}
   void print(phase_stats& stats);
   void print(std::vector<phase_stats>& stats);
+  void print(const std::vector<variant_result>& results);
 
   static std::vector<std::string> format(O3_CPU::stats_type stats);
   static std::vector<std::string> format(CACHE::stats_type stats);
@@ -47,5 +49,6 @@ class json_printer
 public:
   json_printer(std::ostream& str) : stream(str) {}
   void print(std::vector<phase_stats>& stats);
+  void print(const std::vector<variant_result>& results);
 };
 } // namespace champsim
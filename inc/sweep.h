@@ -0,0 +1,93 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * A setting of the knobs that is simulated after a shared warmup.
+ */
+struct variant {
+  std::string name;
+  std::vector<std::pair<std::string, long>> knobs{};
+};
+
+/**
+ * Parse a knob setting of the form KNOB=VALUE.
+ */
+std::pair<std::string, long> parse_knob_setting(std::string_view spec);
+
+/**
+ * Parse a variant of the form NAME:KNOB=VALUE[,KNOB=VALUE...].
+ */
+variant parse_variant(std::string_view spec);
+
+struct variant_result {
+  std::string name;
+  int exit_status = -1;     // The exit status of the process that simulated the variant, or -1 if it did not exit normally
+  std::vector<double> ipc{}; // The IPC of each core, if the process reported it
+};
+
+/**
+ * Simulates each of a set of variants in its own process, forked from a simulator that has been warmed up once.
+ * The children share the warmed memory of the parent until they write to it.
+ */
+class variant_sweep
+{
+  std::vector<variant> variants;
+  std::optional<std::size_t> child_index{};
+  int result_fd = -1;
+
+  struct child_process {
+    int pid;
+    int result_fd;
+  };
+  std::vector<child_process> children{};
+
+public:
+  explicit variant_sweep(std::vector<variant> variants);
+
+  /**
+   * Fork one process for each variant.
+   * Each child applies the knobs of its variant, redirects its standard output to NAME.txt, and returns true.
+   * The parent waits for every child to exit and returns false.
+   */
+  bool fork_children();
+
+  [[nodiscard]] bool in_child() const { return child_index.has_value(); }
+  [[nodiscard]] const variant& current() const;
+
+  /**
+   * In a child, send the IPC of each core to the parent.
+   */
+  void report(const std::vector<double>& ipc) const;
+
+  /**
+   * In the parent, the outcome of each variant, once fork_children() has returned.
+   */
+  std::vector<variant_result> results{};
+};
+} // namespace champsim
+
+#endif
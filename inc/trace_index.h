@@ -0,0 +1,205 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACE_INDEX_H
+#define TRACE_INDEX_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * A point in a compressed stream where decompression can begin again, and the state that the decompressor needs to do so.
+ */
+struct inflate_checkpoint {
+  uint64_t decompressed_offset = 0;
+  uint64_t compressed_offset = 0;
+  uint8_t bits = 0;              // For gzip, the number of bits of the previous byte that belong to the next deflate block
+  std::vector<uint8_t> window{}; // For gzip, the decompressed data that precedes the checkpoint
+};
+
+/**
+ * Detects a stream that can begin decompressing again at a checkpoint.
+ */
+template <typename F>
+using has_checkpoint_seek = decltype(std::declval<F&>().seek(std::declval<const inflate_checkpoint&>(), uint64_t{}));
+
+/**
+ * An index of a trace, which lets a reader begin decoding near any instruction without decompressing the trace before it.
+ * It is kept beside the trace, in a file with the name of the trace followed by ".idx", and is built by the trace_index tool in tracer/.
+ *
+ * The index lists the checkpoints where decompression can begin, and, for a columnar trace, the instruction and offset where each block begins.
+ * Uncompressed traces need no checkpoints.
+ */
+struct trace_index {
+  struct block {
+    uint64_t instruction = 0;
+    uint64_t decompressed_offset = 0;
+  };
+
+  uint64_t trace_size = 0; // The size of the trace file that the index was built from
+  std::vector<inflate_checkpoint> checkpoints{};
+  std::vector<block> blocks{};
+
+  static std::string file_name(std::string_view trace_name) { return std::string{trace_name} + ".idx"; }
+
+  /**
+   * Read the index of the given trace.
+   *
+   * :returns: The index, or std::nullopt if the trace has no index.
+   * :throws std::runtime_error: If the index is malformed, or was built from a different version of the trace.
+   */
+  static std::optional<trace_index> load(const std::string& trace_name);
+
+  /**
+   * Write the index beside the given trace.
+   */
+  void save(const std::string& trace_name) const;
+
+  /**
+   * The last checkpoint at or before the given offset into the decompressed trace, or nullptr if there is none.
+   */
+  [[nodiscard]] const inflate_checkpoint* checkpoint_before(uint64_t decompressed_offset) const
+  {
+    auto found = std::upper_bound(std::begin(checkpoints), std::end(checkpoints), decompressed_offset,
+                                  [](uint64_t offset, const inflate_checkpoint& point) { return offset < point.decompressed_offset; });
+    return (found == std::begin(checkpoints)) ? nullptr : &*std::prev(found);
+  }
+
+  /**
+   * The last block that begins at or before the given instruction, or nullptr if there is none.
+   */
+  [[nodiscard]] const block* block_before(uint64_t instruction) const
+  {
+    auto found =
+        std::upper_bound(std::begin(blocks), std::end(blocks), instruction, [](uint64_t instr, const block& blk) { return instr < blk.instruction; });
+    return (found == std::begin(blocks)) ? nullptr : &*std::prev(found);
+  }
+};
+
+namespace detail
+{
+constexpr std::string_view trace_index_magic{"ChampSim trace index"};
+constexpr uint64_t trace_index_version = 1;
+
+inline void write_u64(std::ostream& os, uint64_t value)
+{
+  std::array<char, sizeof(value)> bytes{};
+  for (std::size_t i = 0; i < std::size(bytes); ++i) {
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  }
+  os.write(std::data(bytes), std::size(bytes));
+}
+
+inline uint64_t read_u64(std::istream& is)
+{
+  std::array<char, sizeof(uint64_t)> bytes{};
+  is.read(std::data(bytes), std::size(bytes));
+  if (!is) {
+    throw std::runtime_error{"The trace index ends unexpectedly"};
+  }
+  uint64_t retval = 0;
+  for (std::size_t i = 0; i < std::size(bytes); ++i) {
+    retval |= uint64_t{static_cast<unsigned char>(bytes[i])} << (8 * i);
+  }
+  return retval;
+}
+} // namespace detail
+
+inline std::optional<trace_index> trace_index::load(const std::string& trace_name)
+{
+  std::ifstream is{file_name(trace_name), std::ios::binary};
+  if (!is) {
+    return std::nullopt;
+  }
+
+  std::string magic(std::size(detail::trace_index_magic), '\0');
+  is.read(std::data(magic), static_cast<std::streamsize>(std::size(magic)));
+  if (!is || magic != detail::trace_index_magic) {
+    throw std::runtime_error{file_name(trace_name) + " is not a trace index"};
+  }
+  if (detail::read_u64(is) != detail::trace_index_version) {
+    throw std::runtime_error{file_name(trace_name) + " has an unsupported version"};
+  }
+
+  trace_index retval;
+  retval.trace_size = detail::read_u64(is);
+  if (retval.trace_size != std::filesystem::file_size(trace_name)) {
+    throw std::runtime_error{file_name(trace_name) + " was built from a different version of the trace. Build the index again."};
+  }
+
+  retval.checkpoints.resize(detail::read_u64(is));
+  for (auto& point : retval.checkpoints) {
+    point.decompressed_offset = detail::read_u64(is);
+    point.compressed_offset = detail::read_u64(is);
+    point.bits = static_cast<uint8_t>(detail::read_u64(is));
+    point.window.resize(detail::read_u64(is));
+    is.read(reinterpret_cast<char*>(std::data(point.window)), static_cast<std::streamsize>(std::size(point.window)));
+    if (!is) {
+      throw std::runtime_error{"The trace index ends unexpectedly"};
+    }
+  }
+
+  retval.blocks.resize(detail::read_u64(is));
+  for (auto& blk : retval.blocks) {
+    blk.instruction = detail::read_u64(is);
+    blk.decompressed_offset = detail::read_u64(is);
+  }
+  return retval;
+}
+
+inline void trace_index::save(const std::string& trace_name) const
+{
+  std::ofstream os{file_name(trace_name), std::ios::binary};
+  os.write(std::data(detail::trace_index_magic), static_cast<std::streamsize>(std::size(detail::trace_index_magic)));
+  detail::write_u64(os, detail::trace_index_version);
+  detail::write_u64(os, trace_size);
+
+  detail::write_u64(os, std::size(checkpoints));
+  for (const auto& point : checkpoints) {
+    detail::write_u64(os, point.decompressed_offset);
+    detail::write_u64(os, point.compressed_offset);
+    detail::write_u64(os, point.bits);
+    detail::write_u64(os, std::size(point.window));
+    os.write(reinterpret_cast<const char*>(std::data(point.window)), static_cast<std::streamsize>(std::size(point.window)));
+  }
+
+  detail::write_u64(os, std::size(blocks));
+  for (const auto& blk : blocks) {
+    detail::write_u64(os, blk.instruction);
+    detail::write_u64(os, blk.decompressed_offset);
+  }
+
+  if (!os) {
+    throw std::runtime_error{"Could not write " + file_name(trace_name)};
+  }
+}
+} // namespace champsim
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACE_INDEX_BUILDER_H
+#define TRACE_INDEX_BUILDER_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "columnar_trace.h"
+#include "inf_stream.h"
+#include "trace_index.h"
+
+namespace champsim
+{
+namespace detail
+{
+/*
+ * A gzip stream is checkpointed at the boundaries of its deflate blocks, where the decompressor needs only the preceding 32 KiB of output.
+ * This follows the zran example that is distributed with zlib.
+ */
+inline std::vector<inflate_checkpoint> gzip_checkpoints(std::istream& file, uint64_t span)
+{
+  constexpr std::size_t window_size = 1 << 15;
+  constexpr std::size_t chunk = 1 << 16;
+  constexpr int automatic_header = 15 + 32;
+  constexpr int end_of_block = 128;
+  constexpr int last_block = 64;
+
+  z_stream strm{};
+  if (::inflateInit2(&strm, automatic_header) != Z_OK) {
+    throw std::runtime_error{"Could not initialize the gzip decoder"};
+  }
+
+  std::vector<inflate_checkpoint> retval;
+  std::array<char, chunk> in_buf{};
+  std::array<uint8_t, chunk> out_buf{};
+  std::vector<uint8_t> window;
+  uint64_t total_in = 0;
+  uint64_t total_out = 0;
+  int ret = Z_OK;
+  while (ret != Z_STREAM_END) {
+    file.read(std::data(in_buf), std::size(in_buf));
+    strm.next_in = reinterpret_cast<Bytef*>(std::data(in_buf));
+    strm.avail_in = static_cast<uInt>(file.gcount());
+    if (strm.avail_in == 0) {
+      ::inflateEnd(&strm);
+      throw std::runtime_error{"The gzip stream ends unexpectedly"};
+    }
+
+    while (strm.avail_in > 0 && ret != Z_STREAM_END) {
+      strm.next_out = std::data(out_buf);
+      strm.avail_out = static_cast<uInt>(std::size(out_buf));
+      auto avail_in = strm.avail_in;
+      ret = ::inflate(&strm, Z_BLOCK);
+      if (ret != Z_OK && ret != Z_STREAM_END) {
+        ::inflateEnd(&strm);
+        throw std::runtime_error{"The gzip stream is corrupt"};
+      }
+
+      auto produced = std::size(out_buf) - strm.avail_out;
+      total_in += avail_in - strm.avail_in;
+      total_out += produced;
+      window.insert(std::end(window), std::begin(out_buf), std::next(std::begin(out_buf), static_cast<std::ptrdiff_t>(produced)));
+      if (std::size(window) > window_size) {
+        window.erase(std::begin(window), std::next(std::begin(window), static_cast<std::ptrdiff_t>(std::size(window) - window_size)));
+      }
+
+      bool at_block_boundary = (strm.data_type & end_of_block) && !(strm.data_type & last_block);
+      if (at_block_boundary && (std::empty(retval) || total_out - retval.back().decompressed_offset >= span)) {
+        retval.push_back({total_out, total_in, static_cast<uint8_t>(strm.data_type & 7), window});
+      }
+    }
+  }
+
+  ::inflateEnd(&strm);
+  return retval;
+}
+
+// An xz stream is checkpointed at the beginning of each of its blocks, which are listed in the index at the end of the stream
+inline std::vector<inflate_checkpoint> xz_checkpoints(std::istream& file, uint64_t file_size)
+{
+  std::array<uint8_t, LZMA_STREAM_HEADER_SIZE> footer_bytes{};
+  file.seekg(-static_cast<std::streamoff>(std::size(footer_bytes)), std::ios::end);
+  file.read(reinterpret_cast<char*>(std::data(footer_bytes)), std::size(footer_bytes));
+  lzma_stream_flags footer{};
+  if (!file || ::lzma_stream_footer_decode(&footer, std::data(footer_bytes)) != LZMA_OK) {
+    throw std::runtime_error{"The xz stream does not end with a stream footer"};
+  }
+
+  std::vector<uint8_t> index_bytes(footer.backward_size);
+  file.seekg(-static_cast<std::streamoff>(std::size(footer_bytes) + std::size(index_bytes)), std::ios::end);
+  file.read(reinterpret_cast<char*>(std::data(index_bytes)), static_cast<std::streamsize>(std::size(index_bytes)));
+
+  lzma_index* index = nullptr;
+  uint64_t memlimit = std::numeric_limits<uint64_t>::max();
+  std::size_t position = 0;
+  if (!file || ::lzma_index_buffer_decode(&index, &memlimit, nullptr, std::data(index_bytes), &position, std::size(index_bytes)) != LZMA_OK) {
+    throw std::runtime_error{"The index of the xz stream is corrupt"};
+  }
+
+  if (::lzma_index_file_size(index) != file_size) {
+    ::lzma_index_end(index, nullptr);
+    throw std::runtime_error{"Only xz files that hold a single stream can be indexed"};
+  }
+
+  std::vector<inflate_checkpoint> retval;
+  lzma_index_iter iter;
+  ::lzma_index_iter_init(&iter, index);
+  while (!::lzma_index_iter_next(&iter, LZMA_INDEX_ITER_BLOCK)) {
+    retval.push_back({iter.block.uncompressed_file_offset, iter.block.compressed_file_offset});
+  }
+  ::lzma_index_end(index, nullptr);
+  return retval;
+}
+
+// A Zstandard stream is checkpointed at the beginning of each of the frames in its seek table
+inline std::vector<inflate_checkpoint> zstd_checkpoints(std::istream& file)
+{
+  auto table = zstd_seek_table::read(file);
+  if (!table.has_value()) {
+    throw std::runtime_error{"The Zstandard stream has no seek table. Compress it again with ChampSim's tools to index it."};
+  }
+
+  std::vector<inflate_checkpoint> retval;
+  for (const auto& frame : table->frames) {
+    retval.push_back({frame.decompressed_offset, frame.compressed_offset});
+  }
+  return retval;
+}
+
+// Find the block boundaries of a columnar trace, without decoding the columns
+template <typename F>
+std::vector<trace_index::block> columnar_blocks(F&& stream)
+{
+  std::array<uint8_t, columnar::header_size> file_header{};
+  stream.read(reinterpret_cast<char*>(std::data(file_header)), std::size(file_header));
+  if (stream.gcount() != static_cast<std::streamsize>(std::size(file_header))
+      || !std::equal(std::begin(columnar::magic), std::end(columnar::magic), std::begin(file_header))) {
+    throw std::runtime_error{"The trace is not in the columnar format"};
+  }
+
+  std::vector<trace_index::block> retval;
+  trace_index::block next{0, columnar::header_size};
+  std::array<uint8_t, columnar::block_header_size> block_header{};
+  std::vector<char> skipped(1 << 16);
+  while (stream.read(reinterpret_cast<char*>(std::data(block_header)), std::size(block_header)), stream.gcount() > 0) {
+    if (stream.gcount() != static_cast<std::streamsize>(std::size(block_header))) {
+      throw std::runtime_error{"The columnar trace ends in the middle of a block"};
+    }
+    retval.push_back(next);
+
+    auto [count, size] = columnar::block_size(block_header);
+    next.instruction += count;
+    next.decompressed_offset += columnar::block_header_size + size;
+    while (size > 0) {
+      auto chunk = std::min(size, std::size(skipped));
+      stream.read(std::data(skipped), static_cast<std::streamsize>(chunk));
+      if (stream.gcount() != static_cast<std::streamsize>(chunk)) {
+        throw std::runtime_error{"The columnar trace ends in the middle of a block"};
+      }
+      size -= chunk;
+    }
+  }
+  return retval;
+}
+} // namespace detail
+
+/**
+ * Build the index of a trace. The compression of the trace is given by its extension, as when it is read.
+ * A gzip stream is checkpointed at most once in each span of this many decompressed bytes. Other compressed streams are checkpointed at the
+ * beginning of each block or frame, and uncompressed traces need no checkpoints.
+ *
+ * :throws std::runtime_error: If the trace cannot be indexed.
+ */
+inline trace_index build_trace_index(const std::string& trace_name, uint64_t span)
+{
+  auto ends_with = [](std::string_view str, std::string_view suffix) {
+    return std::size(str) >= std::size(suffix) && str.substr(std::size(str) - std::size(suffix)) == suffix;
+  };
+
+  std::ifstream file{trace_name, std::ios::binary};
+  if (!file) {
+    throw std::runtime_error{"Could not open " + trace_name};
+  }
+
+  trace_index retval;
+  retval.trace_size = std::filesystem::file_size(trace_name);
+  if (ends_with(trace_name, "gz")) {
+    retval.checkpoints = detail::gzip_checkpoints(file, span);
+  } else if (ends_with(trace_name, "xz")) {
+    retval.checkpoints = detail::xz_checkpoints(file, retval.trace_size);
+  } else if (ends_with(trace_name, "zst")) {
+    retval.checkpoints = detail::zstd_checkpoints(file);
+  } else if (ends_with(trace_name, "bz2")) {
+    throw std::runtime_error{"Traces compressed with bzip2 cannot be indexed"};
+  }
+
+  if (columnar::is_columnar_trace(trace_name)) {
+    if (ends_with(trace_name, "gz")) {
+      retval.blocks = detail::columnar_blocks(inf_istream<decomp_tags::gzip_tag_t<>>{trace_name});
+    } else if (ends_with(trace_name, "xz")) {
+      retval.blocks = detail::columnar_blocks(inf_istream<decomp_tags::lzma_tag_t<>>{trace_name});
+    } else if (ends_with(trace_name, "zst")) {
+      retval.blocks = detail::columnar_blocks(inf_istream<decomp_tags::zstd_tag_t<>>{trace_name});
+    } else {
+      retval.blocks = detail::columnar_blocks(std::ifstream{trace_name, std::ios::binary});
+    }
+  }
+
+  return retval;
+}
+} // namespace champsim
+
+#endif
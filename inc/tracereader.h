@@ -17,25 +17,36 @@
 #ifndef TRACEREADER_H
 #define TRACEREADER_H
 
+#include <algorithm>
 #include <cstring>
 #include <deque>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <type_traits>
+#include <vector>
 
+#include "columnar_trace.h"
+#include "dictionary_trace.h"
 #include "instruction.h"
+#include "mmap_file.h"
+#include "trace_index.h"
 #include "util/detect.h"
 
 namespace champsim
 {
 class tracereader
 {
-  static uint64_t instr_unique_id; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+  // Each reader numbers its records from its own range of ids, so that the ids that a core sees do not depend on when the other cores read
+  static constexpr unsigned instr_id_range_bits = 48;
+  static uint64_t readers_constructed; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
   struct reader_concept {
     virtual ~reader_concept() = default;
     virtual ooo_model_instr operator()() = 0;
     [[nodiscard]] virtual bool eof() const = 0;
+    virtual void pause() = 0;
+    virtual uint64_t seek(uint64_t current, uint64_t target) = 0;
   };
 
   template <typename T>
@@ -46,6 +57,12 @@ class tracereader
     template <typename U>
     using has_eof = decltype(std::declval<U>().eof());
 
+    template <typename U>
+    using has_pause = decltype(std::declval<U>().pause());
+
+    template <typename U>
+    using has_seek = decltype(std::declval<U>().seek(uint64_t{}, uint64_t{}));
+
     ooo_model_instr operator()() override { return intern_(); }
     [[nodiscard]] bool eof() const override
     {
@@ -54,24 +71,67 @@ class tracereader
       }
       return false; // If an eof() member function is not provided, assume the trace never ends.
     }
+
+    void pause() override
+    {
+      if constexpr (champsim::is_detected_v<has_pause, T>) {
+        intern_.pause();
+      }
+    }
+
+    uint64_t seek(uint64_t current, uint64_t target) override
+    {
+      if constexpr (champsim::is_detected_v<has_seek, T>) {
+        return intern_.seek(current, target);
+      }
+      return current; // If a seek() member function is not provided, the records must be read one at a time.
+    }
   };
 
   std::unique_ptr<reader_concept> pimpl_;
+  uint64_t records_read = 0;
+  uint64_t next_instr_id;
 
 public:
   template <typename T, std::enable_if_t<!std::is_same_v<tracereader, T>, bool> = true>
-  tracereader(T&& val) : pimpl_(std::make_unique<reader_model<T>>(std::forward<T>(val)))
+  tracereader(T&& val) : pimpl_(std::make_unique<reader_model<T>>(std::forward<T>(val))), next_instr_id(readers_constructed++ << instr_id_range_bits)
   {
   }
 
   auto operator()()
   {
     auto retval = (*pimpl_)();
-    retval.instr_id = instr_unique_id++;
+    retval.instr_id = next_instr_id++;
+    ++records_read;
     return retval;
   }
 
+  /**
+   * Discard records until the given number have been read from the trace, or until the trace ends.
+   * If the trace has an index, the reader moves to a point near the position without decoding the records before it.
+   */
+  void fast_forward(uint64_t position)
+  {
+    if (records_read < position) {
+      records_read = pimpl_->seek(records_read, position);
+    }
+    for (; records_read < position && !pimpl_->eof(); ++records_read) {
+      (*pimpl_)();
+    }
+  }
+
+  /**
+   * The number of records that have been read from the trace.
+   */
+  [[nodiscard]] uint64_t position() const { return records_read; }
+
   [[nodiscard]] auto eof() const { return pimpl_->eof(); }
+
+  /**
+   * Stop any thread that reads ahead of the simulation. Reading ahead resumes at the next read.
+   * Threads are not copied into a child process, so this must be called before the process forks.
+   */
+  void pause() { pimpl_->pause(); }
 };
 
 template <typename T, typename F>
@@ -83,18 +143,28 @@ class bulk_tracereader
   uint8_t cpu;
   bool eof_ = false;
   F trace_file;
+  std::string trace_name{};
 
   constexpr static std::size_t buffer_size = 128;
   constexpr static std::size_t refresh_thresh = 1;
   std::deque<ooo_model_instr> instr_buffer;
 
+  void refill();
+
 public:
   ooo_model_instr operator()();
 
-  bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf) {}
+  bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf), trace_name(tf) {}
   bulk_tracereader(uint8_t cpu_idx, F&& file) : cpu(cpu_idx), trace_file(std::move(file)) {}
 
   [[nodiscard]] bool eof() const { return trace_file.eof() && std::size(instr_buffer) <= refresh_thresh; }
+
+  /**
+   * Move to the target instruction, if the trace has an index with a checkpoint between the current position and the target.
+   *
+   * \return the position of the reader, which is unchanged if it did not move
+   */
+  uint64_t seek(uint64_t current, uint64_t target);
 };
 
 ooo_model_instr apply_branch_target(ooo_model_instr branch, const ooo_model_instr& target);
@@ -108,7 +178,7 @@ void set_branch_targets(It begin, It end)
 }
 
 template <typename T, typename F>
-ooo_model_instr bulk_tracereader<T, F>::operator()()
+void bulk_tracereader<T, F>::refill()
 {
   if (std::size(instr_buffer) <= refresh_thresh) {
     std::array<T, buffer_size - refresh_thresh> trace_read_buf;
@@ -126,21 +196,241 @@ ooo_model_instr bulk_tracereader<T, F>::operator()()
     // Inflate trace format into core model instructions
     auto begin = std::begin(trace_read_buf);
     auto end = std::next(begin, bytes_read / sizeof(T));
-    std::transform(begin, end, std::back_inserter(instr_buffer), [cpu = this->cpu](T t) { return ooo_model_instr{cpu, t}; });
+    ooo_model_instr::inflate(cpu, begin, end, std::back_inserter(instr_buffer));
 
     // Set branch targets
     set_branch_targets(std::begin(instr_buffer), std::end(instr_buffer));
   }
+}
 
+template <typename T, typename F>
+ooo_model_instr bulk_tracereader<T, F>::operator()()
+{
+  refill();
   auto retval = instr_buffer.front();
   instr_buffer.pop_front();
 
   return retval;
 }
 
+template <typename T, typename F>
+uint64_t bulk_tracereader<T, F>::seek(uint64_t current, uint64_t target)
+{
+  if constexpr (champsim::is_detected_v<has_checkpoint_seek, F>) {
+    auto index = std::empty(trace_name) ? std::nullopt : trace_index::load(trace_name);
+    const auto* point = index.has_value() ? index->checkpoint_before(target * sizeof(T)) : nullptr;
+    if (point != nullptr && point->decompressed_offset > current * sizeof(T)) {
+      trace_file.seek(*point, target * sizeof(T));
+      instr_buffer.clear();
+      refill();
+      if (!eof()) {
+        return target;
+      }
+
+      // The target is at or beyond the last record, so begin at the first record after the checkpoint, and let the rest be read one at a time
+      auto first = (point->decompressed_offset + sizeof(T) - 1) / sizeof(T);
+      trace_file.seek(*point, first * sizeof(T));
+      instr_buffer.clear();
+      return first;
+    }
+  }
+  return current;
+}
+
+/**
+ * Reads an uncompressed trace in place from a mapping of the file, without copying it into intermediate buffers.
+ * Like the other readers, this reader ends before the final record, since the branch target of that record is not known.
+ */
+template <typename T>
+class bulk_tracereader<T, mmap_file>
+{
+  static_assert(std::is_trivial_v<T>);
+  static_assert(std::is_standard_layout_v<T>);
+
+  uint8_t cpu;
+  mmap_file trace_file;
+  std::size_t next_record = 0;
+
+  [[nodiscard]] std::size_t num_records() const { return trace_file.size() / sizeof(T); }
+
+  [[nodiscard]] T record(std::size_t index) const
+  {
+    T retval;
+    std::memcpy(&retval, std::next(trace_file.data(), static_cast<std::ptrdiff_t>(index * sizeof(T))), sizeof(T));
+    return retval;
+  }
+
+public:
+  bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf) {}
+  bulk_tracereader(uint8_t cpu_idx, mmap_file&& file) : cpu(cpu_idx), trace_file(std::move(file)) {}
+
+  ooo_model_instr operator()()
+  {
+    auto retval = ooo_model_instr::inflate(cpu, record(next_record));
+    ++next_record;
+
+    if (retval.is_branch && retval.branch_taken && next_record < num_records()) {
+      retval.branch_target = champsim::address{record(next_record).ip};
+    }
+    return retval;
+  }
+
+  [[nodiscard]] bool eof() const { return next_record + 1 >= num_records(); }
+
+  uint64_t seek(uint64_t current, uint64_t target)
+  {
+    // The last record cannot be read, so a target at or beyond it is left to be read one at a time
+    if (target <= current || target + 1 >= num_records()) {
+      return current;
+    }
+    next_record = target;
+    return target;
+  }
+};
+
+/**
+ * Reads a trace in the columnar format, one block at a time, from a stream of type F.
+ * Like the other readers, this reader ends before the final record, since the branch target of that record is not known.
+ */
+template <typename T, typename F>
+class bulk_tracereader<T, columnar_istream<F>>
+{
+  static_assert(std::is_trivial_v<T>);
+  static_assert(std::is_standard_layout_v<T>);
+
+  uint8_t cpu;
+  columnar_istream<F> trace_file;
+  std::string trace_name{};
+  std::vector<T> records{};
+  std::size_t next_record = 0;
+  bool more_blocks = true;
+
+  // Keep the record after the next one, since it holds the branch target of the next one
+  void refill()
+  {
+    while (more_blocks && next_record + 1 >= std::size(records)) {
+      records.erase(std::begin(records), std::next(std::begin(records), static_cast<std::ptrdiff_t>(next_record)));
+      next_record = 0;
+      more_blocks = trace_file.read_block(records);
+    }
+  }
+
+public:
+  bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf), trace_name(tf) { refill(); }
+  bulk_tracereader(uint8_t cpu_idx, columnar_istream<F>&& file) : cpu(cpu_idx), trace_file(std::move(file)) { refill(); }
+
+  ooo_model_instr operator()()
+  {
+    auto retval = ooo_model_instr::inflate(cpu, records.at(next_record));
+    ++next_record;
+
+    if (retval.is_branch && retval.branch_taken && next_record < std::size(records)) {
+      retval.branch_target = champsim::address{records[next_record].ip};
+    }
+
+    refill();
+    return retval;
+  }
+
+  [[nodiscard]] bool eof() const { return next_record + 1 >= std::size(records); }
+
+  /**
+   * Move to the last block that begins at or before the target instruction, if the trace has an index and the block is after the current position.
+   *
+   * \return the position of the reader, which is unchanged if it did not move
+   */
+  uint64_t seek(uint64_t current, uint64_t target)
+  {
+    auto index = std::empty(trace_name) ? std::nullopt : trace_index::load(trace_name);
+    const auto* block = index.has_value() ? index->block_before(target) : nullptr;
+    if (block == nullptr || block->instruction <= current || !trace_file.seek(*index, block->decompressed_offset)) {
+      return current;
+    }
+
+    records.clear();
+    next_record = 0;
+    more_blocks = true;
+    refill();
+    return block->instruction;
+  }
+};
+
+/**
+ * Reads a trace in the dictionary format, one block at a time, from a stream of type F.
+ * Each static instruction is classified once, when it is first defined, and its executions are copied from it.
+ * Like the other readers, this reader ends before the final record, since the branch target of that record is not known.
+ */
+template <typename T, typename F>
+class bulk_tracereader<T, dictionary_istream<F>>
+{
+  static_assert(std::is_trivial_v<T>);
+  static_assert(std::is_standard_layout_v<T>);
+
+  uint8_t cpu;
+  dictionary_istream<F> trace_file;
+  dictionary::decoder<T> decoder{};
+  std::vector<ooo_model_instr> static_instrs{};
+  std::vector<dictionary::instance<T>> instances{};
+  std::size_t next_instance = 0;
+  bool more_blocks = true;
+
+  // Keep the instruction after the next one, since it holds the branch target of the next one
+  void refill()
+  {
+    while (more_blocks && next_instance + 1 >= std::size(instances)) {
+      instances.erase(std::begin(instances), std::next(std::begin(instances), static_cast<std::ptrdiff_t>(next_instance)));
+      next_instance = 0;
+      more_blocks = trace_file.read_block(decoder, instances);
+    }
+
+    const auto& table = decoder.static_instructions();
+    ooo_model_instr::inflate(cpu, std::next(std::begin(table), static_cast<std::ptrdiff_t>(std::size(static_instrs))), std::end(table),
+                             std::back_inserter(static_instrs));
+  }
+
+public:
+  bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf) { refill(); }
+  bulk_tracereader(uint8_t cpu_idx, dictionary_istream<F>&& file) : cpu(cpu_idx), trace_file(std::move(file)) { refill(); }
+
+  ooo_model_instr operator()()
+  {
+    const auto& inst = instances.at(next_instance);
+    auto retval = static_instrs.at(inst.index);
+    if (retval.branch == BRANCH_CONDITIONAL || retval.branch == BRANCH_OTHER) {
+      retval.branch_taken = inst.branch_taken;
+    }
+
+    auto [num_dmem, num_smem] = decoder.memory_count(inst.index);
+    auto dmem_end = std::next(std::begin(inst.memory), static_cast<std::ptrdiff_t>(num_dmem));
+    std::transform(std::begin(inst.memory), dmem_end, std::back_inserter(retval.destination_memory), [](auto x) { return champsim::address{x}; });
+    std::transform(dmem_end, std::next(dmem_end, static_cast<std::ptrdiff_t>(num_smem)), std::back_inserter(retval.source_memory),
+                   [](auto x) { return champsim::address{x}; });
+
+    if constexpr (dictionary::record_layout<T>::asid) {
+      retval.asid = {inst.asid[0], inst.asid[1]};
+    }
+
+    ++next_instance;
+    if (retval.is_branch && retval.branch_taken && next_instance < std::size(instances)) {
+      retval.branch_target = static_instrs.at(instances[next_instance].index).ip;
+    }
+
+    refill();
+    return retval;
+  }
+
+  [[nodiscard]] bool eof() const { return next_instance + 1 >= std::size(instances); }
+};
+
 std::string get_fptr_cmd(std::string_view fname);
 } // namespace champsim
 
 champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat);
 
+/**
+ * Get a reader for the trace of each CPU. The CPUs that run the same trace share a single reader, so that the trace is decompressed and decoded
+ * once, and each of them reads it from its own position. The i-th of the CPUs that share a trace begins i * offset instructions into it.
+ */
+std::vector<champsim::tracereader> get_tracereaders(const std::vector<std::string>& fnames, bool is_cloudsuite, bool repeat, uint64_t offset);
+
 #endif
@@ -0,0 +1,240 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_CIRCULAR_BUFFER_H
+#define UTIL_CIRCULAR_BUFFER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * A first-in, first-out queue whose slots are allocated when it is constructed.
+ *
+ * Elements are added at the back and removed from the front, so removing them advances the head rather than moving the remaining elements.
+ * Each element keeps its position for as long as it is in the buffer, and iterators remain valid until the element they refer to is removed.
+ * The capacity is rounded up to a power of two. A buffer that is filled beyond it grows, but a pipeline that checks its configured size never does so.
+ */
+template <typename T>
+class circular_buffer
+{
+  std::vector<std::optional<T>> slots;
+  std::size_t mask;
+  std::size_t head = 0; // The position of the front element. Positions increase without wrapping; the slot is the position modulo the capacity.
+  std::size_t tail = 0; // The position one past the back element
+
+  static std::size_t round_capacity(std::size_t capacity)
+  {
+    std::size_t retval = 1;
+    while (retval < capacity) {
+      retval <<= 1;
+    }
+    return retval;
+  }
+
+  void grow()
+  {
+    std::vector<std::optional<T>> new_slots(2 * std::size(slots));
+    auto new_mask = std::size(new_slots) - 1;
+    for (auto pos = head; pos != tail; ++pos) {
+      new_slots[pos & new_mask] = std::move(slots[pos & mask]);
+    }
+    slots.swap(new_slots);
+    mask = new_mask;
+  }
+
+  template <bool Const>
+  class basic_iterator
+  {
+    using buffer_type = std::conditional_t<Const, const circular_buffer, circular_buffer>;
+    buffer_type* buffer = nullptr;
+    std::size_t pos = 0;
+
+    friend class circular_buffer;
+    friend class basic_iterator<!Const>;
+
+    basic_iterator(buffer_type* buf, std::size_t position) : buffer(buf), pos(position) {}
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    basic_iterator() = default;
+
+    template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+    basic_iterator(const basic_iterator<OtherConst>& other) : buffer(other.buffer), pos(other.pos) // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    reference operator*() const { return *buffer->slots[pos & buffer->mask]; }
+    pointer operator->() const { return &(operator*()); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    basic_iterator& operator++()
+    {
+      ++pos;
+      return *this;
+    }
+    basic_iterator operator++(int)
+    {
+      auto retval = *this;
+      ++pos;
+      return retval;
+    }
+    basic_iterator& operator--()
+    {
+      --pos;
+      return *this;
+    }
+    basic_iterator operator--(int)
+    {
+      auto retval = *this;
+      --pos;
+      return retval;
+    }
+
+    basic_iterator& operator+=(difference_type n)
+    {
+      pos += static_cast<std::size_t>(n);
+      return *this;
+    }
+    basic_iterator& operator-=(difference_type n)
+    {
+      pos -= static_cast<std::size_t>(n);
+      return *this;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) { return static_cast<difference_type>(lhs.pos - rhs.pos); }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) { return lhs.pos == rhs.pos; }
+    friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) { return !(lhs == rhs); }
+    friend bool operator<(const basic_iterator& lhs, const basic_iterator& rhs) { return (lhs - rhs) < 0; }
+    friend bool operator>(const basic_iterator& lhs, const basic_iterator& rhs) { return rhs < lhs; }
+    friend bool operator<=(const basic_iterator& lhs, const basic_iterator& rhs) { return !(rhs < lhs); }
+    friend bool operator>=(const basic_iterator& lhs, const basic_iterator& rhs) { return !(lhs < rhs); }
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  explicit circular_buffer(std::size_t capacity) : slots(round_capacity(capacity)), mask(std::size(slots) - 1) {}
+
+  [[nodiscard]] iterator begin() { return iterator{this, head}; }
+  [[nodiscard]] const_iterator begin() const { return const_iterator{this, head}; }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] iterator end() { return iterator{this, tail}; }
+  [[nodiscard]] const_iterator end() const { return const_iterator{this, tail}; }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+
+  [[nodiscard]] size_type size() const { return tail - head; }
+  [[nodiscard]] bool empty() const { return head == tail; }
+  [[nodiscard]] bool full() const { return size() == capacity(); }
+  [[nodiscard]] size_type capacity() const { return std::size(slots); }
+
+  reference operator[](size_type n) { return *slots[(head + n) & mask]; }
+  const_reference operator[](size_type n) const { return *slots[(head + n) & mask]; }
+
+  reference at(size_type n)
+  {
+    if (n >= size()) {
+      throw std::out_of_range{"circular_buffer::at"};
+    }
+    return (*this)[n];
+  }
+
+  [[nodiscard]] const_reference at(size_type n) const
+  {
+    if (n >= size()) {
+      throw std::out_of_range{"circular_buffer::at"};
+    }
+    return (*this)[n];
+  }
+
+  reference front() { return (*this)[0]; }
+  const_reference front() const { return (*this)[0]; }
+  reference back() { return (*this)[size() - 1]; }
+  const_reference back() const { return (*this)[size() - 1]; }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    if (full()) {
+      grow();
+    }
+    auto& slot = slots[tail & mask];
+    slot.emplace(std::forward<Args>(args)...);
+    ++tail;
+    return *slot;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  /**
+   * Add the elements of a range to the back of the buffer. Elements may only be inserted at the end.
+   */
+  template <typename InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last)
+  {
+    assert(pos == cend());
+    auto retval = pos.pos;
+    std::for_each(first, last, [this](const auto& x) { this->push_back(x); });
+    return iterator{this, retval};
+  }
+
+  void pop_front()
+  {
+    assert(!empty());
+    slots[head & mask].reset();
+    ++head;
+  }
+
+  /**
+   * Remove elements from the buffer. Elements may only be removed from the front.
+   */
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    assert(first == cbegin());
+    assert(last <= cend());
+    while (head != last.pos) {
+      pop_front();
+    }
+    return begin();
+  }
+};
+} // namespace champsim
+
+#endif
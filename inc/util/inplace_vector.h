@@ -0,0 +1,145 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_INPLACE_VECTOR_H
+#define UTIL_INPLACE_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace champsim
+{
+/**
+ * A vector whose elements are stored inside the object, up to a fixed capacity, so that it never allocates.
+ * It is meant for the small, bounded lists of operands that each instruction carries.
+ */
+template <typename T, std::size_t N>
+class inplace_vector
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(N <= std::numeric_limits<uint8_t>::max());
+
+  std::array<T, N> storage{};
+  uint8_t count = 0;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  inplace_vector() = default;
+  inplace_vector(std::initializer_list<T> init)
+  {
+    assert(std::size(init) <= N);
+    count = static_cast<uint8_t>(std::size(init));
+    std::copy(std::begin(init), std::end(init), std::begin(storage));
+  }
+
+  [[nodiscard]] iterator begin() { return std::data(storage); }
+  [[nodiscard]] const_iterator begin() const { return std::data(storage); }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] iterator end() { return std::next(begin(), count); }
+  [[nodiscard]] const_iterator end() const { return std::next(begin(), count); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+
+  [[nodiscard]] pointer data() { return std::data(storage); }
+  [[nodiscard]] const_pointer data() const { return std::data(storage); }
+
+  [[nodiscard]] size_type size() const { return count; }
+  [[nodiscard]] bool empty() const { return count == 0; }
+  [[nodiscard]] static constexpr size_type capacity() { return N; }
+  [[nodiscard]] static constexpr size_type max_size() { return N; }
+
+  reference operator[](size_type pos) { return storage[pos]; }
+  const_reference operator[](size_type pos) const { return storage[pos]; }
+
+  reference at(size_type pos)
+  {
+    if (pos >= count) {
+      throw std::out_of_range{"inplace_vector::at"};
+    }
+    return storage[pos];
+  }
+
+  [[nodiscard]] const_reference at(size_type pos) const
+  {
+    if (pos >= count) {
+      throw std::out_of_range{"inplace_vector::at"};
+    }
+    return storage[pos];
+  }
+
+  reference front() { return storage[0]; }
+  const_reference front() const { return storage[0]; }
+  reference back() { return storage[count - 1]; }
+  const_reference back() const { return storage[count - 1]; }
+
+  void push_back(const T& value)
+  {
+    assert(count < N);
+    storage[count++] = value;
+  }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    assert(count < N);
+    storage[count] = T{std::forward<Args>(args)...};
+    return storage[count++];
+  }
+
+  void pop_back()
+  {
+    assert(count > 0);
+    --count;
+  }
+
+  void clear() { count = 0; }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    auto dest = std::next(begin(), std::distance(cbegin(), first));
+    auto removed = std::distance(first, last);
+    std::copy(last, cend(), dest);
+    count = static_cast<uint8_t>(count - removed);
+    return dest;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  friend bool operator==(const inplace_vector& lhs, const inplace_vector& rhs)
+  {
+    return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+  }
+  friend bool operator!=(const inplace_vector& lhs, const inplace_vector& rhs) { return !(lhs == rhs); }
+};
+} // namespace champsim
+
+#endif
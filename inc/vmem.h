@@ -19,9 +19,12 @@
 
 #include <cstdint>
 #include <deque>
+#include <iosfwd>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <random>
+#include <vector>
 
 #include "address.h"
 #include "champsim.h"
@@ -45,18 +48,25 @@ public:
   const pte_entry pte_page_size; // Size of a PTE page
 
 private:
-  std::deque<champsim::page_number> ppage_free_list;
-  champsim::page_number active_pte_page{};
-  champsim::address_slice<champsim::dynamic_extent> next_pte_page;
+  struct page_pool {
+    std::deque<champsim::page_number> ppage_free_list;
+    champsim::page_number active_pte_page{};
+    champsim::address_slice<champsim::dynamic_extent> next_pte_page;
+  };
+
+  std::vector<page_pool> pools;
+  std::mutex allocation_mutex;
 
   // champsim::page_number next_ppage;
   // champsim::page_number last_ppage;
 
-  [[nodiscard]] champsim::page_number ppage_front() const;
-  void ppage_pop();
+  [[nodiscard]] page_pool make_pool() const;
+  [[nodiscard]] page_pool& pool_for(uint32_t cpu_num);
+  [[nodiscard]] static champsim::page_number ppage_front(const page_pool& pool);
+  void ppage_pop(page_pool& pool);
 
-  void shuffle_pages();
-  void populate_pages();
+  void shuffle_pages(std::deque<champsim::page_number>& free_list) const;
+  void populate_pages(std::deque<champsim::page_number>& free_list) const;
 
 public:
   /**
@@ -96,6 +106,15 @@ public:
    */
   [[nodiscard]] std::size_t available_ppages() const;
 
+  /**
+   * Divide the unallocated physical pages between the given number of pools, each serving the address spaces of the cpus with the same index modulo
+   * the number of pools. The pages given to one address space then do not depend on the order in which other address spaces fault.
+   * This has no effect if the pages are already divided this way.
+   *
+   * :param num_pools: The number of pools. Typically, this is the number of cpus.
+   */
+  void partition_pages(std::size_t num_pools);
+
   /**
    * Translate the given address from the virtual space to the physical space.
    * If a page translation does not already exist, one will be created and the minor fault penalty will be applied.
@@ -118,6 +137,12 @@ public:
    * :returns: A pair of the page table page address and the latency to be applied to the operation.
    */
   std::pair<champsim::address, champsim::chrono::clock::duration> get_pte_pa(uint32_t cpu_num, champsim::page_number vaddr, std::size_t level);
+
+  /**
+   * Write the page tables and the unallocated physical pages to a checkpoint, or restore them from one.
+   */
+  void checkpoint_save(std::ostream& os) const;
+  void checkpoint_load(std::istream& is);
 };
 
 #endif
@@ -1,6 +1,7 @@
 #include "ip_stride.h"
 
 #include "cache.h"
+#include "msl/checkpoint.h"
 
 uint32_t ip_stride::prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
                                              uint32_t metadata_in)
@@ -16,8 +17,8 @@ uint32_t ip_stride::prefetcher_cache_operate(champsim::address addr, champsim::a
 
     // Initialize prefetch state unless we somehow saw the same address twice in
     // a row or if this is the first time we've seen this stride
-    if (stride != 0 && stride == found->last_stride)
-      active_lookahead = {champsim::address{cl_addr}, stride, PREFETCH_DEGREE};
+    if (stride != 0 && stride == found->last_stride && prefetch_degree.value() > 0)
+      active_lookahead = {champsim::address{cl_addr}, stride, static_cast<int>(prefetch_degree.value())};
   }
 
   // update tracking set
@@ -57,3 +58,15 @@ uint32_t ip_stride::prefetcher_cache_fill(champsim::address addr, long set, long
 {
   return metadata_in;
 }
+
+void ip_stride::prefetcher_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, active_lookahead);
+  champsim::msl::checkpoint_save(os, table);
+}
+
+void ip_stride::prefetcher_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, active_lookahead);
+  champsim::msl::checkpoint_load(is, table);
+}
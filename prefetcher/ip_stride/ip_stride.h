@@ -2,10 +2,12 @@
 #define IP_STRIDE_H
 
 #include <cstdint>
+#include <iosfwd>
 #include <optional>
 
 #include "address.h"
 #include "champsim.h"
+#include "knob.h"
 #include "modules.h"
 #include "msl/lru_table.h"
 
@@ -37,6 +39,8 @@ struct ip_stride : public champsim::modules::prefetcher {
   constexpr static std::size_t TRACKER_WAYS = 4;
   constexpr static int PREFETCH_DEGREE = 3;
 
+  champsim::knob prefetch_degree{"ip_stride.degree", PREFETCH_DEGREE};
+
   std::optional<lookahead_entry> active_lookahead;
 
   champsim::msl::lru_table<tracker_entry> table{TRACKER_SETS, TRACKER_WAYS};
@@ -48,6 +52,8 @@ public:
                                     uint32_t metadata_in);
   uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in);
   void prefetcher_cycle_operate();
+  void prefetcher_checkpoint_save(std::ostream& os) const;
+  void prefetcher_checkpoint_load(std::istream& is);
 };
 
 #endif
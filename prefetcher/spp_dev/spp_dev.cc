@@ -3,6 +3,8 @@
 #include <cassert>
 #include <iostream>
 
+#include "msl/checkpoint.h"
+
 void spp_dev::prefetcher_initialize()
 {
   std::cout << "Initialize SIGNATURE TABLE" << std::endl;
@@ -556,3 +558,19 @@ uint32_t spp_dev::GLOBAL_REGISTER::check_entry(offset_type page_offset)
 
   return max_conf_way;
 }
+
+void spp_dev::prefetcher_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, ST);
+  champsim::msl::checkpoint_save(os, PT);
+  champsim::msl::checkpoint_save(os, FILTER);
+  champsim::msl::checkpoint_save(os, GHR);
+}
+
+void spp_dev::prefetcher_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, ST);
+  champsim::msl::checkpoint_load(is, PT);
+  champsim::msl::checkpoint_load(is, FILTER);
+  champsim::msl::checkpoint_load(is, GHR);
+}
@@ -2,6 +2,7 @@
 #define SPP_H
 
 #include <cstdint>
+#include <iosfwd>
 #include <vector>
 
 #include "cache.h"
@@ -55,6 +56,8 @@ struct spp_dev : public champsim::modules::prefetcher {
   void prefetcher_initialize();
   void prefetcher_cycle_operate();
   void prefetcher_final_stats();
+  void prefetcher_checkpoint_save(std::ostream& os) const;
+  void prefetcher_checkpoint_load(std::istream& is);
 
   enum FILTER_REQUEST { SPP_L2C_PREFETCH, SPP_LLC_PREFETCH, L2C_DEMAND, L2C_EVICT }; // Request type for prefetch filter
   static uint64_t get_hash(uint64_t key);
@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include "cache.h"
+#include "msl/checkpoint.h"
 
 template <typename T>
 auto va_ampm_lite::page_and_offset(T addr) -> std::pair<champsim::page_number, block_in_page>
@@ -44,7 +45,7 @@ uint32_t va_ampm_lite::prefetcher_cache_operate(champsim::address addr, champsim
 
   // attempt to prefetch in the positive, then negative direction
   for (auto direction : {1, -1}) {
-    for (int i = 1, prefetches_issued = 0; i <= MAX_DISTANCE && prefetches_issued < PREFETCH_DEGREE; i++) {
+    for (int i = 1, prefetches_issued = 0; i <= MAX_DISTANCE && prefetches_issued < prefetch_degree.value(); i++) {
       const auto pos_step_addr = block_addr + (direction * i);
       const auto neg_step_addr = block_addr - (direction * i);
       const auto neg_2step_addr = block_addr - (direction * 2 * i);
@@ -80,3 +81,27 @@ uint32_t va_ampm_lite::prefetcher_cache_fill(champsim::address addr, long set, l
 {
   return metadata_in;
 }
+
+void va_ampm_lite::region_type::checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, vpn);
+  champsim::msl::checkpoint_save(os, access_map);
+  champsim::msl::checkpoint_save(os, prefetch_map);
+}
+
+void va_ampm_lite::region_type::checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, vpn);
+  champsim::msl::checkpoint_load(is, access_map);
+  champsim::msl::checkpoint_load(is, prefetch_map);
+}
+
+void va_ampm_lite::prefetcher_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, regions);
+}
+
+void va_ampm_lite::prefetcher_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, regions);
+}
@@ -4,9 +4,11 @@
 #include <array>
 #include <bitset>
 #include <cstdint>
+#include <iosfwd>
 #include <vector>
 
 #include "champsim.h"
+#include "knob.h"
 #include "modules.h"
 #include "msl/lru_table.h"
 
@@ -23,6 +25,8 @@ public:
   static constexpr int MAX_DISTANCE = 256;
   static constexpr int PREFETCH_DEGREE = 2;
 
+  champsim::knob prefetch_degree{"va_ampm_lite.degree", PREFETCH_DEGREE};
+
   struct region_type {
     champsim::page_number vpn;
     std::vector<bool> access_map{};
@@ -30,6 +34,9 @@ public:
 
     region_type() : region_type(champsim::page_number{}) {}
     explicit region_type(champsim::page_number allocate_vpn) : vpn(allocate_vpn), access_map(PAGE_SIZE / BLOCK_SIZE), prefetch_map(PAGE_SIZE / BLOCK_SIZE) {}
+
+    void checkpoint_save(std::ostream& os) const;
+    void checkpoint_load(std::istream& is);
   };
 
   using prefetcher::prefetcher;
@@ -51,6 +58,9 @@ public:
 
   // void prefetcher_cycle_operate() {}
   // void prefetcher_final_stats() {}
+
+  void prefetcher_checkpoint_save(std::ostream& os) const;
+  void prefetcher_checkpoint_load(std::istream& is);
 };
 
 #endif
@@ -29,13 +29,27 @@ void trace_encoder::write_single_instr(const input_instr &instr)
 void trace_encoder::flush_buffer()
 {
   if (!buffer.empty()) {
-    fwrite(buffer.data(), sizeof(input_instr), buffer.size(), trace_file);
+    if (zstd_file != nullptr) {
+      zstd_file->write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(input_instr)));
+    } else {
+      fwrite(buffer.data(), sizeof(input_instr), buffer.size(), trace_file);
+    }
     buffer.clear();
   }
 }
 
 void trace_encoder::open(std::string trace_string)
 {
+  // Zstandard traces are compressed in this process, in the seekable format
+  if (trace_string.size() >= 4 && trace_string.compare(trace_string.size() - 4, 4, ".zst") == 0) {
+    zstd_file = std::make_unique<champsim::inf_ostream<champsim::decomp_tags::zstd_tag_t<>>>(trace_string);
+    if (!zstd_file->good()) {
+      std::cerr << "*** CANNOT OPEN TRACE FILE FOR WRITING: " << trace_string << " ***" << std::endl;
+      assert(0);
+    }
+    return;
+  }
+
   char compress_command[4096];
   sprintf(compress_command, cmd_fmtstr.c_str(), comp_program.c_str(), trace_string.c_str());
   trace_file = popen(compress_command, "w");
@@ -47,6 +61,9 @@ void trace_encoder::open(std::string trace_string)
 
 void trace_encoder::close()
 {
+  if (zstd_file != nullptr) {
+    zstd_file->close();
+  }
   if (trace_file != nullptr) {
     pclose(trace_file);
   }
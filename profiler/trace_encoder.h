@@ -1,9 +1,13 @@
 #ifndef TRACE_ENCODER_H
 #define TRACE_ENCODER_H
 #include "trace-instruction.h"
+#include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "../inc/inf_stream.h"
+
 namespace clueless
 {
 class trace_encoder
@@ -19,6 +23,7 @@ private:
   void flush_buffer();
 
   FILE *trace_file = nullptr;
+  std::unique_ptr<champsim::inf_ostream<champsim::decomp_tags::zstd_tag_t<>>> zstd_file; // Used instead of trace_file for .zst traces
   std::string trace_string;
   std::string cmd_fmtstr;
   std::string comp_program;
@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "champsim.h"
+#include "msl/checkpoint.h"
 
 drrip::drrip(CACHE* cache) : replacement(cache), NUM_SET(cache->NUM_SET), NUM_WAY(cache->NUM_WAY), rrpv(static_cast<std::size_t>(NUM_SET * NUM_WAY))
 {
@@ -85,3 +86,17 @@ long drrip::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, co
   assert(victim < end);
   return std::distance(begin, victim); // cast protected by assertions
 }
+
+void drrip::replacement_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, bip_counter);
+  champsim::msl::checkpoint_save(os, PSEL);
+  champsim::msl::checkpoint_save(os, rrpv);
+}
+
+void drrip::replacement_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, bip_counter);
+  champsim::msl::checkpoint_load(is, PSEL);
+  champsim::msl::checkpoint_load(is, rrpv);
+}
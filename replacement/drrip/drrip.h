@@ -2,6 +2,7 @@
 #define REPLACEMENT_DRRIP_H
 
 #include <array>
+#include <iosfwd>
 #include <vector>
 
 #include "cache.h"
@@ -37,6 +38,9 @@ public:
   // use this function to print out your own stats at the end of simulation
   // void replacement_final_stats() {}
 
+  void replacement_checkpoint_save(std::ostream& os) const;
+  void replacement_checkpoint_load(std::istream& is);
+
   void update_bip(long set, long way);
   void update_srrip(long set, long way);
 };
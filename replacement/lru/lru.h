@@ -1,6 +1,7 @@
 #ifndef REPLACEMENT_LRU_H
 #define REPLACEMENT_LRU_H
 
+#include <iosfwd>
 #include <vector>
 
 #include "cache.h"
@@ -24,6 +25,9 @@ public:
   void update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
                                 access_type type, uint8_t hit);
   // void replacement_final_stats()
+
+  void replacement_checkpoint_save(std::ostream& os) const;
+  void replacement_checkpoint_load(std::istream& is);
 };
 
 #endif
@@ -1,5 +1,7 @@
 #include "random.h"
 
+#include "msl/checkpoint.h"
+
 random::random(CACHE* cache) : random(cache, cache->NUM_WAY) {}
 
 random::random(CACHE* cache, long ways) : replacement(cache), dist(0, ways - 1) {}
@@ -9,3 +11,13 @@ long random::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, c
 {
   return dist(rng);
 }
+
+void random::replacement_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, rng);
+}
+
+void random::replacement_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, rng);
+}
@@ -5,6 +5,7 @@
 #include <random>
 
 #include "champsim.h"
+#include "msl/checkpoint.h"
 
 // initialize replacement state
 ship::ship(CACHE* cache)
@@ -95,3 +96,19 @@ void ship::update_replacement_state(uint32_t triggering_cpu, long set, long way,
       get_rrpv(set, way) = maxRRPV;
   }
 }
+
+void ship::replacement_checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, access_count);
+  champsim::msl::checkpoint_save(os, sampler);
+  champsim::msl::checkpoint_save(os, rrpv_values);
+  champsim::msl::checkpoint_save(os, SHCT);
+}
+
+void ship::replacement_checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, access_count);
+  champsim::msl::checkpoint_load(is, sampler);
+  champsim::msl::checkpoint_load(is, rrpv_values);
+  champsim::msl::checkpoint_load(is, SHCT);
+}
@@ -2,6 +2,7 @@
 #define REPLACEMENT_SHIP_H
 
 #include <array>
+#include <iosfwd>
 #include <vector>
 
 #include "cache.h"
@@ -51,6 +52,9 @@ public:
 
   // use this function to print out your own stats at the end of simulation
   // void replacement_final_stats() {}
+
+  void replacement_checkpoint_save(std::ostream& os) const;
+  void replacement_checkpoint_load(std::istream& is);
 };
 
 #endif
@@ -5,6 +5,7 @@
 #include <unordered_map>
 
 #include "cache.h"
+#include "msl/checkpoint.h"
 
 srrip::srrip(CACHE* cache) : srrip(cache, cache->NUM_SET, cache->NUM_WAY) {}
 
@@ -44,3 +45,17 @@ long srrip_set_helper::victim()
 }
 
 void srrip_set_helper::update(long way, bool hit) { get_rrpv(way) = hit ? 0 : (maxRRPV - 1); }
+
+void srrip::replacement_checkpoint_save(std::ostream& os) const
+{
+  for (const auto& set : sets) {
+    champsim::msl::checkpoint_save(os, set.rrpv_values);
+  }
+}
+
+void srrip::replacement_checkpoint_load(std::istream& is)
+{
+  for (auto& set : sets) {
+    champsim::msl::checkpoint_load(is, set.rrpv_values);
+  }
+}
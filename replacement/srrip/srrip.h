@@ -2,6 +2,7 @@
 #define REPLACEMENT_SRRIP_H
 
 #include <cstdint>
+#include <iosfwd>
 #include <vector>
 
 #include "cache.h"
@@ -35,6 +36,9 @@ struct srrip : public champsim::modules::replacement {
 
   // use this function to print out your own stats at the end of simulation
   // void replacement_final_stats() {}
+
+  void replacement_checkpoint_save(std::ostream& os) const;
+  void replacement_checkpoint_load(std::istream& is);
 };
 
 #endif
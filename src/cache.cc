@@ -21,13 +21,16 @@
 #include <cmath>
 #include <iomanip>
 #include <numeric>
+#include <typeinfo>
 #include <fmt/core.h>
 
 #include "bandwidth.h"
 #include "champsim.h"
+#include "checkpoint.h"
 #include "chrono.h"
 #include "deadlock.h"
 #include "instruction.h"
+#include "msl/checkpoint.h"
 #include "util/algorithm.h"
 #include "util/bits.h"
 #include "util/span.h"
@@ -36,6 +39,7 @@ CACHE::CACHE(CACHE&& other)
     : operable(other),
 
       upper_levels(std::move(other.upper_levels)), lower_level(std::move(other.lower_level)), lower_translate(std::move(other.lower_translate)),
+      shadows(std::move(other.shadows)),
 
       cpu(other.cpu), NAME(std::move(other.NAME)), NUM_SET(other.NUM_SET), NUM_WAY(other.NUM_WAY), MSHR_SIZE(other.MSHR_SIZE), PQ_SIZE(other.PQ_SIZE),
       HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), block(std::move(other.block)), MAX_TAG(other.MAX_TAG),
@@ -59,6 +63,7 @@ auto CACHE::operator=(CACHE&& other) -> CACHE&
   this->upper_levels = std::move(other.upper_levels);
   this->lower_level = std::move(other.lower_level);
   this->lower_translate = std::move(other.lower_translate);
+  this->shadows = std::move(other.shadows);
 
   this->cpu = other.cpu;
   this->NAME = std::move(other.NAME);
@@ -107,7 +112,7 @@ CACHE::mshr_type::mshr_type(const tag_lookup_type& req, champsim::chrono::clock:
 CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type successor)
 {
   std::vector<uint64_t> merged_instr{};
-  std::vector<std::deque<response_type>*> merged_return{};
+  std::vector<channel_type*> merged_return{};
 
   std::set_union(std::begin(predecessor.instr_depend_on_me), std::end(predecessor.instr_depend_on_me), std::begin(successor.instr_depend_on_me),
                  std::end(successor.instr_depend_on_me), std::back_inserter(merged_instr));
@@ -234,6 +239,10 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
     *way = fill_block(fill_mshr, metadata_thru);
   }
 
+  for (auto* shadow : shadows) {
+    shadow->shadow_fill(fill_mshr);
+  }
+
   // COLLECT STATS
   if (fill_mshr.type != access_type::PREFETCH)
     sim_stats.total_miss_latency_cycles += (current_time - (fill_mshr.time_enqueued + clock_period)) / clock_period;
@@ -241,7 +250,7 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
 
   response_type response{fill_mshr.address, fill_mshr.v_address, fill_mshr.data_promise->data, metadata_thru, fill_mshr.instr_depend_on_me};
   for (auto* ret : fill_mshr.to_return) {
-    ret->push_back(response);
+    ret->add_returned(response);
   }
 
   return true;
@@ -278,7 +287,7 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 
     response_type response{handle_pkt.address, handle_pkt.v_address, way->data, metadata_thru, handle_pkt.instr_depend_on_me};
     for (auto* ret : handle_pkt.to_return) {
-      ret->push_back(response);
+      ret->add_returned(response);
     }
 
     way->dirty |= (handle_pkt.type == access_type::WRITE);
@@ -288,6 +297,8 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
       ++sim_stats.pf_useful;
       way->prefetch = false;
     }
+
+    update_shadows(handle_pkt, true);
   }
 
   return hit;
@@ -367,10 +378,38 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   }
 
   sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  update_shadows(handle_pkt, false);
 
   return true;
 }
 
+bool CACHE::handle_tag_miss(const tag_lookup_type& handle_pkt)
+{
+  if (handle_pkt.type == access_type::WRITE && !match_offset_bits) {
+    return handle_write(handle_pkt); // Treat writes (that is, writebacks) like fills
+  }
+  return handle_miss(handle_pkt); // Treat writes (that is, stores) like reads
+}
+
+bool CACHE::tag_check_blocked(const tag_lookup_type& handle_pkt) const
+{
+  auto [set_begin, set_end] = get_set_span(handle_pkt.address);
+  if (std::any_of(set_begin, set_end, [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); })) {
+    return false; // hit
+  }
+
+  if ((handle_pkt.type == access_type::WRITE && !match_offset_bits) || std::any_of(std::begin(MSHR), std::end(MSHR), matches_address(handle_pkt.address))) {
+    return false; // handled as a fill, or merged into an inflight miss
+  }
+
+  if (std::size(MSHR) == MSHR_SIZE) {
+    return true;
+  }
+
+  const bool send_to_rq = (prefetch_as_load || handle_pkt.type != access_type::PREFETCH);
+  return send_to_rq ? lower_level->rq_occupancy() >= lower_level->rq_size() : lower_level->pq_occupancy() >= lower_level->pq_size();
+}
+
 bool CACHE::handle_write(const tag_lookup_type& handle_pkt)
 {
   if constexpr (champsim::debug_print) {
@@ -384,10 +423,18 @@ bool CACHE::handle_write(const tag_lookup_type& handle_pkt)
   inflight_writes.push_back(to_allocate);
 
   sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  update_shadows(handle_pkt, false);
 
   return true;
 }
 
+champsim::bandwidth::maximum_type CACHE::tag_check_initiation_bandwidth() const
+{
+  const champsim::bandwidth::maximum_type bandwidth_from_tag_checks{champsim::to_underlying(MAX_TAG) * (long)(HIT_LATENCY / clock_period)
+                                                                    - (long)std::size(inflight_tag_check)};
+  return std::clamp(bandwidth_from_tag_checks, champsim::bandwidth::maximum_type{0}, MAX_TAG);
+}
+
 template <bool UpdateRequest>
 auto CACHE::initiate_tag_check(champsim::channel* ul)
 {
@@ -397,7 +444,7 @@ auto CACHE::initiate_tag_check(champsim::channel* ul)
 
     if constexpr (UpdateRequest) {
       if (entry.response_requested) {
-        retval.to_return = {&ul->returned};
+        retval.to_return = {ul};
       }
     } else {
       (void)ul; // supress warning about ul being unused
@@ -450,9 +497,7 @@ long CACHE::operate()
   }
 
   // Initiate tag checks
-  const champsim::bandwidth::maximum_type bandwidth_from_tag_checks{champsim::to_underlying(MAX_TAG) * (long)(HIT_LATENCY / clock_period)
-                                                                    - (long)std::size(inflight_tag_check)};
-  champsim::bandwidth initiate_tag_bw{std::clamp(bandwidth_from_tag_checks, champsim::bandwidth::maximum_type{0}, MAX_TAG)};
+  champsim::bandwidth initiate_tag_bw{tag_check_initiation_bandwidth()};
   auto can_translate = [avail = (std::size(translation_stash) < static_cast<std::size_t>(MSHR_SIZE))](const auto& entry) {
     return avail || entry.is_translated;
   };
@@ -480,6 +525,9 @@ long CACHE::operate()
           champsim::transform_while_n(q.get(), std::back_inserter(inflight_tag_check), per_upper_tag_bw, can_translate, initiate_tag_check<true>(ul));
       channels_bandwidth_consumed.push_back(bandwidth_consumed);
       initiate_tag_bw.consume(bandwidth_consumed);
+      if (bandwidth_consumed > 0) {
+        ul->notify_drained();
+      }
     }
   }
 
@@ -499,10 +547,7 @@ long CACHE::operate()
 
   // Perform tag checks
   auto do_handle_miss = [this](const auto& pkt) {
-    if (pkt.type == access_type::WRITE && !this->match_offset_bits) {
-      return this->handle_write(pkt); // Treat writes (that is, writebacks) like fills
-    }
-    return this->handle_miss(pkt); // Treat writes (that is, stores) like reads
+    return this->handle_tag_miss(pkt);
   };
   champsim::bandwidth tag_check_bw{MAX_TAG};
   auto [tag_check_ready_begin, tag_check_ready_end] =
@@ -525,6 +570,140 @@ long CACHE::operate()
   return progress + fill_bw.amount_consumed() + initiate_tag_bw.amount_consumed() + tag_check_bw.amount_consumed();
 }
 
+champsim::chrono::clock::time_point CACHE::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+
+  // Prefetchers with a cycle hook and returned packets need attention on the next cycle, as do requests that have not been checked for collisions
+  if (pref_module_pimpl->impl_prefetcher_operates_every_cycle() || !std::empty(lower_level->returned)
+      || (lower_translate != nullptr && !std::empty(lower_translate->returned))) {
+    return next_cycle;
+  }
+
+  auto has_unchecked = [](const auto* ul) {
+    auto unchecked = [](const auto& q) {
+      return std::any_of(std::begin(q), std::end(q), [](const auto& x) { return !x.forward_checked; });
+    };
+    return unchecked(ul->RQ) || unchecked(ul->WQ) || unchecked(ul->PQ);
+  };
+  if (std::any_of(std::begin(upper_levels), std::end(upper_levels), has_unchecked)) {
+    return next_cycle;
+  }
+
+  // Queued requests begin their tag checks while there is bandwidth to do so, unless they must wait for room in the translation stash
+  const bool can_initiate = champsim::to_underlying(tag_check_initiation_bandwidth()) > 0;
+  auto can_enter = [stash_avail = (std::size(translation_stash) < static_cast<std::size_t>(MSHR_SIZE))](const auto& q) {
+    return !std::empty(q) && (stash_avail || q.front().is_translated);
+  };
+  auto upper_can_enter = [can_enter](const auto* ul) {
+    return can_enter(ul->RQ) || can_enter(ul->WQ) || can_enter(ul->PQ);
+  };
+  if (can_initiate
+      && ((!std::empty(translation_stash) && translation_stash.front().is_translated) || can_enter(internal_PQ)
+          || std::any_of(std::begin(upper_levels), std::end(upper_levels), upper_can_enter))) {
+    return next_cycle;
+  }
+
+  // Translations are issued on every cycle until the lower level has room for them
+  auto needs_translation_issue = [](const auto& x) {
+    return !x.is_translated && !x.translate_issued;
+  };
+  const bool translation_blocked = lower_translate != nullptr && lower_translate->rq_occupancy() >= lower_translate->rq_size();
+  if (!translation_blocked
+      && (std::any_of(std::begin(translation_stash), std::end(translation_stash), needs_translation_issue)
+          || std::any_of(std::begin(inflight_tag_check), std::end(inflight_tag_check), needs_translation_issue))) {
+    return next_cycle;
+  }
+
+  // A tag check that is blocked is retried with the same result until a fill, or some other operable, frees the resource it waits for. Only a tag check
+  // that would finish is an event, and the checks beyond the tag bandwidth wait for the ones ahead of them. A prefetch issued by a retry could begin
+  // its tag check, though, so a retry that activates the prefetcher is treated as an event unless such a prefetch would have to wait.
+  const bool prefetch_could_enter = can_initiate && std::size(internal_PQ) < PQ_SIZE;
+  auto next_event = champsim::chrono::clock::time_point::max();
+  auto [check_begin, check_end] = champsim::get_span(std::cbegin(inflight_tag_check), std::cend(inflight_tag_check), champsim::bandwidth{MAX_TAG});
+  for (auto it = check_begin; it != check_end && it->is_translated; ++it) {
+    if (it->event_cycle > next_cycle) {
+      next_event = it->event_cycle;
+      break;
+    }
+    if (!tag_check_blocked(*it) || (prefetch_could_enter && should_activate_prefetcher(*it))) {
+      return next_cycle;
+    }
+  }
+
+  // Untranslated tag checks move to the stash once they are ready
+  for (const auto& entry : inflight_tag_check) {
+    if (!entry.is_translated) {
+      next_event = std::min(next_event, entry.event_cycle);
+    }
+  }
+  for (const auto& q : {std::cref(MSHR), std::cref(inflight_writes)}) {
+    for (const auto& entry : q.get()) {
+      next_event = std::min(next_event, entry.data_promise.ready_time());
+    }
+  }
+
+  return next_event;
+}
+
+void CACHE::retry_blocked()
+{
+  for (auto q : {std::ref(inflight_tag_check), std::ref(translation_stash)}) {
+    for (auto& entry : q.get()) {
+      [[maybe_unused]] const bool was_issued = entry.translate_issued;
+      issue_translation(entry);
+      assert(entry.translate_issued == was_issued);
+    }
+  }
+
+  auto [retry_begin, retry_end] = champsim::get_span_p(std::cbegin(inflight_tag_check), std::cend(inflight_tag_check), champsim::bandwidth{MAX_TAG},
+                                                       [time = current_time](const auto& x) { return x.event_cycle <= time && x.is_translated; });
+  std::for_each(retry_begin, retry_end, [this]([[maybe_unused]] const auto& pkt) {
+    [[maybe_unused]] const auto hit = this->try_hit(pkt);
+    assert(!hit);
+  });
+  std::for_each(retry_begin, retry_end, [this]([[maybe_unused]] const auto& pkt) {
+    [[maybe_unused]] const auto finished = this->handle_tag_miss(pkt);
+    assert(!finished);
+  });
+}
+
+void CACHE::idle(long cycles)
+{
+  sim_stats.skipped_operates += static_cast<uint64_t>(cycles);
+
+  // Each call to operate() rotates the priority of the upper levels
+  if (std::size(upper_levels) > 1) {
+    std::rotate(upper_levels.begin(), std::next(upper_levels.begin(), cycles % static_cast<long>(std::size(upper_levels))), upper_levels.end());
+  }
+
+  // Each call to operate() also repeats the attempts of the blocked tag checks and translations, which call the module hooks and count as accesses to
+  // the lower levels
+  auto needs_translation_issue = [](const auto& x) {
+    return !x.is_translated && !x.translate_issued;
+  };
+  auto is_retried = [time = current_time](const auto& x) {
+    return x.is_translated && x.event_cycle <= time;
+  };
+  const bool has_retries = (!std::empty(inflight_tag_check) && is_retried(inflight_tag_check.front()))
+                           || std::any_of(std::begin(translation_stash), std::end(translation_stash), needs_translation_issue)
+                           || std::any_of(std::begin(inflight_tag_check), std::end(inflight_tag_check), needs_translation_issue);
+  for (long i = 0; has_retries && i < cycles; ++i) {
+    retry_blocked();
+  }
+}
+
+std::vector<champsim::channel*> CACHE::lower_channels() const
+{
+  std::vector<champsim::channel*> retval;
+  for (auto* ll : {lower_level, lower_translate}) {
+    if (ll != nullptr) {
+      retval.push_back(ll);
+    }
+  }
+  return retval;
+}
+
 // LCOV_EXCL_START exclude deprecated function
 uint64_t CACHE::get_set(uint64_t address) const { return static_cast<uint64_t>(get_set_index(champsim::address{address})); }
 // LCOV_EXCL_STOP
@@ -590,6 +769,7 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
   pf_packet.is_translated = !virtual_prefetch;
 
   internal_PQ.emplace_back(pf_packet, true, !fill_this_level);
+  wake();
   ++sim_stats.pf_issued;
 
   return true;
@@ -661,25 +841,30 @@ void CACHE::finish_translation(const response_type& packet)
   }
 }
 
+auto CACHE::translation_request(const tag_lookup_type& q_entry) -> request_type
+{
+  request_type fwd_pkt;
+  fwd_pkt.asid[0] = q_entry.asid[0];
+  fwd_pkt.asid[1] = q_entry.asid[1];
+  fwd_pkt.type = access_type::LOAD;
+  fwd_pkt.cpu = q_entry.cpu;
+
+  fwd_pkt.address = q_entry.address;
+  fwd_pkt.v_address = q_entry.v_address;
+  fwd_pkt.data = q_entry.data;
+  fwd_pkt.instr_id = q_entry.instr_id;
+  fwd_pkt.ip = q_entry.ip;
+
+  fwd_pkt.instr_depend_on_me = q_entry.instr_depend_on_me;
+  fwd_pkt.is_translated = true;
+
+  return fwd_pkt;
+}
+
 void CACHE::issue_translation(tag_lookup_type& q_entry) const
 {
   if (!q_entry.translate_issued && !q_entry.is_translated) {
-    request_type fwd_pkt;
-    fwd_pkt.asid[0] = q_entry.asid[0];
-    fwd_pkt.asid[1] = q_entry.asid[1];
-    fwd_pkt.type = access_type::LOAD;
-    fwd_pkt.cpu = q_entry.cpu;
-
-    fwd_pkt.address = q_entry.address;
-    fwd_pkt.v_address = q_entry.v_address;
-    fwd_pkt.data = q_entry.data;
-    fwd_pkt.instr_id = q_entry.instr_id;
-    fwd_pkt.ip = q_entry.ip;
-
-    fwd_pkt.instr_depend_on_me = q_entry.instr_depend_on_me;
-    fwd_pkt.is_translated = true;
-
-    q_entry.translate_issued = lower_translate->add_rq(fwd_pkt);
+    q_entry.translate_issued = lower_translate->add_rq(translation_request(q_entry));
     if constexpr (champsim::debug_print) {
       if (q_entry.translate_issued) {
         fmt::print("[TRANSLATE] do_issue_translation instr_id: {} paddr: {} vaddr: {} type: {}\n", q_entry.instr_id, q_entry.address, q_entry.v_address,
@@ -689,6 +874,205 @@ void CACHE::issue_translation(tag_lookup_type& q_entry) const
   }
 }
 
+champsim::address CACHE::functional_access(const request_type& packet)
+{
+  auto data = functional_tag_check(tag_lookup_type{packet});
+
+  // Prefetches issued by the prefetcher during the access are handled in the same way
+  while (!std::empty(internal_PQ)) {
+    auto pf_packet = internal_PQ.front();
+    internal_PQ.pop_front();
+    functional_tag_check(pf_packet);
+  }
+
+  return data;
+}
+
+champsim::address CACHE::functional_tag_check(tag_lookup_type handle_pkt)
+{
+  cpu = handle_pkt.cpu;
+
+  if (!handle_pkt.is_translated) {
+    auto p_page = champsim::page_number{lower_translate->functional_access(translation_request(handle_pkt))};
+    handle_pkt.address = champsim::address{champsim::splice(p_page, champsim::page_offset{handle_pkt.v_address})};
+    handle_pkt.is_translated = true;
+  }
+
+  auto [set_begin, set_end] = get_set_span(handle_pkt.address);
+  auto way = std::find_if(set_begin, set_end, [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); });
+  const auto hit = (way != set_end);
+  const auto useful_prefetch = (hit && way->prefetch && !handle_pkt.prefetch_from_this);
+
+  if constexpr (champsim::debug_print) {
+    fmt::print("[{}] {} instr_id: {} address: {} v_address: {} set: {} way: {} ({}) type: {}\n", NAME, __func__, handle_pkt.instr_id, handle_pkt.address,
+               handle_pkt.v_address, get_set_index(handle_pkt.address), std::distance(set_begin, way), hit ? "HIT" : "MISS",
+               access_type_names.at(champsim::to_underlying(handle_pkt.type)));
+  }
+
+  // Only the data is returned to the upper level, so the metadata from the prefetcher is not passed on
+  if (should_activate_prefetcher(handle_pkt)) {
+    (void)impl_prefetcher_cache_operate(module_address(handle_pkt), handle_pkt.ip, hit, useful_prefetch, handle_pkt.type, handle_pkt.pf_metadata);
+  }
+
+  const auto way_idx = std::distance(set_begin, way);
+  impl_update_replacement_state(handle_pkt.cpu, get_set_index(handle_pkt.address), way_idx, module_address(handle_pkt), handle_pkt.ip, {}, handle_pkt.type,
+                                hit);
+
+  if (hit) {
+    sim_stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+    way->dirty |= (handle_pkt.type == access_type::WRITE);
+    if (useful_prefetch) {
+      ++sim_stats.pf_useful;
+      way->prefetch = false;
+    }
+    update_shadows(handle_pkt, true);
+    return way->data;
+  }
+
+  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  update_shadows(handle_pkt, false);
+
+  // A block that is still in flight from an earlier detailed phase will be filled when it returns
+  if (std::any_of(std::begin(MSHR), std::end(MSHR), matches_address(handle_pkt.address))) {
+    sim_stats.mshr_merge.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+    return handle_pkt.data;
+  }
+
+  auto data = handle_pkt.data;
+  if (handle_pkt.type != access_type::WRITE || match_offset_bits) {
+    // Writebacks are filled without reading the block from below
+    auto fwd_pkt = mshr_and_forward_packet(handle_pkt).second;
+    data = lower_level->functional_access(fwd_pkt);
+    if (!fwd_pkt.response_requested) {
+      return data;
+    }
+  }
+
+  functional_fill(handle_pkt, data);
+  return data;
+}
+
+void CACHE::functional_fill(const tag_lookup_type& handle_pkt, champsim::address data)
+{
+  mshr_type fill_mshr{handle_pkt, current_time};
+  fill_mshr.data_promise = champsim::waitable{mshr_type::returned_value{data, handle_pkt.pf_metadata}, current_time};
+
+  auto [set_begin, set_end] = get_set_span(fill_mshr.address);
+  auto way = std::find_if_not(set_begin, set_end, [](auto x) { return x.valid; });
+  if (way == set_end) {
+    way = std::next(set_begin, impl_find_victim(fill_mshr.cpu, fill_mshr.instr_id, get_set_index(fill_mshr.address), &*set_begin, fill_mshr.ip,
+                                                fill_mshr.address, fill_mshr.type));
+  }
+  assert(way != set_end || fill_mshr.type != access_type::WRITE); // Writes may not bypass
+  const auto way_idx = std::distance(set_begin, way);
+
+  if (way != set_end && way->valid && way->dirty) {
+    request_type writeback_packet;
+
+    writeback_packet.cpu = fill_mshr.cpu;
+    writeback_packet.address = way->address;
+    writeback_packet.data = way->data;
+    writeback_packet.instr_id = fill_mshr.instr_id;
+    writeback_packet.ip = champsim::address{};
+    writeback_packet.type = access_type::WRITE;
+    writeback_packet.pf_metadata = way->pf_metadata;
+    writeback_packet.response_requested = false;
+
+    lower_level->functional_access(writeback_packet);
+  }
+
+  champsim::address evicting_address{};
+  if (way != set_end && way->valid) {
+    evicting_address = module_address(*way);
+  }
+
+  auto metadata_thru = impl_prefetcher_cache_fill(module_address(fill_mshr), get_set_index(fill_mshr.address), way_idx,
+                                                  (fill_mshr.type == access_type::PREFETCH), evicting_address, fill_mshr.data_promise->pf_metadata);
+  impl_replacement_cache_fill(fill_mshr.cpu, get_set_index(fill_mshr.address), way_idx, module_address(fill_mshr), fill_mshr.ip, evicting_address,
+                              fill_mshr.type);
+
+  if (way != set_end) {
+    if (way->valid && way->prefetch) {
+      ++sim_stats.pf_useless;
+    }
+
+    if (fill_mshr.type == access_type::PREFETCH) {
+      ++sim_stats.pf_fill;
+    }
+
+    *way = fill_block(fill_mshr, metadata_thru);
+  }
+
+  for (auto* shadow : shadows) {
+    shadow->shadow_fill(fill_mshr);
+  }
+
+  sim_stats.mshr_return.increment(std::pair{fill_mshr.type, fill_mshr.cpu});
+}
+
+void CACHE::update_shadows(const tag_lookup_type& handle_pkt, bool hit)
+{
+  for (auto* shadow : shadows) {
+    // A block that this cache already holds is available to the shadow at once. Otherwise, the shadow is filled along with this cache.
+    if (!shadow->shadow_tag_check(handle_pkt) && hit) {
+      shadow->shadow_fill(mshr_type{handle_pkt, current_time});
+    }
+  }
+}
+
+bool CACHE::shadow_tag_check(const tag_lookup_type& handle_pkt)
+{
+  auto [set_begin, set_end] = get_set_span(handle_pkt.address);
+  auto way = std::find_if(set_begin, set_end, [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); });
+  const auto hit = (way != set_end);
+
+  const auto way_idx = std::distance(set_begin, way);
+  impl_update_replacement_state(handle_pkt.cpu, get_set_index(handle_pkt.address), way_idx, module_address(handle_pkt), handle_pkt.ip, {}, handle_pkt.type,
+                                hit);
+
+  if (hit) {
+    sim_stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+    way->dirty |= (handle_pkt.type == access_type::WRITE);
+  } else {
+    sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  }
+
+  return hit;
+}
+
+void CACHE::shadow_fill(const mshr_type& fill_mshr)
+{
+  auto [set_begin, set_end] = get_set_span(fill_mshr.address);
+  if (std::any_of(set_begin, set_end, [matcher = matches_address(fill_mshr.address)](const auto& x) { return x.valid && matcher(x); })) {
+    return;
+  }
+
+  auto way = std::find_if_not(set_begin, set_end, [](auto x) { return x.valid; });
+  if (way == set_end) {
+    way = std::next(set_begin, impl_find_victim(fill_mshr.cpu, fill_mshr.instr_id, get_set_index(fill_mshr.address), &*set_begin, fill_mshr.ip,
+                                                fill_mshr.address, fill_mshr.type));
+  }
+  const auto way_idx = std::distance(set_begin, way);
+
+  champsim::address evicting_address{};
+  if (way != set_end && way->valid) {
+    evicting_address = module_address(*way);
+  }
+
+  impl_replacement_cache_fill(fill_mshr.cpu, get_set_index(fill_mshr.address), way_idx, module_address(fill_mshr), fill_mshr.ip, evicting_address,
+                              fill_mshr.type);
+
+  // Only the tags are kept, so the block carries no data
+  if (way != set_end) {
+    BLOCK to_fill;
+    to_fill.valid = true;
+    to_fill.dirty = (fill_mshr.type == access_type::WRITE);
+    to_fill.address = fill_mshr.address;
+    to_fill.v_address = fill_mshr.v_address;
+    *way = to_fill;
+  }
+}
+
 std::size_t CACHE::get_mshr_occupancy() const { return std::size(MSHR); }
 
 std::vector<std::size_t> CACHE::get_rq_occupancy() const
@@ -841,6 +1225,18 @@ void CACHE::initialize()
 {
   impl_prefetcher_initialize();
   impl_initialize_replacement();
+
+  for (auto* ul : upper_levels) {
+    ul->request_sink = this;
+  }
+  for (auto* ll : {lower_level, lower_translate}) {
+    if (ll != nullptr) {
+      ll->response_sink = this;
+    }
+  }
+  for (auto* shadow : shadows) {
+    shadow->initialize();
+  }
 }
 
 void CACHE::begin_phase()
@@ -854,6 +1250,10 @@ void CACHE::begin_phase()
   roi_stats = new_roi_stats;
   sim_stats = new_sim_stats;
 
+  for (auto* shadow : shadows) {
+    shadow->begin_phase();
+  }
+
   for (auto* ul : upper_levels) {
     channel_type::stats_type ul_new_roi_stats;
     channel_type::stats_type ul_new_sim_stats;
@@ -878,6 +1278,16 @@ void CACHE::end_phase(unsigned finished_cpu)
   roi_stats.pf_useless = sim_stats.pf_useless;
   roi_stats.pf_fill = sim_stats.pf_fill;
 
+  roi_stats.skipped_operates = sim_stats.skipped_operates;
+
+  roi_stats.shadows.clear();
+  sim_stats.shadows.clear();
+  for (auto* shadow : shadows) {
+    shadow->end_phase(finished_cpu);
+    roi_stats.shadows.push_back(shadow->roi_stats);
+    sim_stats.shadows.push_back(shadow->sim_stats);
+  }
+
   for (auto* ul : upper_levels) {
     ul->roi_stats.RQ_ACCESS = ul->sim_stats.RQ_ACCESS;
     ul->roi_stats.RQ_MERGED = ul->sim_stats.RQ_MERGED;
@@ -897,6 +1307,31 @@ void CACHE::end_phase(unsigned finished_cpu)
   }
 }
 
+void CACHE::checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, block);
+  champsim::checkpoint_save_section(os, typeid(*pref_module_pimpl).name(),
+                                    [this](auto& section) { pref_module_pimpl->impl_prefetcher_checkpoint_save(section); });
+  champsim::checkpoint_save_section(os, typeid(*repl_module_pimpl).name(),
+                                    [this](auto& section) { repl_module_pimpl->impl_replacement_checkpoint_save(section); });
+}
+
+void CACHE::checkpoint_load(std::istream& is)
+{
+  set_type loaded_block;
+  champsim::msl::checkpoint_load(is, loaded_block);
+  if (std::size(loaded_block) != std::size(block)) {
+    throw std::runtime_error{fmt::format("{} was checkpointed with {} blocks, but has {}", NAME, std::size(loaded_block), std::size(block))};
+  }
+  block = std::move(loaded_block);
+
+  // The module state is only restored into the same modules that saved it. Other modules begin cold, with the warmed cache contents.
+  champsim::checkpoint_load_section(is, typeid(*pref_module_pimpl).name(),
+                                    [this](auto& section) { pref_module_pimpl->impl_prefetcher_checkpoint_load(section); });
+  champsim::checkpoint_load_section(is, typeid(*repl_module_pimpl).name(),
+                                    [this](auto& section) { repl_module_pimpl->impl_replacement_checkpoint_load(section); });
+}
+
 template <typename T>
 bool CACHE::should_activate_prefetcher(const T& pkt) const
 {
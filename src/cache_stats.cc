@@ -1,8 +1,12 @@
 #include "cache_stats.h"
 
+#include <algorithm>
+#include <iterator>
+
 cache_stats operator-(cache_stats lhs, cache_stats rhs)
 {
   cache_stats result;
+  result.name = lhs.name;
   result.pf_requested = lhs.pf_requested - rhs.pf_requested;
   result.pf_issued = lhs.pf_issued - rhs.pf_issued;
   result.pf_useful = lhs.pf_useful - rhs.pf_useful;
@@ -11,7 +15,40 @@ cache_stats operator-(cache_stats lhs, cache_stats rhs)
 
   result.hits = lhs.hits - rhs.hits;
   result.misses = lhs.misses - rhs.misses;
+  result.mshr_merge = lhs.mshr_merge - rhs.mshr_merge;
+  result.mshr_return = lhs.mshr_return - rhs.mshr_return;
 
   result.total_miss_latency_cycles = lhs.total_miss_latency_cycles - rhs.total_miss_latency_cycles;
+  result.skipped_operates = lhs.skipped_operates - rhs.skipped_operates;
+
+  if (std::size(lhs.shadows) == std::size(rhs.shadows)) {
+    std::transform(std::begin(lhs.shadows), std::end(lhs.shadows), std::begin(rhs.shadows), std::back_inserter(result.shadows),
+                   [](const auto& x, const auto& y) { return x - y; });
+  }
   return result;
 }
+
+cache_stats operator+(cache_stats lhs, cache_stats rhs)
+{
+  lhs.pf_requested += rhs.pf_requested;
+  lhs.pf_issued += rhs.pf_issued;
+  lhs.pf_useful += rhs.pf_useful;
+  lhs.pf_useless += rhs.pf_useless;
+  lhs.pf_fill += rhs.pf_fill;
+
+  lhs.hits += rhs.hits;
+  lhs.misses += rhs.misses;
+  lhs.mshr_merge += rhs.mshr_merge;
+  lhs.mshr_return += rhs.mshr_return;
+
+  lhs.total_miss_latency_cycles += rhs.total_miss_latency_cycles;
+  lhs.skipped_operates += rhs.skipped_operates;
+
+  if (std::empty(lhs.shadows)) {
+    lhs.shadows = rhs.shadows;
+  } else if (std::size(lhs.shadows) == std::size(rhs.shadows)) {
+    std::transform(std::begin(lhs.shadows), std::end(lhs.shadows), std::begin(rhs.shadows), std::begin(lhs.shadows),
+                   [](const auto& x, const auto& y) { return x + y; });
+  }
+  return lhs;
+}
@@ -18,15 +18,28 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <fmt/chrono.h>
 #include <fmt/core.h>
 
+#include "checkpoint.h"
+#include "domain_scheduler.h"
 #include "environment.h"
 #include "ooo_cpu.h"
 #include "operable.h"
+#include "parallel_engine.h"
 #include "phase_info.h"
+#include "sampling.h"
 #include "tracereader.h"
 
 constexpr int DEADLOCK_CYCLE{500};
@@ -35,72 +48,270 @@ const auto start_time = std::chrono::steady_clock::now();
 
 std::chrono::seconds elapsed_time() { return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start_time); }
 
-namespace champsim
+namespace
 {
-long do_cycle(environment& env, std::vector<tracereader>& traces, std::vector<std::size_t> trace_index, champsim::chrono::clock& global_clock)
+void fill_input_queue(O3_CPU& cpu, champsim::tracereader& trace)
 {
-  auto operables = env.operable_view();
-  std::sort(std::begin(operables), std::end(operables),
-            [](const champsim::operable& lhs, const champsim::operable& rhs) { return lhs.current_time < rhs.current_time; });
+  for (auto pkt_count = cpu.IN_QUEUE_SIZE - static_cast<long>(std::size(cpu.input_queue)); !trace.eof() && pkt_count > 0; --pkt_count) {
+    cpu.input_queue.push_back(trace());
+    cpu.wake();
+  }
+}
 
-  // Operate
-  long progress{0};
-  for (champsim::operable& op : operables) {
-    progress += op.operate_on(global_clock);
+void restore_checkpoint(const std::string& file_name, champsim::environment& env, std::vector<champsim::tracereader>& traces,
+                        const std::vector<std::size_t>& trace_index)
+{
+  std::ifstream checkpoint_file{file_name, std::ios::binary};
+  if (!checkpoint_file) {
+    throw std::runtime_error{fmt::format("Could not open the checkpoint {}", file_name)};
   }
+  champsim::load_checkpoint(env, checkpoint_file);
 
-  // Read from trace
+  // Instructions that were in flight when the checkpoint was saved are read again from the trace
   for (O3_CPU& cpu : env.cpu_view()) {
-    auto& trace = traces.at(trace_index.at(cpu.cpu));
-    for (auto pkt_count = cpu.IN_QUEUE_SIZE - static_cast<long>(std::size(cpu.input_queue)); !trace.eof() && pkt_count > 0; --pkt_count) {
-      cpu.input_queue.push_back(trace());
-    }
+    traces.at(trace_index.at(cpu.cpu)).fast_forward(static_cast<uint64_t>(cpu.num_retired));
   }
+  fmt::print("Restored checkpoint {}\n", file_name);
+}
 
-  return progress;
+void write_checkpoint(const std::string& file_name, champsim::environment& env)
+{
+  std::ofstream checkpoint_file{file_name, std::ios::binary};
+  champsim::save_checkpoint(env, checkpoint_file);
+  fmt::print("Saved checkpoint {}\n", file_name);
 }
 
-phase_stats do_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
+template <typename T>
+void accumulate_stats(std::vector<T>& acc, const std::vector<T>& next)
 {
-  auto operables = env.operable_view();
-  auto [phase_name, is_warmup, length, trace_index, trace_names] = phase;
+  if (std::empty(acc)) {
+    acc = next;
+  } else {
+    std::transform(std::begin(acc), std::end(acc), std::begin(next), std::begin(acc), [](const auto& x, const auto& y) { return x + y; });
+  }
+}
+
+template <typename T>
+void subtract_stats(std::vector<T>& acc, const std::vector<T>& prev)
+{
+  std::transform(std::begin(acc), std::end(acc), std::begin(prev), std::begin(acc), [](const auto& x, const auto& y) { return x - y; });
+}
+
+// Fast-forward the traces or restore the checkpoint that the phase begins from, and begin the phase in each operable
+void prepare_phase(const champsim::phase_info& phase, champsim::environment& env, std::vector<champsim::tracereader>& traces)
+{
+  if (phase.fast_forward_to > 0) {
+    for (O3_CPU& cpu : env.cpu_view()) {
+      auto& trace = traces.at(phase.trace_index.at(cpu.cpu));
+      trace.fast_forward(phase.fast_forward_to);
+      fmt::print("{} fast-forwarded CPU {} to instruction {}\n", phase.name, cpu.cpu, trace.position());
+    }
+  }
+
+  if (!phase.load_checkpoint_file.empty()) {
+    restore_checkpoint(phase.load_checkpoint_file, env, traces, phase.trace_index);
+  }
 
   // Initialize phase
-  for (champsim::operable& op : operables) {
-    op.warmup = is_warmup;
+  // Idle gating is not used with the parallel engine, since a core could wake a shared operable while another core does the same
+  for (champsim::operable& op : env.operable_view()) {
+    op.warmup = phase.is_warmup;
+    op.idle_gating = phase.idle_gating && phase.num_threads <= 1;
+    op.wake();
     op.begin_phase();
   }
+}
+
+champsim::phase_stats collect_phase_stats(const champsim::phase_info& phase, champsim::environment& env)
+{
+  champsim::phase_stats stats;
+  stats.name = phase.name;
+  stats.weight = phase.weight;
+
+  for (auto index : phase.trace_index) {
+    stats.trace_names.push_back(phase.trace_names.at(index));
+  }
 
-  const auto time_quantum = std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::duration::max(),
-                                            [](const auto acc, const operable& y) { return std::min(acc, y.clock_period); });
+  auto cpus = env.cpu_view();
+  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.sim_cpu_stats), [](const O3_CPU& cpu) { return cpu.sim_stats; });
+  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.roi_cpu_stats), [](const O3_CPU& cpu) { return cpu.roi_stats; });
 
+  auto caches = env.cache_view();
+  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.sim_cache_stats), [](const CACHE& cache) { return cache.sim_stats; });
+  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.roi_cache_stats), [](const CACHE& cache) { return cache.roi_stats; });
+
+  auto dram = env.dram_view();
+  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.sim_dram_stats),
+                 [](const DRAM_CHANNEL& chan) { return chan.sim_stats; });
+  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.roi_dram_stats),
+                 [](const DRAM_CHANNEL& chan) { return chan.roi_stats; });
+
+  return stats;
+}
+
+// Warm the components by passing each instruction straight to its core, which trains the branch predictors and performs its memory accesses at once.
+// No time passes, so the cores take turns, one instruction at a time, to interleave their accesses to the shared caches.
+void do_functional_phase(const champsim::phase_info& phase, champsim::environment& env, std::vector<champsim::tracereader>& traces, bool report)
+{
+  const auto cpus = env.cpu_view();
+  auto operables = env.operable_view();
+
+  std::vector<long long> begin_instr{};
+  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(begin_instr), [](const O3_CPU& cpu) { return cpu.num_retired; });
+
+  std::vector<bool> phase_complete(std::size(cpus), false);
+  while (!std::accumulate(std::begin(phase_complete), std::end(phase_complete), true, std::logical_and{})) {
+    auto next_phase_complete = phase_complete;
+
+    for (O3_CPU& cpu : cpus) {
+      if (phase_complete.at(cpu.cpu)) {
+        continue;
+      }
+
+      // Instructions that were read before the phase began come first
+      auto& trace = traces.at(phase.trace_index.at(cpu.cpu));
+      if (!std::empty(cpu.input_queue)) {
+        cpu.functional_operate(cpu.input_queue.front());
+        cpu.input_queue.pop_front();
+      } else if (!trace.eof()) {
+        auto instr = trace();
+        cpu.functional_operate(instr);
+      }
+
+      next_phase_complete.at(cpu.cpu) = (cpu.num_retired - begin_instr.at(cpu.cpu) >= phase.length);
+    }
+
+    // If any trace reaches EOF, terminate all phases
+    if (std::any_of(std::begin(traces), std::end(traces), [](const auto& tr) { return tr.eof(); })) {
+      std::fill(std::begin(next_phase_complete), std::end(next_phase_complete), true);
+    }
+
+    for (O3_CPU& cpu : cpus) {
+      if (next_phase_complete.at(cpu.cpu) != phase_complete.at(cpu.cpu)) {
+        for (champsim::operable& op : operables) {
+          op.end_phase(cpu.cpu);
+        }
+
+        if (report) {
+          fmt::print("{} finished CPU {} instructions: {} (functional warming) (Simulation time: {:%H hr %M min %S sec})\n", phase.name, cpu.cpu,
+                     cpu.sim_instr(), elapsed_time());
+        }
+      }
+    }
+
+    phase_complete = next_phase_complete;
+  }
+
+  if (report) {
+    for (O3_CPU& cpu : cpus) {
+      fmt::print("{} complete CPU {} instructions: {} (functional warming) (Simulation time: {:%H hr %M min %S sec})\n", phase.name, cpu.cpu,
+                 cpu.sim_instr(), elapsed_time());
+    }
+  }
+}
+} // namespace
+
+namespace champsim
+{
+long do_cycle(domain_scheduler& scheduler, const std::vector<std::reference_wrapper<O3_CPU>>& cpus, std::vector<tracereader>& traces,
+              const std::vector<std::size_t>& trace_index, const champsim::chrono::clock& global_clock)
+{
+  // Operate
+  long progress = scheduler.operate_on(global_clock);
+
+  // Read from trace
+  for (O3_CPU& cpu : cpus) {
+    fill_input_queue(cpu, traces.at(trace_index.at(cpu.cpu)));
+  }
+
+  return progress;
+}
+
+namespace
+{
+// The scheduler, the threads of the parallel engine, and the deadlock and livelock checks of a phase that is simulated in detail. They are set up
+// once, after which the phase may be simulated in several stretches.
+class detailed_simulation
+{
+  environment& env;
+  std::vector<tracereader>& traces;
+  std::vector<std::size_t> trace_index;
+  std::vector<std::reference_wrapper<operable>> operables;
+  std::vector<std::reference_wrapper<O3_CPU>> cpus;
+  bool skip_idle_cycles;
+  std::size_t num_threads;
+  long sync_quantum;
+  bool deterministic;
+  bool parallel;
+  champsim::chrono::clock::duration time_quantum;
+  domain_scheduler scheduler{operables};
+  std::optional<parallel_engine> engine;
+  std::function<void(O3_CPU&)> engine_fill_input = [this](O3_CPU& cpu) {
+    fill_input_queue(cpu, traces.at(trace_index.at(cpu.cpu)));
+  };
+
+  int stalled_cycle{0};
   bool livelock_trigger{false};
   uint64_t livelock_period{100000};
   uint64_t livelock_timer{0};
   //                                   die | critical | warning
   std::vector<double> livelock_threshold{0.01, 0.02, 0.05};
-  std::vector<uint64_t> livelock_instr(std::size(env.cpu_view()), 0);
+  std::vector<uint64_t> livelock_instr = std::vector<uint64_t>(std::size(cpus), 0);
+
+public:
+  detailed_simulation(const phase_info& phase, environment& env_, std::vector<tracereader>& traces_)
+      : env(env_), traces(traces_), trace_index(phase.trace_index), operables(env.operable_view()), cpus(env.cpu_view()),
+        skip_idle_cycles(phase.skip_idle_cycles), num_threads(phase.num_threads), sync_quantum(phase.sync_quantum), deterministic(phase.deterministic),
+        parallel(phase.num_threads > 1),
+        time_quantum(std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::duration::max(),
+                                     [](const auto acc, const operable& y) { return std::min(acc, y.clock_period); }))
+  {
+  }
+
+  // Simulate until each core has retired the given number of instructions, or until any trace ends
+  void run(std::string_view phase_name, long long length, bool report, champsim::chrono::clock& global_clock);
+
+  // Simulate, without reading any more instructions, until the pipeline of each core is empty
+  void drain(champsim::chrono::clock& global_clock);
+};
+
+void detailed_simulation::run(std::string_view phase_name, long long length, bool report, champsim::chrono::clock& global_clock)
+{
+  // The threads of the engine are started on the first stretch, so a simulation that only drains its pipelines does not start them
+  if (parallel && !engine.has_value()) {
+    engine.emplace(env, num_threads, sync_quantum, time_quantum, deterministic);
+  }
+
+  std::vector<long long> begin_instr{};
+  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(begin_instr), [](const O3_CPU& cpu) { return cpu.num_retired; });
 
   // Perform phase
-  int stalled_cycle{0};
-  std::vector<bool> phase_complete(std::size(env.cpu_view()), false);
+  std::vector<bool> phase_complete(std::size(cpus), false);
+  std::vector<bool> next_phase_complete(std::size(cpus), false);
   while (!std::accumulate(std::begin(phase_complete), std::end(phase_complete), true, std::logical_and{})) {
-    auto next_phase_complete = phase_complete;
-    global_clock.tick(time_quantum);
+    next_phase_complete = phase_complete;
 
-    auto progress = do_cycle(env, traces, trace_index, global_clock);
+    long progress{0};
+    long elapsed_cycles{1};
+    if (engine.has_value()) {
+      progress = engine->operate_quantum(global_clock, engine_fill_input);
+      elapsed_cycles = engine->quantum();
+    } else {
+      global_clock.tick(time_quantum);
+      progress = do_cycle(scheduler, cpus, traces, trace_index, global_clock);
+    }
 
     if (progress == 0) {
-      ++stalled_cycle;
+      stalled_cycle += static_cast<int>(elapsed_cycles);
     } else {
       stalled_cycle = 0;
     }
 
     // Livelock detect, every livelock_period cycles, check progress and alert the user
-    livelock_timer++;
+    livelock_timer += static_cast<uint64_t>(elapsed_cycles);
     if (livelock_timer >= livelock_period) {
       // for each cpu
-      for (O3_CPU& cpu : env.cpu_view()) {
+      for (O3_CPU& cpu : cpus) {
         // for each threshold
         for (auto thres = std::begin(livelock_threshold); thres != std::end(livelock_threshold); thres++) {
           double livelock_ipc = std::ceil(cpu.sim_instr() - livelock_instr[cpu.cpu]) / std::ceil(livelock_period);
@@ -132,56 +343,226 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
     }
 
     // Check for phase finish
-    for (O3_CPU& cpu : env.cpu_view()) {
+    for (O3_CPU& cpu : cpus) {
       // Phase complete
-      next_phase_complete[cpu.cpu] = next_phase_complete[cpu.cpu] || (cpu.sim_instr() >= length);
+      next_phase_complete[cpu.cpu] = next_phase_complete[cpu.cpu] || (cpu.num_retired - begin_instr.at(cpu.cpu) >= length);
     }
 
-    for (O3_CPU& cpu : env.cpu_view()) {
+    for (O3_CPU& cpu : cpus) {
       if (next_phase_complete[cpu.cpu] != phase_complete[cpu.cpu]) {
         for (champsim::operable& op : operables) {
           op.end_phase(cpu.cpu);
         }
 
-        fmt::print("{} finished CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase_name, cpu.cpu,
-                   cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
+        if (report) {
+          fmt::print("{} finished CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase_name,
+                     cpu.cpu, cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
+        }
       }
     }
 
     phase_complete = next_phase_complete;
+
+    // If nothing happened this cycle, nothing will happen until the earliest scheduled event. Jump the clock forward to just before it,
+    // stopping short of any cycle that would trigger the deadlock or livelock checks so that they behave exactly as if every cycle were simulated.
+    const bool all_complete = std::accumulate(std::begin(phase_complete), std::end(phase_complete), true, std::logical_and{});
+    if (skip_idle_cycles && !parallel && progress == 0 && !all_complete) {
+      // Stop asking as soon as any operable needs the next cycle. The cores are the most expensive to query, so they are asked last.
+      auto idle_until = champsim::chrono::clock::time_point::max();
+      for (auto op_it = std::crbegin(operables); op_it != std::crend(operables) && idle_until > global_clock.now(); ++op_it) {
+        idle_until = std::min(idle_until, op_it->get().idle_until());
+      }
+      if (idle_until > global_clock.now()) {
+        auto skip_quanta = (idle_until - global_clock.now()) / time_quantum;
+        skip_quanta = std::min<decltype(skip_quanta)>({skip_quanta, DEADLOCK_CYCLE - 1 - stalled_cycle,
+                                                       static_cast<decltype(skip_quanta)>(livelock_period - 1 - livelock_timer)});
+
+        if (skip_quanta > 0) {
+          global_clock.tick(skip_quanta * time_quantum);
+          for (champsim::operable& op : operables) {
+            op.idle_on(global_clock);
+          }
+
+          stalled_cycle += static_cast<int>(skip_quanta);
+          livelock_timer += static_cast<uint64_t>(skip_quanta);
+        }
+      }
+    }
   }
 
-  for (O3_CPU& cpu : env.cpu_view()) {
-    fmt::print("{} complete CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase_name, cpu.cpu,
-               cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
+  if (report) {
+    for (O3_CPU& cpu : cpus) {
+      fmt::print("{} complete CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase_name, cpu.cpu,
+                 cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
+    }
+  }
+}
+void detailed_simulation::drain(champsim::chrono::clock& global_clock)
+{
+  // Hold back the instructions that have not been fetched
+  std::vector<std::deque<ooo_model_instr>> held_input{};
+  for (O3_CPU& cpu : cpus) {
+    held_input.push_back(std::exchange(cpu.input_queue, {}));
+  }
+
+  // The cores are drained one cycle at a time by this thread, even if the engine has threads
+  while (!std::all_of(std::begin(cpus), std::end(cpus), [](const O3_CPU& cpu) { return cpu.pipeline_empty(); })) {
+    global_clock.tick(time_quantum);
+    if (scheduler.operate_on(global_clock) == 0) {
+      ++stalled_cycle;
+    } else {
+      stalled_cycle = 0;
+    }
+
+    if (stalled_cycle >= DEADLOCK_CYCLE) {
+      std::for_each(std::begin(operables), std::end(operables), [](champsim::operable& c) { c.print_deadlock(); });
+      abort();
+    }
+  }
+
+  auto held_it = std::begin(held_input);
+  for (O3_CPU& cpu : cpus) {
+    cpu.input_queue = std::move(*held_it);
+    ++held_it;
+  }
+}
+} // namespace
+
+phase_stats do_sampled_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock);
+
+phase_stats do_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
+{
+  if (phase.sampling.has_value()) {
+    return do_sampled_phase(phase, env, traces, global_clock);
+  }
+
+  ::prepare_phase(phase, env, traces);
+
+  if (phase.is_warmup && phase.functional_warming) {
+    // The instructions that a detailed phase left in the pipelines retire before the warming, so that each is counted once and in order
+    const auto cpus = env.cpu_view();
+    if (!std::all_of(std::begin(cpus), std::end(cpus), [](const O3_CPU& cpu) { return cpu.pipeline_empty(); })) {
+      detailed_simulation{phase, env, traces}.drain(global_clock);
+    }
+    ::do_functional_phase(phase, env, traces, true);
+  } else {
+    detailed_simulation simulation{phase, env, traces};
+    simulation.run(phase.name, phase.length, true, global_clock);
+  }
+
+  if (!phase.save_checkpoint_file.empty()) {
+    write_checkpoint(phase.save_checkpoint_file, env);
   }
 
+  return ::collect_phase_stats(phase, env);
+}
+
+phase_stats do_sampled_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
+{
+  const auto& params = phase.sampling.value();
+  const auto z = z_score(params.confidence);
+  const auto cpus = env.cpu_view();
+  auto operables = env.operable_view();
+
+  // Each period is made of functional warming, detailed warming, and the measurement. The phase is set up once, and the periods are simulated
+  // in turn without reporting them.
+  ::prepare_phase(phase, env, traces);
+  detailed_simulation simulation{phase, env, traces};
+
+  phase_info functional_warmup{phase};
+  functional_warmup.is_warmup = true;
+  functional_warmup.functional_warming = true;
+  functional_warmup.length = params.functional_warmup();
+
   phase_stats stats;
   stats.name = phase.name;
+  stats.weight = phase.weight;
+  for (auto index : phase.trace_index) {
+    stats.trace_names.push_back(phase.trace_names.at(index));
+  }
+
+  std::vector<sample_estimate> cpi(std::size(cpus));
+  bool converged = false;
+  auto trace_ended = [&traces]() {
+    return std::any_of(std::begin(traces), std::end(traces), [](const auto& tr) { return tr.eof(); });
+  };
+  auto length_reached = [&cpus, length = phase.length]() {
+    return std::all_of(std::begin(cpus), std::end(cpus), [length](const O3_CPU& cpu) { return cpu.sim_instr() >= length; });
+  };
+
+  while (!converged && !trace_ended() && !length_reached()) {
+    if (functional_warmup.length > 0) {
+      simulation.drain(global_clock);
+      for (champsim::operable& op : operables) {
+        op.warmup = true;
+      }
+      ::do_functional_phase(functional_warmup, env, traces, false);
+      for (champsim::operable& op : operables) {
+        op.warmup = phase.is_warmup;
+      }
+    }
+
+    simulation.run(phase.name, params.detailed_warmup, false, global_clock);
 
-  for (std::size_t i = 0; i < std::size(trace_index); ++i) {
-    stats.trace_names.push_back(trace_names.at(trace_index.at(i)));
+    // The sample is what the statistics gain over the measurement
+    for (O3_CPU& cpu : cpus) {
+      for (champsim::operable& op : operables) {
+        op.end_phase(cpu.cpu);
+      }
+    }
+    const auto before = ::collect_phase_stats(phase, env);
+    simulation.run(phase.name, params.measurement, false, global_clock);
+    auto sample = ::collect_phase_stats(phase, env);
+    ::subtract_stats(sample.roi_cpu_stats, before.roi_cpu_stats);
+    ::subtract_stats(sample.roi_cache_stats, before.roi_cache_stats);
+    ::subtract_stats(sample.roi_dram_stats, before.roi_dram_stats);
+
+    // A sample that the end of the trace cut short is not measured
+    if (std::any_of(std::begin(sample.roi_cpu_stats), std::end(sample.roi_cpu_stats), [&params](const auto& x) { return x.instrs() < params.measurement; })) {
+      break;
+    }
+
+    for (std::size_t cpu = 0; cpu < std::size(cpi); ++cpu) {
+      cpi.at(cpu).add(std::ceil(sample.roi_cpu_stats.at(cpu).cycles()) / std::ceil(sample.roi_cpu_stats.at(cpu).instrs()));
+    }
+    ::accumulate_stats(stats.roi_cpu_stats, sample.roi_cpu_stats);
+    ::accumulate_stats(stats.roi_cache_stats, sample.roi_cache_stats);
+    ::accumulate_stats(stats.roi_dram_stats, sample.roi_dram_stats);
+
+    converged = cpi.front().count() >= params.min_samples
+                && std::all_of(std::begin(cpi), std::end(cpi), [z, target = params.target_error](const auto& x) { return x.relative_error(z) <= target; });
   }
 
-  auto cpus = env.cpu_view();
-  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.sim_cpu_stats), [](const O3_CPU& cpu) { return cpu.sim_stats; });
-  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.roi_cpu_stats), [](const O3_CPU& cpu) { return cpu.roi_stats; });
+  if (!phase.save_checkpoint_file.empty()) {
+    write_checkpoint(phase.save_checkpoint_file, env);
+  }
 
-  auto caches = env.cache_view();
-  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.sim_cache_stats), [](const CACHE& cache) { return cache.sim_stats; });
-  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.roi_cache_stats), [](const CACHE& cache) { return cache.roi_stats; });
+  // Only the measured instructions are reported
+  stats.sim_cpu_stats = stats.roi_cpu_stats;
+  stats.sim_cache_stats = stats.roi_cache_stats;
+  stats.sim_dram_stats = stats.roi_dram_stats;
+
+  sampling_summary summary{};
+  summary.samples = std::empty(cpi) ? 0 : cpi.front().count();
+  summary.confidence = params.confidence;
+  summary.converged = converged;
+  for (const auto& estimate : cpi) {
+    summary.cpi.push_back(estimate.mean());
+    summary.error.push_back(estimate.relative_error(z));
+  }
+  stats.sampling = summary;
 
-  auto dram = env.dram_view();
-  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.sim_dram_stats),
-                 [](const DRAM_CHANNEL& chan) { return chan.sim_stats; });
-  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.roi_dram_stats),
-                 [](const DRAM_CHANNEL& chan) { return chan.roi_stats; });
+  for (O3_CPU& cpu : cpus) {
+    fmt::print("{} complete CPU {} samples: {} CPI: {:.4g} error: {:.3g}% at {:.4g}% confidence{} (Simulation time: {:%H hr %M min %S sec})\n", phase.name,
+               cpu.cpu, summary.samples, summary.cpi.at(cpu.cpu), 100 * summary.error.at(cpu.cpu), 100 * summary.confidence,
+               converged ? "" : " (target not reached)", elapsed_time());
+  }
 
   return stats;
 }
 
 // simulation entry point
-std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces)
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, const std::function<bool()>& end_of_warmup)
 {
   for (champsim::operable& op : env.operable_view()) {
     op.initialize();
@@ -189,7 +570,16 @@ std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases,
 
   champsim::chrono::clock global_clock;
   std::vector<phase_stats> results;
+  bool warmup_ended = false;
   for (auto phase : phases) {
+    // Before the first measured phase, the caller may hand off the warmed machine. If it returns false, the simulation stops here.
+    if (!phase.is_warmup && !warmup_ended) {
+      warmup_ended = true;
+      if (end_of_warmup && !end_of_warmup()) {
+        break;
+      }
+    }
+
     auto stats = do_phase(phase, env, traces, global_clock);
     if (!phase.is_warmup) {
       results.push_back(stats);
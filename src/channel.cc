@@ -22,6 +22,7 @@
 #include "cache.h"
 #include "champsim.h"
 #include "instruction.h"
+#include "operable.h"
 #include "util/to_underlying.h" // for to_underlying
 
 champsim::channel::channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset)
@@ -73,12 +74,14 @@ void champsim::channel::check_collision()
 {
   auto write_shamt = match_offset_bits ? champsim::data::bits{} : OFFSET_BITS;
   auto read_shamt = OFFSET_BITS;
+  bool drained = false;
 
   // Check WQ for duplicates, merging if they are found
   for (auto wq_it = std::find_if(std::begin(WQ), std::end(WQ), std::not_fn(&request_type::forward_checked)); wq_it != std::end(WQ);) {
     if (do_collision_for_merge(std::begin(WQ), wq_it, *wq_it, write_shamt)) {
       sim_stats.WQ_MERGED++;
       wq_it = WQ.erase(wq_it);
+      drained = true;
     } else {
       wq_it->forward_checked = true;
       ++wq_it;
@@ -90,9 +93,11 @@ void champsim::channel::check_collision()
     if (do_collision_for_return(std::begin(WQ), std::end(WQ), *rq_it, write_shamt, returned)) {
       sim_stats.WQ_FORWARD++;
       rq_it = RQ.erase(rq_it);
+      drained = true;
     } else if (do_collision_for_merge(std::begin(RQ), rq_it, *rq_it, read_shamt)) {
       sim_stats.RQ_MERGED++;
       rq_it = RQ.erase(rq_it);
+      drained = true;
     } else {
       rq_it->forward_checked = true;
       ++rq_it;
@@ -104,14 +109,27 @@ void champsim::channel::check_collision()
     if (do_collision_for_return(std::begin(WQ), std::end(WQ), *pq_it, write_shamt, returned)) {
       sim_stats.WQ_FORWARD++;
       pq_it = PQ.erase(pq_it);
+      drained = true;
     } else if (do_collision_for_merge(std::begin(PQ), pq_it, *pq_it, read_shamt)) {
       sim_stats.PQ_MERGED++;
       pq_it = PQ.erase(pq_it);
+      drained = true;
     } else {
       pq_it->forward_checked = true;
       ++pq_it;
     }
   }
+
+  if (response_sink != nullptr && (drained || !std::empty(returned))) {
+    response_sink->wake();
+  }
+}
+
+void champsim::channel::notify_drained() const
+{
+  if (response_sink != nullptr) {
+    response_sink->wake();
+  }
 }
 
 template <typename R>
@@ -127,9 +145,30 @@ bool champsim::channel::do_add_queue(R& queue, std::size_t queue_size, const typ
   fwd_pkt.forward_checked = false;
   queue.push_back(fwd_pkt);
 
+  if (request_sink != nullptr) {
+    request_sink->wake();
+  }
+
   return true;
 }
 
+void champsim::channel::add_returned(const response_type& resp)
+{
+  returned.push_back(resp);
+
+  if (response_sink != nullptr) {
+    response_sink->wake();
+  }
+}
+
+champsim::address champsim::channel::functional_access(const request_type& packet) const
+{
+  if (request_sink == nullptr) {
+    return packet.data;
+  }
+  return request_sink->functional_access(packet);
+}
+
 bool champsim::channel::add_rq(const request_type& packet)
 {
   if constexpr (champsim::debug_print) {
@@ -0,0 +1,132 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "checkpoint.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+#include "environment.h"
+#include "msl/checkpoint.h"
+#include "vmem.h"
+
+namespace
+{
+constexpr std::string_view checkpoint_magic{"ChampSim checkpoint"};
+constexpr uint32_t checkpoint_version = 1;
+
+// The names of the components, which must match between the saving and loading machines
+std::vector<std::string> component_names(champsim::environment& env)
+{
+  std::vector<std::string> retval;
+  for (const O3_CPU& cpu : env.cpu_view()) {
+    retval.push_back(fmt::format("cpu{}", cpu.cpu));
+  }
+  for (const CACHE& cache : env.cache_view()) {
+    retval.push_back(cache.NAME);
+  }
+  for (const PageTableWalker& ptw : env.ptw_view()) {
+    retval.push_back(ptw.NAME);
+  }
+  return retval;
+}
+
+// Each page table walker may share its virtual memory with others, which should only be saved once
+std::vector<VirtualMemory*> unique_vmems(champsim::environment& env)
+{
+  std::vector<VirtualMemory*> retval;
+  for (PageTableWalker& ptw : env.ptw_view()) {
+    if (ptw.vmem != nullptr && std::find(std::begin(retval), std::end(retval), ptw.vmem) == std::end(retval)) {
+      retval.push_back(ptw.vmem);
+    }
+  }
+  return retval;
+}
+} // namespace
+
+void champsim::save_checkpoint(environment& env, std::ostream& os)
+{
+  os.write(std::data(checkpoint_magic), static_cast<std::streamsize>(std::size(checkpoint_magic)));
+  msl::checkpoint_save(os, checkpoint_version);
+  msl::checkpoint_save(os, component_names(env));
+
+  for (const champsim::operable& op : env.operable_view()) {
+    op.checkpoint_save(os);
+  }
+
+  for (const auto* vmem : unique_vmems(env)) {
+    vmem->checkpoint_save(os);
+  }
+
+  if (!os) {
+    throw std::runtime_error{"Could not write the checkpoint"};
+  }
+}
+
+void champsim::load_checkpoint(environment& env, std::istream& is)
+{
+  std::string magic(std::size(checkpoint_magic), '\0');
+  uint32_t version{};
+  is.read(std::data(magic), static_cast<std::streamsize>(std::size(magic)));
+  if (!is || magic != checkpoint_magic) {
+    throw std::runtime_error{"The file is not a checkpoint"};
+  }
+  msl::checkpoint_load(is, version);
+  if (version != checkpoint_version) {
+    throw std::runtime_error{fmt::format("The checkpoint has version {}, but version {} is expected", version, checkpoint_version)};
+  }
+
+  std::vector<std::string> names;
+  msl::checkpoint_load(is, names);
+  if (names != component_names(env)) {
+    throw std::runtime_error{"The checkpoint was saved from a machine with different components"};
+  }
+
+  for (champsim::operable& op : env.operable_view()) {
+    op.checkpoint_load(is);
+  }
+
+  for (auto* vmem : unique_vmems(env)) {
+    vmem->checkpoint_load(is);
+  }
+}
+
+void champsim::checkpoint_save_section(std::ostream& os, std::string_view identity, const std::function<void(std::ostream&)>& save)
+{
+  std::ostringstream section;
+  save(section);
+  msl::checkpoint_save(os, std::string{identity});
+  msl::checkpoint_save(os, section.str());
+}
+
+bool champsim::checkpoint_load_section(std::istream& is, std::string_view identity, const std::function<void(std::istream&)>& load)
+{
+  std::string saved_identity;
+  std::string section;
+  msl::checkpoint_load(is, saved_identity);
+  msl::checkpoint_load(is, section);
+  if (saved_identity != identity) {
+    return false;
+  }
+
+  std::istringstream section_stream{section};
+  load(section_stream);
+  return true;
+}
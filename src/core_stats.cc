@@ -7,9 +7,25 @@ cpu_stats operator-(cpu_stats lhs, cpu_stats rhs)
   lhs.end_instrs -= rhs.end_instrs;
   lhs.end_cycles -= rhs.end_cycles;
   lhs.total_rob_occupancy_at_branch_mispredict -= rhs.total_rob_occupancy_at_branch_mispredict;
+  lhs.skipped_operates -= rhs.skipped_operates;
 
   lhs.total_branch_types -= rhs.total_branch_types;
   lhs.branch_type_misses -= rhs.branch_type_misses;
 
   return lhs;
 }
+
+cpu_stats operator+(cpu_stats lhs, cpu_stats rhs)
+{
+  lhs.begin_instrs += rhs.begin_instrs;
+  lhs.begin_cycles += rhs.begin_cycles;
+  lhs.end_instrs += rhs.end_instrs;
+  lhs.end_cycles += rhs.end_cycles;
+  lhs.total_rob_occupancy_at_branch_mispredict += rhs.total_rob_occupancy_at_branch_mispredict;
+  lhs.skipped_operates += rhs.skipped_operates;
+
+  lhs.total_branch_types += rhs.total_branch_types;
+  lhs.branch_type_misses += rhs.branch_type_misses;
+
+  return lhs;
+}
@@ -0,0 +1,78 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "domain_scheduler.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "operable.h"
+
+champsim::domain_scheduler::domain_scheduler(const std::vector<std::reference_wrapper<operable>>& operables)
+{
+  for (std::size_t i = 0; i < std::size(operables); ++i) {
+    operable& op = operables.at(i);
+    auto domain = std::find_if(std::begin(domains), std::end(domains), [period = op.clock_period](const auto& x) { return x.clock_period == period; });
+    if (domain == std::end(domains)) {
+      domain = domains.insert(domain, clock_domain{op.clock_period, op.current_time});
+    }
+    domain->current_time = std::min(domain->current_time, op.current_time);
+    domain->members.emplace_back(i, op);
+  }
+}
+
+long champsim::domain_scheduler::operate_on(const champsim::chrono::clock& clock)
+{
+  for (auto& domain : domains) {
+    domain.next_member = (domain.current_time < clock.now()) ? 0 : std::size(domain.members);
+  }
+
+  // Merge the members of the due domains, earliest time first. The domain's recorded time is only a lower bound on its members' times,
+  // since the members may have been idled since it was recorded.
+  long progress{0};
+  auto dispatch_order = [](const clock_domain& domain) {
+    const auto& [index, op] = domain.members[domain.next_member];
+    return std::tuple{op.get().current_time, index};
+  };
+  while (true) {
+    clock_domain* next_domain = nullptr;
+    for (auto& domain : domains) {
+      if (domain.next_member < std::size(domain.members) && (next_domain == nullptr || dispatch_order(domain) < dispatch_order(*next_domain))) {
+        next_domain = &domain;
+      }
+    }
+
+    if (next_domain == nullptr) {
+      break;
+    }
+
+    operable& op = next_domain->members[next_domain->next_member].second;
+    ++next_domain->next_member;
+    progress += op.operate_on(clock);
+  }
+
+  for (auto& domain : domains) {
+    if (domain.current_time < clock.now()) {
+      domain.current_time = std::min_element(std::begin(domain.members), std::end(domain.members), [](const auto& lhs, const auto& rhs) {
+                              return lhs.second.get().current_time < rhs.second.get().current_time;
+                            })->second.get().current_time;
+    }
+  }
+
+  return progress;
+}
+
+std::size_t champsim::domain_scheduler::num_domains() const { return std::size(domains); }
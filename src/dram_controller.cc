@@ -19,10 +19,13 @@
 #include <algorithm>
 #include <cfenv>
 #include <cmath>
+#include <numeric>
+#include <utility>
 #include <fmt/core.h>
 
 #include "deadlock.h"
 #include "instruction.h"
+#include "msl/checkpoint.h"
 #include "util/bits.h" // for lg2, bitmask
 #include "util/span.h"
 #include "util/units.h"
@@ -108,12 +111,13 @@ long DRAM_CHANNEL::operate()
 {
   long progress{0};
 
+  // Requests that a bank has already scheduled, because the warmup began while they were in flight, drain as usual
   if (warmup) {
     for (auto& entry : RQ) {
-      if (entry.has_value()) {
+      if (entry.has_value() && !entry->scheduled) {
         response_type response{entry->address, entry->v_address, entry->data, entry->pf_metadata, entry->instr_depend_on_me};
         for (auto* ret : entry.value().to_return) {
-          ret->push_back(response);
+          ret->add_returned(response);
         }
 
         ++progress;
@@ -122,10 +126,10 @@ long DRAM_CHANNEL::operate()
     }
 
     for (auto& entry : WQ) {
-      if (entry.has_value()) {
+      if (entry.has_value() && !entry->scheduled) {
         ++progress;
+        entry.reset();
       }
-      entry.reset();
     }
   }
 
@@ -140,6 +144,84 @@ long DRAM_CHANNEL::operate()
   return progress;
 }
 
+champsim::chrono::clock::time_point MEMORY_CONTROLLER::next_event_time() const
+{
+  // Queued requests move to their channels while those have room. A write that does not fit is counted by idle() on each cycle that it is retried.
+  auto has_room = [](const auto& q) {
+    return std::any_of(std::begin(q), std::end(q), [](const auto& x) { return !x.has_value(); });
+  };
+  auto channel_of = [this](const auto& pkt) -> const DRAM_CHANNEL& {
+    return channels[address_mapping.get_channel(pkt.address)];
+  };
+  auto can_initiate = [has_room, channel_of](const auto* ul) {
+    return (!std::empty(ul->RQ) && has_room(channel_of(ul->RQ.front()).RQ)) || (!std::empty(ul->PQ) && has_room(channel_of(ul->PQ.front()).RQ))
+           || (!std::empty(ul->WQ) && has_room(channel_of(ul->WQ.front()).WQ));
+  };
+  if (std::any_of(std::begin(queues), std::end(queues), can_initiate)) {
+    return current_time + clock_period;
+  }
+
+  return std::accumulate(std::begin(channels), std::end(channels), champsim::chrono::clock::time_point::max(),
+                         [](const auto acc, const DRAM_CHANNEL& chan) { return std::min(acc, chan.next_event_time()); });
+}
+
+void MEMORY_CONTROLLER::idle(long cycles)
+{
+  // Each call to operate() retries the first queued write of each upper level
+  for (auto* ul : queues) {
+    if (!std::empty(ul->WQ)) {
+      channels[address_mapping.get_channel(ul->WQ.front().address)].sim_stats.WQ_FULL += static_cast<unsigned>(cycles);
+    }
+  }
+
+  for (auto& channel : channels) {
+    channel._idle(cycles);
+  }
+}
+
+champsim::chrono::clock::time_point DRAM_CHANNEL::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+
+  auto is_occupied = [](const auto& x) {
+    return x.has_value();
+  };
+  auto is_unchecked = [](const auto& x) {
+    return x.has_value() && !x->forward_checked;
+  };
+  if ((warmup && (std::any_of(std::begin(RQ), std::end(RQ), is_occupied) || std::any_of(std::begin(WQ), std::end(WQ), is_occupied)))
+      || std::any_of(std::begin(RQ), std::end(RQ), is_unchecked) || std::any_of(std::begin(WQ), std::end(WQ), is_unchecked) || should_swap_write_mode()) {
+    return next_cycle;
+  }
+
+  // Banks that are refreshing, or are waiting to begin a refresh, make progress every cycle
+  if (std::any_of(std::begin(bank_request), std::end(bank_request), [](const auto& x) { return x.under_refresh || (x.need_refresh && !x.valid); })) {
+    return next_cycle;
+  }
+
+  auto next_event = last_refresh + tREF;
+
+  if (active_request != std::end(bank_request)) {
+    next_event = std::min(next_event, active_request->ready_time);
+  }
+
+  // A request that is waiting for the data bus is either placed on it or counted as congested on every cycle
+  auto iter_next_process = std::min_element(std::begin(bank_request), std::end(bank_request),
+                                            [](const auto& lhs, const auto& rhs) { return !rhs.valid || (lhs.valid && lhs.ready_time < rhs.ready_time); });
+  if (iter_next_process->valid) {
+    next_event = std::min(next_event, iter_next_process->ready_time);
+  }
+
+  if (auto pkt = schedule_packet(); pkt->has_value() && pkt->value().ready_time != champsim::chrono::clock::time_point::max()) {
+    const auto& bank = bank_request[bank_request_index(pkt->value().address)];
+    if (!bank.valid && !bank.under_refresh) {
+      next_event = std::min(next_event, pkt->value().ready_time);
+    }
+  }
+
+  return next_event;
+}
+
 long DRAM_CHANNEL::finish_dbus_request()
 {
   long progress{0};
@@ -148,7 +230,7 @@ long DRAM_CHANNEL::finish_dbus_request()
     response_type response{active_request->pkt->value().address, active_request->pkt->value().v_address, active_request->pkt->value().data,
                            active_request->pkt->value().pf_metadata, active_request->pkt->value().instr_depend_on_me};
     for (auto* ret : active_request->pkt->value().to_return) {
-      ret->push_back(response);
+      ret->add_returned(response);
     }
 
     active_request->valid = false;
@@ -201,7 +283,7 @@ long DRAM_CHANNEL::schedule_refresh()
   return (progress);
 }
 
-void DRAM_CHANNEL::swap_write_mode()
+bool DRAM_CHANNEL::should_swap_write_mode() const
 {
   // these values control when to send out a burst of writes
   const std::size_t DRAM_WRITE_HIGH_WM = ((std::size(WQ) * 7) >> 3); // 7/8th
@@ -213,8 +295,13 @@ void DRAM_CHANNEL::swap_write_mode()
   auto rq_occu = static_cast<std::size_t>(std::count_if(std::begin(RQ), std::end(RQ), [](const auto& x) { return x.has_value(); }));
 
   // Change modes if the queues are unbalanced
-  if ((!write_mode && (wq_occu >= DRAM_WRITE_HIGH_WM || (rq_occu == 0 && wq_occu > 0)))
-      || (write_mode && (wq_occu == 0 || (rq_occu > 0 && wq_occu < DRAM_WRITE_LOW_WM)))) {
+  return (!write_mode && (wq_occu >= DRAM_WRITE_HIGH_WM || (rq_occu == 0 && wq_occu > 0)))
+         || (write_mode && (wq_occu == 0 || (rq_occu > 0 && wq_occu < DRAM_WRITE_LOW_WM)));
+}
+
+void DRAM_CHANNEL::swap_write_mode()
+{
+  if (should_swap_write_mode()) {
     // Reset scheduled requests
     for (auto it = std::begin(bank_request); it != std::end(bank_request); ++it) {
       // Leave active request on the data bus
@@ -314,6 +401,12 @@ std::size_t DRAM_CHANNEL::bankgroup_request_index(champsim::address addr) const
 
 // Look for queued packets that have not been scheduled
 DRAM_CHANNEL::queue_type::iterator DRAM_CHANNEL::schedule_packet()
+{
+  auto& queue = write_mode ? WQ : RQ;
+  return std::next(std::begin(queue), std::distance(std::cbegin(queue), std::as_const(*this).schedule_packet()));
+}
+
+DRAM_CHANNEL::queue_type::const_iterator DRAM_CHANNEL::schedule_packet() const
 {
   // Look for queued packets that have not been scheduled
   // prioritize packets that are ready to execute, bank is free
@@ -331,11 +424,11 @@ DRAM_CHANNEL::queue_type::iterator DRAM_CHANNEL::schedule_packet()
     auto lready = !this->bank_request[lop_idx].valid;
     return (rready == lready) ? lhs.value().ready_time <= rhs.value().ready_time : lready;
   };
-  queue_type::iterator iter_next_schedule;
+  queue_type::const_iterator iter_next_schedule;
   if (write_mode) {
-    iter_next_schedule = std::min_element(std::begin(WQ), std::end(WQ), next_schedule);
+    iter_next_schedule = std::min_element(std::cbegin(WQ), std::cend(WQ), next_schedule);
   } else {
-    iter_next_schedule = std::min_element(std::begin(RQ), std::end(RQ), next_schedule);
+    iter_next_schedule = std::min_element(std::cbegin(RQ), std::cend(RQ), next_schedule);
   }
   return (iter_next_schedule);
 }
@@ -367,6 +460,10 @@ long DRAM_CHANNEL::service_packet(DRAM_CHANNEL::queue_type::iterator pkt)
 
 void MEMORY_CONTROLLER::initialize()
 {
+  for (auto* ul : queues) {
+    ul->request_sink = this;
+  }
+
   using namespace champsim::data::data_literals;
   using namespace std::literals::chrono_literals;
   auto sz = this->size();
@@ -455,7 +552,7 @@ void DRAM_CHANNEL::check_read_collision()
         response_type response{rq_it->value().address, rq_it->value().v_address, wq_it->value().data, rq_it->value().pf_metadata,
                                rq_it->value().instr_depend_on_me};
         for (auto* ret : rq_it->value().to_return) {
-          ret->push_back(response);
+          ret->add_returned(response);
         }
 
         rq_it->reset();
@@ -496,14 +593,21 @@ void MEMORY_CONTROLLER::initiate_requests()
 {
   // Initiate read requests
   for (auto* ul : queues) {
+    bool drained = false;
     for (auto q : {std::ref(ul->RQ), std::ref(ul->PQ)}) {
       auto [begin, end] = champsim::get_span_p(std::cbegin(q.get()), std::cend(q.get()), [ul, this](const auto& pkt) { return this->add_rq(pkt, ul); });
+      drained = drained || begin != end;
       q.get().erase(begin, end);
     }
 
     // Initiate write requests
     auto [wq_begin, wq_end] = champsim::get_span_p(std::cbegin(ul->WQ), std::cend(ul->WQ), [this](const auto& pkt) { return this->add_wq(pkt); });
+    drained = drained || wq_begin != wq_end;
     ul->WQ.erase(wq_begin, wq_end);
+
+    if (drained) {
+      ul->notify_drained();
+    }
   }
 }
 
@@ -525,7 +629,7 @@ bool MEMORY_CONTROLLER::add_rq(const request_type& packet, champsim::channel* ul
     rq_it->value().scheduled = false;
     rq_it->value().ready_time = current_time;
     if (packet.response_requested)
-      rq_it->value().to_return = {&ul->returned};
+      rq_it->value().to_return = {ul};
 
     return true;
   }
@@ -612,6 +716,45 @@ std::size_t DRAM_ADDRESS_MAPPING::channels() const { return std::size_t{1} << ch
 std::size_t DRAM_CHANNEL::bank_request_capacity() const { return std::size(bank_request); }
 std::size_t DRAM_CHANNEL::bankgroup_request_capacity() const { return std::size(bankgroup_readytime); };
 
+void MEMORY_CONTROLLER::checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, static_cast<uint64_t>(std::size(channels)));
+  for (const auto& chan : channels) {
+    chan.checkpoint_save(os);
+  }
+}
+
+void MEMORY_CONTROLLER::checkpoint_load(std::istream& is)
+{
+  uint64_t num_channels{};
+  champsim::msl::checkpoint_load(is, num_channels);
+  if (num_channels != std::size(channels)) {
+    throw std::runtime_error{fmt::format("The DRAM was checkpointed with {} channels, but has {}", num_channels, std::size(channels))};
+  }
+  for (auto& chan : channels) {
+    chan.checkpoint_load(is);
+  }
+}
+
+void DRAM_CHANNEL::checkpoint_save(std::ostream& os) const
+{
+  std::vector<std::optional<std::size_t>> open_rows;
+  std::transform(std::cbegin(bank_request), std::cend(bank_request), std::back_inserter(open_rows), [](const auto& bank) { return bank.open_row; });
+  champsim::msl::checkpoint_save(os, open_rows);
+}
+
+void DRAM_CHANNEL::checkpoint_load(std::istream& is)
+{
+  std::vector<std::optional<std::size_t>> open_rows;
+  champsim::msl::checkpoint_load(is, open_rows);
+  if (std::size(open_rows) != std::size(bank_request)) {
+    throw std::runtime_error{fmt::format("A DRAM channel was checkpointed with {} banks, but has {}", std::size(open_rows), std::size(bank_request))};
+  }
+  for (std::size_t i = 0; i < std::size(bank_request); ++i) {
+    bank_request[i].open_row = open_rows[i];
+  }
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void MEMORY_CONTROLLER::print_deadlock()
 {
@@ -18,6 +18,7 @@
 #include <utility>
 #include <nlohmann/json.hpp>
 
+#include "simpoint.h"
 #include "stats_printer.h"
 
 void to_json(nlohmann::json& j, const O3_CPU::stats_type& stats)
@@ -36,6 +37,7 @@ void to_json(nlohmann::json& j, const O3_CPU::stats_type& stats)
   j = nlohmann::json{{"instructions", stats.instrs()},
                      {"cycles", stats.cycles()},
                      {"Avg ROB occupancy at mispredict", std::ceil(stats.total_rob_occupancy_at_branch_mispredict) / std::ceil(total_mispredictions)},
+                     {"skipped operates", stats.skipped_operates},
                      {"mispredict", mpki}};
 }
 
@@ -51,6 +53,7 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
   statsmap.emplace("prefetch issued", stats.pf_issued);
   statsmap.emplace("useful prefetch", stats.pf_useful);
   statsmap.emplace("useless prefetch", stats.pf_useless);
+  statsmap.emplace("skipped operates", stats.skipped_operates);
 
   uint64_t total_downstream_demands = stats.mshr_return.total();
   for (std::size_t cpu = 0; cpu < NUM_CPUS; ++cpu)
@@ -71,6 +74,24 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
     statsmap.emplace(access_type_names.at(champsim::to_underlying(type)), nlohmann::json{{"hit", hits}, {"miss", misses}, {"mshr_merge", mshr_merges}});
   }
 
+  if (!std::empty(stats.shadows)) {
+    std::vector<nlohmann::json> shadows;
+    for (const auto& shadow : stats.shadows) {
+      std::map<std::string, nlohmann::json> shadowmap{{"name", shadow.name}};
+      for (const auto type : {access_type::LOAD, access_type::RFO, access_type::PREFETCH, access_type::WRITE, access_type::TRANSLATION}) {
+        std::vector<hits_value_type> hits;
+        std::vector<misses_value_type> misses;
+        for (std::size_t cpu = 0; cpu < NUM_CPUS; ++cpu) {
+          hits.push_back(shadow.hits.value_or(std::pair{type, cpu}, hits_value_type{}));
+          misses.push_back(shadow.misses.value_or(std::pair{type, cpu}, misses_value_type{}));
+        }
+        shadowmap.emplace(access_type_names.at(champsim::to_underlying(type)), nlohmann::json{{"hit", hits}, {"miss", misses}});
+      }
+      shadows.emplace_back(shadowmap);
+    }
+    statsmap.emplace("shadows", shadows);
+  }
+
   j = statsmap;
 }
 
@@ -103,10 +124,44 @@ void to_json(nlohmann::json& j, const champsim::phase_stats stats)
   }
 
   std::map<std::string, nlohmann::json> statsmap{{"name", stats.name}, {"traces", stats.trace_names}};
+  if (stats.weight.has_value()) {
+    statsmap.emplace("weight", stats.weight.value());
+  }
+  if (stats.sampling.has_value()) {
+    std::vector<nlohmann::json> cores;
+    std::transform(std::begin(stats.sampling->cpi), std::end(stats.sampling->cpi), std::begin(stats.sampling->error), std::back_inserter(cores),
+                   [](double cpi, double error) { return nlohmann::json{{"CPI", cpi}, {"error bound", error}}; });
+    statsmap.emplace("sampling", nlohmann::json{{"samples", stats.sampling->samples},
+                                                {"confidence", stats.sampling->confidence},
+                                                {"converged", stats.sampling->converged},
+                                                {"cores", cores}});
+  }
   statsmap.emplace("roi", roi_stats);
   statsmap.emplace("sim", sim_stats);
   j = statsmap;
 }
 } // namespace champsim
 
-void champsim::json_printer::print(std::vector<phase_stats>& stats) { stream << nlohmann::json::array_t{std::begin(stats), std::end(stats)}; }
+void champsim::json_printer::print(std::vector<phase_stats>& stats)
+{
+  nlohmann::json::array_t phases{std::begin(stats), std::end(stats)};
+
+  // The weighted phases are sampled from one program, so an estimate for the whole program follows them
+  if (auto summary = summarize_weighted(stats); summary.has_value()) {
+    std::vector<nlohmann::json> cores;
+    std::transform(std::begin(summary->cpi), std::end(summary->cpi), std::back_inserter(cores),
+                   [](double cpi) { return nlohmann::json{{"CPI", cpi}, {"IPC", 1 / cpi}}; });
+    phases.push_back(nlohmann::json{{"name", "Weighted"}, {"weight", summary->total_weight}, {"cores", cores}});
+  }
+
+  stream << phases;
+}
+
+void champsim::json_printer::print(const std::vector<variant_result>& results)
+{
+  nlohmann::json::array_t variants;
+  std::transform(std::begin(results), std::end(results), std::back_inserter(variants), [](const auto& result) {
+    return nlohmann::json{{"name", result.name}, {"exit status", result.exit_status}, {"IPC", result.ipc}};
+  });
+  stream << variants;
+}
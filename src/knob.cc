@@ -0,0 +1,65 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "knob.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace
+{
+std::vector<champsim::knob*>& registry()
+{
+  static std::vector<champsim::knob*> knobs;
+  return knobs;
+}
+} // namespace
+
+champsim::knob::knob(std::string name, long default_value) : name_(std::move(name)), value_(default_value) { ::registry().push_back(this); }
+
+champsim::knob::knob(const knob& other) : name_(other.name_), value_(other.value_) { ::registry().push_back(this); }
+
+auto champsim::knob::operator=(const knob& other) -> knob&
+{
+  name_ = other.name_;
+  value_ = other.value_;
+  return *this;
+}
+
+champsim::knob::~knob()
+{
+  auto& knobs = ::registry();
+  knobs.erase(std::remove(std::begin(knobs), std::end(knobs), this), std::end(knobs));
+}
+
+std::size_t champsim::knob::set(std::string_view name, long value)
+{
+  std::size_t count = 0;
+  for (auto* k : ::registry()) {
+    if (k->name_ == name) {
+      k->value_ = value;
+      ++count;
+    }
+  }
+  return count;
+}
+
+bool champsim::knob::is_registered(std::string_view name)
+{
+  const auto& knobs = ::registry();
+  return std::any_of(std::begin(knobs), std::end(knobs), [name](const auto* k) { return k->name() == name; });
+}
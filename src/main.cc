@@ -15,7 +15,9 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <functional>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -29,15 +31,20 @@
 #endif
 #include "defaults.hpp"
 #include "environment.h"
+#include "inf_stream.h"
+#include "knob.h"
 #include "ooo_cpu.h" // for O3_CPU
 #include "phase_info.h"
+#include "sampling.h"
+#include "simpoint.h"
 #include "stats_printer.h"
+#include "sweep.h"
 #include "tracereader.h"
 #include "vmem.h"
 
 namespace champsim
 {
-std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces);
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, const std::function<bool()>& end_of_warmup);
 }
 
 #ifndef CHAMPSIM_TEST_BUILD
@@ -59,9 +66,25 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   CLI::App app{"A microarchitecture simulator for research and education"};
 
   bool knob_cloudsuite{false};
+  bool knob_skip_idle_cycles{false};
+  bool knob_idle_gating{false};
+  bool knob_relaxed{false};
+  bool knob_functional_warmup{false};
+  std::size_t num_threads{1};
+  long sync_quantum{0};
   long long warmup_instructions = 0;
   long long simulation_instructions = std::numeric_limits<long long>::max();
   std::string json_file_name;
+  std::string save_checkpoint_name;
+  std::string load_checkpoint_name;
+  std::string simpoints_file_name;
+  std::string simpoint_weights_file_name;
+  long long simpoint_interval = 100'000'000;
+  uint64_t skip_instructions = 0;
+  uint64_t shared_trace_offset = 0;
+  champsim::sampling_parameters sampling{};
+  std::vector<std::string> knob_settings;
+  std::vector<std::string> variant_specs;
   std::vector<std::string> trace_names;
 
   auto set_heartbeat_callback = [&](auto) {
@@ -72,6 +95,19 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
 
   app.add_flag("-c,--cloudsuite", knob_cloudsuite, "Read all traces using the cloudsuite format");
   app.add_flag("--hide-heartbeat", set_heartbeat_callback, "Hide the heartbeat output");
+  app.add_flag("--skip-idle-cycles", knob_skip_idle_cycles, "Advance the clock directly to the next scheduled event when no component makes progress");
+  app.add_flag("--idle-gating", knob_idle_gating, "Do not operate components that have no work until a request or response arrives for them");
+  app.add_flag("--functional-warmup", knob_functional_warmup,
+               "Warm up by training the branch predictors and caches directly from the trace, without simulating the pipeline");
+  app.add_option("--threads", num_threads,
+                 "Simulate the cores and their private caches on this many threads");
+  app.add_option("--sync-quantum", sync_quantum,
+                 "The number of cycles between synchronizations of the threads. If not given, use the latency of the shared caches.");
+  app.add_flag("--relaxed", knob_relaxed,
+               "When using multiple threads, allocate physical pages in the order the cores request them. The results may vary between runs.");
+  app.add_option("--decompression-threads", champsim::decomp_tags::lzma_decoder_threads,
+                 "Decompress each xz trace on this many threads, or on one thread per processor if 0 is given. "
+                 "Only traces that were compressed into several blocks can be decompressed in parallel. Not available with --variant.");
   auto* warmup_instr_option = app.add_option("-w,--warmup-instructions", warmup_instructions, "The number of instructions in the warmup phase");
   auto* deprec_warmup_instr_option =
       app.add_option("--warmup_instructions", warmup_instructions, "[deprecated] use --warmup-instructions instead")->excludes(warmup_instr_option);
@@ -80,6 +116,62 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   auto* deprec_sim_instr_option =
       app.add_option("--simulation_instructions", simulation_instructions, "[deprecated] use --simulation-instructions instead")->excludes(sim_instr_option);
 
+  auto* save_checkpoint_option = app.add_option("--save-checkpoint", save_checkpoint_name, "Save the state of the machine to this file after the warmup phase");
+  auto* load_checkpoint_option =
+      app.add_option("--load-checkpoint", load_checkpoint_name, "Restore the state of the machine from this file, instead of running the warmup phase")
+          ->excludes(save_checkpoint_option)
+          ->excludes(warmup_instr_option)
+          ->excludes(deprec_warmup_instr_option)
+          ->check(CLI::ExistingFile);
+
+  auto* simpoints_option =
+      app.add_option("--simpoints", simpoints_file_name, "Simulate only the intervals listed in this file, as written by the SimPoint tool")
+          ->excludes(sim_instr_option)
+          ->excludes(deprec_sim_instr_option)
+          ->excludes(save_checkpoint_option)
+          ->excludes(load_checkpoint_option)
+          ->check(CLI::ExistingFile);
+  auto* skip_instr_option =
+      app.add_option("--skip-instructions", skip_instructions,
+                     "Discard this many instructions from the beginning of each trace before the warmup phase. "
+                     "If a trace has an index, built by the trace_index tool in tracer/, "
+                     "the reader moves near the position without decoding the trace before it.")
+          ->excludes(simpoints_option)
+          ->excludes(load_checkpoint_option)
+          ->excludes(save_checkpoint_option);
+  app.add_option("--shared-trace-offset", shared_trace_offset,
+                 "Cores that run the same trace share one reader of it. Start each of them this many instructions after the previous one, "
+                 "so that they do not run in lockstep.");
+  auto* simpoint_weights_option =
+      app.add_option("--simpoint-weights", simpoint_weights_file_name, "The weights of the intervals listed by --simpoints")->check(CLI::ExistingFile);
+  simpoints_option->needs(simpoint_weights_option);
+  simpoint_weights_option->needs(simpoints_option);
+  app.add_option("--simpoint-interval", simpoint_interval, "The number of instructions in each SimPoint interval")->needs(simpoints_option);
+
+  auto* sample_period_option =
+      app.add_option("--sample-period", sampling.period,
+                     "Measure a sample of the detailed phase every this many instructions, and warm the components functionally in between")
+          ->excludes(simpoints_option)
+          ->check(CLI::PositiveNumber);
+  app.add_option("--sample-length", sampling.measurement, "The number of instructions measured in each sample")
+      ->needs(sample_period_option)
+      ->check(CLI::PositiveNumber);
+  app.add_option("--sample-detailed-warmup", sampling.detailed_warmup, "The number of instructions simulated in detail before each sample")
+      ->needs(sample_period_option)
+      ->check(CLI::NonNegativeNumber);
+  app.add_option("--sample-confidence", sampling.confidence, "The confidence level of the error bound of the sampled CPI")
+      ->needs(sample_period_option)
+      ->check(CLI::Range(0.0, 1.0));
+  app.add_option("--sample-error", sampling.target_error, "End the detailed phase once the error bound of the sampled CPI is within this fraction of it")
+      ->needs(sample_period_option)
+      ->check(CLI::PositiveNumber);
+
+  app.add_option("--knob", knob_settings, "Set a runtime knob of a module, given as KNOB=VALUE, for example ip_stride.degree=4")->expected(1);
+  app.add_option("--variant", variant_specs,
+                 "After the warmup, fork a process to simulate this variant, given as NAME:KNOB=VALUE[,KNOB=VALUE...]. "
+                 "Each variant writes its output to NAME.txt and NAME.json, and the summary of all variants is printed.")
+      ->expected(1);
+
   auto* json_option =
       app.add_option("--json", json_file_name, "The name of the file to receive JSON output. If no name is specified, stdout will be used")->expected(0, 1);
 
@@ -104,10 +196,30 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     warmup_instructions = simulation_instructions / 5;
   }
 
-  std::vector<champsim::tracereader> traces;
-  std::transform(
-      std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
-      [knob_cloudsuite, repeat = simulation_given, i = uint8_t(0)](auto name) mutable { return get_tracereader(name, i++, knob_cloudsuite, repeat); });
+  std::vector<champsim::variant> variants;
+  std::transform(std::begin(variant_specs), std::end(variant_specs), std::back_inserter(variants), champsim::parse_variant);
+  // Only the thread that forks is copied into a variant's process, so a decoder that runs on several threads would never produce its next block
+  if (!std::empty(variants) && champsim::decomp_tags::lzma_decoder_threads != 1) {
+    fmt::print(stderr, "--variant cannot be combined with --decompression-threads other than 1\n");
+    return 1;
+  }
+  for (const auto& setting : knob_settings) {
+    auto [name, value] = champsim::parse_knob_setting(setting);
+    if (champsim::knob::set(name, value) == 0) {
+      fmt::print(stderr, "No module has a knob named {}\n", name);
+      return 1;
+    }
+  }
+  for (const auto& var : variants) {
+    for (const auto& [name, value] : var.knobs) {
+      if (!champsim::knob::is_registered(name)) {
+        fmt::print(stderr, "No module has a knob named {}\n", name);
+        return 1;
+      }
+    }
+  }
+
+  auto traces = get_tracereaders(trace_names, knob_cloudsuite, simulation_given, shared_trace_offset);
 
   std::vector<champsim::phase_info> phases{
       {champsim::phase_info{"Warmup", true, warmup_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names},
@@ -115,12 +227,72 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
 
   for (auto& p : phases) {
     std::iota(std::begin(p.trace_index), std::end(p.trace_index), 0);
+    p.skip_idle_cycles = knob_skip_idle_cycles;
+    p.idle_gating = knob_idle_gating;
+    p.num_threads = num_threads;
+    p.sync_quantum = sync_quantum;
+    p.deterministic = !knob_relaxed;
+    p.functional_warming = knob_functional_warmup;
+  }
+
+  phases.front().save_checkpoint_file = save_checkpoint_name;
+  if (skip_instr_option->count() > 0) {
+    phases.front().fast_forward_to = skip_instructions;
+  }
+  if (!load_checkpoint_name.empty()) {
+    // The checkpoint takes the place of the warmup
+    phases.erase(std::begin(phases));
+    phases.front().load_checkpoint_file = load_checkpoint_name;
+    warmup_instructions = 0;
+  }
+
+  if (simpoints_option->count() > 0) {
+    std::ifstream simpoints_file{simpoints_file_name};
+    std::ifstream simpoint_weights_file{simpoint_weights_file_name};
+    if (!warmup_given) {
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+      warmup_instructions = simpoint_interval / 5;
+    }
+    simulation_instructions = simpoint_interval;
+    phases = champsim::simpoint_phases(champsim::read_simpoints(simpoints_file, simpoint_weights_file), simpoint_interval, warmup_instructions,
+                                       phases.back());
+  }
+
+  if (sample_period_option->count() > 0) {
+    phases.back().sampling = sampling;
   }
 
   fmt::print("\n*** ChampSim Multicore Out-of-Order Simulator ***\nWarmup Instructions: {}\nSimulation Instructions: {}\nNumber of CPUs: {}\nPage size: {}\n\n",
-             phases.at(0).length, phases.at(1).length, std::size(gen_environment.cpu_view()), PAGE_SIZE);
+             warmup_instructions, simulation_instructions, std::size(gen_environment.cpu_view()), PAGE_SIZE);
+
+  champsim::variant_sweep sweep{variants};
+  std::function<bool()> end_of_warmup{};
+  if (!std::empty(variants)) {
+    end_of_warmup = [&sweep, &traces]() {
+      for (auto& trace : traces) {
+        trace.pause();
+      }
+      return sweep.fork_children();
+    };
+  }
 
-  auto phase_stats = champsim::main(gen_environment, phases, traces);
+  auto phase_stats = champsim::main(gen_environment, phases, traces, end_of_warmup);
+
+  if (!std::empty(variants) && !sweep.in_child()) {
+    fmt::print("\nChampSim completed all variants\n\n");
+    champsim::plain_printer{std::cout}.print(sweep.results);
+    if (json_option->count() > 0) {
+      if (json_file_name.empty()) {
+        champsim::json_printer{std::cout}.print(sweep.results);
+      } else {
+        std::ofstream json_file{json_file_name};
+        champsim::json_printer{json_file}.print(sweep.results);
+      }
+    }
+
+    auto failed = std::any_of(std::begin(sweep.results), std::end(sweep.results), [](const auto& result) { return result.exit_status != 0; });
+    return failed ? 1 : 0;
+  }
 
   fmt::print("\nChampSim completed all CPUs\n\n");
 
@@ -134,7 +306,22 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     cache.impl_replacement_final_stats();
   }
 
-  if (json_option->count() > 0) {
+  if (sweep.in_child()) {
+    std::ofstream json_file{sweep.current().name + ".json"};
+    champsim::json_printer{json_file}.print(phase_stats);
+
+    std::vector<double> ipc(std::size(gen_environment.cpu_view()), 0);
+    for (std::size_t cpu = 0; cpu < std::size(ipc); ++cpu) {
+      long long instrs = 0;
+      long long cycles = 0;
+      for (const auto& phase : phase_stats) {
+        instrs += phase.roi_cpu_stats.at(cpu).instrs();
+        cycles += phase.roi_cpu_stats.at(cpu).cycles();
+      }
+      ipc.at(cpu) = std::ceil(instrs) / std::ceil(cycles);
+    }
+    sweep.report(ipc);
+  } else if (json_option->count() > 0) {
     if (json_file_name.empty()) {
       champsim::json_printer{std::cout}.print(phase_stats);
     } else {
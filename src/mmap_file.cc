@@ -0,0 +1,97 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mmap_file.h"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+champsim::mmap_file::mmap_file(const std::string& fname)
+{
+  // A FIFO would block the open until it has a writer, only to be rejected below
+  int fd = ::open(fname.c_str(), O_RDONLY | O_NONBLOCK);
+  if (fd < 0) {
+    throw std::system_error{errno, std::generic_category(), fmt::format("Could not open {}", fname)};
+  }
+
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) != 0) {
+    auto error = errno;
+    ::close(fd);
+    throw std::system_error{error, std::generic_category(), fmt::format("Could not read the size of {}", fname)};
+  }
+
+  if (!S_ISREG(file_stat.st_mode)) {
+    ::close(fd);
+    throw std::system_error{ENODEV, std::generic_category(), fmt::format("Could not map {}, which is not a regular file", fname)};
+  }
+
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  if (size_ > 0) {
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+      auto error = errno;
+      ::close(fd);
+      throw std::system_error{error, std::generic_category(), fmt::format("Could not map {}", fname)};
+    }
+    data_ = static_cast<const char*>(mapping);
+
+    // These are only hints, so their failure is not an error
+    ::madvise(mapping, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(mapping, size_, MADV_HUGEPAGE);
+#endif
+  }
+
+  // The mapping remains valid after the file is closed
+  ::close(fd);
+}
+
+bool champsim::mmap_file::can_map(const std::string& fname)
+{
+  struct stat file_stat {};
+  return ::stat(fname.c_str(), &file_stat) == 0 && S_ISREG(file_stat.st_mode);
+}
+
+champsim::mmap_file::mmap_file(mmap_file&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+{
+}
+
+auto champsim::mmap_file::operator=(mmap_file&& other) noexcept -> mmap_file&
+{
+  if (this != &other) {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+champsim::mmap_file::~mmap_file()
+{
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char*>(data_), size_); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+  }
+}
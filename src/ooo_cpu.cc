@@ -20,14 +20,17 @@
 #include <chrono>
 #include <cmath>
 #include <numeric>
+#include <typeinfo>
 #include <fmt/chrono.h>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include "cache.h"
 #include "champsim.h"
+#include "checkpoint.h"
 #include "deadlock.h"
 #include "instruction.h"
+#include "msl/checkpoint.h"
 #include "util/span.h"
 
 std::chrono::seconds elapsed_time();
@@ -76,6 +79,12 @@ void O3_CPU::initialize()
   // BRANCH PREDICTOR & BTB
   impl_initialize_branch_predictor();
   impl_initialize_btb();
+
+  for (auto* ll : {L1I_bus.lower_level, L1D_bus.lower_level}) {
+    if (ll != nullptr) {
+      ll->response_sink = this;
+    }
+  }
 }
 
 void O3_CPU::begin_phase()
@@ -161,7 +170,7 @@ bool O3_CPU::do_predict_branch(ooo_model_instr& arch_instr)
 
   if (arch_instr.is_branch) {
     if constexpr (champsim::debug_print) {
-      fmt::print("[BRANCH] instr_id: {} ip: {} taken: {}\n", arch_instr.instr_id, arch_instr.ip, arch_instr.branch_taken);
+      fmt::print("[BRANCH] instr_id: {} ip: {} taken: {}\n", arch_instr.instr_id, arch_instr.ip, bool{arch_instr.branch_taken});
     }
 
     // call code prefetcher every time the branch predictor is used
@@ -266,7 +275,7 @@ long O3_CPU::fetch_instruction()
   return progress;
 }
 
-bool O3_CPU::do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end)
+bool O3_CPU::do_fetch_instruction(instr_buffer_type::iterator begin, instr_buffer_type::iterator end)
 {
   CacheBus::request_type fetch_packet;
   fetch_packet.v_address = begin->ip;
@@ -300,7 +309,6 @@ long O3_CPU::promote_to_decode()
   auto fetched_check_end = std::find_if(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), [](const ooo_model_instr& x) { return !x.fetch_completed; });
   // find the first not fetch completed
   auto [window_begin, window_end] = champsim::get_span_p(std::begin(IFETCH_BUFFER), fetched_check_end, available_fetch_bandwidth, fetch_complete_and_ready);
-  auto decoded_window_end = std::stable_partition(window_begin, window_end, is_decoded); // reorder instructions
   auto mark_for_decode = [time = current_time, lat = DECODE_LATENCY, warmup = warmup](auto& x) {
     return x.ready_time = time + (warmup ? champsim::chrono::clock::duration{} : lat);
   };
@@ -309,15 +317,19 @@ long O3_CPU::promote_to_decode()
     return x.ready_time = time + lat;
   };
 
-  std::for_each(window_begin, decoded_window_end, mark_for_dib); // assume DECODE_LATENCY = DIB_HIT_LATENCY
-  std::move(window_begin, decoded_window_end, std::back_inserter(DIB_HIT_BUFFER));
-  // to DECODE_BUFFER
-
-  std::for_each(decoded_window_end, window_end, mark_for_decode);
-  std::move(decoded_window_end, window_end, std::back_inserter(DECODE_BUFFER));
+  // The window is split between the two buffers in a single pass, which keeps the program order within each of them
+  std::for_each(window_begin, window_end, [&, this](auto& x) {
+    if (is_decoded(x)) {
+      mark_for_dib(x); // assume DECODE_LATENCY = DIB_HIT_LATENCY
+      this->DIB_HIT_BUFFER.push_back(std::move(x));
+    } else {
+      mark_for_decode(x);
+      this->DECODE_BUFFER.push_back(std::move(x));
+    }
+  });
 
   long progress{std::distance(window_begin, window_end)};
-  IFETCH_BUFFER.erase(window_begin, window_end);
+  IFETCH_BUFFER.erase(window_begin, window_end); // the window begins at the front of the buffer
   return progress;
 }
 long O3_CPU::decode_instruction()
@@ -411,8 +423,7 @@ long O3_CPU::dispatch_instruction()
   // dispatch DISPATCH_WIDTH instructions into the ROB
   while (available_dispatch_bandwidth.has_remaining() && !std::empty(DISPATCH_BUFFER) && DISPATCH_BUFFER.front().ready_time <= current_time
          && std::size(ROB) != ROB_SIZE
-         && ((std::size_t)std::count_if(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return !lq_entry.has_value(); })
-             >= std::size(DISPATCH_BUFFER.front().source_memory))
+         && std::size(lq_free_slots) >= std::size(DISPATCH_BUFFER.front().source_memory)
          && ((std::size(DISPATCH_BUFFER.front().destination_memory) + std::size(SQ)) <= SQ_SIZE)) {
     ROB.push_back(std::move(DISPATCH_BUFFER.front()));
     DISPATCH_BUFFER.pop_front();
@@ -432,12 +443,13 @@ long O3_CPU::schedule_instruction()
   for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && search_bw.has_remaining(); ++rob_it) {
     // if there aren't enough physical registers available for the next instruction, stop scheduling
     unsigned long sources_to_allocate = std::count_if(rob_it->source_registers.begin(), rob_it->source_registers.end(),
-                                                      [alloc = std::as_const(reg_allocator)](auto srcreg) { return !alloc.isAllocated(srcreg); });
+                                                      [&alloc = std::as_const(reg_allocator)](auto srcreg) { return !alloc.isAllocated(srcreg); });
     if (reg_allocator.count_free_registers() < (sources_to_allocate + rob_it->destination_registers.size())) {
       break;
     }
     if (!rob_it->scheduled && rob_it->ready_time <= current_time) {
       do_scheduling(*rob_it);
+      do_register_wakeup(rob_it);
       ++progress;
     }
 
@@ -465,20 +477,46 @@ void O3_CPU::do_scheduling(ooo_model_instr& instr)
   instr.scheduled = true;
 }
 
+void O3_CPU::do_register_wakeup(instr_buffer_type::iterator rob_it)
+{
+  // Wait on each distinct source that is not yet valid. The instruction is woken as each of them completes.
+  const auto& sources = rob_it->source_registers;
+  bool waiting = false;
+  for (auto src_it = std::begin(sources); src_it != std::end(sources); ++src_it) {
+    if (!reg_allocator.isValid(*src_it) && std::find(std::begin(sources), src_it, *src_it) == src_it) {
+      reg_allocator.add_consumer(*src_it, rob_it->instr_id);
+      waiting = true;
+    }
+  }
+
+  if (!waiting) {
+    do_mark_ready(rob_it);
+  }
+}
+
+void O3_CPU::do_mark_ready(instr_buffer_type::iterator rob_it)
+{
+  // Keep the ready instructions in program order, so that the oldest are selected first
+  ready_to_execute.insert(std::upper_bound(std::begin(ready_to_execute), std::end(ready_to_execute), rob_it), rob_it);
+}
+
 long O3_CPU::execute_instruction()
 {
+  // Select from the instructions whose sources are ready, rather than searching the ROB
   champsim::bandwidth exec_bw{EXEC_WIDTH};
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && exec_bw.has_remaining(); ++rob_it) {
-    if (rob_it->scheduled && !rob_it->executed && rob_it->ready_time <= current_time) {
-      bool ready = std::all_of(std::begin(rob_it->source_registers), std::end(rob_it->source_registers),
-                               [alloc = std::as_const(reg_allocator)](auto srcreg) { return alloc.isValid(srcreg); });
-      if (ready) {
-        do_execution(*rob_it);
-        exec_bw.consume();
-      }
+  for (auto ready_it = std::begin(ready_to_execute); ready_it != std::end(ready_to_execute) && exec_bw.has_remaining(); ++ready_it) {
+    if ((*ready_it)->ready_time <= current_time) {
+      do_execution(**ready_it);
+      executing.insert(std::upper_bound(std::begin(executing), std::end(executing), *ready_it), *ready_it);
+      exec_bw.consume();
     }
   }
 
+  if (exec_bw.amount_consumed() > 0) {
+    auto still_waiting = std::remove_if(std::begin(ready_to_execute), std::end(ready_to_execute), [](auto rob_it) { return rob_it->executed; });
+    ready_to_execute.erase(still_waiting, std::end(ready_to_execute));
+  }
+
   return exec_bw.amount_consumed();
 }
 
@@ -487,19 +525,25 @@ void O3_CPU::do_execution(ooo_model_instr& instr)
   instr.executed = true;
   instr.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
 
-  // Mark LQ entries as ready to translate
-  for (auto& lq_entry : LQ) {
-    if (lq_entry.has_value() && lq_entry->instr_id == instr.instr_id) {
-      lq_entry->ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
+  // Mark LQ entries as ready to translate. A slot may have been released, and then reused by a later instruction, if the load was forwarded.
+  if (auto lq_slots = lq_slots_by_instr.find(instr.instr_id); lq_slots != std::end(lq_slots_by_instr)) {
+    for (auto slot : lq_slots->second) {
+      if (auto& lq_entry = LQ.at(slot); lq_entry.has_value() && lq_entry->instr_id == instr.instr_id) {
+        lq_entry->ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
+        if (lq_entry->producer_id == std::numeric_limits<uint64_t>::max()) {
+          lq_ready_slots.insert(slot);
+        }
+      }
     }
+    lq_slots_by_instr.erase(lq_slots);
   }
 
-  // Mark SQ entries as ready to translate
-  for (auto& sq_entry : SQ) {
-    if (sq_entry.instr_id == instr.instr_id) {
-      sq_entry.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
-    }
-  }
+  // Mark SQ entries as ready to translate. The SQ is in program order.
+  auto sq_begin = std::partition_point(std::begin(SQ), std::end(SQ), LSQ_ENTRY::precedes(instr.instr_id));
+  auto sq_end = std::find_if_not(sq_begin, std::end(SQ), LSQ_ENTRY::matches_id(instr.instr_id));
+  std::for_each(sq_begin, sq_end, [ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY)](auto& sq_entry) {
+    sq_entry.ready_time = ready_time;
+  });
 
   if constexpr (champsim::debug_print) {
     fmt::print("[ROB] {} instr_id: {} ready_time: {}\n", __func__, instr.instr_id, instr.ready_time.time_since_epoch() / clock_period);
@@ -509,34 +553,38 @@ void O3_CPU::do_execution(ooo_model_instr& instr)
 void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
 {
   // load
-  for (auto& smem : instr.source_memory) {
-    auto q_entry = std::find_if_not(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return lq_entry.has_value(); });
-    assert(q_entry != std::end(LQ));
-    q_entry->emplace(smem, instr.instr_id, instr.ip, instr.asid); // add it to the load queue
-
-    // Check for forwarding
-    auto sq_it = std::max_element(std::begin(SQ), std::end(SQ), [smem](const auto& lhs, const auto& rhs) {
-      return lhs.virtual_address != smem || (rhs.virtual_address == smem && LSQ_ENTRY::program_order(lhs, rhs));
-    });
-    if (sq_it != std::end(SQ) && sq_it->virtual_address == smem) {
-      if (sq_it->fetch_issued) { // Store already executed
-        (*q_entry)->finish(instr);
-        q_entry->reset();
+  for (auto smem : instr.source_memory) {
+    auto& q_entry = allocate_lq_entry();
+    q_entry.emplace(smem, instr.instr_id, instr.ip, instr.asid); // add it to the load queue
+
+    // Check for forwarding from the youngest prior store to the same address
+    if (auto stores = sq_by_address.find(smem.to<uint64_t>()); stores != std::end(sq_by_address)) {
+      auto youngest_id = stores->second.back()->instr_id;
+      LSQ_ENTRY& sq_entry = **std::find_if(std::begin(stores->second), std::end(stores->second), [youngest_id](const LSQ_ENTRY* x) {
+        return x->instr_id == youngest_id;
+      });
+      if (sq_entry.fetch_issued) { // Store already executed
+        q_entry->finish(instr);
+        release_lq_entry(q_entry);
       } else {
-        assert(sq_it->instr_id < instr.instr_id);      // The found SQ entry is a prior store
-        sq_it->lq_depend_on_me.emplace_back(*q_entry); // Forward the load when the store finishes
-        (*q_entry)->producer_id = sq_it->instr_id;     // The load waits on the store to finish
+        assert(sq_entry.instr_id < instr.instr_id);     // The found SQ entry is a prior store
+        sq_entry.lq_depend_on_me.emplace_back(q_entry); // Forward the load when the store finishes
+        q_entry->producer_id = sq_entry.instr_id;       // The load waits on the store to finish
 
         if constexpr (champsim::debug_print) {
-          fmt::print("[DISPATCH] {} instr_id: {} waits on: {}\n", __func__, instr.instr_id, sq_it->instr_id);
+          fmt::print("[DISPATCH] {} instr_id: {} waits on: {}\n", __func__, instr.instr_id, sq_entry.instr_id);
         }
       }
     }
+
+    if (q_entry.has_value()) {
+      lq_slots_by_instr[instr.instr_id].push_back(static_cast<std::size_t>(std::distance(std::data(LQ), &q_entry)));
+    }
   }
 
   // store
-  for (auto& dmem : instr.destination_memory) {
-    SQ.emplace_back(dmem, instr.instr_id, instr.ip, instr.asid); // add it to the store queue
+  for (auto dmem : instr.destination_memory) {
+    sq_by_address[dmem.to<uint64_t>()].push_back(&SQ.emplace_back(dmem, instr.instr_id, instr.ip, instr.asid)); // add it to the store queue
   }
 
   if constexpr (champsim::debug_print) {
@@ -566,24 +614,53 @@ long O3_CPU::operate_lsq()
 
   auto [complete_begin, complete_end] = champsim::get_span_p(std::cbegin(SQ), std::cend(SQ), store_bw, do_complete);
   store_bw.consume(std::distance(complete_begin, complete_end));
+  std::for_each(complete_begin, complete_end, [this](const auto& sq_entry) {
+    // Stores leave the SQ in program order, so each is the oldest of the stores to its address
+    auto stores = this->sq_by_address.find(sq_entry.virtual_address.template to<uint64_t>());
+    assert(stores != std::end(this->sq_by_address) && stores->second.front() == &sq_entry);
+    stores->second.erase(std::begin(stores->second));
+    if (std::empty(stores->second)) {
+      this->sq_by_address.erase(stores);
+    }
+  });
   SQ.erase(complete_begin, complete_end);
 
   champsim::bandwidth load_bw{LQ_WIDTH};
 
-  for (auto& lq_entry : LQ) {
-    if (load_bw.has_remaining() && lq_entry.has_value() && lq_entry->producer_id == std::numeric_limits<uint64_t>::max() && !lq_entry->fetch_issued
-        && lq_entry->ready_time < current_time) {
-      auto success = execute_load(*lq_entry);
-      if (success) {
-        load_bw.consume();
-        lq_entry->fetch_issued = true;
-      }
+  for (auto slot_it = std::begin(lq_ready_slots); slot_it != std::end(lq_ready_slots) && load_bw.has_remaining();) {
+    auto& lq_entry = LQ.at(*slot_it);
+    assert(lq_entry.has_value() && lq_entry->producer_id == std::numeric_limits<uint64_t>::max() && !lq_entry->fetch_issued);
+    if (lq_entry->ready_time < current_time && execute_load(*lq_entry)) {
+      load_bw.consume();
+      lq_entry->fetch_issued = true;
+      lq_slots_by_block[champsim::block_number{lq_entry->virtual_address}.to<uint64_t>()].push_back(*slot_it);
+      slot_it = lq_ready_slots.erase(slot_it);
+    } else {
+      ++slot_it;
     }
   }
 
   return store_bw.amount_consumed() + load_bw.amount_consumed();
 }
 
+std::optional<LSQ_ENTRY>& O3_CPU::allocate_lq_entry()
+{
+  assert(!std::empty(lq_free_slots));
+  auto& lq_entry = LQ.at(lq_free_slots.top());
+  lq_free_slots.pop();
+  assert(!lq_entry.has_value());
+  return lq_entry;
+}
+
+void O3_CPU::release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry)
+{
+  assert(lq_entry.has_value());
+  lq_entry.reset();
+  const auto slot = static_cast<std::size_t>(std::distance(std::data(LQ), &lq_entry));
+  lq_ready_slots.erase(slot);
+  lq_free_slots.push(slot);
+}
+
 void O3_CPU::do_finish_store(const LSQ_ENTRY& sq_entry)
 {
   if constexpr (champsim::debug_print) {
@@ -598,7 +675,7 @@ void O3_CPU::do_finish_store(const LSQ_ENTRY& sq_entry)
     assert(dependent->producer_id == sq_entry.instr_id);
 
     dependent->finish(std::begin(ROB), std::end(ROB));
-    dependent.reset();
+    release_lq_entry(dependent);
   }
 }
 
@@ -630,11 +707,54 @@ bool O3_CPU::execute_load(const LSQ_ENTRY& lq_entry)
   return L1D_bus.issue_read(data_packet);
 }
 
+bool O3_CPU::pipeline_empty() const
+{
+  return std::empty(IFETCH_BUFFER) && std::empty(DIB_HIT_BUFFER) && std::empty(DECODE_BUFFER) && std::empty(DISPATCH_BUFFER) && std::empty(ROB);
+}
+
+void O3_CPU::functional_operate(ooo_model_instr& arch_instr)
+{
+  // In warmup, a misprediction does not stop fetch, so the result is not needed
+  do_init_instruction(arch_instr);
+
+  if (!DIB.check_hit(arch_instr.ip).has_value()) {
+    CacheBus::request_type fetch_packet;
+    fetch_packet.v_address = arch_instr.ip;
+    fetch_packet.instr_id = arch_instr.instr_id;
+    fetch_packet.ip = arch_instr.ip;
+    L1I_bus.functional_read(fetch_packet);
+  }
+  do_dib_update(arch_instr);
+
+  for (auto address : arch_instr.source_memory) {
+    CacheBus::request_type data_packet;
+    data_packet.v_address = address;
+    data_packet.instr_id = arch_instr.instr_id;
+    data_packet.ip = arch_instr.ip;
+    L1D_bus.functional_read(data_packet);
+  }
+
+  for (auto address : arch_instr.destination_memory) {
+    CacheBus::request_type data_packet;
+    data_packet.v_address = address;
+    data_packet.instr_id = arch_instr.instr_id;
+    data_packet.ip = arch_instr.ip;
+    L1D_bus.functional_write(data_packet);
+  }
+
+  ++num_retired;
+}
+
 void O3_CPU::do_complete_execution(ooo_model_instr& instr)
 {
   for (auto dreg : instr.destination_registers) {
-    // mark physical register's data as valid
-    reg_allocator.complete_dest_register(dreg);
+    // mark physical register's data as valid, and wake the instructions whose last outstanding source it was
+    for (auto consumer_id : reg_allocator.complete_dest_register(dreg)) {
+      auto consumer = ooo_model_instr::find_id(std::begin(ROB), std::end(ROB), consumer_id);
+      if (consumer != std::end(ROB) && reg_allocator.count_reg_dependencies(*consumer) == 0) {
+        do_mark_ready(consumer);
+      }
+    }
   }
 
   instr.completed = true;
@@ -646,15 +766,20 @@ void O3_CPU::do_complete_execution(ooo_model_instr& instr)
 
 long O3_CPU::complete_inflight_instruction()
 {
-  // update ROB entries with completed executions
+  // update ROB entries with completed executions, selecting from the executed instructions rather than searching the ROB
   champsim::bandwidth complete_bw{EXEC_WIDTH};
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && complete_bw.has_remaining(); ++rob_it) {
-    if (rob_it->executed && !rob_it->completed && (rob_it->ready_time <= current_time) && rob_it->completed_mem_ops == rob_it->num_mem_ops()) {
+  for (auto exec_it = std::begin(executing); exec_it != std::end(executing) && complete_bw.has_remaining(); ++exec_it) {
+    if (auto rob_it = *exec_it; (rob_it->ready_time <= current_time) && rob_it->completed_mem_ops == rob_it->num_mem_ops()) {
       do_complete_execution(*rob_it);
       complete_bw.consume();
     }
   }
 
+  if (complete_bw.amount_consumed() > 0) {
+    auto still_executing = std::remove_if(std::begin(executing), std::end(executing), [](auto rob_it) { return rob_it->completed; });
+    executing.erase(still_executing, std::end(executing));
+  }
+
   return complete_bw.amount_consumed();
 }
 
@@ -667,7 +792,7 @@ long O3_CPU::handle_memory_return()
     auto& l1i_entry = L1I_bus.lower_level->returned.front();
 
     while (l1i_bw.has_remaining() && !l1i_entry.instr_depend_on_me.empty()) {
-      auto fetched = std::find_if(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), ooo_model_instr::matches_id(l1i_entry.instr_depend_on_me.front()));
+      auto fetched = ooo_model_instr::find_id(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), l1i_entry.instr_depend_on_me.front());
       if (fetched != std::end(IFETCH_BUFFER) && champsim::block_number{fetched->ip} == champsim::block_number{l1i_entry.v_address} && fetched->fetch_issued) {
         fetched->fetch_completed = true;
         l1i_bw.consume();
@@ -690,12 +815,16 @@ long O3_CPU::handle_memory_return()
 
   auto l1d_it = std::begin(L1D_bus.lower_level->returned);
   for (champsim::bandwidth l1d_bw{L1D_BANDWIDTH}; l1d_bw.has_remaining() && l1d_it != std::end(L1D_bus.lower_level->returned); l1d_bw.consume(), ++l1d_it) {
-    for (auto& lq_entry : LQ) {
-      if (lq_entry.has_value() && lq_entry->fetch_issued && champsim::block_number{lq_entry->virtual_address} == champsim::block_number{l1d_it->v_address}) {
+    // Wake exactly the loads that were issued to this block
+    if (auto waiting = lq_slots_by_block.find(champsim::block_number{l1d_it->v_address}.to<uint64_t>()); waiting != std::end(lq_slots_by_block)) {
+      for (auto slot : waiting->second) {
+        auto& lq_entry = LQ.at(slot);
+        assert(lq_entry.has_value() && lq_entry->fetch_issued);
         lq_entry->finish(std::begin(ROB), std::end(ROB));
-        lq_entry.reset();
+        release_lq_entry(lq_entry);
         ++progress;
       }
+      lq_slots_by_block.erase(waiting);
     }
     ++progress;
   }
@@ -730,6 +859,106 @@ long O3_CPU::retire_rob()
   return retire_count;
 }
 
+champsim::chrono::clock::time_point O3_CPU::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+
+  // Retirement, memory returns, DIB checks, and fetches are attempted on every cycle
+  if ((!std::empty(ROB) && ROB.front().completed) || !std::empty(L1I_bus.lower_level->returned) || !std::empty(L1D_bus.lower_level->returned)
+      || std::any_of(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), [](const ooo_model_instr& x) { return !x.dib_checked || !x.fetch_issued; })) {
+    return next_cycle;
+  }
+
+  auto next_event = champsim::chrono::clock::time_point::max();
+  auto consider = [&next_event](champsim::chrono::clock::time_point event) {
+    next_event = std::min(next_event, event);
+  };
+
+  // initialize_instruction()
+  if (!std::empty(input_queue) && std::size(IFETCH_BUFFER) < IFETCH_BUFFER_SIZE) {
+    consider(fetch_resume_time);
+  }
+
+  // promote_to_decode()
+  if (!std::empty(IFETCH_BUFFER) && IFETCH_BUFFER.front().fetch_completed && std::size(DIB_HIT_BUFFER) < DIB_HIT_BUFFER_SIZE
+      && std::size(DECODE_BUFFER) < DECODE_BUFFER_SIZE) {
+    consider(IFETCH_BUFFER.front().ready_time);
+  }
+
+  // decode_instruction() acts on the oldest of the two buffer heads
+  if (std::size(DISPATCH_BUFFER) < DISPATCH_BUFFER_SIZE) {
+    if (!std::empty(DIB_HIT_BUFFER) && !std::empty(DECODE_BUFFER)) {
+      consider(std::min(DIB_HIT_BUFFER.front(), DECODE_BUFFER.front(), ooo_model_instr::program_order).ready_time);
+    } else if (!std::empty(DIB_HIT_BUFFER)) {
+      consider(DIB_HIT_BUFFER.front().ready_time);
+    } else if (!std::empty(DECODE_BUFFER)) {
+      consider(DECODE_BUFFER.front().ready_time);
+    }
+  }
+
+  // dispatch_instruction()
+  if (!std::empty(DISPATCH_BUFFER) && std::size(ROB) != ROB_SIZE
+      && std::size(lq_free_slots) >= std::size(DISPATCH_BUFFER.front().source_memory)
+      && ((std::size(DISPATCH_BUFFER.front().destination_memory) + std::size(SQ)) <= SQ_SIZE)) {
+    consider(DISPATCH_BUFFER.front().ready_time);
+  }
+
+  // schedule_instruction(), following the same search window
+  champsim::bandwidth search_bw{SCHEDULER_SIZE};
+  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && search_bw.has_remaining(); ++rob_it) {
+    unsigned long sources_to_allocate = std::count_if(rob_it->source_registers.begin(), rob_it->source_registers.end(),
+                                                      [&alloc = reg_allocator](auto srcreg) { return !alloc.isAllocated(srcreg); });
+    if (reg_allocator.count_free_registers() < (sources_to_allocate + rob_it->destination_registers.size())) {
+      break;
+    }
+    if (!rob_it->scheduled) {
+      consider(rob_it->ready_time);
+    }
+    if (!rob_it->executed) {
+      search_bw.consume();
+    }
+  }
+
+  // execute_instruction()
+  for (auto rob_it : ready_to_execute) {
+    consider(rob_it->ready_time);
+  }
+
+  // complete_inflight_instruction()
+  for (auto rob_it : executing) {
+    if (rob_it->completed_mem_ops == rob_it->num_mem_ops()) {
+      consider(rob_it->ready_time);
+    }
+  }
+
+  // operate_lsq()
+  if (auto unfetched = std::partition_point(std::begin(SQ), std::end(SQ), [](const auto& x) { return x.fetch_issued; }); unfetched != std::end(SQ)) {
+    consider(unfetched->ready_time);
+  }
+  const auto complete_id = std::empty(ROB) ? std::numeric_limits<uint64_t>::max() : ROB.front().instr_id;
+  if (!std::empty(SQ) && SQ.front().fetch_issued && LSQ_ENTRY::precedes(complete_id)(SQ.front())) {
+    consider(SQ.front().ready_time);
+  }
+  for (auto slot : lq_ready_slots) {
+    consider(LQ.at(slot)->ready_time + champsim::chrono::clock::duration{1}); // loads issue strictly after they become ready
+  }
+
+  return next_event;
+}
+
+void O3_CPU::idle(long cycles) { sim_stats.skipped_operates += static_cast<uint64_t>(cycles); }
+
+std::vector<champsim::channel*> O3_CPU::lower_channels() const
+{
+  std::vector<champsim::channel*> retval;
+  for (auto* ll : {L1I_bus.lower_level, L1D_bus.lower_level}) {
+    if (ll != nullptr) {
+      retval.push_back(ll);
+    }
+  }
+  return retval;
+}
+
 void O3_CPU::impl_initialize_branch_predictor() const { branch_module_pimpl->impl_initialize_branch_predictor(); }
 
 void O3_CPU::impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) const
@@ -754,6 +983,22 @@ std::pair<champsim::address, bool> O3_CPU::impl_btb_prediction(champsim::address
   return btb_module_pimpl->impl_btb_prediction(ip, branch_type);
 }
 
+void O3_CPU::checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, num_retired);
+  champsim::checkpoint_save_section(os, typeid(*branch_module_pimpl).name(),
+                                    [this](auto& section) { branch_module_pimpl->impl_branch_checkpoint_save(section); });
+  champsim::checkpoint_save_section(os, typeid(*btb_module_pimpl).name(), [this](auto& section) { btb_module_pimpl->impl_btb_checkpoint_save(section); });
+}
+
+void O3_CPU::checkpoint_load(std::istream& is)
+{
+  champsim::msl::checkpoint_load(is, num_retired);
+  champsim::checkpoint_load_section(is, typeid(*branch_module_pimpl).name(),
+                                    [this](auto& section) { branch_module_pimpl->impl_branch_checkpoint_load(section); });
+  champsim::checkpoint_load_section(is, typeid(*btb_module_pimpl).name(), [this](auto& section) { btb_module_pimpl->impl_btb_checkpoint_load(section); });
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void O3_CPU::print_deadlock()
 {
@@ -807,9 +1052,9 @@ LSQ_ENTRY::LSQ_ENTRY(champsim::address addr, champsim::program_ordered<LSQ_ENTRY
 {
 }
 
-void LSQ_ENTRY::finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const
+void LSQ_ENTRY::finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const
 {
-  auto rob_entry = std::partition_point(begin, end, ooo_model_instr::precedes(this->instr_id));
+  auto rob_entry = ooo_model_instr::find_id(begin, end, this->instr_id);
   assert(rob_entry != end);
   finish(*rob_entry);
 }
@@ -847,3 +1092,24 @@ bool CacheBus::issue_write(request_type data_packet)
 
   return lower_level->add_wq(data_packet);
 }
+
+champsim::address CacheBus::functional_read(request_type data_packet) const
+{
+  data_packet.address = data_packet.v_address;
+  data_packet.is_translated = false;
+  data_packet.cpu = cpu;
+  data_packet.type = access_type::LOAD;
+
+  return lower_level->functional_access(data_packet);
+}
+
+void CacheBus::functional_write(request_type data_packet) const
+{
+  data_packet.address = data_packet.v_address;
+  data_packet.is_translated = false;
+  data_packet.cpu = cpu;
+  data_packet.type = access_type::WRITE;
+  data_packet.response_requested = false;
+
+  lower_level->functional_access(data_packet);
+}
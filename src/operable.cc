@@ -22,11 +22,22 @@ champsim::operable::operable(champsim::chrono::picoseconds clock_period_) : cloc
 
 long champsim::operable::operate_on(const champsim::chrono::clock& clock)
 {
+  if (asleep) {
+    idle_on(clock);
+    return 0;
+  }
+
+  const auto begin_time = current_time;
   long progress{0};
   while (current_time < clock.now()) {
     progress += _operate();
   }
 
+  // Nothing is scheduled, so nothing will happen until another component adds work
+  if (idle_gating && progress == 0 && current_time != begin_time && next_event_time() == champsim::chrono::clock::time_point::max()) {
+    sleep();
+  }
+
   return progress;
 }
 
@@ -36,4 +47,55 @@ long champsim::operable::_operate()
   return operate();
 }
 
+long champsim::operable::idle_on(const champsim::chrono::clock& clock)
+{
+  long cycles{0};
+  if (current_time < clock.now()) {
+    cycles = static_cast<long>((clock.now() - current_time + clock_period - champsim::chrono::clock::duration{1}) / clock_period);
+  }
+
+  return _idle(cycles);
+}
+
+long champsim::operable::_idle(long cycles)
+{
+  if (cycles > 0) {
+    current_time += cycles * clock_period;
+    idle(cycles);
+  }
+  return cycles;
+}
+
+champsim::chrono::clock::time_point champsim::operable::idle_until() const
+{
+  if (asleep) {
+    return champsim::chrono::clock::time_point::max();
+  }
+
+  // The latest time to which the global clock may advance such that idle_on() does not pass over next_event_time()
+  const auto next_event = next_event_time();
+  if (next_event == champsim::chrono::clock::time_point::max()) {
+    return next_event;
+  }
+  if (next_event <= current_time + clock_period) {
+    return current_time;
+  }
+  const auto cycles = (next_event - current_time + clock_period - champsim::chrono::clock::duration{1}) / clock_period;
+  return current_time + (cycles - 1) * clock_period;
+}
+
+void champsim::operable::sleep() { asleep = true; }
+
+void champsim::operable::wake()
+{
+  // Only write if needed, since several threads may wake a shared operable that is already awake
+  if (asleep) {
+    asleep = false;
+  }
+}
+
+bool champsim::operable::is_asleep() const { return asleep; }
+
+champsim::chrono::clock::time_point champsim::operable::next_event_time() const { return current_time + clock_period; }
+
 uint64_t champsim::operable::current_cycle() const { return static_cast<uint64_t>(current_time.time_since_epoch() / clock_period); }
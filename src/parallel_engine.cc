@@ -0,0 +1,184 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallel_engine.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <set>
+
+#include "channel.h"
+#include "environment.h"
+#include "operable.h"
+#include "vmem.h"
+
+auto champsim::partition_operables(const std::vector<std::reference_wrapper<operable>>& operables, const std::vector<std::reference_wrapper<operable>>& roots)
+    -> std::vector<std::vector<std::reference_wrapper<operable>>>
+{
+  // For each operable, the roots from which it can be reached
+  std::map<const operable*, std::set<std::size_t>> reached_from;
+  for (std::size_t root_idx = 0; root_idx < std::size(roots); ++root_idx) {
+    std::vector<const operable*> frontier{&roots.at(root_idx).get()};
+    while (!std::empty(frontier)) {
+      const auto* op = frontier.back();
+      frontier.pop_back();
+      if (reached_from[op].insert(root_idx).second) {
+        for (const auto* ch : op->lower_channels()) {
+          if (ch->request_sink != nullptr) {
+            frontier.push_back(ch->request_sink);
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<std::vector<std::reference_wrapper<operable>>> retval(std::size(roots) + 1);
+  for (operable& op : operables) {
+    auto found = reached_from.find(&op);
+    if (found != std::end(reached_from) && std::size(found->second) == 1) {
+      retval.at(*std::begin(found->second)).push_back(op);
+    } else {
+      retval.back().push_back(op);
+    }
+  }
+  return retval;
+}
+
+champsim::parallel_engine::parallel_engine(environment& env, std::size_t threads, long quantum, champsim::chrono::clock::duration time_quantum_,
+                                           bool deterministic)
+    : num_threads(std::max<std::size_t>(threads, 1)), quantum_cycles(quantum), time_quantum(time_quantum_)
+{
+  auto cpus = env.cpu_view();
+  num_threads = std::min(num_threads, std::max<std::size_t>(std::size(cpus), 1));
+
+  std::vector<std::reference_wrapper<operable>> roots{std::begin(cpus), std::end(cpus)};
+  const auto groups = partition_operables(env.operable_view(), roots);
+  std::transform(std::begin(groups), std::end(groups), std::back_inserter(partitions), [](const auto& group) { return domain_scheduler{group}; });
+  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(partition_cpus),
+                 [](O3_CPU& cpu) { return std::vector<std::reference_wrapper<O3_CPU>>{cpu}; });
+  partition_progress.resize(std::size(partitions));
+
+  // Without a given quantum, synchronize as often as a request could complete in the shared level of the hierarchy
+  if (quantum_cycles <= 0) {
+    const auto& shared = groups.back();
+    auto lookahead = champsim::chrono::clock::duration::max();
+    for (CACHE& cache : env.cache_view()) {
+      auto is_shared = std::any_of(std::begin(shared), std::end(shared), [addr = &cache](const operable& op) { return &op == addr; });
+      if (is_shared) {
+        lookahead = std::min(lookahead, cache.HIT_LATENCY);
+      }
+    }
+    quantum_cycles = (lookahead == champsim::chrono::clock::duration::max()) ? 1 : static_cast<long>(lookahead / time_quantum);
+    quantum_cycles = std::max<long>(quantum_cycles, 1);
+  }
+
+  if (deterministic) {
+    for (PageTableWalker& ptw : env.ptw_view()) {
+      ptw.vmem->partition_pages(std::size(cpus));
+    }
+  }
+
+  for (std::size_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back([this, i] { work(i); });
+  }
+}
+
+champsim::parallel_engine::~parallel_engine()
+{
+  {
+    std::lock_guard lock{mutex};
+    stopping = true;
+  }
+  start_cv.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+long champsim::parallel_engine::quantum() const { return quantum_cycles; }
+
+long champsim::parallel_engine::operate_partition(std::size_t index)
+{
+  auto clock = quantum_begin;
+  auto& scheduler = partitions.at(index);
+  long progress{0};
+  for (long cycle = 0; cycle < quantum_cycles; ++cycle) {
+    clock.tick(time_quantum);
+    progress += scheduler.operate_on(clock);
+
+    if (index < std::size(partition_cpus)) {
+      for (O3_CPU& cpu : partition_cpus.at(index)) {
+        (*fill_input)(cpu);
+      }
+    }
+  }
+  return progress;
+}
+
+void champsim::parallel_engine::operate_assigned(std::size_t thread_index)
+{
+  for (auto index = thread_index; index < std::size(partition_cpus); index += num_threads) {
+    partition_progress.at(index) = operate_partition(index);
+  }
+}
+
+void champsim::parallel_engine::work(std::size_t thread_index)
+{
+  uint64_t seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock lock{mutex};
+      start_cv.wait(lock, [this, seen_generation] { return stopping || generation != seen_generation; });
+      if (stopping) {
+        return;
+      }
+      seen_generation = generation;
+    }
+
+    operate_assigned(thread_index);
+
+    {
+      std::lock_guard lock{mutex};
+      --outstanding;
+    }
+    done_cv.notify_one();
+  }
+}
+
+long champsim::parallel_engine::operate_quantum(champsim::chrono::clock& global_clock, const std::function<void(O3_CPU&)>& fill_input_queue)
+{
+  quantum_begin = global_clock;
+  fill_input = &fill_input_queue;
+
+  // The shared partition goes first, so that with a quantum of one cycle the order of operation matches the serial engine
+  partition_progress.back() = operate_partition(std::size(partitions) - 1);
+
+  {
+    std::lock_guard lock{mutex};
+    ++generation;
+    outstanding = std::size(workers);
+  }
+  start_cv.notify_all();
+  operate_assigned(0);
+  {
+    std::unique_lock lock{mutex};
+    done_cv.wait(lock, [this] { return outstanding == 0; });
+  }
+
+  global_clock.tick(quantum_cycles * time_quantum);
+  return std::accumulate(std::begin(partition_progress), std::end(partition_progress), long{0});
+}
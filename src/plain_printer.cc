@@ -24,6 +24,7 @@
 #include <fmt/core.h>
 #include <fmt/ostream.h>
 
+#include "simpoint.h"
 #include "stats_printer.h"
 
 namespace
@@ -56,6 +57,10 @@ std::vector<std::string> champsim::plain_printer::format(O3_CPU::stats_type stat
                               ::print_ratio(std::kilo::num * total_mispredictions, stats.instrs()),
                               ::print_ratio(stats.total_rob_occupancy_at_branch_mispredict, total_mispredictions)));
 
+  if (stats.skipped_operates > 0) {
+    lines.push_back(fmt::format("{} Skipped operates: {}", stats.name, stats.skipped_operates));
+  }
+
   lines.emplace_back("Branch type MPKI");
   for (auto idx : types) {
     lines.push_back(fmt::format("{}: {}", branch_type_names.at(champsim::to_underlying(idx)),
@@ -122,6 +127,21 @@ std::vector<std::string> champsim::plain_printer::format(CACHE::stats_type stats
     uint64_t total_downstream_demands = total_mshr_return - stats.mshr_return.value_or(std::pair{access_type::PREFETCH, cpu}, mshr_return_value_type{});
     lines.push_back(
         fmt::format("cpu{}->{} AVERAGE MISS LATENCY: {} cycles", cpu, stats.name, ::print_ratio(stats.total_miss_latency_cycles, total_downstream_demands)));
+
+    for (const auto& shadow : stats.shadows) {
+      hits_value_type shadow_hits = 0;
+      misses_value_type shadow_misses = 0;
+      for (const auto type : {access_type::LOAD, access_type::RFO, access_type::PREFETCH, access_type::WRITE, access_type::TRANSLATION}) {
+        shadow_hits += shadow.hits.value_or(std::pair{type, cpu}, hits_value_type{});
+        shadow_misses += shadow.misses.value_or(std::pair{type, cpu}, misses_value_type{});
+      }
+      lines.push_back(fmt::format("cpu{}->{} SHADOW {} ACCESS: {:10d} HIT: {:10d} MISS: {:10d}", cpu, stats.name, shadow.name, shadow_hits + shadow_misses,
+                                  shadow_hits, shadow_misses));
+    }
+  }
+
+  if (stats.skipped_operates > 0) {
+    lines.push_back(fmt::format("{} SKIPPED OPERATES: {:10}", stats.name, stats.skipped_operates));
   }
 
   return lines;
@@ -155,6 +175,13 @@ std::vector<std::string> champsim::plain_printer::format(champsim::phase_stats&
 {
   std::vector<std::string> lines{};
   lines.push_back(fmt::format("=== {} ===", stats.name));
+  if (stats.weight.has_value()) {
+    lines.push_back(fmt::format("Weight: {:.4g}", stats.weight.value()));
+  }
+  if (stats.sampling.has_value()) {
+    lines.push_back(fmt::format("Samples: {} Confidence: {:.4g}%{}", stats.sampling->samples, 100 * stats.sampling->confidence,
+                                stats.sampling->converged ? "" : " (target error not reached)"));
+  }
 
   int i = 0;
   for (auto tn : stats.trace_names) {
@@ -181,8 +208,11 @@ std::vector<std::string> champsim::plain_printer::format(champsim::phase_stats&
   lines.emplace_back("");
   lines.emplace_back("Region of Interest Statistics");
 
-  for (const auto& stat : stats.roi_cpu_stats) {
-    auto sublines = format(stat);
+  for (std::size_t cpu = 0; cpu < std::size(stats.roi_cpu_stats); ++cpu) {
+    auto sublines = format(stats.roi_cpu_stats.at(cpu));
+    if (stats.sampling.has_value()) {
+      sublines.front() += fmt::format(" error bound: {:.3g}%", 100 * stats.sampling->error.at(cpu));
+    }
     lines.emplace_back("");
     std::move(std::begin(sublines), std::end(sublines), std::back_inserter(lines));
     lines.emplace_back("");
@@ -209,4 +239,22 @@ void champsim::plain_printer::print(std::vector<phase_stats>& stats)
   for (auto p : stats) {
     print(p);
   }
+
+  if (auto summary = summarize_weighted(stats); summary.has_value()) {
+    stream << fmt::format("=== Weighted ===\nTotal weight: {:.4g}\n", summary->total_weight);
+    for (std::size_t cpu = 0; cpu < std::size(summary->cpi); ++cpu) {
+      stream << fmt::format("CPU {} weighted IPC: {:.4g} CPI: {:.4g}\n", cpu, 1 / summary->cpi.at(cpu), summary->cpi.at(cpu));
+    }
+  }
+}
+
+void champsim::plain_printer::print(const std::vector<variant_result>& results)
+{
+  stream << "=== Variants ===\n";
+  for (const auto& result : results) {
+    stream << fmt::format("Variant {} exit status: {}\n", result.name, result.exit_status);
+    for (std::size_t cpu = 0; cpu < std::size(result.ipc); ++cpu) {
+      stream << fmt::format("Variant {} CPU {} cumulative IPC: {:.4g}\n", result.name, cpu, result.ipc.at(cpu));
+    }
+  }
 }
@@ -16,7 +16,10 @@
 
 #include "ptw.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <functional>
 #include <numeric>
 #include <fmt/chrono.h>
 #include <fmt/core.h>
@@ -24,6 +27,7 @@
 #include "champsim.h"
 #include "deadlock.h"
 #include "instruction.h"
+#include "msl/checkpoint.h"
 #include "ptw_builder.h" // for ptw_builder
 #include "util/bits.h"   // for bitmask, lg2, splice_bits
 #include "util/span.h"
@@ -53,7 +57,7 @@ PageTableWalker::mshr_type::mshr_type(const request_type& req, std::size_t level
   asid[1] = req.asid[1];
 }
 
-auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type* ul) -> std::optional<mshr_type>
+auto PageTableWalker::begin_walk(const request_type& handle_pkt) -> mshr_type
 {
   pscl_entry walk_init = {handle_pkt.v_address, CR3_addr, std::size(pscl)};
   std::vector<std::optional<pscl_entry>> pscl_hits;
@@ -68,15 +72,22 @@ auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type*
   mshr_type fwd_mshr{handle_pkt, walk_init.level};
   fwd_mshr.address = champsim::address{champsim::splice(champsim::page_number{walk_init.ptw_addr}, champsim::page_offset{walk_offset})};
   fwd_mshr.v_address = handle_pkt.address;
-  if (handle_pkt.response_requested) {
-    fwd_mshr.to_return = {&ul->returned};
-  }
 
   if constexpr (champsim::debug_print) {
     fmt::print("[{}] {} address: {} v_address: {} pt_page_offset: {} translation_level: {} cycle: {}\n", NAME, __func__, fwd_mshr.address, handle_pkt.v_address,
                walk_offset.to<int>(), walk_init.level, current_time.time_since_epoch() / clock_period);
   }
 
+  return fwd_mshr;
+}
+
+auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type* ul) -> std::optional<mshr_type>
+{
+  auto fwd_mshr = begin_walk(handle_pkt);
+  if (handle_pkt.response_requested) {
+    fwd_mshr.to_return = {ul};
+  }
+
   return step_translation(fwd_mshr);
 }
 
@@ -99,7 +110,7 @@ auto PageTableWalker::handle_fill(const mshr_type& fill_mshr) -> std::optional<m
   return step_translation(fwd_mshr);
 }
 
-auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional<mshr_type>
+auto PageTableWalker::step_request(const mshr_type& source) -> request_type
 {
   request_type packet;
   packet.address = source.address;
@@ -111,7 +122,12 @@ auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional
   packet.is_translated = true;
   packet.type = access_type::TRANSLATION;
 
-  bool success = lower_level->add_rq(packet);
+  return packet;
+}
+
+auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional<mshr_type>
+{
+  bool success = lower_level->add_rq(step_request(source));
   if (success) {
     return source;
   }
@@ -136,7 +152,8 @@ long PageTableWalker::operate()
   auto [complete_begin, complete_end] = champsim::get_span_p(std::cbegin(completed), std::cend(completed), fill_bw, is_ready);
   std::for_each(complete_begin, complete_end, [](auto& mshr_entry) {
     for (auto ret : mshr_entry.to_return) {
-      ret->emplace_back(mshr_entry.v_address, mshr_entry.v_address, *mshr_entry.data, mshr_entry.pf_metadata, mshr_entry.instr_depend_on_me);
+      ret->add_returned(
+          response_type{mshr_entry.v_address, mshr_entry.v_address, *mshr_entry.data, mshr_entry.pf_metadata, mshr_entry.instr_depend_on_me});
     }
   });
   fill_bw.consume(std::distance(complete_begin, complete_end));
@@ -163,7 +180,10 @@ long PageTableWalker::operate()
       return result.has_value();
     });
     tag_bw.consume(std::distance(rq_begin, rq_end));
-    ul->RQ.erase(rq_begin, rq_end);
+    if (rq_begin != rq_end) {
+      ul->RQ.erase(rq_begin, rq_end);
+      ul->notify_drained();
+    }
   }
 
   MSHR.insert(std::cend(MSHR), std::begin(next_steps), std::end(next_steps));
@@ -180,6 +200,69 @@ long PageTableWalker::operate()
   return progress;
 }
 
+champsim::chrono::clock::time_point PageTableWalker::next_event_time() const
+{
+  const auto next_cycle = current_time + clock_period;
+  if (!std::empty(lower_level->returned)) {
+    return next_cycle;
+  }
+
+  // Reads and the steps of walks are retried on every cycle until the lower level has room for them. The retries are replayed by idle(), so a blocked
+  // read or step is not an event, but one that has yet to become ready is.
+  const bool lower_full = lower_level->rq_occupancy() >= lower_level->rq_size();
+  auto has_reads = [](const auto* ul) {
+    return !std::empty(ul->RQ);
+  };
+  if (!lower_full && std::any_of(std::begin(upper_levels), std::end(upper_levels), has_reads)) {
+    return next_cycle;
+  }
+
+  auto next_event = champsim::chrono::clock::time_point::max();
+  for (const auto& entry : completed) {
+    next_event = std::min(next_event, entry.data.ready_time());
+  }
+  for (const auto& entry : finished) {
+    if (!lower_full || entry.data.ready_time() > next_cycle) {
+      next_event = std::min(next_event, entry.data.ready_time());
+    }
+  }
+
+  return next_event;
+}
+
+void PageTableWalker::retry_blocked()
+{
+  auto is_ready = [time = current_time](const auto& pkt) {
+    return pkt.data.is_ready_at(time);
+  };
+  auto [fill_begin, fill_end] = champsim::get_span_p(std::cbegin(finished), std::cend(finished), champsim::bandwidth{MAX_FILL}, is_ready);
+  if (fill_begin != fill_end) {
+    [[maybe_unused]] const auto result = handle_fill(*fill_begin);
+    assert(!result.has_value());
+  }
+
+  for (auto* ul : upper_levels) {
+    if (auto [rq_begin, rq_end] = champsim::get_span(std::cbegin(ul->RQ), std::cend(ul->RQ), champsim::bandwidth{MAX_READ}); rq_begin != rq_end) {
+      [[maybe_unused]] const auto result = handle_read(*rq_begin, ul);
+      assert(!result.has_value());
+    }
+  }
+}
+
+void PageTableWalker::idle(long cycles)
+{
+  // Each call to operate() repeats the attempts of the blocked reads and steps, which look up the paging structure caches and count as accesses to the
+  // lower level
+  auto has_reads = [](const auto* ul) {
+    return !std::empty(ul->RQ);
+  };
+  const bool has_retries = (!std::empty(finished) && finished.front().data.is_ready_at(current_time))
+                           || std::any_of(std::begin(upper_levels), std::end(upper_levels), has_reads);
+  for (long i = 0; has_retries && i < cycles; ++i) {
+    retry_blocked();
+  }
+}
+
 void PageTableWalker::finish_packet(const response_type& packet)
 {
   auto finish_step = [this](auto mshr_entry) {
@@ -222,6 +305,41 @@ void PageTableWalker::finish_packet(const response_type& packet)
   MSHR.erase(std::begin(MSHR), last_finished);
 }
 
+champsim::address PageTableWalker::functional_access(const request_type& packet)
+{
+  auto walk = begin_walk(packet);
+  for (;;) {
+    lower_level->functional_access(step_request(walk));
+
+    if (walk.translation_level == 0) {
+      return champsim::address{vmem->va_to_pa(walk.cpu, champsim::page_number{walk.v_address}).first};
+    }
+
+    auto next_table = vmem->get_pte_pa(walk.cpu, champsim::page_number{walk.v_address}, walk.translation_level).first;
+    pscl.at(std::size(pscl) - walk.translation_level).fill({walk.v_address, next_table, walk.translation_level - 1});
+    walk.address = next_table;
+    --walk.translation_level;
+  }
+}
+
+std::vector<champsim::channel*> PageTableWalker::lower_channels() const
+{
+  if (lower_level == nullptr) {
+    return {};
+  }
+  return {lower_level};
+}
+
+void PageTableWalker::initialize()
+{
+  for (auto* ul : upper_levels) {
+    ul->request_sink = this;
+  }
+  if (lower_level != nullptr) {
+    lower_level->response_sink = this;
+  }
+}
+
 void PageTableWalker::begin_phase()
 {
   for (auto* ul : upper_levels) {
@@ -232,6 +350,26 @@ void PageTableWalker::begin_phase()
   }
 }
 
+void PageTableWalker::checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, static_cast<uint64_t>(std::size(pscl)));
+  for (const auto& cache : pscl) {
+    champsim::msl::checkpoint_save(os, cache);
+  }
+}
+
+void PageTableWalker::checkpoint_load(std::istream& is)
+{
+  uint64_t num_pscl{};
+  champsim::msl::checkpoint_load(is, num_pscl);
+  if (num_pscl != std::size(pscl)) {
+    throw std::runtime_error{fmt::format("{} was checkpointed with {} paging structure caches, but has {}", NAME, num_pscl, std::size(pscl))};
+  }
+  for (auto& cache : pscl) {
+    champsim::msl::checkpoint_load(is, cache);
+  }
+}
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void PageTableWalker::print_deadlock()
 {
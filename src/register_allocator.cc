@@ -9,6 +9,7 @@ RegisterAllocator::RegisterAllocator(size_t num_physical_registers)
     free_registers.push(static_cast<PHYSICAL_REGISTER_ID>(i));
   }
   physical_register_file = std::vector<physical_register>(num_physical_registers, {0, 0, false, false});
+  consumers.resize(num_physical_registers);
   frontend_RAT.fill(-1); // default value for no mapping
   backend_RAT.fill(-1);
 }
@@ -42,10 +43,22 @@ PHYSICAL_REGISTER_ID RegisterAllocator::rename_src_register(int16_t reg)
   return phys;
 }
 
-void RegisterAllocator::complete_dest_register(PHYSICAL_REGISTER_ID physreg)
+void RegisterAllocator::add_consumer(PHYSICAL_REGISTER_ID physreg, champsim::program_ordered<ooo_model_instr>::id_type consumer_id)
+{
+  assert(!isValid(physreg));
+  consumers.at(physreg).push_back(consumer_id);
+}
+
+const std::vector<champsim::program_ordered<ooo_model_instr>::id_type>& RegisterAllocator::complete_dest_register(PHYSICAL_REGISTER_ID physreg)
 {
   // mark the physical register as valid
   physical_register_file.at(physreg).valid = true;
+
+  // wake the instructions that wait on it
+  // Swapping hands the consumer list's storage to the returned buffer and the buffer's storage back to the register, so neither reallocates once warm
+  woken.clear();
+  woken.swap(consumers.at(physreg));
+  return woken;
 }
 
 void RegisterAllocator::retire_dest_register(PHYSICAL_REGISTER_ID physreg)
@@ -66,6 +79,7 @@ void RegisterAllocator::retire_dest_register(PHYSICAL_REGISTER_ID physreg)
 void RegisterAllocator::free_register(PHYSICAL_REGISTER_ID physreg)
 {
   physical_register_file.at(physreg) = {255, 0, false, false}; // arch_reg_index, producing_inst_id, valid, busy
+  consumers.at(physreg).clear();
   free_registers.push(physreg);
 }
 
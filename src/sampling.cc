@@ -0,0 +1,72 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sampling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <fmt/core.h>
+
+long long champsim::sampling_parameters::functional_warmup() const { return std::max(0LL, period - detailed_warmup - measurement); }
+
+void champsim::sample_estimate::add(double value)
+{
+  // Welford's method, which does not lose precision when the variance is small relative to the mean
+  ++n;
+  auto delta = value - mean_;
+  mean_ += delta / static_cast<double>(n);
+  sum_sq_ += delta * (value - mean_);
+}
+
+double champsim::sample_estimate::variance() const
+{
+  if (n < 2) {
+    return 0;
+  }
+  return sum_sq_ / static_cast<double>(n - 1);
+}
+
+double champsim::sample_estimate::relative_error(double z) const
+{
+  if (n < 2 || mean_ == 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return z * std::sqrt(variance() / static_cast<double>(n)) / std::abs(mean_);
+}
+
+double champsim::z_score(double confidence)
+{
+  if (!(confidence > 0 && confidence < 1)) {
+    throw std::range_error{fmt::format("The confidence level {} is not between 0 and 1", confidence)};
+  }
+
+  // The two-sided coverage of [-z, z] is erf(z / sqrt(2)), which increases with z, so it can be inverted by bisection
+  constexpr double max_z = 40;
+  constexpr int iterations = 100;
+  double lower = 0;
+  double upper = max_z;
+  for (int i = 0; i < iterations; ++i) {
+    auto mid = (lower + upper) / 2;
+    if (std::erf(mid / std::sqrt(2.0)) < confidence) {
+      lower = mid;
+    } else {
+      upper = mid;
+    }
+  }
+  return (lower + upper) / 2;
+}
@@ -0,0 +1,155 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shared_trace.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace champsim
+{
+shared_trace::shared_trace(std::function<tracereader()> open_fn, std::size_t window_chunks)
+    : open(std::move(open_fn)), reader(open()), window(std::max<std::size_t>(window_chunks, 1))
+{
+}
+
+shared_trace::cursor shared_trace::make_cursor(const std::shared_ptr<shared_trace>& trace, uint8_t cpu, bool stamp_asid, uint64_t offset)
+{
+  std::lock_guard lock{trace->mutex};
+  trace->cursor_chunks.push_back(offset / chunk_size);
+  return cursor{trace, std::size(trace->cursor_chunks) - 1, cpu, stamp_asid, offset};
+}
+
+void shared_trace::pause()
+{
+  std::lock_guard lock{mutex};
+  reader.pause();
+}
+
+void shared_trace::move_cursor(std::size_t cursor_id, uint64_t index)
+{
+  std::lock_guard lock{mutex};
+  cursor_chunks.at(cursor_id) = index;
+}
+
+std::shared_ptr<const shared_trace::chunk_type> shared_trace::chunk(std::size_t cursor_id, uint64_t index)
+{
+  std::lock_guard lock{mutex};
+  if (index < first_chunk) {
+    return nullptr;
+  }
+  cursor_chunks.at(cursor_id) = index;
+
+  // Release the chunks that every cursor has passed, and those that are further behind than the window.
+  // Cursors that need the latter continue with readers of their own.
+  auto lowest = *std::min_element(std::cbegin(cursor_chunks), std::cend(cursor_chunks));
+  assert(lowest <= index);
+  lowest = std::max(lowest, (index >= window) ? index + 1 - window : 0);
+  while (!std::empty(chunks) && first_chunk < lowest) {
+    chunks.pop_front();
+    ++first_chunk;
+  }
+
+  // No cursor needs the instructions before the lowest chunk, so the reader may skip them
+  if (std::empty(chunks) && first_chunk < lowest) {
+    reader.fast_forward(lowest * chunk_size);
+    first_chunk = lowest;
+  }
+
+  while (first_chunk + std::size(chunks) <= index) {
+    if (reader.eof()) {
+      return std::make_shared<const chunk_type>();
+    }
+
+    auto next = std::make_shared<chunk_type>();
+    next->reserve(chunk_size);
+    while (std::size(*next) < chunk_size && !reader.eof()) {
+      next->push_back(reader());
+    }
+    chunks.push_back(std::move(next));
+  }
+
+  return chunks.at(index - first_chunk);
+}
+
+shared_trace::cursor::cursor(std::shared_ptr<shared_trace> trace_, std::size_t id_, uint8_t cpu_, bool stamp_asid_, uint64_t position_)
+    : trace(std::move(trace_)), id(id_), cpu(cpu_), stamp_asid(stamp_asid_), position(position_)
+{
+}
+
+void shared_trace::cursor::load() const
+{
+  auto index = position / chunk_size;
+  if (own_reader.has_value() || (current != nullptr && current_index == index)) {
+    return;
+  }
+
+  current = trace->chunk(id, index);
+  current_index = index;
+  if (current == nullptr) {
+    trace->move_cursor(id, detached);
+    own_reader.emplace(trace->open());
+    own_reader->fast_forward(position);
+  }
+}
+
+ooo_model_instr shared_trace::cursor::operator()()
+{
+  load();
+  auto retval = own_reader.has_value() ? (*own_reader)() : current->at(position % chunk_size);
+  ++position;
+
+  if (stamp_asid) {
+    retval.asid = {cpu, cpu};
+  }
+  return retval;
+}
+
+bool shared_trace::cursor::eof() const
+{
+  load();
+  if (own_reader.has_value()) {
+    return own_reader->eof();
+  }
+  return position % chunk_size >= std::size(*current);
+}
+
+void shared_trace::cursor::pause()
+{
+  if (own_reader.has_value()) {
+    own_reader->pause();
+  }
+  trace->pause();
+}
+
+uint64_t shared_trace::cursor::seek(uint64_t current_pos, uint64_t target)
+{
+  if (target <= current_pos) {
+    return current_pos;
+  }
+
+  if (own_reader.has_value()) {
+    auto before = own_reader->position();
+    own_reader->fast_forward(before + (target - current_pos));
+    position += own_reader->position() - before;
+    return current_pos + (own_reader->position() - before);
+  }
+
+  position += target - current_pos;
+  trace->move_cursor(id, position / chunk_size);
+  return target;
+}
+} // namespace champsim
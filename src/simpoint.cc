@@ -0,0 +1,112 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "simpoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <map>
+#include <stdexcept>
+#include <fmt/core.h>
+
+std::vector<champsim::simpoint> champsim::read_simpoints(std::istream& simpoints, std::istream& weights)
+{
+  std::map<long long, long long> interval_of_cluster;
+  long long interval{};
+  long long cluster{};
+  while (simpoints >> interval >> cluster) {
+    interval_of_cluster.insert_or_assign(cluster, interval);
+  }
+
+  std::vector<simpoint> retval;
+  double weight{};
+  while (weights >> weight >> cluster) {
+    auto found = interval_of_cluster.find(cluster);
+    if (found == std::end(interval_of_cluster)) {
+      throw std::runtime_error{fmt::format("SimPoint cluster {} has a weight but no interval", cluster)};
+    }
+    retval.push_back(simpoint{found->second, weight});
+    interval_of_cluster.erase(found);
+  }
+
+  if (!std::empty(interval_of_cluster)) {
+    throw std::runtime_error{fmt::format("SimPoint cluster {} has an interval but no weight", std::begin(interval_of_cluster)->first)};
+  }
+
+  std::sort(std::begin(retval), std::end(retval), [](const auto& lhs, const auto& rhs) { return lhs.interval < rhs.interval; });
+  return retval;
+}
+
+std::vector<champsim::phase_info> champsim::simpoint_phases(const std::vector<simpoint>& points, long long interval_length, long long warmup_length,
+                                                            const phase_info& base)
+{
+  std::vector<phase_info> retval;
+  long long previous_end = 0;
+  for (const auto& point : points) {
+    const auto interval_begin = point.interval * interval_length;
+
+    // The warmup may not reach back into the interval of the previous point, which has already been simulated
+    phase_info warmup{base};
+    warmup.name = fmt::format("Warmup {}", point.interval);
+    warmup.is_warmup = true;
+    warmup.length = std::clamp(interval_begin - previous_end, 0ll, warmup_length);
+    warmup.fast_forward_to = static_cast<uint64_t>(interval_begin - warmup.length);
+    warmup.weight.reset();
+
+    phase_info detailed{base};
+    detailed.name = fmt::format("SimPoint {}", point.interval);
+    detailed.is_warmup = false;
+    detailed.length = interval_length;
+    detailed.fast_forward_to = 0;
+    detailed.weight = point.weight;
+
+    // A point at the start of the trace, or directly after the previous point, has no instructions before it to warm with
+    if (warmup.length > 0) {
+      retval.push_back(warmup);
+    } else {
+      detailed.fast_forward_to = warmup.fast_forward_to;
+    }
+    retval.push_back(detailed);
+    previous_end = interval_begin + interval_length;
+  }
+  return retval;
+}
+
+auto champsim::summarize_weighted(const std::vector<phase_stats>& stats) -> std::optional<weighted_summary>
+{
+  std::optional<weighted_summary> retval;
+  for (const auto& phase : stats) {
+    if (!phase.weight.has_value()) {
+      continue;
+    }
+
+    if (!retval.has_value()) {
+      retval = weighted_summary{0, std::vector<double>(std::size(phase.roi_cpu_stats), 0)};
+    }
+
+    retval->total_weight += phase.weight.value();
+    for (std::size_t cpu = 0; cpu < std::size(phase.roi_cpu_stats) && cpu < std::size(retval->cpi); ++cpu) {
+      const auto& cpu_stats = phase.roi_cpu_stats.at(cpu);
+      retval->cpi.at(cpu) += phase.weight.value() * std::ceil(cpu_stats.cycles()) / std::ceil(cpu_stats.instrs());
+    }
+  }
+
+  if (retval.has_value() && retval->total_weight > 0) {
+    std::transform(std::begin(retval->cpi), std::end(retval->cpi), std::begin(retval->cpi), [total = retval->total_weight](auto x) { return x / total; });
+  }
+  return retval;
+}
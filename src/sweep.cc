@@ -0,0 +1,158 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sweep.h"
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <fmt/core.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "knob.h"
+
+std::pair<std::string, long> champsim::parse_knob_setting(std::string_view spec)
+{
+  auto split = spec.find('=');
+  if (split == std::string_view::npos || split == 0) {
+    throw std::invalid_argument{fmt::format("The knob setting {} is not of the form KNOB=VALUE", spec)};
+  }
+
+  auto value_text = spec.substr(split + 1);
+  long value{};
+  auto [end, ec] = std::from_chars(value_text.data(), value_text.data() + value_text.size(), value);
+  if (ec != std::errc{} || end != value_text.data() + value_text.size()) {
+    throw std::invalid_argument{fmt::format("The value of the knob setting {} is not an integer", spec)};
+  }
+
+  return std::pair{std::string{spec.substr(0, split)}, value};
+}
+
+auto champsim::parse_variant(std::string_view spec) -> variant
+{
+  auto split = spec.find(':');
+  if (split == std::string_view::npos || split == 0) {
+    throw std::invalid_argument{fmt::format("The variant {} is not of the form NAME:KNOB=VALUE[,KNOB=VALUE...]", spec)};
+  }
+
+  variant retval{std::string{spec.substr(0, split)}};
+  auto settings = spec.substr(split + 1);
+  while (!settings.empty()) {
+    auto next = settings.find(',');
+    retval.knobs.push_back(parse_knob_setting(settings.substr(0, next)));
+    settings = (next == std::string_view::npos) ? std::string_view{} : settings.substr(next + 1);
+  }
+
+  return retval;
+}
+
+champsim::variant_sweep::variant_sweep(std::vector<variant> variants_) : variants(std::move(variants_)) {}
+
+bool champsim::variant_sweep::fork_children()
+{
+  for (std::size_t i = 0; i < std::size(variants); ++i) {
+    std::array<int, 2> fds{};
+    if (::pipe(fds.data()) != 0) {
+      throw std::system_error{errno, std::generic_category(), "Could not open a pipe to the variant"};
+    }
+
+    // Output that is still buffered would otherwise be written again by every child
+    std::cout.flush();
+    std::fflush(stdout);
+
+    auto pid = ::fork();
+    if (pid < 0) {
+      throw std::system_error{errno, std::generic_category(), "Could not fork the variant"};
+    }
+
+    if (pid == 0) {
+      ::close(fds[0]);
+      for (const auto& child : children) {
+        ::close(child.result_fd);
+      }
+      children.clear();
+
+      child_index = i;
+      result_fd = fds[1];
+
+      const auto& var = variants.at(i);
+      auto output_name = var.name + ".txt";
+      if (std::freopen(output_name.c_str(), "w", stdout) == nullptr) {
+        throw std::system_error{errno, std::generic_category(), fmt::format("Could not open {}", output_name)};
+      }
+
+      fmt::print("Variant {}\n", var.name);
+      for (const auto& [name, value] : var.knobs) {
+        knob::set(name, value);
+        fmt::print("Knob {}: {}\n", name, value);
+      }
+      return true;
+    }
+
+    ::close(fds[1]);
+    children.push_back({pid, fds[0]});
+    fmt::print("Forked variant {} as process {}\n", variants.at(i).name, pid);
+  }
+
+  for (std::size_t i = 0; i < std::size(children); ++i) {
+    std::string received;
+    std::array<char, 256> buffer{};
+    for (auto count = ::read(children.at(i).result_fd, buffer.data(), buffer.size()); count > 0;
+         count = ::read(children.at(i).result_fd, buffer.data(), buffer.size())) {
+      received.append(buffer.data(), static_cast<std::size_t>(count));
+    }
+    ::close(children.at(i).result_fd);
+
+    int status = 0;
+    ::waitpid(children.at(i).pid, &status, 0);
+
+    variant_result result{variants.at(i).name};
+    result.exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    std::istringstream received_stream{received};
+    for (double ipc{}; received_stream >> ipc;) {
+      result.ipc.push_back(ipc);
+    }
+    results.push_back(result);
+  }
+  children.clear();
+
+  return false;
+}
+
+auto champsim::variant_sweep::current() const -> const variant& { return variants.at(child_index.value()); }
+
+void champsim::variant_sweep::report(const std::vector<double>& ipc) const
+{
+  std::string message;
+  for (auto x : ipc) {
+    message += fmt::format("{:.17g} ", x);
+  }
+  message += '\n';
+
+  for (std::string_view remaining{message}; !remaining.empty();) {
+    auto count = ::write(result_fd, remaining.data(), remaining.size());
+    if (count < 0) {
+      break;
+    }
+    remaining.remove_prefix(static_cast<std::size_t>(count));
+  }
+}
@@ -17,14 +17,18 @@
 #include "tracereader.h"
 
 #include <fstream>
+#include <map>
 #include <string>
+#include <vector>
 
+#include "async_reader.h"
 #include "inf_stream.h"
 #include "repeatable.h"
+#include "shared_trace.h"
 
 namespace champsim
 {
-uint64_t tracereader::instr_unique_id = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+uint64_t tracereader::readers_constructed = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 ooo_model_instr apply_branch_target(ooo_model_instr branch, const ooo_model_instr& target)
 {
@@ -32,27 +36,55 @@ ooo_model_instr apply_branch_target(ooo_model_instr branch, const ooo_model_inst
   return branch;
 }
 
-template <template <class, class> typename R, typename T>
-champsim::tracereader get_tracereader_for_type(std::string fname, uint8_t cpu)
+template <typename F>
+using native_stream = F;
+
+// Select the stream that decompresses the file, and read records in the trace format Format from it
+template <template <class, class> typename R, typename T, template <class> typename Format, typename Uncompressed>
+champsim::tracereader get_tracereader_for_format(std::string fname, uint8_t cpu)
 {
   if (bool is_gzip_compressed = (fname.substr(std::size(fname) - 2) == "gz"); is_gzip_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>(cpu, fname)};
+    return champsim::tracereader{R<T, Format<champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>>(cpu, fname)};
   }
 
   if (bool is_lzma_compressed = (fname.substr(std::size(fname) - 2) == "xz"); is_lzma_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>(cpu, fname)};
+    return champsim::tracereader{R<T, Format<champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>>(cpu, fname)};
   }
 
   if (bool is_bzip2_compressed = (fname.substr(std::size(fname) - 3) == "bz2"); is_bzip2_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>(cpu, fname)};
+    return champsim::tracereader{R<T, Format<champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>>(cpu, fname)};
   }
 
-  return champsim::tracereader{R<T, std::ifstream>(cpu, fname)};
+  if (bool is_zstd_compressed = (fname.substr(std::size(fname) - 3) == "zst"); is_zstd_compressed) {
+    return champsim::tracereader{R<T, Format<champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>>>(cpu, fname)};
+  }
+
+  return champsim::tracereader{R<T, Format<Uncompressed>>(cpu, fname)};
+}
+
+template <template <class, class> typename R, typename T>
+champsim::tracereader get_tracereader_for_type(std::string fname, uint8_t cpu)
+{
+  if (champsim::columnar::is_columnar_trace(fname)) {
+    return get_tracereader_for_format<R, T, champsim::columnar_istream, std::ifstream>(fname, cpu);
+  }
+  if (champsim::dictionary::is_dictionary_trace(fname)) {
+    return get_tracereader_for_format<R, T, champsim::dictionary_istream, std::ifstream>(fname, cpu);
+  }
+  if (champsim::mmap_file::can_map(fname)) {
+    return get_tracereader_for_format<R, T, native_stream, champsim::mmap_file>(fname, cpu);
+  }
+  return get_tracereader_for_format<R, T, native_stream, std::ifstream>(fname, cpu);
 }
 } // namespace champsim
 
+// The trace is decompressed and decoded on a background thread. The reader is reopened outside of that thread, so that the end of the trace
+// is reported when the simulation reaches it.
+template <typename T, typename S>
+using async_reader_t = champsim::async_reader<champsim::bulk_tracereader<T, S>>;
+
 template <typename T, typename S>
-using repeatable_reader_t = champsim::repeatable<champsim::bulk_tracereader<T, S>, uint8_t, std::string>;
+using repeatable_reader_t = champsim::repeatable<async_reader_t<T, S>, uint8_t, std::string>;
 
 champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool repeat)
 {
@@ -61,12 +93,43 @@ champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, boo
   }
 
   if (is_cloudsuite && !repeat) {
-    return champsim::get_tracereader_for_type<champsim::bulk_tracereader, cloudsuite_instr>(fname, cpu);
+    return champsim::get_tracereader_for_type<async_reader_t, cloudsuite_instr>(fname, cpu);
   }
 
   if (!is_cloudsuite && repeat) {
     return champsim::get_tracereader_for_type<repeatable_reader_t, input_instr>(fname, cpu);
   }
 
-  return champsim::get_tracereader_for_type<champsim::bulk_tracereader, input_instr>(fname, cpu);
+  return champsim::get_tracereader_for_type<async_reader_t, input_instr>(fname, cpu);
+}
+
+std::vector<champsim::tracereader> get_tracereaders(const std::vector<std::string>& fnames, bool is_cloudsuite, bool repeat, uint64_t offset)
+{
+  std::map<std::string, std::vector<uint8_t>> cpus_of_trace;
+  for (std::size_t cpu = 0; cpu < std::size(fnames); ++cpu) {
+    cpus_of_trace[fnames[cpu]].push_back(static_cast<uint8_t>(cpu));
+  }
+
+  std::vector<std::optional<champsim::tracereader>> readers(std::size(fnames));
+  for (const auto& [fname, cpus] : cpus_of_trace) {
+    if (std::size(cpus) == 1) {
+      readers.at(cpus.front()).emplace(get_tracereader(fname, cpus.front(), is_cloudsuite, repeat));
+      continue;
+    }
+
+    // The shared trace retains the instructions between the first and last cursors, in addition to its window
+    auto spread_chunks = (offset * (std::size(cpus) - 1)) / champsim::shared_trace::chunk_size + 1;
+    auto trace = std::make_shared<champsim::shared_trace>(
+        [fname = fname, cpu = cpus.front(), is_cloudsuite, repeat] { return get_tracereader(fname, cpu, is_cloudsuite, repeat); },
+        champsim::shared_trace::default_window + spread_chunks);
+    for (std::size_t i = 0; i < std::size(cpus); ++i) {
+      readers.at(cpus[i]).emplace(champsim::shared_trace::make_cursor(trace, cpus[i], !is_cloudsuite, offset * i));
+    }
+  }
+
+  std::vector<champsim::tracereader> retval;
+  for (auto& reader : readers) {
+    retval.push_back(*std::move(reader));
+  }
+  return retval;
 }
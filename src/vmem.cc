@@ -16,11 +16,16 @@
 
 #include "vmem.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <numeric>
+#include <tuple>
 #include <fmt/core.h>
 
 #include "champsim.h"
 #include "dram_controller.h"
+#include "msl/checkpoint.h"
 #include "util/bits.h"
 
 using namespace champsim::data::data_literals;
@@ -28,9 +33,7 @@ using namespace champsim::data::data_literals;
 VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
                              MEMORY_CONTROLLER& dram_, std::optional<uint64_t> randomization_seed_)
     : randomization_seed(randomization_seed_), dram(dram_), minor_fault_penalty(minor_penalty), pt_levels(page_table_levels),
-      pte_page_size(page_table_page_size),
-      next_pte_page(
-          champsim::dynamic_extent{champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{champsim::lg2(champsim::data::bytes{pte_page_size}.count())}}, 0)
+      pte_page_size(page_table_page_size), pools(1, make_pool())
 {
   assert(pte_page_size > 1_kiB);
   assert(champsim::is_power_of_2(pte_page_size.count()));
@@ -44,8 +47,8 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
   if (required_bits > champsim::data::bits{champsim::lg2(dram.size().count())}) {
     fmt::print("[VMEM] WARNING: physical memory size is smaller than virtual memory size.\n"); // LCOV_EXCL_LINE
   }
-  populate_pages();
-  shuffle_pages();
+  populate_pages(pools.front().ppage_free_list);
+  shuffle_pages(pools.front().ppage_free_list);
 }
 
 VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
@@ -54,25 +57,56 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
 {
 }
 
-void VirtualMemory::populate_pages()
+auto VirtualMemory::make_pool() const -> page_pool
+{
+  return page_pool{
+      {},
+      {},
+      champsim::address_slice{
+          champsim::dynamic_extent{champsim::data::bits{LOG2_PAGE_SIZE}, champsim::data::bits{champsim::lg2(champsim::data::bytes{pte_page_size}.count())}},
+          0}};
+}
+
+void VirtualMemory::populate_pages(std::deque<champsim::page_number>& free_list) const
 {
   assert(dram.size() > 1_MiB);
-  ppage_free_list.resize(((dram.size() - 1_MiB) / PAGE_SIZE).count());
-  assert(ppage_free_list.size() != 0);
+  free_list.resize(((dram.size() - 1_MiB) / PAGE_SIZE).count());
+  assert(free_list.size() != 0);
   champsim::page_number base_address =
       champsim::page_number{champsim::lowest_address_for_size(std::max<champsim::data::mebibytes>(champsim::data::bytes{PAGE_SIZE}, 1_MiB))};
-  for (auto it = ppage_free_list.begin(); it != ppage_free_list.end(); it++) {
+  for (auto it = free_list.begin(); it != free_list.end(); it++) {
     *it = base_address;
     base_address++;
   }
 }
 
-void VirtualMemory::shuffle_pages()
+void VirtualMemory::shuffle_pages(std::deque<champsim::page_number>& free_list) const
 {
   if (randomization_seed.has_value())
-    std::shuffle(ppage_free_list.begin(), ppage_free_list.end(), std::mt19937_64{randomization_seed.value()});
+    std::shuffle(free_list.begin(), free_list.end(), std::mt19937_64{randomization_seed.value()});
+}
+
+void VirtualMemory::partition_pages(std::size_t num_pools)
+{
+  std::lock_guard lock{allocation_mutex};
+  if (num_pools == 0 || std::size(pools) == num_pools) {
+    return;
+  }
+
+  // Deal the remaining pages out in their current order, so that each pool receives an even share of the shuffled space
+  std::deque<champsim::page_number> remaining;
+  for (auto& pool : pools) {
+    std::move(std::begin(pool.ppage_free_list), std::end(pool.ppage_free_list), std::back_inserter(remaining));
+    pool.ppage_free_list.clear();
+  }
+  pools.resize(num_pools, make_pool());
+  for (std::size_t i = 0; i < std::size(remaining); ++i) {
+    pools.at(i % num_pools).ppage_free_list.push_back(remaining.at(i));
+  }
 }
 
+auto VirtualMemory::pool_for(uint32_t cpu_num) -> page_pool& { return pools.at(cpu_num % std::size(pools)); }
+
 champsim::dynamic_extent VirtualMemory::extent(std::size_t level) const
 {
   const champsim::data::bits lower{LOG2_PAGE_SIZE + champsim::lg2(pte_page_size.count()) * (level - 1)};
@@ -86,31 +120,44 @@ uint64_t VirtualMemory::get_offset(champsim::address vaddr, std::size_t level) c
 
 uint64_t VirtualMemory::get_offset(champsim::page_number vaddr, std::size_t level) const { return get_offset(champsim::address{vaddr}, level); }
 
-champsim::page_number VirtualMemory::ppage_front() const
+champsim::page_number VirtualMemory::ppage_front(const page_pool& pool)
 {
-  assert(available_ppages() > 0);
-  return ppage_free_list.front();
+  assert(std::size(pool.ppage_free_list) > 0);
+  return pool.ppage_free_list.front();
 }
 
-void VirtualMemory::ppage_pop()
+void VirtualMemory::ppage_pop(page_pool& pool)
 {
-  ppage_free_list.pop_front();
-  if (available_ppages() == 0) {
+  pool.ppage_free_list.pop_front();
+  if (std::empty(pool.ppage_free_list)) {
     fmt::print("[VMEM] WARNING: Out of physical memory, freeing ppages\n");
-    populate_pages();
-    shuffle_pages();
+    std::deque<champsim::page_number> refill;
+    populate_pages(refill);
+    shuffle_pages(refill);
+
+    // Each pool reclaims only its own share of the space
+    const auto pool_idx = static_cast<std::size_t>(std::distance(&pools.front(), &pool));
+    for (std::size_t i = pool_idx; i < std::size(refill); i += std::size(pools)) {
+      pool.ppage_free_list.push_back(refill.at(i));
+    }
   }
 }
 
-std::size_t VirtualMemory::available_ppages() const { return (ppage_free_list.size()); }
+std::size_t VirtualMemory::available_ppages() const
+{
+  return std::accumulate(std::cbegin(pools), std::cend(pools), std::size_t{0},
+                         [](std::size_t acc, const page_pool& pool) { return acc + std::size(pool.ppage_free_list); });
+}
 
 std::pair<champsim::page_number, champsim::chrono::clock::duration> VirtualMemory::va_to_pa(uint32_t cpu_num, champsim::page_number vaddr)
 {
-  auto [ppage, fault] = vpage_to_ppage_map.try_emplace({cpu_num, champsim::page_number{vaddr}}, ppage_front());
+  std::lock_guard lock{allocation_mutex};
+  auto& pool = pool_for(cpu_num);
+  auto [ppage, fault] = vpage_to_ppage_map.try_emplace({cpu_num, champsim::page_number{vaddr}}, ppage_front(pool));
 
   // this vpage doesn't yet have a ppage mapping
   if (fault) {
-    ppage_pop();
+    ppage_pop(pool);
   }
 
   auto penalty = fault ? minor_fault_penalty : champsim::chrono::clock::duration::zero();
@@ -124,18 +171,20 @@ std::pair<champsim::page_number, champsim::chrono::clock::duration> VirtualMemor
 
 std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::get_pte_pa(uint32_t cpu_num, champsim::page_number vaddr, std::size_t level)
 {
-  if (champsim::page_offset{next_pte_page} == champsim::page_offset{0}) {
-    active_pte_page = ppage_front();
-    ppage_pop();
+  std::lock_guard lock{allocation_mutex};
+  auto& pool = pool_for(cpu_num);
+  if (champsim::page_offset{pool.next_pte_page} == champsim::page_offset{0}) {
+    pool.active_pte_page = ppage_front(pool);
+    ppage_pop(pool);
   }
 
   champsim::dynamic_extent pte_table_entry_extent{champsim::address::bits, shamt(level)};
-  auto [ppage, fault] =
-      page_table.try_emplace({cpu_num, level, champsim::address_slice{pte_table_entry_extent, vaddr}}, champsim::splice(active_pte_page, next_pte_page));
+  auto [ppage, fault] = page_table.try_emplace({cpu_num, level, champsim::address_slice{pte_table_entry_extent, vaddr}},
+                                               champsim::splice(pool.active_pte_page, pool.next_pte_page));
 
   // this PTE doesn't yet have a mapping
   if (fault) {
-    next_pte_page++;
+    pool.next_pte_page++;
   }
 
   auto offset = get_offset(vaddr, level);
@@ -154,3 +203,43 @@ std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::g
 
   return {paddr, penalty};
 }
+
+void VirtualMemory::checkpoint_save(std::ostream& os) const
+{
+  champsim::msl::checkpoint_save(os, vpage_to_ppage_map);
+  champsim::msl::checkpoint_save(os, static_cast<uint64_t>(std::size(page_table)));
+  for (const auto& [key, pte_addr] : page_table) {
+    const auto& [cpu_num, level, entry] = key;
+    champsim::msl::checkpoint_save(os, std::tuple{cpu_num, level, entry.to<uint64_t>(), pte_addr});
+  }
+  champsim::msl::checkpoint_save(os, static_cast<uint64_t>(std::size(pools)));
+  for (const auto& pool : pools) {
+    champsim::msl::checkpoint_save(os, pool.ppage_free_list);
+    champsim::msl::checkpoint_save(os, pool.active_pte_page);
+    champsim::msl::checkpoint_save(os, pool.next_pte_page);
+  }
+}
+
+void VirtualMemory::checkpoint_load(std::istream& is)
+{
+  std::lock_guard lock{allocation_mutex};
+  champsim::msl::checkpoint_load(is, vpage_to_ppage_map);
+  uint64_t num_entries{};
+  champsim::msl::checkpoint_load(is, num_entries);
+  page_table.clear();
+  for (; num_entries > 0; --num_entries) {
+    std::tuple<uint32_t, uint32_t, uint64_t, champsim::address> saved_entry;
+    champsim::msl::checkpoint_load(is, saved_entry);
+    auto [cpu_num, level, entry, pte_addr] = saved_entry;
+    champsim::dynamic_extent pte_table_entry_extent{champsim::address::bits, shamt(level)};
+    page_table.try_emplace({cpu_num, level, champsim::address_slice{pte_table_entry_extent, entry}}, pte_addr);
+  }
+  uint64_t num_pools{};
+  champsim::msl::checkpoint_load(is, num_pools);
+  pools.assign(num_pools, make_pool());
+  for (auto& pool : pools) {
+    champsim::msl::checkpoint_load(is, pool.ppage_free_list);
+    champsim::msl::checkpoint_load(is, pool.active_pte_page);
+    champsim::msl::checkpoint_load(is, pool.next_pte_page);
+  }
+}
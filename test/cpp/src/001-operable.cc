@@ -7,6 +7,16 @@ struct mock_operable : champsim::operable {
   int count = 0;
   long operate() { ++count; return 1; }
 };
+
+struct mock_idle_operable : champsim::operable {
+  using operable::operable;
+  champsim::chrono::clock::time_point next_event{};
+  int count = 0;
+  long idle_count = 0;
+  long operate() { ++count; return 0; }
+  champsim::chrono::clock::time_point next_event_time() const { return next_event; }
+  void idle(long cycles) { idle_count += cycles; }
+};
 }
 
 TEST_CASE("An operable with a scale of 1 operates every cycle") {
@@ -51,3 +61,60 @@ TEST_CASE("An operable with a scale greater than 2 skips multiple cycles") {
 
   REQUIRE(uut.count == num_cycles/4);
 }
+
+TEST_CASE("An operable may not idle past the cycle before its next event") {
+  champsim::chrono::clock::duration period{100};
+  mock_idle_operable uut{period};
+  uut.next_event = uut.current_time + 10*period;
+
+  REQUIRE(uut.idle_until() == uut.current_time + 9*period);
+}
+
+TEST_CASE("An operable whose next event is the next cycle may not idle") {
+  champsim::chrono::clock::duration period{100};
+  mock_idle_operable uut{period};
+  uut.next_event = uut.current_time + period;
+
+  REQUIRE(uut.idle_until() == uut.current_time);
+}
+
+TEST_CASE("An operable with no next event may idle indefinitely") {
+  champsim::chrono::clock::duration period{100};
+  mock_idle_operable uut{period};
+  uut.next_event = champsim::chrono::clock::time_point::max();
+
+  REQUIRE(uut.idle_until() == champsim::chrono::clock::time_point::max());
+}
+
+TEST_CASE("An idled operable catches up to the clock without operating") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  mock_idle_operable uut{period};
+
+  global_clock.tick(10*period);
+  auto idled = uut.idle_on(global_clock);
+
+  REQUIRE(idled == 10);
+  REQUIRE(uut.idle_count == 10);
+  REQUIRE(uut.count == 0);
+  REQUIRE(uut.current_time == global_clock.now());
+
+  global_clock.tick(period);
+  uut.operate_on(global_clock);
+
+  REQUIRE(uut.count == 1);
+}
+
+TEST_CASE("A slower operable idles the same number of cycles it would have operated") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{400};
+  mock_idle_operable idled{period};
+  mock_operable operated{period};
+
+  global_clock.tick(champsim::chrono::picoseconds{1000});
+  idled.idle_on(global_clock);
+  operated.operate_on(global_clock);
+
+  REQUIRE(idled.idle_count == operated.count);
+  REQUIRE(idled.current_time == operated.current_time);
+}
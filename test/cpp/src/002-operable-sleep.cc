@@ -0,0 +1,102 @@
+#include <catch.hpp>
+#include "channel.h"
+#include "operable.h"
+
+namespace {
+struct mock_gated_operable : champsim::operable {
+  using operable::operable;
+  champsim::chrono::clock::time_point next_event = champsim::chrono::clock::time_point::max();
+  int count = 0;
+  long idle_count = 0;
+  long operate() { ++count; return 0; }
+  champsim::chrono::clock::time_point next_event_time() const { return next_event; }
+  void idle(long cycles) { idle_count += cycles; }
+};
+}
+
+TEST_CASE("An idle-gated operable with nothing scheduled falls asleep") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  mock_gated_operable uut{period};
+  uut.idle_gating = true;
+
+  global_clock.tick(period);
+  uut.operate_on(global_clock);
+  REQUIRE(uut.is_asleep());
+
+  for (int i = 0; i < 10; ++i) {
+    global_clock.tick(period);
+    uut.operate_on(global_clock);
+  }
+
+  REQUIRE(uut.count == 1);
+  REQUIRE(uut.idle_count == 10);
+  REQUIRE(uut.current_time == global_clock.now());
+}
+
+TEST_CASE("An operable without idle gating does not fall asleep") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  mock_gated_operable uut{period};
+
+  for (int i = 0; i < 10; ++i) {
+    global_clock.tick(period);
+    uut.operate_on(global_clock);
+  }
+
+  REQUIRE_FALSE(uut.is_asleep());
+  REQUIRE(uut.count == 10);
+}
+
+TEST_CASE("An idle-gated operable with a scheduled event stays awake") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  mock_gated_operable uut{period};
+  uut.idle_gating = true;
+  uut.next_event = global_clock.now() + 100*period;
+
+  global_clock.tick(period);
+  uut.operate_on(global_clock);
+
+  REQUIRE_FALSE(uut.is_asleep());
+}
+
+TEST_CASE("A sleeping operable operates again once woken") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  mock_gated_operable uut{period};
+  uut.sleep();
+
+  global_clock.tick(period);
+  uut.operate_on(global_clock);
+  REQUIRE(uut.count == 0);
+
+  uut.wake();
+  global_clock.tick(period);
+  uut.operate_on(global_clock);
+  REQUIRE(uut.count == 1);
+}
+
+TEST_CASE("Adding a request to a channel wakes its request sink") {
+  champsim::channel uut{32, 32, 32, champsim::data::bits{6}, false};
+  mock_gated_operable sink{};
+  uut.request_sink = &sink;
+
+  auto add_fn = GENERATE(as<bool (champsim::channel::*)(const champsim::channel::request_type&)>{}, &champsim::channel::add_rq, &champsim::channel::add_wq,
+                         &champsim::channel::add_pq);
+
+  sink.sleep();
+  REQUIRE((uut.*add_fn)(champsim::channel::request_type{}));
+  REQUIRE_FALSE(sink.is_asleep());
+}
+
+TEST_CASE("Returning a response through a channel wakes its response sink") {
+  champsim::channel uut{};
+  mock_gated_operable sink{};
+  uut.response_sink = &sink;
+
+  sink.sleep();
+  uut.add_returned(champsim::channel::response_type{champsim::channel::request_type{}});
+  REQUIRE_FALSE(sink.is_asleep());
+  REQUIRE(std::size(uut.returned) == 1);
+}
@@ -0,0 +1,72 @@
+#include <catch.hpp>
+#include "channel.h"
+#include "operable.h"
+#include "parallel_engine.h"
+
+namespace {
+struct mock_node : champsim::operable {
+  std::vector<champsim::channel*> lower{};
+  long operate() { return 0; }
+  std::vector<champsim::channel*> lower_channels() const { return lower; }
+};
+
+bool contains(const std::vector<std::reference_wrapper<champsim::operable>>& group, const champsim::operable& op)
+{
+  return std::any_of(std::begin(group), std::end(group), [&](const champsim::operable& x) { return &x == &op; });
+}
+}
+
+TEST_CASE("Operables reachable from only one root are placed with that root") {
+  // core_a -> private_a -> shared <- private_b <- core_b
+  mock_node core_a, core_b, private_a, private_b, shared;
+  champsim::channel a_to_priv, b_to_priv, priv_a_to_shared, priv_b_to_shared;
+  a_to_priv.request_sink = &private_a;
+  b_to_priv.request_sink = &private_b;
+  priv_a_to_shared.request_sink = &shared;
+  priv_b_to_shared.request_sink = &shared;
+  core_a.lower = {&a_to_priv};
+  core_b.lower = {&b_to_priv};
+  private_a.lower = {&priv_a_to_shared};
+  private_b.lower = {&priv_b_to_shared};
+
+  auto groups = champsim::partition_operables({core_a, core_b, shared, private_a, private_b}, {core_a, core_b});
+
+  REQUIRE(std::size(groups) == 3);
+  CHECK(std::size(groups.at(0)) == 2);
+  CHECK(contains(groups.at(0), core_a));
+  CHECK(contains(groups.at(0), private_a));
+  CHECK(std::size(groups.at(1)) == 2);
+  CHECK(contains(groups.at(1), core_b));
+  CHECK(contains(groups.at(1), private_b));
+  CHECK(std::size(groups.at(2)) == 1);
+  CHECK(contains(groups.at(2), shared));
+}
+
+TEST_CASE("Operables not reachable from any root are shared") {
+  mock_node core, orphan;
+  auto groups = champsim::partition_operables({core, orphan}, {core});
+
+  REQUIRE(std::size(groups) == 2);
+  CHECK(std::size(groups.at(0)) == 1);
+  CHECK(contains(groups.at(0), core));
+  CHECK(std::size(groups.at(1)) == 1);
+  CHECK(contains(groups.at(1), orphan));
+}
+
+TEST_CASE("Cycles in the channel graph do not prevent partitioning") {
+  // A translation path that returns to the data cache, as the page table walker does
+  mock_node core, cache, walker;
+  champsim::channel to_cache, to_walker, walker_to_cache;
+  to_cache.request_sink = &cache;
+  to_walker.request_sink = &walker;
+  walker_to_cache.request_sink = &cache;
+  core.lower = {&to_cache};
+  cache.lower = {&to_walker};
+  walker.lower = {&walker_to_cache};
+
+  auto groups = champsim::partition_operables({core, cache, walker}, {core});
+
+  REQUIRE(std::size(groups) == 2);
+  CHECK(std::size(groups.at(0)) == 3);
+  CHECK(std::empty(groups.at(1)));
+}
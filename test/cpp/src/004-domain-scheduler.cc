@@ -0,0 +1,63 @@
+#include <catch.hpp>
+#include "domain_scheduler.h"
+#include "operable.h"
+
+namespace {
+struct mock_logging_operable : champsim::operable {
+  std::vector<int>* log;
+  int id;
+  mock_logging_operable(champsim::chrono::picoseconds period, std::vector<int>* log_, int id_) : operable(period), log(log_), id(id_) {}
+  long operate() { log->push_back(id); return 1; }
+};
+}
+
+TEST_CASE("The domain scheduler groups operables by clock period") {
+  std::vector<int> log;
+  mock_logging_operable fast_a{champsim::chrono::picoseconds{250}, &log, 0};
+  mock_logging_operable slow{champsim::chrono::picoseconds{625}, &log, 1};
+  mock_logging_operable fast_b{champsim::chrono::picoseconds{250}, &log, 2};
+
+  champsim::domain_scheduler uut{{fast_a, slow, fast_b}};
+  REQUIRE(uut.num_domains() == 2);
+}
+
+TEST_CASE("The domain scheduler operates slow domains only on their edges") {
+  std::vector<int> log;
+  mock_logging_operable fast{champsim::chrono::picoseconds{250}, &log, 0};
+  mock_logging_operable slow{champsim::chrono::picoseconds{625}, &log, 1};
+  champsim::domain_scheduler uut{{fast, slow}};
+
+  champsim::chrono::clock global_clock{};
+  long progress{0};
+  for (int i = 0; i < 10; ++i) {
+    global_clock.tick(champsim::chrono::picoseconds{250});
+    progress += uut.operate_on(global_clock);
+  }
+
+  REQUIRE(std::count(std::begin(log), std::end(log), 0) == 10);
+  REQUIRE(std::count(std::begin(log), std::end(log), 1) == 4);
+  REQUIRE(progress == 14);
+  REQUIRE(fast.current_time == global_clock.now());
+  REQUIRE(slow.current_time >= global_clock.now());
+}
+
+TEST_CASE("The domain scheduler operates lagging domains first, then in the given order") {
+  std::vector<int> log;
+  mock_logging_operable fast_a{champsim::chrono::picoseconds{250}, &log, 0};
+  mock_logging_operable slow{champsim::chrono::picoseconds{300}, &log, 1};
+  mock_logging_operable fast_b{champsim::chrono::picoseconds{250}, &log, 2};
+  champsim::domain_scheduler uut{{fast_a, slow, fast_b}};
+
+  champsim::chrono::clock global_clock{};
+
+  // Every domain begins at the same time, so the given order is kept
+  global_clock.tick(champsim::chrono::picoseconds{250});
+  uut.operate_on(global_clock);
+  REQUIRE_THAT(log, Catch::Matchers::Equals(std::vector<int>{0, 1, 2}));
+
+  // The fast domain is at 250ps and the slow domain at 300ps, so the fast domain goes first
+  log.clear();
+  global_clock.tick(champsim::chrono::picoseconds{250});
+  uut.operate_on(global_clock);
+  REQUIRE_THAT(log, Catch::Matchers::Equals(std::vector<int>{0, 2, 1}));
+}
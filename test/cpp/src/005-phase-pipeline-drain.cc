@@ -0,0 +1,101 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "instr.h"
+#include "defaults.hpp"
+
+#include <functional>
+#include <vector>
+
+#include "dram_controller.h"
+#include "environment.h"
+#include "ooo_cpu.h"
+#include "phase_info.h"
+#include "tracereader.h"
+
+namespace champsim
+{
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, const std::function<bool()>& end_of_warmup);
+}
+
+namespace
+{
+struct single_core_environment final : champsim::environment {
+  do_nothing_MRC mock_L1I{5}, mock_L1D{5};
+  O3_CPU cpu{champsim::core_builder{champsim::defaults::default_core}
+    .fetch_queues(&mock_L1I.queues)
+    .data_queues(&mock_L1D.queues)
+  };
+  MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200}, champsim::chrono::picoseconds{6400}, std::size_t{18}, std::size_t{18}, std::size_t{18}, std::size_t{38}, champsim::chrono::microseconds{64000}, {}, 64, 64, 1, champsim::data::bytes{8}, 1024, 1024, 4, 4, 4, 8192};
+
+  single_core_environment()
+  {
+    mock_L1I.clock_period = cpu.clock_period;
+    mock_L1D.clock_period = cpu.clock_period;
+  }
+
+  std::vector<std::reference_wrapper<O3_CPU>> cpu_view() override { return {std::ref(cpu)}; }
+  std::vector<std::reference_wrapper<CACHE>> cache_view() override { return {}; }
+  std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() override { return {}; }
+  MEMORY_CONTROLLER& dram_view() override { return dram; }
+  std::vector<std::reference_wrapper<champsim::operable>> operable_view() override { return {std::ref(cpu), std::ref(mock_L1I), std::ref(mock_L1D)}; }
+};
+
+champsim::phase_info make_phase(std::string name, bool is_warmup, bool functional_warming, long long length)
+{
+  champsim::phase_info retval{};
+  retval.name = name;
+  retval.is_warmup = is_warmup;
+  retval.length = length;
+  retval.trace_index = {0};
+  retval.trace_names = {"generated"};
+  retval.functional_warming = functional_warming;
+  return retval;
+}
+
+long long instructions_taken(const O3_CPU& cpu)
+{
+  return cpu.num_retired + static_cast<long long>(std::size(cpu.IFETCH_BUFFER) + std::size(cpu.DIB_HIT_BUFFER) + std::size(cpu.DECODE_BUFFER)
+                                                  + std::size(cpu.DISPATCH_BUFFER) + std::size(cpu.ROB) + std::size(cpu.input_queue));
+}
+} // namespace
+
+SCENARIO("Functional warming between two detailed phases retires each instruction once") {
+  GIVEN("A detailed warmup, a functional warmup, and a detailed simulation over a stream of loads") {
+    constexpr long long phase_length = 1000;
+    single_core_environment env;
+
+    uint64_t next_ip = 0;
+    std::vector<champsim::tracereader> traces{};
+    traces.emplace_back([&next_ip]() {
+      next_ip += 4;
+      return champsim::test::instruction_with_ip_and_source_memory(champsim::address{next_ip}, champsim::address{0x10000 + 64 * next_ip});
+    });
+
+    std::vector<champsim::phase_info> phases{make_phase("Detailed warmup", true, false, phase_length), make_phase("Functional warmup", true, true, phase_length),
+                                             make_phase("Simulation", false, false, phase_length)};
+
+    WHEN("The phases are simulated") {
+      bool pipeline_empty_at_warmup_end = false;
+      long long retired_at_warmup_end = 0;
+      long long taken_at_warmup_end = 0;
+      auto results = champsim::main(env, phases, traces, [&]() {
+        pipeline_empty_at_warmup_end = env.cpu.pipeline_empty();
+        retired_at_warmup_end = env.cpu.num_retired;
+        taken_at_warmup_end = static_cast<long long>(traces.front().position() - std::size(env.cpu.input_queue));
+        return true;
+      });
+
+      THEN("The functional warmup begins and ends with an empty pipeline") {
+        REQUIRE(pipeline_empty_at_warmup_end);
+        REQUIRE(retired_at_warmup_end == taken_at_warmup_end);
+        REQUIRE(retired_at_warmup_end >= 2 * phase_length);
+      }
+
+      THEN("Every instruction read from the trace is either retired or still in the core") {
+        REQUIRE(std::size(results) == 1);
+        REQUIRE(results.front().roi_cpu_stats.front().instrs() >= phase_length);
+        REQUIRE(instructions_taken(env.cpu) == static_cast<long long>(traces.front().position()));
+      }
+    }
+  }
+}
@@ -0,0 +1,166 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "instr.h"
+#include "defaults.hpp"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "cache.h"
+#include "channel.h"
+#include "dram_controller.h"
+#include "environment.h"
+#include "ooo_cpu.h"
+#include "phase_info.h"
+#include "ptw.h"
+#include "tracereader.h"
+#include "vmem.h"
+
+namespace champsim
+{
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, const std::function<bool()>& end_of_warmup);
+}
+
+namespace
+{
+constexpr std::size_t num_cores = 2;
+constexpr uint8_t pointer_register = 5;
+
+struct core_links {
+  champsim::channel fetch{}, data{}, itlb{}, dtlb{}, itlb_to_ptw{}, dtlb_to_ptw{}, l1i_to_dram{}, l1d_to_dram{}, ptw_to_dram{};
+};
+
+struct core_components {
+  CACHE itlb, dtlb, l1i, l1d;
+  PageTableWalker ptw;
+  O3_CPU cpu;
+
+  core_components(uint32_t index, core_links& links, VirtualMemory& vmem)
+      : itlb{champsim::cache_builder{champsim::defaults::default_itlb}
+          .name("006-cpu" + std::to_string(index) + "_ITLB")
+          .upper_levels({&links.itlb})
+          .lower_level(&links.itlb_to_ptw)},
+        dtlb{champsim::cache_builder{champsim::defaults::default_dtlb}
+          .name("006-cpu" + std::to_string(index) + "_DTLB")
+          .upper_levels({&links.dtlb})
+          .lower_level(&links.dtlb_to_ptw)},
+        l1i{champsim::cache_builder{champsim::defaults::default_l1i}
+          .name("006-cpu" + std::to_string(index) + "_L1I")
+          .upper_levels({&links.fetch})
+          .lower_level(&links.l1i_to_dram)
+          .lower_translate(&links.itlb)},
+        l1d{champsim::cache_builder{champsim::defaults::default_l1d}
+          .name("006-cpu" + std::to_string(index) + "_L1D")
+          .upper_levels({&links.data})
+          .lower_level(&links.l1d_to_dram)
+          .lower_translate(&links.dtlb)},
+        ptw{champsim::ptw_builder{champsim::defaults::default_ptw}
+          .name("006-cpu" + std::to_string(index) + "_PTW")
+          .cpu(index)
+          .upper_levels({&links.itlb_to_ptw, &links.dtlb_to_ptw})
+          .lower_level(&links.ptw_to_dram)
+          .virtual_memory(&vmem)},
+        cpu{champsim::core_builder{champsim::defaults::default_core}
+          .index(index)
+          .fetch_queues(&links.fetch)
+          .data_queues(&links.data)}
+  {
+  }
+};
+
+// Each core has its own TLBs, L1 caches, and page table walker, and all of them share the memory controller directly
+struct memory_bound_environment final : champsim::environment {
+  std::array<core_links, num_cores> links{};
+  MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{312}, champsim::chrono::picoseconds{625}, std::size_t{24}, std::size_t{24}, std::size_t{24}, std::size_t{52}, champsim::chrono::microseconds{32000},
+    {&links[0].l1i_to_dram, &links[0].l1d_to_dram, &links[0].ptw_to_dram, &links[1].l1i_to_dram, &links[1].l1d_to_dram, &links[1].ptw_to_dram},
+    64, 64, 1, champsim::data::bytes{8}, 65536, 1024, 1, 8, 4, 8192};
+  VirtualMemory vmem{champsim::data::bytes{1<<12}, 5, champsim::chrono::nanoseconds{50}, dram};
+  std::array<core_components, num_cores> cores{{{0, links[0], vmem}, {1, links[1], vmem}}};
+
+  std::vector<std::reference_wrapper<O3_CPU>> cpu_view() override { return {std::ref(cores[0].cpu), std::ref(cores[1].cpu)}; }
+
+  std::vector<std::reference_wrapper<CACHE>> cache_view() override
+  {
+    std::vector<std::reference_wrapper<CACHE>> retval{};
+    for (auto& core : cores) {
+      retval.insert(std::end(retval), {std::ref(core.itlb), std::ref(core.dtlb), std::ref(core.l1i), std::ref(core.l1d)});
+    }
+    return retval;
+  }
+
+  std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() override { return {std::ref(cores[0].ptw), std::ref(cores[1].ptw)}; }
+  MEMORY_CONTROLLER& dram_view() override { return dram; }
+
+  std::vector<std::reference_wrapper<champsim::operable>> operable_view() override
+  {
+    std::vector<std::reference_wrapper<champsim::operable>> retval{};
+    for (auto& core : cores) {
+      retval.insert(std::end(retval), {std::ref(core.cpu), std::ref(core.itlb), std::ref(core.dtlb), std::ref(core.l1i), std::ref(core.l1d), std::ref(core.ptw)});
+    }
+    retval.push_back(std::ref(dram));
+    return retval;
+  }
+};
+
+std::vector<champsim::phase_stats> simulate_streams(bool skip_idle_cycles)
+{
+  memory_bound_environment env;
+
+  // Each core chases pointers through memory: every load reads a new cache block, and depends on the value of the load before it
+  std::array<uint64_t, num_cores> loads_issued{};
+  std::vector<champsim::tracereader> traces{};
+  for (std::size_t i = 0; i < num_cores; ++i) {
+    traces.emplace_back([&count = loads_issued[i], i]() {
+      ++count;
+      auto instr = champsim::test::instruction_with_ip_and_source_memory(champsim::address{0x1000 + 4 * (count % 64)},
+                                                                         champsim::address{((i + 1) << 32) + BLOCK_SIZE * count});
+      instr.source_registers.push_back(pointer_register);
+      instr.destination_registers.push_back(pointer_register);
+      return instr;
+    });
+  }
+
+  champsim::phase_info phase{};
+  phase.name = "Simulation";
+  phase.is_warmup = false;
+  phase.length = 500;
+  phase.trace_index = {0, 1};
+  phase.trace_names = {"generated0", "generated1"};
+  phase.skip_idle_cycles = skip_idle_cycles;
+
+  std::vector<champsim::phase_info> phases{phase};
+  return champsim::main(env, phases, traces, []() { return true; });
+}
+} // namespace
+
+SCENARIO("Skipping idle cycles advances the clock while every core waits on memory") {
+  GIVEN("Two cores that each stream loads to memory") {
+    WHEN("The cores are simulated with and without skipping idle cycles") {
+      auto skipped = simulate_streams(true);
+      auto operated = simulate_streams(false);
+
+      REQUIRE(std::size(skipped) == 1);
+      REQUIRE(std::size(operated) == 1);
+
+      THEN("Most cycles are skipped, and the simulated timing does not change") {
+        for (const auto& stats : skipped.front().roi_cpu_stats) {
+          CHECK(2 * stats.skipped_operates > static_cast<uint64_t>(stats.cycles()));
+        }
+        for (const auto& stats : operated.front().roi_cpu_stats) {
+          CHECK(stats.skipped_operates == 0);
+        }
+
+        for (std::size_t i = 0; i < num_cores; ++i) {
+          CHECK(skipped.front().roi_cpu_stats.at(i).instrs() == operated.front().roi_cpu_stats.at(i).instrs());
+          CHECK(skipped.front().roi_cpu_stats.at(i).cycles() == operated.front().roi_cpu_stats.at(i).cycles());
+        }
+        REQUIRE(std::size(skipped.front().roi_dram_stats) == std::size(operated.front().roi_dram_stats));
+        for (std::size_t i = 0; i < std::size(skipped.front().roi_dram_stats); ++i) {
+          CHECK(skipped.front().roi_dram_stats.at(i).RQ_ROW_BUFFER_HIT == operated.front().roi_dram_stats.at(i).RQ_ROW_BUFFER_HIT);
+          CHECK(skipped.front().roi_dram_stats.at(i).RQ_ROW_BUFFER_MISS == operated.front().roi_dram_stats.at(i).RQ_ROW_BUFFER_MISS);
+        }
+      }
+    }
+  }
+}
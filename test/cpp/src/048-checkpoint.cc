@@ -0,0 +1,162 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+#include "msl/checkpoint.h"
+#include "util/lru_table.h"
+
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  struct type_with_getters
+  {
+    unsigned int value;
+
+    auto index() const
+    {
+      return value;
+    }
+
+    auto tag() const
+    {
+      return value;
+    }
+  };
+
+  template <typename T>
+  T round_trip(const T& value)
+  {
+    std::stringstream stream;
+    champsim::msl::checkpoint_save(stream, value);
+    T retval{};
+    champsim::msl::checkpoint_load(stream, retval);
+    return retval;
+  }
+}
+
+TEMPLATE_TEST_CASE("Values survive a round trip through a checkpoint", "", int, std::vector<int>, std::vector<bool>, (std::map<int, std::string>), std::optional<long>, std::string) {
+  TestType value{};
+  if constexpr (std::is_same_v<TestType, int>) {
+    value = 2016;
+  } else if constexpr (std::is_same_v<TestType, std::vector<int>>) {
+    value = {1, 2, 3, 5, 8};
+  } else if constexpr (std::is_same_v<TestType, std::vector<bool>>) {
+    value = {true, false, false, true, true};
+  } else if constexpr (std::is_same_v<TestType, std::map<int, std::string>>) {
+    value = {{1, "one"}, {2, "two"}};
+  } else if constexpr (std::is_same_v<TestType, std::optional<long>>) {
+    value = 42;
+  } else {
+    value = "champsim";
+  }
+
+  REQUIRE(::round_trip(value) == value);
+}
+
+TEST_CASE("Loading from a truncated checkpoint throws") {
+  std::stringstream stream;
+  champsim::msl::checkpoint_save(stream, std::vector<int>{1, 2, 3});
+  auto saved = stream.str();
+  std::stringstream truncated{saved.substr(0, std::size(saved) - 1)};
+
+  std::vector<int> loaded;
+  REQUIRE_THROWS_AS(champsim::msl::checkpoint_load(truncated, loaded), std::runtime_error);
+}
+
+SCENARIO("An lru_table can be restored from a checkpoint") {
+  GIVEN("A table with some entries") {
+    champsim::lru_table<::type_with_getters> uut{1, 4};
+    uut.fill({1});
+    uut.fill({2});
+    uut.fill({3});
+
+    WHEN("The table is restored into an empty table") {
+      std::stringstream stream;
+      champsim::msl::checkpoint_save(stream, uut);
+      champsim::lru_table<::type_with_getters> restored{1, 4};
+      champsim::msl::checkpoint_load(stream, restored);
+
+      THEN("The restored table holds the same entries") {
+        REQUIRE(restored.check_hit({1}).has_value());
+        REQUIRE(restored.check_hit({2}).has_value());
+        REQUIRE(restored.check_hit({3}).has_value());
+        REQUIRE_FALSE(restored.check_hit({4}).has_value());
+      }
+
+      THEN("The restored table evicts in the same order") {
+        restored.fill({4});
+        restored.fill({5});
+        REQUIRE_FALSE(restored.check_hit({1}).has_value());
+      }
+    }
+
+    WHEN("The table is restored into a table of a different size") {
+      std::stringstream stream;
+      champsim::msl::checkpoint_save(stream, uut);
+      champsim::lru_table<::type_with_getters> restored{2, 4};
+
+      THEN("The restore fails") {
+        REQUIRE_THROWS_AS(champsim::msl::checkpoint_load(stream, restored), std::runtime_error);
+      }
+    }
+  }
+}
+
+SCENARIO("A cache can be restored from a checkpoint") {
+  GIVEN("A cache with some valid blocks") {
+    do_nothing_MRC mock_ll;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("048-uut")
+      .sets(16)
+      .lower_level(&mock_ll.queues)
+    };
+    uut.initialize();
+
+    for (std::size_t i = 0; i < std::size(uut.block); i += 3) {
+      uut.block[i].valid = true;
+      uut.block[i].address = champsim::address{0xdeadbeef + (i << LOG2_BLOCK_SIZE)};
+    }
+
+    WHEN("The cache is restored into a cold cache") {
+      std::stringstream stream;
+      uut.checkpoint_save(stream);
+
+      do_nothing_MRC restored_ll;
+      CACHE restored{champsim::cache_builder{champsim::defaults::default_l1d}
+        .name("048-restored")
+        .sets(16)
+        .lower_level(&restored_ll.queues)
+      };
+      restored.initialize();
+      restored.checkpoint_load(stream);
+
+      THEN("The restored cache holds the same blocks") {
+        for (std::size_t i = 0; i < std::size(uut.block); ++i) {
+          REQUIRE(restored.block[i].valid == uut.block[i].valid);
+          REQUIRE(restored.block[i].address == uut.block[i].address);
+        }
+      }
+    }
+
+    WHEN("The cache is restored into a cache with a different geometry") {
+      std::stringstream stream;
+      uut.checkpoint_save(stream);
+
+      do_nothing_MRC restored_ll;
+      CACHE restored{champsim::cache_builder{champsim::defaults::default_l1d}
+        .name("048-restored")
+        .sets(32)
+        .lower_level(&restored_ll.queues)
+      };
+      restored.initialize();
+
+      THEN("The restore fails") {
+        REQUIRE_THROWS_AS(restored.checkpoint_load(stream), std::runtime_error);
+      }
+    }
+  }
+}
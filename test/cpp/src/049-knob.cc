@@ -0,0 +1,48 @@
+#include <catch.hpp>
+
+#include "knob.h"
+#include "sweep.h"
+
+TEST_CASE("Setting a knob changes every knob with its name") {
+  champsim::knob first{"049.degree", 3};
+  champsim::knob second{"049.degree", 3};
+  champsim::knob other{"049.distance", 7};
+
+  REQUIRE(champsim::knob::set("049.degree", 5) == 2);
+  REQUIRE(first.value() == 5);
+  REQUIRE(second.value() == 5);
+  REQUIRE(other.value() == 7);
+}
+
+TEST_CASE("A copied knob is registered under the same name") {
+  champsim::knob original{"049.copied", 1};
+  auto copy = original;
+
+  REQUIRE(champsim::knob::set("049.copied", 4) == 2);
+  REQUIRE(copy.value() == 4);
+}
+
+TEST_CASE("A destroyed knob is no longer registered") {
+  {
+    champsim::knob temporary{"049.temporary", 1};
+    REQUIRE(champsim::knob::is_registered("049.temporary"));
+  }
+  REQUIRE_FALSE(champsim::knob::is_registered("049.temporary"));
+  REQUIRE(champsim::knob::set("049.temporary", 2) == 0);
+}
+
+TEST_CASE("A variant is parsed into its name and knob settings") {
+  auto uut = champsim::parse_variant("wide:ip_stride.degree=8,va_ampm_lite.degree=-1");
+
+  REQUIRE(uut.name == "wide");
+  REQUIRE(std::size(uut.knobs) == 2);
+  REQUIRE(uut.knobs.at(0) == std::pair{std::string{"ip_stride.degree"}, 8L});
+  REQUIRE(uut.knobs.at(1) == std::pair{std::string{"va_ampm_lite.degree"}, -1L});
+}
+
+TEST_CASE("Malformed variants are rejected") {
+  REQUIRE_THROWS_AS(champsim::parse_variant("ip_stride.degree=8"), std::invalid_argument);
+  REQUIRE_THROWS_AS(champsim::parse_variant(":ip_stride.degree=8"), std::invalid_argument);
+  REQUIRE_THROWS_AS(champsim::parse_variant("wide:ip_stride.degree"), std::invalid_argument);
+  REQUIRE_THROWS_AS(champsim::parse_knob_setting("ip_stride.degree=eight"), std::invalid_argument);
+}
@@ -0,0 +1,58 @@
+#include <catch.hpp>
+#include "util/inplace_vector.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("An inplace_vector begins empty") {
+  champsim::inplace_vector<int, 4> uut{};
+  REQUIRE(uut.empty());
+  REQUIRE(std::size(uut) == 0);
+  REQUIRE(std::begin(uut) == std::end(uut));
+  REQUIRE(uut.capacity() == 4);
+}
+
+TEST_CASE("An inplace_vector holds the elements pushed into it, in order") {
+  champsim::inplace_vector<int, 4> uut{};
+  std::vector<int> expected{3, 1, 4, 1};
+  std::copy(std::begin(expected), std::end(expected), std::back_inserter(uut));
+
+  REQUIRE(std::size(uut) == 4);
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(expected));
+  REQUIRE(uut.front() == 3);
+  REQUIRE(uut.back() == 1);
+  REQUIRE(uut.at(2) == 4);
+  REQUIRE_THROWS_AS(uut.at(4), std::out_of_range);
+}
+
+TEST_CASE("An inplace_vector can be constructed from a list") {
+  champsim::inplace_vector<int, 4> uut{5, 6};
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{5, 6}));
+}
+
+TEST_CASE("Erasing from an inplace_vector keeps the order of the remaining elements") {
+  champsim::inplace_vector<int, 4> uut{1, 2, 3, 2};
+  uut.erase(std::remove(std::begin(uut), std::end(uut), 2), std::end(uut));
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{1, 3}));
+
+  uut.erase(std::begin(uut));
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{3}));
+
+  uut.clear();
+  REQUIRE(uut.empty());
+}
+
+TEST_CASE("Two inplace_vectors are equal if they hold the same elements") {
+  champsim::inplace_vector<int, 4> lhs{1, 2};
+  champsim::inplace_vector<int, 4> rhs{1, 2};
+  REQUIRE(lhs == rhs);
+
+  rhs.push_back(3);
+  REQUIRE(lhs != rhs);
+
+  // Elements that were removed do not take part in the comparison
+  rhs.pop_back();
+  REQUIRE(lhs == rhs);
+}
@@ -0,0 +1,88 @@
+#include <catch.hpp>
+#include "util/circular_buffer.h"
+#include "instruction.h"
+#include "instr.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("A circular_buffer begins empty, with its capacity rounded up to a power of two") {
+  champsim::circular_buffer<int> uut{5};
+  REQUIRE(uut.empty());
+  REQUIRE(std::size(uut) == 0);
+  REQUIRE(std::begin(uut) == std::end(uut));
+  REQUIRE(uut.capacity() == 8);
+}
+
+TEST_CASE("A circular_buffer removes elements in the order they were added, across the end of its storage") {
+  champsim::circular_buffer<int> uut{4};
+  std::vector<int> expected{};
+  for (int i = 0; i < 20; ++i) {
+    uut.push_back(i);
+    expected.push_back(i);
+    if (std::size(uut) == 3) {
+      uut.pop_front();
+      expected.erase(std::begin(expected));
+    }
+    REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(expected));
+  }
+
+  REQUIRE(uut.front() == 18);
+  REQUIRE(uut.back() == 19);
+  REQUIRE(uut.at(1) == 19);
+  REQUIRE_THROWS_AS(uut.at(2), std::out_of_range);
+  REQUIRE(uut.capacity() == 4);
+}
+
+TEST_CASE("Iterators into a circular_buffer remain valid when the front is removed") {
+  champsim::circular_buffer<int> uut{8};
+  std::vector<int> values(6);
+  std::iota(std::begin(values), std::end(values), 0);
+  uut.insert(std::end(uut), std::begin(values), std::end(values));
+
+  auto it = std::next(std::begin(uut), 4);
+  uut.erase(std::begin(uut), std::next(std::begin(uut), 3));
+  REQUIRE(std::size(uut) == 3);
+  REQUIRE(*it == 4);
+  REQUIRE(std::distance(std::begin(uut), it) == 1);
+  REQUIRE(std::partition_point(std::begin(uut), std::end(uut), [](int x) { return x < 5; }) == std::next(it));
+}
+
+TEST_CASE("A circular_buffer that is filled beyond its capacity grows and keeps its order") {
+  champsim::circular_buffer<int> uut{2};
+  uut.push_back(0);
+  uut.push_back(1);
+  uut.pop_front();
+  for (int i = 2; i < 7; ++i) {
+    uut.push_back(i);
+  }
+
+  REQUIRE(uut.capacity() >= 6);
+  REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{1, 2, 3, 4, 5, 6}));
+}
+
+TEST_CASE("Instructions in a circular_buffer are found by their ID") {
+  champsim::circular_buffer<ooo_model_instr> uut{4};
+  for (uint64_t id = 10; id < 16; ++id) {
+    uut.push_back(champsim::test::instruction_with_ip(id));
+    uut.back().instr_id = id;
+    if (std::size(uut) == 4) {
+      uut.pop_front();
+    }
+  }
+
+  // The buffer holds IDs 13, 14, and 15
+  auto found = ooo_model_instr::find_id(std::begin(uut), std::end(uut), 14);
+  REQUIRE(found == std::next(std::begin(uut)));
+  REQUIRE(ooo_model_instr::find_id(std::begin(uut), std::end(uut), 12) == std::end(uut));
+  REQUIRE(ooo_model_instr::find_id(std::begin(uut), std::end(uut), 16) == std::end(uut));
+
+  // The IDs need not be consecutive
+  uut.push_back(champsim::test::instruction_with_ip(20));
+  uut.back().instr_id = 20;
+  uut.pop_front();
+  REQUIRE(ooo_model_instr::find_id(std::begin(uut), std::end(uut), 20) == std::prev(std::end(uut)));
+}
@@ -52,6 +52,15 @@ TEST_CASE("Two event counters can be added") {
   REQUIRE((lhs + rhs).at(key) == lhs_value + rhs_value);
 }
 
+TEST_CASE("An event counter can be added to one that has not counted the same events") {
+  champsim::stats::event_counter<int> lhs{};
+  champsim::stats::event_counter<int> rhs{};
+  constexpr typename decltype(lhs)::key_type key = 2016;
+  constexpr typename decltype(lhs)::value_type rhs_value = 20;
+  rhs.set(key, rhs_value);
+  REQUIRE((lhs + rhs).at(key) == rhs_value);
+}
+
 TEST_CASE("Two event counters can be subtracted") {
   champsim::stats::event_counter<int> lhs{};
   champsim::stats::event_counter<int> rhs{};
@@ -1,5 +1,10 @@
 #include <catch.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <sys/stat.h>
+
 #include "tracereader.h"
 
 const std::string trace{{
@@ -61,3 +66,98 @@ TEST_CASE("A tracereader can read the byte representation of an input_instr") {
   REQUIRE_THAT(inst1.destination_memory, Catch::Matchers::IsEmpty());
   REQUIRE_THAT(inst1.source_memory, Catch::Matchers::IsEmpty());
 }
+
+namespace
+{
+struct temporary_file {
+  std::filesystem::path path;
+
+  temporary_file(std::string_view name, const std::string& contents) : path(std::filesystem::temp_directory_path() / name)
+  {
+    std::ofstream file{path, std::ios::binary};
+    file.write(std::data(contents), static_cast<std::streamsize>(std::size(contents)));
+  }
+
+  ~temporary_file() { std::filesystem::remove(path); }
+};
+} // namespace
+
+TEST_CASE("A mapped tracereader reads the same instructions as a streamed one") {
+  std::string branchy_trace;
+  for (unsigned i = 0; i < 1000; ++i) {
+    input_instr record{};
+    record.ip = 0x1000 + 4 * (i % 37);
+    record.is_branch = (i % 5 == 0);
+    record.branch_taken = (i % 10 == 0);
+    record.destination_registers[0] = static_cast<unsigned char>(i % 64);
+    branchy_trace.append(reinterpret_cast<const char*>(&record), sizeof(record));
+  }
+  temporary_file file{"champsim-080-mmap.trace", branchy_trace};
+
+  champsim::bulk_tracereader<input_instr, std::istringstream> expected{0, std::istringstream{branchy_trace}};
+  champsim::bulk_tracereader<input_instr, champsim::mmap_file> uut{0, file.path.string()};
+
+  while (!expected.eof()) {
+    REQUIRE_FALSE(uut.eof());
+    auto expected_instr = expected();
+    auto instr = uut();
+    REQUIRE(instr.ip == expected_instr.ip);
+    REQUIRE(instr.is_branch == expected_instr.is_branch);
+    REQUIRE(instr.branch_taken == expected_instr.branch_taken);
+    REQUIRE(instr.branch_target == expected_instr.branch_target);
+    REQUIRE(instr.destination_registers == expected_instr.destination_registers);
+  }
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A mapped tracereader can read the byte representation of an input_instr") {
+  temporary_file file{"champsim-080-mmap-bytes.trace", trace};
+  champsim::bulk_tracereader<input_instr, champsim::mmap_file> uut{0, file.path.string()};
+
+  REQUIRE_FALSE(uut.eof());
+  auto inst0 = uut();
+  REQUIRE(inst0.ip == champsim::address{0x4c00133a});
+  REQUIRE_THAT(inst0.destination_registers, Catch::Matchers::RangeEquals(std::vector{59}));
+
+  REQUIRE_FALSE(uut.eof());
+  auto inst1 = uut();
+  REQUIRE(inst1.ip == champsim::address{0x4c00163a});
+
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A mapped tracereader of an empty file is at its end") {
+  temporary_file file{"champsim-080-mmap-empty.trace", std::string{}};
+  champsim::bulk_tracereader<input_instr, champsim::mmap_file> uut{0, file.path.string()};
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("A mapped tracereader of a missing file cannot be constructed") {
+  REQUIRE_THROWS_AS((champsim::bulk_tracereader<input_instr, champsim::mmap_file>{0, "champsim-080-no-such-file.trace"}), std::system_error);
+}
+
+TEST_CASE("A trace that is not a regular file is read as a stream") {
+  const auto path = std::filesystem::temp_directory_path() / "champsim-080-fifo.trace";
+  std::filesystem::remove(path);
+  REQUIRE(::mkfifo(path.c_str(), 0600) == 0);
+  REQUIRE_FALSE(champsim::mmap_file::can_map(path.string()));
+  REQUIRE_THROWS_AS(champsim::mmap_file{path.string()}, std::system_error);
+
+  // Opening a FIFO blocks until the other end is opened, so the trace is written from another thread
+  std::thread writer{[&path] {
+    std::ofstream fifo{path, std::ios::binary};
+    fifo.write(std::data(trace), static_cast<std::streamsize>(std::size(trace)));
+  }};
+
+  std::vector<champsim::address> ips{};
+  {
+    auto uut = get_tracereader(path.string(), 0, false, false);
+    while (!uut.eof()) {
+      ips.push_back(uut().ip);
+    }
+  }
+  writer.join();
+  std::filesystem::remove(path);
+
+  REQUIRE_THAT(ips, Catch::Matchers::RangeEquals(std::vector{champsim::address{0x4c00133a}, champsim::address{0x4c00163a}}));
+}
@@ -1,6 +1,7 @@
 #include <catch.hpp>
 #include <algorithm>
 #include <functional>
+#include <numeric>
 #include <type_traits>
 #include <vector>
 #include "matchers.hpp"
@@ -30,3 +31,18 @@ TEST_CASE("Two tracereaders produce monotonically increasing instruction IDs") {
 
   REQUIRE_THAT(ids, champsim::test::MonotonicallyIncreasingMatcher{});
 }
+
+TEST_CASE("Reading from another tracereader does not change the instruction IDs of a tracereader") {
+  champsim::tracereader uuta{[](){ return ooo_model_instr{0, input_instr{}}; }};
+  champsim::tracereader uutb{[](){ return ooo_model_instr{0, input_instr{}}; }};
+
+  std::vector<uint64_t> ids{};
+  for (int i = 0; i < 10; ++i) {
+    ids.push_back(uuta().instr_id);
+    std::invoke(uutb);
+  }
+
+  std::vector<uint64_t> expected_ids(std::size(ids));
+  std::iota(std::begin(expected_ids), std::end(expected_ids), ids.front());
+  REQUIRE_THAT(ids, Catch::Matchers::Equals(expected_ids));
+}
@@ -116,3 +116,116 @@ TEST_CASE("An inf_stream can inflate a bz2-compressed text") {
   comp_stream.read(inflated, static_cast<std::streamsize>(std::size(plaintext)));
   REQUIRE_THAT(std::string{inflated}, Catch::Matchers::Equals(plaintext));
 }
+
+TEST_CASE("An inf_stream can inflate a multi-block xz text on several threads") {
+  std::string long_plaintext;
+  for (int i = 0; i < 100; ++i) {
+    long_plaintext += std::to_string(i) + plaintext;
+  }
+
+  // Compress into blocks much smaller than the text
+  lzma_mt options{};
+  options.threads = 2;
+  options.block_size = 4096;
+  options.preset = LZMA_PRESET_DEFAULT;
+  options.check = LZMA_CHECK_CRC64;
+
+  lzma_stream encoder = LZMA_STREAM_INIT;
+  REQUIRE(::lzma_stream_encoder_mt(&encoder, &options) == LZMA_OK);
+  std::vector<uint8_t> cyphertext(std::size(long_plaintext) + 4096);
+  encoder.next_in = reinterpret_cast<const uint8_t*>(std::data(long_plaintext));
+  encoder.avail_in = std::size(long_plaintext);
+  encoder.next_out = std::data(cyphertext);
+  encoder.avail_out = std::size(cyphertext);
+  REQUIRE(::lzma_code(&encoder, LZMA_FINISH) == LZMA_STREAM_END);
+  cyphertext.resize(std::size(cyphertext) - encoder.avail_out);
+  ::lzma_end(&encoder);
+
+  auto old_threads = champsim::decomp_tags::lzma_decoder_threads;
+  champsim::decomp_tags::lzma_decoder_threads = 4;
+  champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>, std::istringstream> comp_stream{
+      std::istringstream{std::string{std::begin(cyphertext), std::end(cyphertext)}}};
+
+  std::vector<char> inflated(std::size(long_plaintext));
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  champsim::decomp_tags::lzma_decoder_threads = old_threads;
+
+  REQUIRE(comp_stream.gcount() == static_cast<std::streamsize>(std::size(long_plaintext)));
+  REQUIRE_THAT(std::string(std::begin(inflated), std::end(inflated)), Catch::Matchers::Equals(long_plaintext));
+}
+
+namespace
+{
+template <typename Tag>
+std::string deflate_text(const std::string& text)
+{
+  champsim::inf_ostream<Tag, std::ostringstream> comp_stream{std::ostringstream{}};
+  comp_stream.write(std::data(text), static_cast<std::streamsize>(std::size(text)));
+  comp_stream.close();
+  return comp_stream.underlying->str();
+}
+
+template <typename Tag>
+std::string inflate_text(const std::string& cyphertext, std::size_t size)
+{
+  champsim::inf_istream<Tag, std::istringstream> comp_stream{std::istringstream{cyphertext}};
+  std::string retval(size, '\0');
+  comp_stream.read(std::data(retval), static_cast<std::streamsize>(size));
+  retval.resize(static_cast<std::size_t>(comp_stream.gcount()));
+  return retval;
+}
+
+std::string repeated_plaintext()
+{
+  std::string retval;
+  for (int i = 0; i < 100; ++i) {
+    retval += std::to_string(i) + plaintext;
+  }
+  return retval;
+}
+} // namespace
+
+TEST_CASE("An inf_ostream writes a stream that an inf_istream can inflate") {
+  auto text = repeated_plaintext();
+  REQUIRE(inflate_text<champsim::decomp_tags::gzip_tag_t<>>(deflate_text<champsim::decomp_tags::gzip_tag_t<>>(text), std::size(text)) == text);
+  REQUIRE(inflate_text<champsim::decomp_tags::lzma_tag_t<>>(deflate_text<champsim::decomp_tags::lzma_tag_t<>>(text), std::size(text)) == text);
+  REQUIRE(inflate_text<champsim::decomp_tags::bzip2_tag_t>(deflate_text<champsim::decomp_tags::bzip2_tag_t>(text), std::size(text)) == text);
+  REQUIRE(inflate_text<champsim::decomp_tags::zstd_tag_t<>>(deflate_text<champsim::decomp_tags::zstd_tag_t<>>(text), std::size(text)) == text);
+}
+
+TEST_CASE("An inf_ostream compresses less than it is given") {
+  auto text = repeated_plaintext();
+  REQUIRE(std::size(deflate_text<champsim::decomp_tags::zstd_tag_t<>>(text)) < std::size(text));
+}
+
+TEST_CASE("A seekable zstd stream can be read from any frame") {
+  auto text = repeated_plaintext();
+  using tag_type = champsim::decomp_tags::zstd_tag_t<ZSTD_CLEVEL_DEFAULT, 4096>;
+  auto cyphertext = deflate_text<tag_type>(text);
+
+  std::istringstream table_stream{cyphertext};
+  auto table = champsim::zstd_seek_table::read(table_stream);
+  REQUIRE(table.has_value());
+  REQUIRE(std::size(table->frames) == (std::size(text) + 4095) / 4096);
+  CHECK(table->frames.front().compressed_offset == 0);
+  CHECK(table->frames.at(1).decompressed_offset == 4096);
+  CHECK(table->frames.back().decompressed_offset + table->frames.back().decompressed_size == std::size(text));
+
+  auto frame = table->locate(10000);
+  REQUIRE(frame.has_value());
+  REQUIRE(frame->decompressed_offset == 8192);
+  REQUIRE_FALSE(table->locate(std::size(text)).has_value());
+
+  std::istringstream frame_stream{cyphertext};
+  frame_stream.seekg(static_cast<std::streamoff>(frame->compressed_offset));
+  champsim::inf_istream<tag_type, std::istringstream> comp_stream{std::move(frame_stream)};
+
+  std::string inflated(frame->decompressed_size, '\0');
+  comp_stream.read(std::data(inflated), static_cast<std::streamsize>(std::size(inflated)));
+  REQUIRE(inflated == text.substr(frame->decompressed_offset, frame->decompressed_size));
+}
+
+TEST_CASE("A zstd stream without a seek table has no seek table") {
+  std::istringstream stream{gzip_cyphertext};
+  REQUIRE_FALSE(champsim::zstd_seek_table::read(stream).has_value());
+}
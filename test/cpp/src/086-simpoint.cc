@@ -0,0 +1,120 @@
+#include <catch.hpp>
+
+#include "simpoint.h"
+#include "tracereader.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+TEST_CASE("SimPoint output is read in the order of the intervals") {
+  std::istringstream simpoints{"7 0\n2 1\n4 2\n"};
+  std::istringstream weights{"0.5 0\n0.25 1\n0.25 2\n"};
+
+  auto points = champsim::read_simpoints(simpoints, weights);
+
+  REQUIRE(std::size(points) == 3);
+  REQUIRE(points.at(0).interval == 2);
+  REQUIRE(points.at(0).weight == 0.25);
+  REQUIRE(points.at(1).interval == 4);
+  REQUIRE(points.at(2).interval == 7);
+  REQUIRE(points.at(2).weight == 0.5);
+}
+
+TEST_CASE("SimPoint output with an unmatched cluster is rejected") {
+  std::istringstream simpoints{"7 0\n2 1\n"};
+  std::istringstream weights{"0.5 0\n"};
+
+  REQUIRE_THROWS_AS(champsim::read_simpoints(simpoints, weights), std::runtime_error);
+}
+
+TEST_CASE("Each simulation point is given a warmup phase and a weighted phase") {
+  champsim::phase_info base{};
+  auto phases = champsim::simpoint_phases({{0, 0.25}, {3, 0.75}}, 100, 20, base);
+
+  REQUIRE(std::size(phases) == 3);
+
+  // The first point has nothing before it to warm with
+  REQUIRE_FALSE(phases.at(0).is_warmup);
+  REQUIRE(phases.at(0).fast_forward_to == 0);
+  REQUIRE(phases.at(0).weight == 0.25);
+
+  REQUIRE(phases.at(1).is_warmup);
+  REQUIRE(phases.at(1).length == 20);
+  REQUIRE(phases.at(1).fast_forward_to == 280);
+  REQUIRE_FALSE(phases.at(1).weight.has_value());
+
+  REQUIRE_FALSE(phases.at(2).is_warmup);
+  REQUIRE(phases.at(2).length == 100);
+  REQUIRE(phases.at(2).fast_forward_to == 0);
+  REQUIRE(phases.at(2).weight == 0.75);
+}
+
+TEST_CASE("The warmup of a simulation point does not overlap the previous point") {
+  constexpr long long interval_length = 100;
+  const std::vector<champsim::simpoint> points{{2, 0.25}, {3, 0.25}, {4, 0.25}, {6, 0.25}};
+  auto phases = champsim::simpoint_phases(points, interval_length, 150, champsim::phase_info{});
+
+  // Follow the trace through the phases, in the way the phases fast-forward and consume it
+  long long position = 0;
+  std::vector<long long> detailed_begin{};
+  for (const auto& phase : phases) {
+    position = std::max(position, static_cast<long long>(phase.fast_forward_to));
+    if (!phase.is_warmup) {
+      detailed_begin.push_back(position);
+    }
+    position += phase.length;
+  }
+
+  REQUIRE(std::size(detailed_begin) == std::size(points));
+  for (std::size_t i = 0; i < std::size(points); ++i) {
+    REQUIRE(detailed_begin.at(i) == points.at(i).interval * interval_length);
+  }
+
+  // Only the first point and the point after the gap are warmed, and the latter only by the gap
+  REQUIRE(std::count_if(std::begin(phases), std::end(phases), [](const auto& phase) { return phase.is_warmup; }) == 2);
+  REQUIRE(phases.at(0).length == 150);
+  REQUIRE(phases.at(4).is_warmup);
+  REQUIRE(phases.at(4).length == interval_length);
+}
+
+TEST_CASE("The weighted summary normalizes the weights of the phases") {
+  champsim::phase_stats first;
+  first.weight = 1;
+  first.roi_cpu_stats.push_back(cpu_stats{});
+  first.roi_cpu_stats.back().end_instrs = 100;
+  first.roi_cpu_stats.back().end_cycles = 100;
+
+  champsim::phase_stats second;
+  second.weight = 3;
+  second.roi_cpu_stats.push_back(cpu_stats{});
+  second.roi_cpu_stats.back().end_instrs = 100;
+  second.roi_cpu_stats.back().end_cycles = 500;
+
+  champsim::phase_stats unweighted;
+  unweighted.roi_cpu_stats.push_back(cpu_stats{});
+
+  auto summary = champsim::summarize_weighted({first, unweighted, second});
+
+  REQUIRE(summary.has_value());
+  REQUIRE(summary->total_weight == 4);
+  REQUIRE(summary->cpi.at(0) == Approx(4));
+}
+
+TEST_CASE("The weighted summary is empty if no phase has a weight") {
+  REQUIRE_FALSE(champsim::summarize_weighted({champsim::phase_stats{}}).has_value());
+}
+
+TEST_CASE("A tracereader can be fast-forwarded") {
+  champsim::tracereader uut{[](){ return ooo_model_instr{0, input_instr{}}; }};
+
+  uut.fast_forward(10);
+  REQUIRE(uut.position() == 10);
+
+  (void)uut();
+  REQUIRE(uut.position() == 11);
+
+  // Fast-forwarding to an earlier position does nothing
+  uut.fast_forward(5);
+  REQUIRE(uut.position() == 11);
+}
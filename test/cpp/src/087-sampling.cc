@@ -0,0 +1,70 @@
+#include <catch.hpp>
+
+#include "core_stats.h"
+#include "sampling.h"
+
+TEST_CASE("A sample estimate finds the mean and variance of its samples") {
+  champsim::sample_estimate uut;
+  for (double x : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}) {
+    uut.add(x);
+  }
+
+  REQUIRE(uut.count() == 8);
+  REQUIRE(uut.mean() == Approx(5));
+  REQUIRE(uut.variance() == Approx(32.0 / 7.0));
+}
+
+TEST_CASE("The error bound of a sample estimate shrinks as samples are added") {
+  champsim::sample_estimate uut;
+  uut.add(1);
+  uut.add(3);
+  auto first_error = uut.relative_error(2);
+
+  uut.add(1);
+  uut.add(3);
+
+  REQUIRE(uut.relative_error(2) < first_error);
+}
+
+TEST_CASE("The error bound of a sample estimate with one sample is unbounded") {
+  champsim::sample_estimate uut;
+  uut.add(1);
+  REQUIRE(uut.relative_error(2) == std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("The standard score matches the normal distribution") {
+  REQUIRE(champsim::z_score(0.95) == Approx(1.96).epsilon(0.001));
+  REQUIRE(champsim::z_score(0.997) == Approx(2.968).epsilon(0.001));
+  REQUIRE_THROWS_AS(champsim::z_score(1), std::range_error);
+}
+
+TEST_CASE("The functional warming fills the remainder of the sampling period") {
+  champsim::sampling_parameters uut{};
+  uut.period = 10000;
+  uut.detailed_warmup = 2000;
+  uut.measurement = 1000;
+  REQUIRE(uut.functional_warmup() == 7000);
+
+  uut.period = 2000;
+  REQUIRE(uut.functional_warmup() == 0);
+}
+
+TEST_CASE("Core statistics can be summed") {
+  cpu_stats lhs{};
+  lhs.end_instrs = 100;
+  lhs.end_cycles = 300;
+  lhs.total_branch_types.set(branch_type::BRANCH_CONDITIONAL, 10);
+
+  cpu_stats rhs{};
+  rhs.begin_instrs = 200;
+  rhs.end_instrs = 300;
+  rhs.begin_cycles = 1000;
+  rhs.end_cycles = 1100;
+  rhs.branch_type_misses.set(branch_type::BRANCH_CONDITIONAL, 4);
+
+  auto sum = lhs + rhs;
+  REQUIRE(sum.instrs() == 200);
+  REQUIRE(sum.cycles() == 400);
+  REQUIRE(sum.total_branch_types.value_or(branch_type::BRANCH_CONDITIONAL, 0) == 10);
+  REQUIRE(sum.branch_type_misses.value_or(branch_type::BRANCH_CONDITIONAL, 0) == 4);
+}
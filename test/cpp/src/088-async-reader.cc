@@ -0,0 +1,130 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <stdexcept>
+
+#include "async_reader.h"
+#include "spsc_ring.h"
+#include "tracereader.h"
+
+TEST_CASE("An SPSC ring returns its elements in order") {
+  champsim::spsc_ring<int> uut{3};
+  REQUIRE(uut.capacity() == 4);
+  REQUIRE(uut.empty());
+
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(uut.try_push(int{i}));
+  }
+  REQUIRE(uut.full());
+  REQUIRE_FALSE(uut.try_push(4));
+
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(uut.try_pop() == i);
+  }
+  REQUIRE(uut.empty());
+  REQUIRE_FALSE(uut.try_pop().has_value());
+}
+
+namespace
+{
+struct counting_generator {
+  int next = 0;
+  int end;
+
+  explicit counting_generator(int e) : end(e) {}
+  int operator()() { return next++; }
+  [[nodiscard]] bool eof() const { return next >= end; }
+};
+
+struct throwing_generator {
+  int next = 0;
+  int operator()()
+  {
+    if (next == 3) {
+      throw std::runtime_error{"The generator failed"};
+    }
+    return next++;
+  }
+};
+
+std::string make_trace(std::size_t count)
+{
+  std::string retval;
+  for (std::size_t i = 0; i < count; ++i) {
+    input_instr record{};
+    record.ip = 0x1000 + 4 * (i % 37);
+    record.is_branch = (i % 5 == 0);
+    record.branch_taken = (i % 10 == 0);
+    record.destination_registers[0] = static_cast<unsigned char>(i % 64);
+    retval.append(reinterpret_cast<const char*>(&record), sizeof(record));
+  }
+  return retval;
+}
+} // namespace
+
+TEST_CASE("An asynchronous reader produces the values of its generator in order") {
+  champsim::async_reader<counting_generator, 8> uut{1000};
+
+  for (int i = 0; i < 1000; ++i) {
+    REQUIRE_FALSE(uut.eof());
+    REQUIRE(uut() == i);
+  }
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("An asynchronous reader continues where it left off after it is paused") {
+  champsim::async_reader<counting_generator, 4> uut{100};
+
+  for (int i = 0; i < 10; ++i) {
+    REQUIRE(uut() == i);
+  }
+
+  uut.pause();
+  uut.pause();
+
+  for (int i = 10; i < 100; ++i) {
+    REQUIRE(uut() == i);
+  }
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("An asynchronous reader can be moved") {
+  champsim::async_reader<counting_generator, 4> uut{100};
+  REQUIRE(uut() == 0);
+
+  auto moved = std::move(uut);
+  REQUIRE(moved() == 1);
+
+  moved = champsim::async_reader<counting_generator, 4>{5};
+  REQUIRE(moved() == 0);
+}
+
+TEST_CASE("An asynchronous reader reports the errors of its generator when they are reached") {
+  champsim::async_reader<throwing_generator, 4> uut{};
+
+  for (int i = 0; i < 3; ++i) {
+    REQUIRE(uut() == i);
+  }
+  REQUIRE_THROWS_AS(uut(), std::runtime_error);
+}
+
+TEST_CASE("An asynchronous trace reader reads the same instructions as a synchronous one") {
+  auto trace = make_trace(1000);
+  champsim::bulk_tracereader<input_instr, std::istringstream> expected{0, std::istringstream{trace}};
+  champsim::async_reader<champsim::bulk_tracereader<input_instr, std::istringstream>, 16> uut{uint8_t{0}, std::istringstream{trace}};
+
+  std::size_t count = 0;
+  while (!expected.eof()) {
+    REQUIRE_FALSE(uut.eof());
+    auto expected_instr = expected();
+    auto instr = uut();
+    REQUIRE(instr.ip == expected_instr.ip);
+    REQUIRE(instr.is_branch == expected_instr.is_branch);
+    REQUIRE(instr.branch_target == expected_instr.branch_target);
+    REQUIRE(instr.destination_registers == expected_instr.destination_registers);
+    ++count;
+  }
+
+  REQUIRE(uut.eof());
+  REQUIRE(count > 900);
+}
@@ -0,0 +1,146 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "columnar_trace.h"
+#include "tracereader.h"
+
+namespace
+{
+template <typename T>
+std::vector<T> make_records(std::size_t count)
+{
+  std::vector<T> retval;
+  uint64_t ip = 0x400000;
+  for (std::size_t i = 0; i < count; ++i) {
+    T record{};
+    record.ip = ip;
+    record.is_branch = (i % 7 == 0);
+    record.branch_taken = (i % 14 == 0);
+    record.destination_registers[1] = static_cast<unsigned char>(i % 64);
+    record.source_registers[0] = static_cast<unsigned char>((i + 3) % 32);
+    record.source_registers[2] = (i % 3 == 0) ? champsim::REG_FLAGS : 0;
+    if (i % 4 == 0) {
+      record.source_memory[1] = 0x7fff0000 + 8 * i;
+    }
+    if (i % 9 == 0) {
+      record.destination_memory[0] = 0x10000000 + ((i * 2654435761u) % (1u << 24));
+    }
+    ip = record.branch_taken ? 0x400000 + 4 * ((i * 37) % 1000) : ip + 4;
+    retval.push_back(record);
+  }
+  return retval;
+}
+
+template <typename T>
+std::string encode(const std::vector<T>& records)
+{
+  auto retval = champsim::columnar::header<T>();
+  champsim::columnar::encoder<T> encoder;
+  for (const auto& record : records) {
+    encoder.push(record);
+    if (encoder.size() == champsim::columnar::block_instructions) {
+      auto block = encoder.flush();
+      retval.insert(std::end(retval), std::begin(block), std::end(block));
+    }
+  }
+  auto block = encoder.flush();
+  retval.insert(std::end(retval), std::begin(block), std::end(block));
+  return std::string{std::begin(retval), std::end(retval)};
+}
+
+template <typename T>
+std::string serialize(const std::vector<T>& records)
+{
+  return std::string{reinterpret_cast<const char*>(std::data(records)), std::size(records) * sizeof(T)};
+}
+} // namespace
+
+TEST_CASE("A columnar trace reader reads the same instructions as the native format") {
+  auto records = make_records<input_instr>(2 * champsim::columnar::block_instructions + 1000);
+  auto columnar = encode(records);
+  REQUIRE(std::size(columnar) * 5 < std::size(records) * sizeof(input_instr));
+
+  champsim::bulk_tracereader<input_instr, std::istringstream> expected{0, std::istringstream{serialize(records)}};
+  champsim::bulk_tracereader<input_instr, champsim::columnar_istream<std::istringstream>> uut{
+      0, champsim::columnar_istream<std::istringstream>{std::istringstream{columnar}}};
+
+  std::size_t count = 0;
+  while (!expected.eof()) {
+    REQUIRE_FALSE(uut.eof());
+    auto expected_instr = expected();
+    auto instr = uut();
+    REQUIRE(instr.ip == expected_instr.ip);
+    REQUIRE(instr.is_branch == expected_instr.is_branch);
+    REQUIRE(instr.branch_taken == expected_instr.branch_taken);
+    REQUIRE(instr.branch_target == expected_instr.branch_target);
+    REQUIRE(instr.destination_registers == expected_instr.destination_registers);
+    REQUIRE(instr.source_registers == expected_instr.source_registers);
+    REQUIRE(instr.destination_memory == expected_instr.destination_memory);
+    REQUIRE(instr.source_memory == expected_instr.source_memory);
+    ++count;
+  }
+
+  REQUIRE(uut.eof());
+  REQUIRE(count == std::size(records) - 1);
+}
+
+TEST_CASE("A columnar trace packs the nonzero operands to the front of each array") {
+  std::vector<input_instr> records(2);
+  records[0].ip = 0x1000;
+  records[0].destination_registers[1] = 59;
+  records[0].source_registers[3] = 6;
+  records[0].source_memory[2] = 0xdeadbeef;
+
+  std::istringstream in{encode(records)};
+  champsim::columnar_istream<std::istringstream> uut{std::move(in)};
+  std::vector<input_instr> decoded;
+  REQUIRE(uut.read_block(decoded));
+  REQUIRE_FALSE(uut.read_block(decoded));
+
+  REQUIRE(std::size(decoded) == 2);
+  REQUIRE(decoded[0].ip == 0x1000);
+  REQUIRE(decoded[0].destination_registers[0] == 59);
+  REQUIRE(decoded[0].destination_registers[1] == 0);
+  REQUIRE(decoded[0].source_registers[0] == 6);
+  REQUIRE(decoded[0].source_memory[0] == 0xdeadbeef);
+  REQUIRE(decoded[0].source_memory[2] == 0);
+}
+
+TEST_CASE("A columnar trace preserves the ASIDs of CloudSuite records") {
+  auto records = make_records<cloudsuite_instr>(100);
+  for (std::size_t i = 0; i < std::size(records); ++i) {
+    records[i].asid[0] = static_cast<unsigned char>(i);
+    records[i].asid[1] = static_cast<unsigned char>(3 * i);
+  }
+
+  champsim::columnar_istream<std::istringstream> uut{std::istringstream{encode(records)}};
+  std::vector<cloudsuite_instr> decoded;
+  REQUIRE(uut.read_block(decoded));
+
+  REQUIRE(std::size(decoded) == std::size(records));
+  for (std::size_t i = 0; i < std::size(records); ++i) {
+    REQUIRE(decoded[i].ip == records[i].ip);
+    REQUIRE(decoded[i].asid[0] == records[i].asid[0]);
+    REQUIRE(decoded[i].asid[1] == records[i].asid[1]);
+  }
+}
+
+TEST_CASE("A columnar trace reader rejects traces it cannot read") {
+  std::vector<std::string> bad_traces{
+      serialize(make_records<input_instr>(10)), // The native format
+      encode(make_records<cloudsuite_instr>(10)), // A different kind of record
+  };
+
+  auto truncated = encode(make_records<input_instr>(10));
+  truncated.resize(std::size(truncated) - 3);
+  bad_traces.push_back(truncated);
+
+  for (const auto& trace : bad_traces) {
+    champsim::columnar_istream<std::istringstream> uut{std::istringstream{trace}};
+    std::vector<input_instr> decoded;
+    REQUIRE_THROWS_AS(uut.read_block(decoded), std::runtime_error);
+  }
+}
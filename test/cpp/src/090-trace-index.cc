@@ -0,0 +1,236 @@
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "columnar_trace.h"
+#include "inf_stream.h"
+#include "trace_index_builder.h"
+#include "tracereader.h"
+
+namespace
+{
+std::vector<input_instr> make_records(std::size_t count)
+{
+  std::vector<input_instr> retval;
+  uint64_t ip = 0x400000;
+  for (std::size_t i = 0; i < count; ++i) {
+    input_instr record{};
+    record.ip = ip;
+    record.is_branch = (i % 7 == 0);
+    record.branch_taken = (i % 14 == 0);
+    record.destination_registers[0] = static_cast<unsigned char>(i % 64);
+    if (i % 3 == 0) {
+      record.source_memory[0] = 0x10000000 + ((i * 2654435761u) % (1u << 24));
+    }
+    ip = record.branch_taken ? 0x400000 + 4 * ((i * 37) % 1000) : ip + 4;
+    retval.push_back(record);
+  }
+  return retval;
+}
+
+std::string serialize(const std::vector<input_instr>& records)
+{
+  return std::string{reinterpret_cast<const char*>(std::data(records)), std::size(records) * sizeof(input_instr)};
+}
+
+std::string encode_columnar(const std::vector<input_instr>& records)
+{
+  auto retval = champsim::columnar::header<input_instr>();
+  champsim::columnar::encoder<input_instr> encoder;
+  for (const auto& record : records) {
+    encoder.push(record);
+    if (encoder.size() == champsim::columnar::block_instructions) {
+      auto block = encoder.flush();
+      retval.insert(std::end(retval), std::begin(block), std::end(block));
+    }
+  }
+  auto block = encoder.flush();
+  retval.insert(std::end(retval), std::begin(block), std::end(block));
+  return std::string{std::begin(retval), std::end(retval)};
+}
+
+template <typename Tag>
+void write_compressed(const std::string& name, const std::string& data)
+{
+  champsim::inf_ostream<Tag> os{name};
+  os.write(std::data(data), static_cast<std::streamsize>(std::size(data)));
+  os.close();
+}
+
+void write_multiblock_xz(const std::string& name, const std::string& data)
+{
+  lzma_mt options{};
+  options.threads = 1;
+  options.block_size = 1 << 16;
+  options.preset = LZMA_PRESET_DEFAULT;
+  options.check = LZMA_CHECK_CRC64;
+
+  lzma_stream encoder = LZMA_STREAM_INIT;
+  REQUIRE(::lzma_stream_encoder_mt(&encoder, &options) == LZMA_OK);
+  std::vector<uint8_t> compressed(std::size(data) + (1 << 16));
+  encoder.next_in = reinterpret_cast<const uint8_t*>(std::data(data));
+  encoder.avail_in = std::size(data);
+  encoder.next_out = std::data(compressed);
+  encoder.avail_out = std::size(compressed);
+  REQUIRE(::lzma_code(&encoder, LZMA_FINISH) == LZMA_STREAM_END);
+  compressed.resize(std::size(compressed) - encoder.avail_out);
+  ::lzma_end(&encoder);
+
+  std::ofstream{name, std::ios::binary}.write(reinterpret_cast<const char*>(std::data(compressed)), static_cast<std::streamsize>(std::size(compressed)));
+}
+
+// A trace file in the temporary directory, which is removed with its index
+struct temporary_trace {
+  std::string name;
+  explicit temporary_trace(std::string_view suffix)
+      : name((std::filesystem::temp_directory_path() / "champsim-trace-index-test").string() + std::string{suffix})
+  {
+  }
+  ~temporary_trace()
+  {
+    std::filesystem::remove(name);
+    std::filesystem::remove(champsim::trace_index::file_name(name));
+  }
+};
+
+// Seek the reader to the target, and check that it continues as a reader of the records that read them from the beginning
+template <typename Reader>
+void check_seek(Reader& uut, const std::vector<input_instr>& records, uint64_t target)
+{
+  auto position = uut.seek(0, target);
+  REQUIRE(position > 0);
+  REQUIRE(position <= target);
+
+  champsim::bulk_tracereader<input_instr, std::istringstream> expected{0, std::istringstream{serialize(records)}};
+  for (uint64_t i = 0; i < position; ++i) {
+    expected();
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    REQUIRE_FALSE(uut.eof());
+    auto expected_instr = expected();
+    auto instr = uut();
+    REQUIRE(instr.ip == expected_instr.ip);
+    REQUIRE(instr.branch_target == expected_instr.branch_target);
+    REQUIRE(instr.destination_registers == expected_instr.destination_registers);
+    REQUIRE(instr.source_memory == expected_instr.source_memory);
+  }
+}
+} // namespace
+
+TEST_CASE("A trace index lets a gzip trace be read from a checkpoint") {
+  auto records = make_records(40000);
+  temporary_trace trace{".gz"};
+  write_compressed<champsim::decomp_tags::gzip_tag_t<>>(trace.name, serialize(records));
+
+  auto index = champsim::build_trace_index(trace.name, 1 << 16);
+  REQUIRE(std::size(index.checkpoints) > 1);
+  index.save(trace.name);
+
+  champsim::bulk_tracereader<input_instr, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>> uut{0, trace.name};
+  check_seek(uut, records, 30001);
+}
+
+TEST_CASE("A trace index lets an xz trace be read from any of its blocks") {
+  auto records = make_records(40000);
+  temporary_trace trace{".xz"};
+  write_multiblock_xz(trace.name, serialize(records));
+
+  auto index = champsim::build_trace_index(trace.name, 0);
+  REQUIRE(std::size(index.checkpoints) == (std::size(records) * sizeof(input_instr) + (1 << 16) - 1) / (1 << 16));
+  index.save(trace.name);
+
+  champsim::bulk_tracereader<input_instr, champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>> uut{0, trace.name};
+  check_seek(uut, records, 30001);
+}
+
+TEST_CASE("A trace index lets a Zstandard trace be read from any of its frames") {
+  auto records = make_records(40000);
+  temporary_trace trace{".zst"};
+  write_compressed<champsim::decomp_tags::zstd_tag_t<ZSTD_CLEVEL_DEFAULT, (1u << 16)>>(trace.name, serialize(records));
+
+  auto index = champsim::build_trace_index(trace.name, 0);
+  REQUIRE(std::size(index.checkpoints) > 1);
+  index.save(trace.name);
+
+  champsim::bulk_tracereader<input_instr, champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>> uut{0, trace.name};
+  check_seek(uut, records, 30001);
+}
+
+TEST_CASE("A trace index lets a columnar trace be read from any of its blocks") {
+  auto records = make_records(2 * champsim::columnar::block_instructions + 1000);
+  auto target = champsim::columnar::block_instructions + 5;
+
+  SECTION("Uncompressed") {
+    temporary_trace trace{".cols"};
+    auto columnar = encode_columnar(records);
+    std::ofstream{trace.name, std::ios::binary}.write(std::data(columnar), static_cast<std::streamsize>(std::size(columnar)));
+
+    auto index = champsim::build_trace_index(trace.name, 0);
+    REQUIRE(std::size(index.blocks) == 3);
+    index.save(trace.name);
+
+    champsim::bulk_tracereader<input_instr, champsim::columnar_istream<std::ifstream>> uut{0, trace.name};
+    check_seek(uut, records, target);
+  }
+
+  SECTION("Compressed") {
+    temporary_trace trace{".cols.zst"};
+    write_compressed<champsim::decomp_tags::zstd_tag_t<ZSTD_CLEVEL_DEFAULT, (1u << 16)>>(trace.name, encode_columnar(records));
+
+    auto index = champsim::build_trace_index(trace.name, 0);
+    REQUIRE(std::size(index.blocks) == 3);
+    REQUIRE(std::size(index.checkpoints) > 1);
+    index.save(trace.name);
+
+    champsim::bulk_tracereader<input_instr, champsim::columnar_istream<champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>>> uut{0, trace.name};
+    check_seek(uut, records, target);
+  }
+}
+
+TEST_CASE("A trace reader does not skip past the end of the trace") {
+  auto records = make_records(40000);
+  temporary_trace trace{".xz"};
+  write_multiblock_xz(trace.name, serialize(records));
+  champsim::build_trace_index(trace.name, 0).save(trace.name);
+
+  champsim::bulk_tracereader<input_instr, champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>> uut{0, trace.name};
+  auto position = uut.seek(0, std::size(records) - 1);
+  REQUIRE(position < std::size(records) - 1);
+
+  for (; !uut.eof(); ++position) {
+    REQUIRE(uut().ip == champsim::address{records.at(position).ip});
+  }
+  REQUIRE(position == std::size(records) - 1);
+}
+
+TEST_CASE("A trace reader reads from the beginning if the trace has no index") {
+  auto records = make_records(1000);
+  temporary_trace trace{".gz"};
+  write_compressed<champsim::decomp_tags::gzip_tag_t<>>(trace.name, serialize(records));
+
+  champsim::bulk_tracereader<input_instr, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>> uut{0, trace.name};
+  REQUIRE(uut.seek(0, 500) == 0);
+}
+
+TEST_CASE("A trace index is rejected if the trace has changed") {
+  auto records = make_records(1000);
+  temporary_trace trace{".zst"};
+  write_compressed<champsim::decomp_tags::zstd_tag_t<>>(trace.name, serialize(records));
+  champsim::build_trace_index(trace.name, 0).save(trace.name);
+  REQUIRE(champsim::trace_index::load(trace.name).has_value());
+
+  std::ofstream{trace.name, std::ios::binary | std::ios::app} << "more";
+  REQUIRE_THROWS_AS(champsim::trace_index::load(trace.name), std::runtime_error);
+}
+
+TEST_CASE("A bzip2 trace cannot be indexed") {
+  temporary_trace trace{".bz2"};
+  write_compressed<champsim::decomp_tags::bzip2_tag_t>(trace.name, serialize(make_records(100)));
+  REQUIRE_THROWS_AS(champsim::build_trace_index(trace.name, 0), std::runtime_error);
+}
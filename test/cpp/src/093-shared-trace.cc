@@ -0,0 +1,111 @@
+#include <catch.hpp>
+
+#include <memory>
+
+#include "shared_trace.h"
+
+namespace
+{
+struct counting_trace {
+  uint64_t next = 0;
+  uint64_t end;
+
+  explicit counting_trace(uint64_t e) : end(e) {}
+  ooo_model_instr operator()()
+  {
+    input_instr record{};
+    record.ip = next++;
+    return ooo_model_instr{0, record};
+  }
+  [[nodiscard]] bool eof() const { return next >= end; }
+};
+
+std::shared_ptr<champsim::shared_trace> make_trace(uint64_t length, std::size_t window, int* opened)
+{
+  return std::make_shared<champsim::shared_trace>(
+      [length, opened] {
+        ++*opened;
+        return champsim::tracereader{counting_trace{length}};
+      },
+      window);
+}
+} // namespace
+
+TEST_CASE("The cursors of a shared trace each read the whole trace") {
+  constexpr uint64_t length = 3 * champsim::shared_trace::chunk_size + 100;
+  int opened = 0;
+  auto trace = make_trace(length, champsim::shared_trace::default_window, &opened);
+  champsim::tracereader first{champsim::shared_trace::make_cursor(trace, 0, true, 0)};
+  champsim::tracereader second{champsim::shared_trace::make_cursor(trace, 1, true, 0)};
+
+  for (uint64_t i = 0; i < length; ++i) {
+    REQUIRE_FALSE(first.eof());
+    auto instr = first();
+    REQUIRE(instr.ip == champsim::address{i});
+    REQUIRE(instr.asid[0] == 0);
+  }
+  REQUIRE(first.eof());
+
+  for (uint64_t i = 0; i < length; ++i) {
+    REQUIRE_FALSE(second.eof());
+    auto instr = second();
+    REQUIRE(instr.ip == champsim::address{i});
+    REQUIRE(instr.asid[0] == 1);
+  }
+  REQUIRE(second.eof());
+
+  REQUIRE(opened == 1);
+}
+
+TEST_CASE("The cursors of a shared trace begin at their offsets") {
+  constexpr uint64_t offset = 1000;
+  int opened = 0;
+  auto trace = make_trace(10 * champsim::shared_trace::chunk_size, champsim::shared_trace::default_window, &opened);
+  champsim::tracereader first{champsim::shared_trace::make_cursor(trace, 0, true, 0)};
+  champsim::tracereader second{champsim::shared_trace::make_cursor(trace, 1, true, offset)};
+
+  for (uint64_t i = 0; i < 2 * champsim::shared_trace::chunk_size; ++i) {
+    REQUIRE(second().ip == champsim::address{offset + i});
+    REQUIRE(first().ip == champsim::address{i});
+  }
+}
+
+TEST_CASE("A cursor that falls behind the window of a shared trace continues on its own") {
+  constexpr uint64_t length = 8 * champsim::shared_trace::chunk_size;
+  int opened = 0;
+  auto trace = make_trace(length, 2, &opened);
+  champsim::tracereader leader{champsim::shared_trace::make_cursor(trace, 0, true, 0)};
+  champsim::tracereader follower{champsim::shared_trace::make_cursor(trace, 1, true, 0)};
+
+  for (uint64_t i = 0; i < 10; ++i) {
+    REQUIRE(follower().ip == champsim::address{i});
+  }
+  for (uint64_t i = 0; i < 5 * champsim::shared_trace::chunk_size; ++i) {
+    REQUIRE(leader().ip == champsim::address{i});
+  }
+  REQUIRE(opened == 1);
+
+  for (uint64_t i = 10; i < length; ++i) {
+    REQUIRE_FALSE(follower.eof());
+    REQUIRE(follower().ip == champsim::address{i});
+  }
+  REQUIRE(follower.eof());
+  REQUIRE(opened == 2);
+}
+
+TEST_CASE("A shared trace skips the instructions that no cursor needs") {
+  constexpr uint64_t target = 20 * champsim::shared_trace::chunk_size + 7;
+  int opened = 0;
+  auto trace = make_trace(40 * champsim::shared_trace::chunk_size, 2, &opened);
+  champsim::tracereader first{champsim::shared_trace::make_cursor(trace, 0, true, 0)};
+  champsim::tracereader second{champsim::shared_trace::make_cursor(trace, 1, true, 0)};
+
+  first.fast_forward(target);
+  second.fast_forward(target);
+  REQUIRE(first.position() == target);
+  REQUIRE(second.position() == target);
+
+  REQUIRE(first().ip == champsim::address{target});
+  REQUIRE(second().ip == champsim::address{target});
+  REQUIRE(opened == 1);
+}
@@ -0,0 +1,135 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "dictionary_trace.h"
+#include "tracereader.h"
+
+namespace
+{
+template <typename T>
+std::vector<T> make_records(std::size_t count)
+{
+  std::vector<T> retval;
+  uint64_t ip = 0x400000;
+  for (std::size_t i = 0; i < count; ++i) {
+    T record{};
+    record.ip = ip;
+    auto site = (ip / 4) % 11;
+    record.is_branch = (site == 3 || site == 7);
+    record.branch_taken = record.is_branch && (i % 3 != 0);
+    record.destination_registers[0] = static_cast<unsigned char>(1 + site);
+    record.source_registers[1] = static_cast<unsigned char>(20 + site);
+    if (site == 3) {
+      record.destination_registers[1] = champsim::REG_INSTRUCTION_POINTER;
+      record.source_registers[0] = champsim::REG_INSTRUCTION_POINTER;
+      record.source_registers[2] = champsim::REG_FLAGS;
+    }
+    if (site == 7) {
+      record.destination_registers[1] = champsim::REG_INSTRUCTION_POINTER;
+    }
+    if (site % 2 == 0) {
+      record.source_memory[2] = 0x7fff0000 + 8 * i;
+    }
+    if (site == 5 && i % 4 != 0) {
+      // The same IP, with a different number of memory operands
+      record.destination_memory[1] = 0x10000000 + ((i * 2654435761u) % (1u << 24));
+    }
+    if constexpr (champsim::dictionary::record_layout<T>::asid) {
+      record.asid[0] = static_cast<unsigned char>(i % 3);
+      record.asid[1] = 1;
+    }
+    ip = (record.is_branch && record.branch_taken) ? 0x400000 + 4 * ((i * 37) % 200) : ip + 4;
+    retval.push_back(record);
+  }
+  return retval;
+}
+
+template <typename T>
+std::string encode(const std::vector<T>& records)
+{
+  auto retval = champsim::dictionary::header<T>();
+  champsim::dictionary::encoder<T> encoder;
+  for (const auto& record : records) {
+    encoder.push(record);
+    if (encoder.size() == champsim::dictionary::block_instructions) {
+      auto block = encoder.flush();
+      retval.insert(std::end(retval), std::begin(block), std::end(block));
+    }
+  }
+  auto block = encoder.flush();
+  retval.insert(std::end(retval), std::begin(block), std::end(block));
+  return std::string{std::begin(retval), std::end(retval)};
+}
+
+template <typename T>
+std::string serialize(const std::vector<T>& records)
+{
+  return std::string{reinterpret_cast<const char*>(std::data(records)), std::size(records) * sizeof(T)};
+}
+
+template <typename T>
+void check_same_instructions(const std::vector<T>& records)
+{
+  auto dictionary = encode(records);
+  REQUIRE(std::size(dictionary) * 4 < std::size(records) * sizeof(T));
+
+  champsim::bulk_tracereader<T, std::istringstream> expected{0, std::istringstream{serialize(records)}};
+  champsim::bulk_tracereader<T, champsim::dictionary_istream<std::istringstream>> uut{
+      0, champsim::dictionary_istream<std::istringstream>{std::istringstream{dictionary}}};
+
+  std::size_t count = 0;
+  while (!expected.eof()) {
+    REQUIRE_FALSE(uut.eof());
+    auto expected_instr = expected();
+    auto instr = uut();
+    REQUIRE(instr.ip == expected_instr.ip);
+    REQUIRE(instr.is_branch == expected_instr.is_branch);
+    REQUIRE(instr.branch_taken == expected_instr.branch_taken);
+    REQUIRE(instr.branch == expected_instr.branch);
+    REQUIRE(instr.branch_target == expected_instr.branch_target);
+    REQUIRE(instr.asid == expected_instr.asid);
+    REQUIRE(instr.destination_registers == expected_instr.destination_registers);
+    REQUIRE(instr.source_registers == expected_instr.source_registers);
+    REQUIRE(instr.destination_memory == expected_instr.destination_memory);
+    REQUIRE(instr.source_memory == expected_instr.source_memory);
+    ++count;
+  }
+  REQUIRE(uut.eof());
+  REQUIRE(count == std::size(records) - 1);
+}
+} // namespace
+
+TEST_CASE("A dictionary trace reader reads the same instructions as the native format") {
+  check_same_instructions(make_records<input_instr>(2 * champsim::dictionary::block_instructions + 1000));
+}
+
+TEST_CASE("A dictionary trace reader reads the same CloudSuite instructions as the native format") {
+  check_same_instructions(make_records<cloudsuite_instr>(champsim::dictionary::block_instructions + 1000));
+}
+
+TEST_CASE("A dictionary trace stores each static instruction once") {
+  auto records = make_records<input_instr>(10000);
+  champsim::dictionary::encoder<input_instr> encoder;
+  for (const auto& record : records) {
+    encoder.push(record);
+  }
+
+  // Each of the 200 branch targets begins a run of IPs, and one IP in every 11 has two static instructions
+  REQUIRE(encoder.static_instructions() < 300);
+}
+
+TEST_CASE("A dictionary trace reader rejects a trace of another kind of record") {
+  auto dictionary = encode(make_records<input_instr>(100));
+  using reader_type = champsim::bulk_tracereader<cloudsuite_instr, champsim::dictionary_istream<std::istringstream>>;
+  REQUIRE_THROWS_AS((reader_type{0, champsim::dictionary_istream<std::istringstream>{std::istringstream{dictionary}}}), std::runtime_error);
+}
+
+TEST_CASE("The dictionary format is recognized by the name of the trace") {
+  REQUIRE(champsim::dictionary::is_dictionary_trace("trace.dict"));
+  REQUIRE(champsim::dictionary::is_dictionary_trace("trace.champsimtrace.dict.xz"));
+  REQUIRE_FALSE(champsim::dictionary::is_dictionary_trace("trace.champsimtrace.xz"));
+  REQUIRE_FALSE(champsim::dictionary::is_dictionary_trace("trace.cols.zst"));
+}
@@ -0,0 +1,110 @@
+#include <catch.hpp>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "instruction.h"
+
+namespace
+{
+constexpr std::array<unsigned char, 5> register_choices{0, champsim::REG_STACK_POINTER, champsim::REG_FLAGS, champsim::REG_INSTRUCTION_POINTER, 3};
+
+void require_same(const ooo_model_instr& lhs, const ooo_model_instr& rhs)
+{
+  REQUIRE(lhs.ip == rhs.ip);
+  REQUIRE(lhs.is_branch == rhs.is_branch);
+  REQUIRE(lhs.branch_taken == rhs.branch_taken);
+  REQUIRE(lhs.branch == rhs.branch);
+  REQUIRE(lhs.branch_target == rhs.branch_target);
+  REQUIRE(lhs.asid == rhs.asid);
+  REQUIRE(lhs.destination_registers == rhs.destination_registers);
+  REQUIRE(lhs.source_registers == rhs.source_registers);
+  REQUIRE(lhs.destination_memory == rhs.destination_memory);
+  REQUIRE(lhs.source_memory == rhs.source_memory);
+}
+
+template <typename T>
+void check_inflate(const std::vector<T>& records)
+{
+  constexpr uint8_t cpu = 3;
+  std::vector<ooo_model_instr> inflated;
+  ooo_model_instr::inflate(cpu, std::begin(records), std::end(records), std::back_inserter(inflated));
+  REQUIRE(std::size(inflated) == std::size(records));
+  for (std::size_t i = 0; i < std::size(records); ++i) {
+    require_same(inflated[i], ooo_model_instr{cpu, records[i]});
+  }
+}
+} // namespace
+
+TEST_CASE("Inflating records classifies every combination of registers as the constructor does") {
+  std::vector<input_instr> records;
+  std::array<std::size_t, NUM_INSTR_DESTINATIONS + NUM_INSTR_SOURCES> choice{};
+  bool done = false;
+  while (!done) {
+    for (unsigned flags = 0; flags < 4; ++flags) {
+      input_instr record{};
+      record.ip = 0xdeadbeef + 4 * std::size(records);
+      record.is_branch = flags & 1;
+      record.branch_taken = (flags >> 1) & 1;
+      for (std::size_t i = 0; i < NUM_INSTR_DESTINATIONS; ++i) {
+        record.destination_registers[i] = register_choices[choice[i]];
+      }
+      for (std::size_t i = 0; i < NUM_INSTR_SOURCES; ++i) {
+        record.source_registers[i] = register_choices[choice[NUM_INSTR_DESTINATIONS + i]];
+      }
+      records.push_back(record);
+    }
+
+    // Advance to the next combination
+    done = true;
+    for (auto& c : choice) {
+      if (++c < std::size(register_choices)) {
+        done = false;
+        break;
+      }
+      c = 0;
+    }
+  }
+
+  check_inflate(records);
+}
+
+TEST_CASE("Inflating records keeps the memory operands that are present, in order") {
+  std::mt19937_64 rng{};
+  std::vector<input_instr> records(1000);
+  for (auto& record : records) {
+    record.ip = rng();
+    for (auto& addr : record.destination_memory) {
+      addr = (rng() % 2 == 0) ? 0 : rng();
+    }
+    for (auto& addr : record.source_memory) {
+      addr = (rng() % 2 == 0) ? 0 : rng();
+    }
+  }
+
+  check_inflate(records);
+}
+
+TEST_CASE("Inflating CloudSuite records keeps their address spaces") {
+  std::mt19937_64 rng{};
+  std::vector<cloudsuite_instr> records(10000);
+  for (auto& record : records) {
+    record.ip = rng();
+    record.is_branch = rng() % 2;
+    record.branch_taken = rng() % 2;
+    for (auto& reg : record.destination_registers) {
+      reg = register_choices[rng() % std::size(register_choices)];
+    }
+    for (auto& reg : record.source_registers) {
+      reg = register_choices[rng() % std::size(register_choices)];
+    }
+    for (auto& addr : record.source_memory) {
+      addr = (rng() % 3 == 0) ? rng() : 0;
+    }
+    record.asid[0] = static_cast<unsigned char>(rng());
+    record.asid[1] = static_cast<unsigned char>(rng());
+  }
+
+  check_inflate(records);
+}
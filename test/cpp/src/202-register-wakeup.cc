@@ -0,0 +1,94 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "ooo_cpu.h"
+#include "instr.h"
+#include "register_allocator.h"
+
+SCENARIO("Completing a register wakes the instructions that wait on it") {
+  GIVEN("A register that is written by one instruction and read by two others") {
+    RegisterAllocator ra{128};
+    auto producer = ra.rename_dest_register(5, 1);
+    ra.add_consumer(producer, 2);
+    ra.add_consumer(producer, 3);
+
+    WHEN("The register is completed") {
+      auto woken = ra.complete_dest_register(producer);
+
+      THEN("Both readers are woken, in the order they began waiting") {
+        REQUIRE_THAT(woken, Catch::Matchers::RangeEquals(std::vector<uint64_t>{2, 3}));
+        REQUIRE(ra.isValid(producer));
+      }
+
+      AND_WHEN("The register is completed again") {
+        THEN("No instruction is woken a second time") {
+          REQUIRE(std::empty(ra.complete_dest_register(producer)));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("The execute stage selects only instructions whose sources are ready") {
+  GIVEN("A ROB where the youngest instruction reads the results of two older ones") {
+    constexpr unsigned execute_latency = 2;
+
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+      .schedule_width(champsim::bandwidth::maximum_type{128})
+      .register_file_size(128)
+      .execute_latency(execute_latency)
+      .execute_width(champsim::bandwidth::maximum_type{4})
+      .rob_size(4)
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+    };
+
+    for (uint64_t id : {1, 2, 3}) {
+      uut.ROB.push_back(champsim::test::instruction_with_ip(id));
+      uut.ROB.back().instr_id = id;
+      uut.ROB.back().ready_time = champsim::chrono::clock::time_point{};
+    }
+    uut.ROB.at(0).destination_registers.push_back(5);
+    uut.ROB.at(1).destination_registers.push_back(6);
+    uut.ROB.at(2).source_registers.push_back(5);
+    uut.ROB.at(2).source_registers.push_back(6);
+    uut.ROB.at(2).source_registers.push_back(5);
+
+    WHEN("The instructions are scheduled") {
+      uut.schedule_instruction();
+
+      THEN("The two writers are ready, oldest first, and the reader waits") {
+        REQUIRE(std::size(uut.ready_to_execute) == 2);
+        REQUIRE(uut.ready_to_execute.at(0)->instr_id == 1);
+        REQUIRE(uut.ready_to_execute.at(1)->instr_id == 2);
+      }
+
+      AND_WHEN("Only the first writer completes") {
+        uut.execute_instruction();
+        uut.ROB.at(1).ready_time = champsim::chrono::clock::time_point::max();
+        uut.current_time += execute_latency * uut.clock_period;
+        uut.complete_inflight_instruction();
+
+        THEN("The reader still waits") {
+          REQUIRE(uut.ROB.at(0).completed);
+          REQUIRE_FALSE(uut.ROB.at(1).completed);
+          REQUIRE(std::empty(uut.ready_to_execute));
+        }
+
+        AND_WHEN("The second writer completes") {
+          uut.ROB.at(1).ready_time = uut.current_time;
+          uut.complete_inflight_instruction();
+
+          THEN("The reader is ready to execute") {
+            REQUIRE(std::size(uut.ready_to_execute) == 1);
+            REQUIRE(uut.ready_to_execute.front()->instr_id == 3);
+
+            uut.execute_instruction();
+            REQUIRE(uut.ROB.at(2).executed);
+            REQUIRE(std::empty(uut.ready_to_execute));
+          }
+        }
+      }
+    }
+  }
+}
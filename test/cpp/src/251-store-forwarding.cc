@@ -0,0 +1,96 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "ooo_cpu.h"
+#include "instr.h"
+
+namespace
+{
+ooo_model_instr store_instruction(uint64_t id, champsim::address dmem)
+{
+  auto retval = champsim::test::instruction_with_ip(champsim::address{1000 + 4 * id});
+  retval.destination_memory.push_back(dmem);
+  retval.instr_id = id;
+  retval.ready_time = champsim::chrono::clock::time_point{};
+  return retval;
+}
+
+ooo_model_instr load_instruction(uint64_t id, champsim::address smem)
+{
+  auto retval = champsim::test::instruction_with_ip_and_source_memory(champsim::address{1000 + 4 * id}, smem);
+  retval.instr_id = id;
+  retval.ready_time = champsim::chrono::clock::time_point{};
+  return retval;
+}
+} // namespace
+
+SCENARIO("A load waits on the youngest prior store to its address") {
+  GIVEN("Two stores to one address and a store to another, followed by a load") {
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+      .dispatch_width(champsim::bandwidth::maximum_type{4})
+      .rob_size(4)
+      .lq_size(2)
+      .sq_size(3)
+    };
+
+    uut.DISPATCH_BUFFER.push_back(store_instruction(1, champsim::address{0xcafe0000}));
+    uut.DISPATCH_BUFFER.push_back(store_instruction(2, champsim::address{0xcafe0000}));
+    uut.DISPATCH_BUFFER.push_back(store_instruction(3, champsim::address{0xbeef0000}));
+    uut.DISPATCH_BUFFER.push_back(load_instruction(4, champsim::address{0xcafe0000}));
+
+    WHEN("The instructions are dispatched") {
+      uut.dispatch_instruction();
+
+      THEN("The load is forwarded from the second store") {
+        REQUIRE(std::size(uut.ROB) == 4);
+        REQUIRE(uut.LQ.at(0).has_value());
+        REQUIRE(uut.LQ.at(0)->producer_id == 2);
+        REQUIRE(std::empty(uut.SQ.at(0).lq_depend_on_me));
+        REQUIRE(std::size(uut.SQ.at(1).lq_depend_on_me) == 1);
+        REQUIRE(std::size(uut.lq_free_slots) == 1);
+      }
+
+      AND_WHEN("The second store finishes") {
+        uut.do_finish_store(uut.SQ.at(1));
+
+        THEN("The load is complete, and its LQ entry is free") {
+          REQUIRE(uut.ROB.at(3).completed_mem_ops == 1);
+          REQUIRE_FALSE(uut.LQ.at(0).has_value());
+          REQUIRE(std::size(uut.lq_free_slots) == 2);
+        }
+      }
+    }
+  }
+
+  GIVEN("A store that has already executed") {
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+      .dispatch_width(champsim::bandwidth::maximum_type{4})
+      .rob_size(4)
+      .lq_size(2)
+      .sq_size(2)
+    };
+
+    uut.DISPATCH_BUFFER.push_back(store_instruction(1, champsim::address{0xcafe0000}));
+    uut.dispatch_instruction();
+    uut.SQ.at(0).fetch_issued = true;
+
+    WHEN("A load from the same address and a load from another address are dispatched") {
+      uut.DISPATCH_BUFFER.push_back(load_instruction(2, champsim::address{0xcafe0000}));
+      uut.DISPATCH_BUFFER.push_back(load_instruction(3, champsim::address{0xbeef0000}));
+      uut.dispatch_instruction();
+
+      THEN("The first load completes at once, and the second load takes the first LQ entry") {
+        REQUIRE(uut.ROB.at(1).completed_mem_ops == 1);
+        REQUIRE(uut.LQ.at(0).has_value());
+        REQUIRE(uut.LQ.at(0)->instr_id == 3);
+        REQUIRE(uut.LQ.at(0)->producer_id == std::numeric_limits<uint64_t>::max());
+        REQUIRE_FALSE(uut.LQ.at(1).has_value());
+      }
+    }
+  }
+}
@@ -0,0 +1,67 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "ooo_cpu.h"
+#include "instr.h"
+
+SCENARIO("A returned block finishes exactly the loads that were issued to it") {
+  GIVEN("Three issued loads, two of which are to the same block") {
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+      .dispatch_width(champsim::bandwidth::maximum_type{4})
+      .lq_width(champsim::bandwidth::maximum_type{4})
+      .l1d_bandwidth(champsim::bandwidth::maximum_type{4})
+      .rob_size(4)
+      .lq_size(4)
+    };
+
+    uint64_t id = 1;
+    for (auto smem : {champsim::address{0xcafe0000}, champsim::address{0xcafe0008}, champsim::address{0xbeef0000}}) {
+      auto instr = champsim::test::instruction_with_ip_and_source_memory(champsim::address{1000 + 4 * id}, smem);
+      instr.instr_id = id++;
+      instr.ready_time = champsim::chrono::clock::time_point{};
+      uut.DISPATCH_BUFFER.push_back(instr);
+    }
+    uut.dispatch_instruction();
+    uut.warmup = true; // Execute with no latency
+    for (auto& instr : uut.ROB) {
+      uut.do_execution(instr);
+    }
+    uut.warmup = false;
+    REQUIRE(std::size(uut.lq_ready_slots) == 3);
+
+    uut.current_time += uut.clock_period;
+    uut.operate_lsq();
+
+    REQUIRE(std::empty(uut.lq_ready_slots));
+    REQUIRE(std::all_of(std::begin(uut.LQ), std::prev(std::end(uut.LQ)), [](const auto& x) { return x.has_value() && x->fetch_issued; }));
+    REQUIRE(mock_L1D.queues.RQ.size() == 3);
+
+    WHEN("The block of the first two loads returns") {
+      mock_L1D.queues.returned.push_back(champsim::channel::response_type{mock_L1D.queues.RQ.front()});
+      uut.handle_memory_return();
+
+      THEN("The first two loads are finished and the third still waits") {
+        REQUIRE(uut.ROB.at(0).completed_mem_ops == 1);
+        REQUIRE(uut.ROB.at(1).completed_mem_ops == 1);
+        REQUIRE(uut.ROB.at(2).completed_mem_ops == 0);
+        REQUIRE_FALSE(uut.LQ.at(0).has_value());
+        REQUIRE_FALSE(uut.LQ.at(1).has_value());
+        REQUIRE(uut.LQ.at(2).has_value());
+        REQUIRE(std::empty(mock_L1D.queues.returned));
+      }
+
+      AND_WHEN("The same block returns again") {
+        mock_L1D.queues.returned.push_back(champsim::channel::response_type{mock_L1D.queues.RQ.front()});
+        uut.handle_memory_return();
+
+        THEN("No load is finished twice") {
+          REQUIRE(uut.ROB.at(0).completed_mem_ops == 1);
+          REQUIRE(uut.ROB.at(1).completed_mem_ops == 1);
+          REQUIRE(uut.LQ.at(2).has_value());
+        }
+      }
+    }
+  }
+}
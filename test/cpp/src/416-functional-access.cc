@@ -0,0 +1,160 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+namespace
+{
+/*
+ * A MemoryRequestConsumer that records the functional accesses made to it
+ */
+class functional_MRC : public champsim::operable
+{
+  public:
+    champsim::channel queues{};
+    champsim::address ret_data{};
+    std::vector<champsim::channel::request_type> accesses{};
+
+    functional_MRC() : champsim::operable() { queues.request_sink = this; }
+
+    long operate() override { return 0; }
+
+    champsim::address functional_access(const champsim::channel::request_type& packet) override {
+      accesses.push_back(packet);
+      return ret_data;
+    }
+};
+}
+
+SCENARIO("A functional access fills the cache without using its queues") {
+  GIVEN("An empty cache") {
+    functional_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("416a-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = true;
+      elem->begin_phase();
+    }
+
+    WHEN("A load is made functionally") {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xdeadbeef};
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+
+      mock_ul.queues.functional_access(test);
+
+      THEN("The miss is forwarded to the lower level at once") {
+        REQUIRE(std::size(mock_ll.accesses) == 1);
+        CHECK(mock_ll.accesses.front().address == test.address);
+        CHECK(uut.sim_stats.misses.value_or(std::pair{access_type::LOAD, 0}, 0) == 1);
+      }
+
+      THEN("No request is left in flight") {
+        CHECK(std::empty(mock_ul.queues.RQ));
+        CHECK(std::empty(uut.MSHR));
+      }
+
+      AND_WHEN("The same address is loaded again") {
+        mock_ul.queues.functional_access(test);
+
+        THEN("The load hits") {
+          CHECK(std::size(mock_ll.accesses) == 1);
+          CHECK(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, 0}, 0) == 1);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A functional access writes back a dirty victim") {
+  GIVEN("A cache with one block") {
+    functional_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("416b-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = true;
+      elem->begin_phase();
+    }
+
+    WHEN("A block is written and then evicted") {
+      decltype(mock_ul)::request_type seed;
+      seed.address = champsim::address{0xdeadbeef};
+      seed.cpu = 0;
+      seed.type = access_type::WRITE;
+      mock_ul.queues.functional_access(seed);
+
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xcafebabe};
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+      mock_ul.queues.functional_access(test);
+
+      THEN("The written block is sent to the lower level") {
+        REQUIRE(std::size(mock_ll.accesses) == 2);
+        CHECK(mock_ll.accesses.at(0).type == access_type::LOAD);
+        CHECK(mock_ll.accesses.at(1).type == access_type::WRITE);
+        CHECK(champsim::block_number{mock_ll.accesses.at(1).address} == champsim::block_number{seed.address});
+      }
+    }
+  }
+}
+
+SCENARIO("A functional access is translated before the tag check") {
+  GIVEN("An empty cache with a translator") {
+    functional_MRC mock_translator;
+    functional_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("416c-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .lower_translate(&mock_translator.queues)
+    };
+
+    std::array<champsim::operable*, 4> elements{{&uut, &mock_ll, &mock_ul, &mock_translator}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = true;
+      elem->begin_phase();
+    }
+
+    mock_translator.ret_data = champsim::address{0x11111000};
+
+    WHEN("An untranslated load is made functionally") {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xdeadbeef};
+      test.v_address = champsim::address{0xdeadbeef};
+      test.is_translated = false;
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+
+      mock_ul.queues.functional_access(test);
+
+      THEN("The lower level receives the physical address") {
+        REQUIRE(std::size(mock_translator.accesses) == 1);
+        REQUIRE(std::size(mock_ll.accesses) == 1);
+        CHECK(mock_ll.accesses.front().address == champsim::address{0x11111eef});
+      }
+    }
+  }
+}
@@ -0,0 +1,127 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+
+namespace
+{
+void issue_and_wait(to_rq_MRP& mock_ul, champsim::address address, std::array<champsim::operable*, 3>& elements)
+{
+  to_rq_MRP::request_type test;
+  test.address = address;
+  test.cpu = 0;
+  test.type = access_type::LOAD;
+  REQUIRE(mock_ul.issue(test));
+
+  for (auto i = 0; i < 100; ++i) {
+    for (auto elem : elements) {
+      elem->_operate();
+    }
+  }
+}
+}
+
+SCENARIO("A shadow cache observes the accesses to its parent") {
+  GIVEN("A direct-mapped cache with a two-way shadow") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("417a-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+    CACHE shadow{champsim::cache_builder{}
+      .name("417a-shadow")
+      .sets(1)
+      .ways(2)
+      .replacement<lru>()
+    };
+    uut.shadows = {&shadow};
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Two blocks are loaded, and then the first is loaded again") {
+      issue_and_wait(mock_ul, champsim::address{0xdeadbeef}, elements);
+      issue_and_wait(mock_ul, champsim::address{0xcafebabe}, elements);
+      issue_and_wait(mock_ul, champsim::address{0xdeadbeef}, elements);
+
+      for (auto elem : elements) {
+        elem->end_phase(0);
+      }
+
+      THEN("The cache misses every time") {
+        CHECK(uut.roi_stats.misses.value_or(std::pair{access_type::LOAD, 0}, 0) == 3);
+        CHECK(uut.roi_stats.hits.value_or(std::pair{access_type::LOAD, 0}, 0) == 0);
+      }
+
+      THEN("The shadow hits on the second load of the first block") {
+        CHECK(shadow.roi_stats.misses.value_or(std::pair{access_type::LOAD, 0}, 0) == 2);
+        CHECK(shadow.roi_stats.hits.value_or(std::pair{access_type::LOAD, 0}, 0) == 1);
+      }
+
+      THEN("The statistics of the shadow are reported with the cache") {
+        REQUIRE(std::size(uut.roi_stats.shadows) == 1);
+        CHECK(uut.roi_stats.shadows.front().name == "417a-shadow");
+        CHECK(uut.roi_stats.shadows.front().hits.value_or(std::pair{access_type::LOAD, 0}, 0) == 1);
+      }
+
+      THEN("The lower level sees only the misses of the cache") {
+        CHECK(mock_ll.packet_count() == 3);
+      }
+    }
+  }
+}
+
+SCENARIO("A shadow cache is filled when its parent hits") {
+  GIVEN("A two-way cache with a direct-mapped shadow") {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("417b-uut")
+      .sets(1)
+      .ways(2)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+    CACHE shadow{champsim::cache_builder{}
+      .name("417b-shadow")
+      .sets(1)
+      .ways(1)
+      .replacement<lru>()
+    };
+    uut.shadows = {&shadow};
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Two blocks are loaded, and then each is loaded again") {
+      issue_and_wait(mock_ul, champsim::address{0xdeadbeef}, elements);
+      issue_and_wait(mock_ul, champsim::address{0xcafebabe}, elements);
+      issue_and_wait(mock_ul, champsim::address{0xdeadbeef}, elements);
+      issue_and_wait(mock_ul, champsim::address{0xdeadbeef}, elements);
+
+      THEN("The cache hits on the repeated loads") {
+        CHECK(uut.sim_stats.misses.value_or(std::pair{access_type::LOAD, 0}, 0) == 2);
+        CHECK(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, 0}, 0) == 2);
+      }
+
+      THEN("The shadow holds the first block again after its parent hits on it") {
+        CHECK(shadow.sim_stats.misses.value_or(std::pair{access_type::LOAD, 0}, 0) == 3);
+        CHECK(shadow.sim_stats.hits.value_or(std::pair{access_type::LOAD, 0}, 0) == 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#include <catch.hpp>
+#include "vmem.h"
+
+#include "dram_controller.h"
+
+namespace {
+MEMORY_CONTROLLER make_dram()
+{
+  return MEMORY_CONTROLLER{champsim::chrono::picoseconds{3200}, champsim::chrono::picoseconds{6400}, std::size_t{18}, std::size_t{18}, std::size_t{18}, std::size_t{38}, champsim::chrono::microseconds{64000}, {}, 64, 64, 1, champsim::data::bytes{8}, 1024, 1024, 4, 4, 4, 8192};
+}
+}
+
+SCENARIO("Partitioning the physical pages preserves the free pages") {
+  GIVEN("A virtual memory") {
+    auto dram = make_dram();
+    VirtualMemory uut{champsim::data::bytes{1LL << 12}, 5, std::chrono::nanoseconds{6400}, dram};
+    auto original_size = uut.available_ppages();
+
+    WHEN("The pages are partitioned") {
+      uut.partition_pages(4);
+
+      THEN("No pages are lost") {
+        REQUIRE(uut.available_ppages() == original_size);
+      }
+    }
+  }
+}
+
+SCENARIO("Partitioned page allocation does not depend on the order of faults from other cpus") {
+  GIVEN("Two partitioned virtual memories") {
+    auto dram = make_dram();
+    VirtualMemory first{champsim::data::bytes{1LL << 12}, 5, std::chrono::nanoseconds{6400}, dram, 1234};
+    VirtualMemory second{champsim::data::bytes{1LL << 12}, 5, std::chrono::nanoseconds{6400}, dram, 1234};
+    first.partition_pages(2);
+    second.partition_pages(2);
+
+    WHEN("The cpus fault in a different order in each") {
+      const champsim::page_number vpage_a{0xdeadbeef};
+      const champsim::page_number vpage_b{0xcafebabe};
+
+      auto [first_a, first_a_delay] = first.va_to_pa(0, vpage_a);
+      auto [first_b, first_b_delay] = first.va_to_pa(1, vpage_b);
+
+      auto [second_b, second_b_delay] = second.va_to_pa(1, vpage_b);
+      auto [second_a, second_a_delay] = second.va_to_pa(0, vpage_a);
+
+      THEN("Each cpu receives the same page in both") {
+        REQUIRE(first_a == second_a);
+        REQUIRE(first_b == second_b);
+      }
+
+      THEN("The cpus receive different pages") {
+        REQUIRE(first_a != first_b);
+      }
+    }
+
+    WHEN("The cpus walk the page table in a different order in each") {
+      const champsim::page_number vpage_a{0xdeadbeef};
+      const champsim::page_number vpage_b{0xcafebabe};
+
+      auto first_a = first.get_pte_pa(0, vpage_a, 2).first;
+      auto first_b = first.get_pte_pa(1, vpage_b, 2).first;
+
+      auto second_b = second.get_pte_pa(1, vpage_b, 2).first;
+      auto second_a = second.get_pte_pa(0, vpage_a, 2).first;
+
+      THEN("Each cpu receives the same page table entry in both") {
+        REQUIRE(first_a == second_a);
+        REQUIRE(first_b == second_b);
+      }
+    }
+  }
+}
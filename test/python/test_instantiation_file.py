@@ -188,6 +188,47 @@ class CacheBuilderTests(unittest.TestCase):
         self.get_element_diff(['.replacement<class a_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }])
         self.get_element_diff(['.replacement<class a_class, class b_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
+class ShadowBuilderTests(unittest.TestCase):
+
+    def get_lines(self, **kwargs):
+        base_shadow = { 'name': 'test_shadow' }
+        return {l.strip() for l in config.instantiation_file.get_shadow_builder({**base_shadow, **kwargs}, 'parent')}
+
+    def test_geometry_is_inherited(self):
+        lines = self.get_lines()
+        self.assertIn('.sets(parent.NUM_SET)', lines)
+        self.assertIn('.ways(parent.NUM_WAY)', lines)
+        self.assertIn('.offset_bits(parent.OFFSET_BITS)', lines)
+
+    def test_sets_are_not_inherited_if_given(self):
+        lines = self.get_lines(sets=1)
+        self.assertIn('.sets(1)', lines)
+        self.assertNotIn('.sets(parent.NUM_SET)', lines)
+        self.assertIn('.ways(parent.NUM_WAY)', lines)
+
+    def test_ways_are_not_inherited_if_given(self):
+        lines = self.get_lines(log2_ways=1)
+        self.assertIn('.log2_ways(1)', lines)
+        self.assertIn('.sets(parent.NUM_SET)', lines)
+        self.assertNotIn('.ways(parent.NUM_WAY)', lines)
+
+    def test_size_determines_sets(self):
+        lines = self.get_lines(size=1)
+        self.assertIn('.size(champsim::data::bytes{1})', lines)
+        self.assertNotIn('.sets(parent.NUM_SET)', lines)
+        self.assertIn('.ways(parent.NUM_WAY)', lines)
+
+    def test_size_and_sets_determine_ways(self):
+        lines = self.get_lines(size=1, sets=1)
+        self.assertNotIn('.sets(parent.NUM_SET)', lines)
+        self.assertNotIn('.ways(parent.NUM_WAY)', lines)
+
+    def test_replacement(self):
+        self.assertIn('.replacement<class a_class>()', self.get_lines(_replacement_data=[{ 'name': 'a', 'class': 'a_class' }]))
+
+    def test_timing_parameters_are_ignored(self):
+        self.assertEqual(self.get_lines(), self.get_lines(latency=1, mshr_size=1))
+
 class PageTableWalkerBuilderTests(unittest.TestCase):
 
     def get_element_diff(self, added_lines, **kwargs):
@@ -321,6 +321,29 @@ class ParseNormalizedTests(unittest.TestCase):
                 module_names = [c.get(module_key) for c in caches]
                 self.assertNotIn(None, module_names)
 
+    def test_shadows_are_named_and_have_replacement(self):
+        test_config = config.parse.NormalizedConfiguration({
+            'ooo_cpu': [{ 'name': 'test_cpu' }],
+            'LLC': { 'replacement': 'parent_repl', 'shadows': [{ 'sets': 1 }, { 'name': 'named', 'replacement': 'shadow_repl' }] }
+        })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        llc = next(c for c in result[0]['caches'] if c['name'] == 'LLC')
+        shadows = llc['_shadows']
+
+        self.assertEqual([s['name'] for s in shadows], ['LLC_shadow0', 'named'])
+        self.assertEqual(shadows[0]['sets'], 1)
+        self.assertEqual([d['name'] for d in shadows[0]['_replacement_data']], ['parent_repl'])
+        self.assertEqual([d['name'] for d in shadows[1]['_replacement_data']], ['shadow_repl'])
+
+    def test_caches_have_no_shadows_by_default(self):
+        test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu' }] })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        for cache in result[0]['caches']:
+            with self.subTest(cache=cache['name']):
+                self.assertEqual(cache['_shadows'], [])
+
 class NormalizeConfigTest(unittest.TestCase):
 
     def test_empty_config_creates_defaults(self):
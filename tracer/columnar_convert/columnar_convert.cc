@@ -0,0 +1,201 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Convert a trace of input_instr or cloudsuite_instr records into the columnar or dictionary trace format, which is chosen by the name of the
+ * output: *.cols or *.dict, followed by the extension of any compression.
+ * The input may be uncompressed, or compressed with xz, gzip, bzip2, or zstd. The output is compressed according to its extension.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../../inc/columnar_trace.h"
+#include "../../inc/dictionary_trace.h"
+#include "../../inc/inf_stream.h"
+
+namespace
+{
+struct options {
+  std::string input_name;
+  std::string output_name;
+  bool cloudsuite = false;
+};
+
+[[noreturn]] void usage(const char* name)
+{
+  std::cerr << "Usage: " << name << " [-c] INPUT OUTPUT\n";
+  std::cerr << "  -c  The input is a CloudSuite trace\n";
+  std::exit(EXIT_FAILURE);
+}
+
+options parse_options(int argc, char** argv)
+{
+  options retval;
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg{argv[i]};
+    if (arg == "-c") {
+      retval.cloudsuite = true;
+    } else if (!arg.empty() && arg.front() == '-') {
+      usage(argv[0]);
+    } else {
+      positional.emplace_back(arg);
+    }
+  }
+
+  if (std::size(positional) != 2) {
+    usage(argv[0]);
+  }
+  retval.input_name = positional.at(0);
+  retval.output_name = positional.at(1);
+  return retval;
+}
+
+bool ends_with(std::string_view str, std::string_view suffix)
+{
+  return std::size(str) >= std::size(suffix) && str.substr(std::size(str) - std::size(suffix)) == suffix;
+}
+
+template <typename Out>
+void write_bytes(Out& output, const std::vector<uint8_t>& bytes)
+{
+  output.write(reinterpret_cast<const char*>(std::data(bytes)), static_cast<std::streamsize>(std::size(bytes)));
+}
+
+template <typename T, typename Encoder, typename In, typename Out>
+uint64_t convert_with(In& input, Out& output, const std::vector<uint8_t>& header, std::size_t block_instructions)
+{
+  write_bytes(output, header);
+
+  Encoder encoder;
+  uint64_t count = 0;
+  T record;
+  while (input.read(reinterpret_cast<char*>(&record), sizeof(T)), input.gcount() == sizeof(T)) {
+    encoder.push(record);
+    ++count;
+    if (encoder.size() == block_instructions) {
+      write_bytes(output, encoder.flush());
+    }
+  }
+
+  if (encoder.size() > 0) {
+    write_bytes(output, encoder.flush());
+  }
+
+  if constexpr (std::is_same_v<Encoder, champsim::dictionary::encoder<T>>) {
+    std::cout << "Found " << encoder.static_instructions() << " static instructions\n";
+  }
+  return count;
+}
+
+template <typename T, typename In, typename Out>
+uint64_t convert(In& input, Out& output, bool dictionary)
+{
+  if (dictionary) {
+    return convert_with<T, champsim::dictionary::encoder<T>>(input, output, champsim::dictionary::header<T>(), champsim::dictionary::block_instructions);
+  }
+  return convert_with<T, champsim::columnar::encoder<T>>(input, output, champsim::columnar::header<T>(), champsim::columnar::block_instructions);
+}
+
+template <typename T, typename In>
+bool convert_to(In& input, const std::string& output_name)
+{
+  uint64_t count = 0;
+  bool success = false;
+  bool dictionary = champsim::dictionary::is_dictionary_trace(output_name);
+  if (ends_with(output_name, ".xz")) {
+    champsim::inf_ostream<champsim::decomp_tags::lzma_tag_t<>> output{output_name};
+    count = convert<T>(input, output, dictionary);
+    output.close();
+    success = output.good();
+  } else if (ends_with(output_name, ".gz")) {
+    champsim::inf_ostream<champsim::decomp_tags::gzip_tag_t<>> output{output_name};
+    count = convert<T>(input, output, dictionary);
+    output.close();
+    success = output.good();
+  } else if (ends_with(output_name, ".bz2")) {
+    champsim::inf_ostream<champsim::decomp_tags::bzip2_tag_t> output{output_name};
+    count = convert<T>(input, output, dictionary);
+    output.close();
+    success = output.good();
+  } else if (ends_with(output_name, ".zst")) {
+    champsim::inf_ostream<champsim::decomp_tags::zstd_tag_t<>> output{output_name};
+    count = convert<T>(input, output, dictionary);
+    output.close();
+    success = output.good();
+  } else {
+    std::ofstream output{output_name, std::ios::binary};
+    count = convert<T>(input, output, dictionary);
+    output.flush();
+    success = output.good();
+  }
+
+  std::cout << "Converted " << count << " instructions\n";
+  return success;
+}
+
+template <typename T>
+bool convert_from(const std::string& input_name, const std::string& output_name)
+{
+  if (ends_with(input_name, "xz")) {
+    champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>> input{input_name};
+    return convert_to<T>(input, output_name);
+  }
+  if (ends_with(input_name, "gz")) {
+    champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>> input{input_name};
+    return convert_to<T>(input, output_name);
+  }
+  if (ends_with(input_name, "bz2")) {
+    champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t> input{input_name};
+    return convert_to<T>(input, output_name);
+  }
+  if (ends_with(input_name, "zst")) {
+    champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>> input{input_name};
+    return convert_to<T>(input, output_name);
+  }
+  std::ifstream input{input_name, std::ios::binary};
+  return convert_to<T>(input, output_name);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  auto opts = parse_options(argc, argv);
+
+  if (!std::ifstream{opts.input_name}) {
+    std::cerr << "Could not open " << opts.input_name << " for reading\n";
+    return EXIT_FAILURE;
+  }
+
+  if (!std::ofstream{opts.output_name, std::ios::binary}) {
+    std::cerr << "Could not open " << opts.output_name << " for writing\n";
+    return EXIT_FAILURE;
+  }
+
+  bool success = opts.cloudsuite ? convert_from<cloudsuite_instr>(opts.input_name, opts.output_name)
+                                 : convert_from<input_instr>(opts.input_name, opts.output_name);
+  if (!success) {
+    std::cerr << "Could not write " << opts.output_name << "\n";
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,81 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Build the index of a trace, which lets ChampSim begin reading the trace near any instruction without decompressing the trace before it.
+ * The index is written beside the trace, with ".idx" appended to its name.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../inc/trace_index_builder.h"
+
+namespace
+{
+constexpr uint64_t MiB = 1 << 20;
+
+[[noreturn]] void usage(const char* name)
+{
+  std::cerr << "Usage: " << name << " [-s span in MiB] TRACE...\n";
+  std::cerr << "  -s  For gzip traces, the number of decompressed bytes between checkpoints. Each checkpoint adds 32 KiB to the index. (default: 64)\n";
+  std::exit(EXIT_FAILURE);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  uint64_t span = 64 * MiB;
+  std::vector<std::string> trace_names;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg{argv[i]};
+    if (arg == "-s" && i + 1 < argc) {
+      span = std::strtoull(argv[++i], nullptr, 10) * MiB;
+    } else if (!arg.empty() && arg.front() == '-') {
+      usage(argv[0]);
+    } else {
+      trace_names.emplace_back(arg);
+    }
+  }
+
+  if (std::empty(trace_names) || span == 0) {
+    usage(argv[0]);
+  }
+
+  bool success = true;
+  for (const auto& name : trace_names) {
+    try {
+      auto index = champsim::build_trace_index(name, span);
+      index.save(name);
+      std::cout << champsim::trace_index::file_name(name) << ": " << std::size(index.checkpoints) << " checkpoints, " << std::size(index.blocks)
+                << " columnar blocks\n";
+
+      if (std::size(index.checkpoints) == 1 && name.size() >= 2 && name.substr(name.size() - 2) == "xz") {
+        std::cout << "  The trace holds a single xz block, so it can only be read from the beginning. Recompress it with xz_recompress to index it.\n";
+      }
+    } catch (const std::exception& err) {
+      std::cerr << name << ": " << err.what() << "\n";
+      success = false;
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
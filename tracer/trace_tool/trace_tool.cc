@@ -0,0 +1,507 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cut, join, and rewrite traces without simulating them:
+ *
+ *   slice       Copy a range of instructions from a trace
+ *   concat      Join traces one after another
+ *   interleave  Join traces by taking a quantum of instructions from each in turn
+ *   recompress  Copy a whole trace, to change its format or compression
+ *
+ * The inputs may be in the native, columnar, or dictionary format, with any compression that ChampSim reads.
+ * The format and compression of the output are chosen by its name, as ChampSim chooses them when it reads a trace.
+ * The records are streamed one block at a time, so the memory used does not depend on the size of the traces.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../../inc/columnar_trace.h"
+#include "../../inc/dictionary_trace.h"
+#include "../../inc/inf_stream.h"
+#include "../../inc/trace_index.h"
+
+namespace
+{
+constexpr std::size_t buffer_records = 1 << 12;
+
+struct options {
+  std::string command;
+  std::string output_name;
+  std::vector<std::string> input_names;
+  bool cloudsuite = false;
+  uint64_t first = 0;
+  uint64_t count = std::numeric_limits<uint64_t>::max();
+  uint64_t quantum = 1;
+};
+
+[[noreturn]] void usage(const char* name)
+{
+  std::cerr << "Usage: " << name << " slice [OPTIONS] -s FIRST -n COUNT INPUT OUTPUT\n";
+  std::cerr << "       " << name << " concat [OPTIONS] OUTPUT INPUT...\n";
+  std::cerr << "       " << name << " interleave [OPTIONS] [-q QUANTUM] OUTPUT INPUT...\n";
+  std::cerr << "       " << name << " recompress [OPTIONS] INPUT OUTPUT\n";
+  std::cerr << "Options:\n";
+  std::cerr << "  -c  The traces are CloudSuite traces\n";
+  std::cerr << "  -T  The number of threads that compress an xz or zstd output. 0 selects one thread for each processor. (default: 0)\n";
+  std::cerr << "  -s  The first instruction of the slice (default: 0)\n";
+  std::cerr << "  -n  The number of instructions in the slice (default: to the end of the trace)\n";
+  std::cerr << "  -q  The number of instructions taken from each trace in turn (default: 1)\n";
+  std::exit(EXIT_FAILURE);
+}
+
+options parse_options(int argc, char** argv)
+{
+  if (argc < 2) {
+    usage(argv[0]);
+  }
+
+  options retval;
+  retval.command = argv[1];
+  champsim::decomp_tags::compression_threads = 0;
+
+  std::vector<std::string> positional;
+  for (int i = 2; i < argc; ++i) {
+    std::string_view arg{argv[i]};
+    if (arg == "-c") {
+      retval.cloudsuite = true;
+    } else if ((arg == "-T" || arg == "-s" || arg == "-n" || arg == "-q") && i + 1 < argc) {
+      auto value = std::strtoull(argv[++i], nullptr, 10);
+      if (arg == "-T") {
+        champsim::decomp_tags::compression_threads = static_cast<uint32_t>(value);
+      } else if (arg == "-s") {
+        retval.first = value;
+      } else if (arg == "-n") {
+        retval.count = value;
+      } else {
+        retval.quantum = value;
+      }
+    } else if (!arg.empty() && arg.front() == '-') {
+      usage(argv[0]);
+    } else {
+      positional.emplace_back(arg);
+    }
+  }
+
+  if (retval.command == "slice" || retval.command == "recompress") {
+    if (std::size(positional) != 2) {
+      usage(argv[0]);
+    }
+    retval.input_names.push_back(positional.at(0));
+    retval.output_name = positional.at(1);
+  } else if (retval.command == "concat" || retval.command == "interleave") {
+    if (std::size(positional) < 2 || retval.quantum == 0) {
+      usage(argv[0]);
+    }
+    retval.output_name = positional.at(0);
+    retval.input_names.assign(std::next(std::begin(positional)), std::end(positional));
+  } else {
+    usage(argv[0]);
+  }
+  return retval;
+}
+
+bool ends_with(std::string_view str, std::string_view suffix)
+{
+  return std::size(str) >= std::size(suffix) && str.substr(std::size(str) - std::size(suffix)) == suffix;
+}
+
+/**
+ * The records of a trace, in any format.
+ */
+template <typename T>
+class record_source
+{
+public:
+  virtual ~record_source() = default;
+
+  /**
+   * Read up to the given number of records.
+   *
+   * \return the number of records read, which is 0 at the end of the trace
+   */
+  virtual std::size_t read(T* out, std::size_t count) = 0;
+
+  /**
+   * Discard the given number of records, or the rest of the trace.
+   *
+   * \return the number of records discarded
+   */
+  virtual uint64_t skip(uint64_t count)
+  {
+    std::vector<T> discard(buffer_records);
+    uint64_t retval = 0;
+    while (retval < count) {
+      auto found = read(std::data(discard), static_cast<std::size_t>(std::min<uint64_t>(count - retval, std::size(discard))));
+      if (found == 0) {
+        break;
+      }
+      retval += found;
+    }
+    return retval;
+  }
+};
+
+// Records in the native format, which can be skipped through the checkpoints of an index
+template <typename T, typename F>
+class native_source : public record_source<T>
+{
+  std::string name;
+  F trace_file;
+  uint64_t position = 0;
+
+public:
+  explicit native_source(std::string trace_name) : name(trace_name), trace_file(trace_name) {}
+
+  std::size_t read(T* out, std::size_t count) override
+  {
+    trace_file.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count * sizeof(T)));
+    auto found = static_cast<std::size_t>(trace_file.gcount()) / sizeof(T);
+    position += found;
+    return found;
+  }
+
+  uint64_t skip(uint64_t count) override
+  {
+    auto start = position;
+    auto target = position + count;
+    if constexpr (std::is_same_v<F, std::ifstream>) {
+      position = std::min<uint64_t>(target, std::filesystem::file_size(name) / sizeof(T));
+      trace_file.seekg(static_cast<std::streamoff>(position * sizeof(T)));
+    } else if constexpr (champsim::is_detected_v<champsim::has_checkpoint_seek, F>) {
+      auto index = champsim::trace_index::load(name);
+      const auto* point = index.has_value() ? index->checkpoint_before(target * sizeof(T)) : nullptr;
+      if (point != nullptr && point->decompressed_offset > position * sizeof(T)) {
+        // Begin at the first whole record after the checkpoint
+        position = (point->decompressed_offset + sizeof(T) - 1) / sizeof(T);
+        trace_file.seek(*point, position * sizeof(T));
+      }
+    }
+
+    auto moved = position - start;
+    return moved + record_source<T>::skip(count - moved);
+  }
+};
+
+// Records in the columnar format, which can be skipped a block at a time through an index
+template <typename T, typename F>
+class columnar_source : public record_source<T>
+{
+  std::string name;
+  champsim::columnar_istream<F> trace_file;
+  std::vector<T> records{};
+  std::size_t next_record = 0;
+  uint64_t position = 0; // The index of the first record in the buffer
+
+public:
+  explicit columnar_source(std::string trace_name) : name(trace_name), trace_file(trace_name) {}
+
+  std::size_t read(T* out, std::size_t count) override
+  {
+    if (next_record == std::size(records)) {
+      position += std::size(records);
+      records.clear();
+      next_record = 0;
+      trace_file.read_block(records);
+    }
+
+    auto found = std::min(count, std::size(records) - next_record);
+    std::copy_n(std::next(std::begin(records), static_cast<std::ptrdiff_t>(next_record)), found, out);
+    next_record += found;
+    return found;
+  }
+
+  uint64_t skip(uint64_t count) override
+  {
+    auto start = position + next_record;
+    auto target = start + count;
+    auto index = champsim::trace_index::load(name);
+    const auto* block = index.has_value() ? index->block_before(target) : nullptr;
+    if (block != nullptr && block->instruction > start && trace_file.seek(*index, block->decompressed_offset)) {
+      records.clear();
+      next_record = 0;
+      position = block->instruction;
+    }
+    auto moved = (position + next_record) - start;
+    return moved + record_source<T>::skip(count - moved);
+  }
+};
+
+// Records in the dictionary format, which are expanded from the static instructions that they execute
+template <typename T, typename F>
+class dictionary_source : public record_source<T>
+{
+  champsim::dictionary_istream<F> trace_file;
+  champsim::dictionary::decoder<T> decoder{};
+  std::vector<champsim::dictionary::instance<T>> instances{};
+  std::size_t next_instance = 0;
+
+public:
+  explicit dictionary_source(std::string trace_name) : trace_file(trace_name) {}
+
+  std::size_t read(T* out, std::size_t count) override
+  {
+    if (next_instance == std::size(instances)) {
+      instances.clear();
+      next_instance = 0;
+      trace_file.read_block(decoder, instances);
+    }
+
+    auto found = std::min(count, std::size(instances) - next_instance);
+    auto begin = std::next(std::begin(instances), static_cast<std::ptrdiff_t>(next_instance));
+    std::transform(begin, std::next(begin, static_cast<std::ptrdiff_t>(found)), out, [this](const auto& inst) { return decoder.expand(inst); });
+    next_instance += found;
+    return found;
+  }
+};
+
+template <typename T, template <class, class> typename Source>
+std::unique_ptr<record_source<T>> open_compressed(const std::string& name)
+{
+  if (ends_with(name, "xz")) {
+    return std::make_unique<Source<T, champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>>(name);
+  }
+  if (ends_with(name, "gz")) {
+    return std::make_unique<Source<T, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>>(name);
+  }
+  if (ends_with(name, "bz2")) {
+    return std::make_unique<Source<T, champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>>(name);
+  }
+  if (ends_with(name, "zst")) {
+    return std::make_unique<Source<T, champsim::inf_istream<champsim::decomp_tags::zstd_tag_t<>>>>(name);
+  }
+  return std::make_unique<Source<T, std::ifstream>>(name);
+}
+
+template <typename T>
+std::unique_ptr<record_source<T>> open_source(const std::string& name)
+{
+  if (!std::ifstream{name}) {
+    throw std::runtime_error{"Could not open " + name + " for reading"};
+  }
+  if (champsim::columnar::is_columnar_trace(name)) {
+    return open_compressed<T, columnar_source>(name);
+  }
+  if (champsim::dictionary::is_dictionary_trace(name)) {
+    return open_compressed<T, dictionary_source>(name);
+  }
+  return open_compressed<T, native_source>(name);
+}
+
+/**
+ * A trace that is being written, in any format.
+ */
+template <typename T>
+class record_sink
+{
+public:
+  virtual ~record_sink() = default;
+  virtual void write(const T* data, std::size_t count) = 0;
+
+  /**
+   * Write any buffered records and end the trace.
+   *
+   * \return whether the trace was written successfully
+   */
+  virtual bool finish() = 0;
+};
+
+template <typename F>
+bool close_stream(F& stream)
+{
+  if constexpr (std::is_same_v<F, std::ofstream>) {
+    stream.flush();
+  } else {
+    stream.close();
+  }
+  return stream.good();
+}
+
+template <typename F>
+void write_bytes(F& stream, const std::vector<uint8_t>& bytes)
+{
+  stream.write(reinterpret_cast<const char*>(std::data(bytes)), static_cast<std::streamsize>(std::size(bytes)));
+}
+
+template <typename T, typename F>
+class native_sink : public record_sink<T>
+{
+  F trace_file;
+
+public:
+  explicit native_sink(std::string trace_name) : trace_file(trace_name) {}
+
+  void write(const T* data, std::size_t count) override
+  {
+    trace_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+  }
+
+  bool finish() override { return close_stream(trace_file); }
+};
+
+// Records encoded into blocks of the columnar or dictionary format
+template <typename T, typename Encoder, typename F>
+class encoded_sink : public record_sink<T>
+{
+  F trace_file;
+  Encoder encoder{};
+  std::size_t block_instructions;
+
+public:
+  encoded_sink(std::string trace_name, const std::vector<uint8_t>& header, std::size_t block_instrs)
+      : trace_file(trace_name), block_instructions(block_instrs)
+  {
+    write_bytes(trace_file, header);
+  }
+
+  void write(const T* data, std::size_t count) override
+  {
+    for (std::size_t i = 0; i < count; ++i) {
+      encoder.push(data[i]);
+      if (encoder.size() == block_instructions) {
+        write_bytes(trace_file, encoder.flush());
+      }
+    }
+  }
+
+  bool finish() override
+  {
+    if (encoder.size() > 0) {
+      write_bytes(trace_file, encoder.flush());
+    }
+    return close_stream(trace_file);
+  }
+};
+
+template <typename T, typename F>
+std::unique_ptr<record_sink<T>> open_format(const std::string& name)
+{
+  if (champsim::columnar::is_columnar_trace(name)) {
+    return std::make_unique<encoded_sink<T, champsim::columnar::encoder<T>, F>>(name, champsim::columnar::header<T>(),
+                                                                                champsim::columnar::block_instructions);
+  }
+  if (champsim::dictionary::is_dictionary_trace(name)) {
+    return std::make_unique<encoded_sink<T, champsim::dictionary::encoder<T>, F>>(name, champsim::dictionary::header<T>(),
+                                                                                  champsim::dictionary::block_instructions);
+  }
+  return std::make_unique<native_sink<T, F>>(name);
+}
+
+template <typename T>
+std::unique_ptr<record_sink<T>> open_sink(const std::string& name)
+{
+  if (!std::ofstream{name, std::ios::binary}) {
+    throw std::runtime_error{"Could not open " + name + " for writing"};
+  }
+  if (ends_with(name, ".xz")) {
+    return open_format<T, champsim::inf_ostream<champsim::decomp_tags::lzma_tag_t<>>>(name);
+  }
+  if (ends_with(name, ".gz")) {
+    return open_format<T, champsim::inf_ostream<champsim::decomp_tags::gzip_tag_t<>>>(name);
+  }
+  if (ends_with(name, ".bz2")) {
+    return open_format<T, champsim::inf_ostream<champsim::decomp_tags::bzip2_tag_t>>(name);
+  }
+  if (ends_with(name, ".zst")) {
+    return open_format<T, champsim::inf_ostream<champsim::decomp_tags::zstd_tag_t<>>>(name);
+  }
+  return open_format<T, std::ofstream>(name);
+}
+
+// Copy up to the given number of records
+template <typename T>
+uint64_t copy(record_source<T>& source, record_sink<T>& sink, uint64_t count, std::vector<T>& buffer)
+{
+  uint64_t retval = 0;
+  while (retval < count) {
+    auto found = source.read(std::data(buffer), static_cast<std::size_t>(std::min<uint64_t>(count - retval, std::size(buffer))));
+    if (found == 0) {
+      break;
+    }
+    sink.write(std::data(buffer), found);
+    retval += found;
+  }
+  return retval;
+}
+
+template <typename T>
+bool run(const options& opts)
+{
+  std::vector<std::unique_ptr<record_source<T>>> sources;
+  std::transform(std::begin(opts.input_names), std::end(opts.input_names), std::back_inserter(sources), open_source<T>);
+  auto sink = open_sink<T>(opts.output_name);
+
+  std::vector<T> buffer(buffer_records);
+  uint64_t written = 0;
+  if (opts.command == "slice") {
+    auto skipped = sources.front()->skip(opts.first);
+    if (skipped < opts.first) {
+      std::cerr << opts.input_names.front() << " has only " << skipped << " instructions\n";
+    }
+    written = copy(*sources.front(), *sink, opts.count, buffer);
+  } else if (opts.command == "interleave") {
+    // Take a quantum from each trace in turn, and drop each trace when it ends
+    std::size_t turn = 0;
+    while (!std::empty(sources)) {
+      auto found = copy(*sources.at(turn), *sink, opts.quantum, buffer);
+      written += found;
+      if (found < opts.quantum) {
+        sources.erase(std::next(std::begin(sources), static_cast<std::ptrdiff_t>(turn)));
+      } else {
+        ++turn;
+      }
+      if (turn >= std::size(sources)) {
+        turn = 0;
+      }
+    }
+  } else {
+    for (auto& source : sources) {
+      written += copy(*source, *sink, std::numeric_limits<uint64_t>::max(), buffer);
+    }
+  }
+
+  std::cout << "Wrote " << written << " instructions\n";
+  return sink->finish();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  auto opts = parse_options(argc, argv);
+
+  try {
+    bool success = opts.cloudsuite ? run<cloudsuite_instr>(opts) : run<input_instr>(opts);
+    if (!success) {
+      std::cerr << "Could not write " << opts.output_name << "\n";
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+  } catch (const std::exception& err) {
+    std::cerr << err.what() << "\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,170 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Rewrite a trace as an xz stream of many independently compressed blocks, so that ChampSim can decompress it on several threads.
+ * The input may be uncompressed, or compressed with xz, gzip, or bzip2.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../inc/inf_stream.h"
+
+namespace
+{
+constexpr std::size_t CHUNK = 1 << 16;
+constexpr uint64_t MiB = 1 << 20;
+
+struct options {
+  std::string input_name;
+  std::string output_name;
+  uint32_t threads = 0;
+  uint32_t preset = LZMA_PRESET_DEFAULT;
+  uint64_t block_size = 16 * MiB;
+};
+
+[[noreturn]] void usage(const char* name)
+{
+  std::cerr << "Usage: " << name << " [-T threads] [-b block size in MiB] [-p preset] INPUT OUTPUT\n";
+  std::cerr << "  -T  The number of compression threads. 0 selects one thread for each processor. (default: 0)\n";
+  std::cerr << "  -b  The size of each block before compression. Smaller blocks decompress with more parallelism. (default: 16)\n";
+  std::cerr << "  -p  The xz compression preset, from 0 to 9. (default: 6)\n";
+  std::exit(EXIT_FAILURE);
+}
+
+options parse_options(int argc, char** argv)
+{
+  options retval;
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg{argv[i]};
+    if ((arg == "-T" || arg == "-b" || arg == "-p") && i + 1 < argc) {
+      auto value = std::strtoull(argv[++i], nullptr, 10);
+      if (arg == "-T") {
+        retval.threads = static_cast<uint32_t>(value);
+      } else if (arg == "-b") {
+        retval.block_size = value * MiB;
+      } else {
+        retval.preset = static_cast<uint32_t>(value);
+      }
+    } else if (!arg.empty() && arg.front() == '-') {
+      usage(argv[0]);
+    } else {
+      positional.emplace_back(arg);
+    }
+  }
+
+  if (std::size(positional) != 2 || retval.block_size == 0 || retval.preset > 9) {
+    usage(argv[0]);
+  }
+  retval.input_name = positional.at(0);
+  retval.output_name = positional.at(1);
+  return retval;
+}
+
+bool ends_with(std::string_view str, std::string_view suffix)
+{
+  return std::size(str) >= std::size(suffix) && str.substr(std::size(str) - std::size(suffix)) == suffix;
+}
+
+template <typename Stream>
+bool recompress(Stream& input, std::ostream& output, const options& opts)
+{
+  lzma_mt mt{};
+  mt.threads = (opts.threads == 0) ? std::max(::lzma_cputhreads(), uint32_t{1}) : opts.threads;
+  mt.block_size = opts.block_size;
+  mt.preset = opts.preset;
+  mt.check = LZMA_CHECK_CRC64;
+
+  lzma_stream strm = LZMA_STREAM_INIT;
+  if (auto ret = ::lzma_stream_encoder_mt(&strm, &mt); ret != LZMA_OK) {
+    std::cerr << "Could not initialize the xz encoder (error " << ret << ")\n";
+    return false;
+  }
+
+  std::array<char, CHUNK> in_buf;
+  std::array<uint8_t, CHUNK> out_buf;
+  bool input_done = false;
+  lzma_ret ret = LZMA_OK;
+  while (ret != LZMA_STREAM_END) {
+    if (strm.avail_in == 0 && !input_done) {
+      input.read(std::data(in_buf), std::size(in_buf));
+      strm.next_in = reinterpret_cast<const uint8_t*>(std::data(in_buf));
+      strm.avail_in = static_cast<std::size_t>(input.gcount());
+      input_done = input.eof() || strm.avail_in == 0;
+    }
+
+    strm.next_out = std::data(out_buf);
+    strm.avail_out = std::size(out_buf);
+    ret = ::lzma_code(&strm, input_done ? LZMA_FINISH : LZMA_RUN);
+    if (ret != LZMA_OK && ret != LZMA_STREAM_END) {
+      std::cerr << "Could not compress the trace (error " << ret << ")\n";
+      ::lzma_end(&strm);
+      return false;
+    }
+
+    output.write(reinterpret_cast<const char*>(std::data(out_buf)), static_cast<std::streamsize>(std::size(out_buf) - strm.avail_out));
+  }
+
+  ::lzma_end(&strm);
+  return output.good();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  auto opts = parse_options(argc, argv);
+
+  if (!std::ifstream{opts.input_name}) {
+    std::cerr << "Could not open " << opts.input_name << " for reading\n";
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream output{opts.output_name, std::ios::binary};
+  if (!output) {
+    std::cerr << "Could not open " << opts.output_name << " for writing\n";
+    return EXIT_FAILURE;
+  }
+
+  bool success = false;
+  if (ends_with(opts.input_name, "xz")) {
+    // Decompress on as many threads as the input allows, so that existing multi-block traces are not a bottleneck
+    champsim::decomp_tags::lzma_decoder_threads = 0;
+    champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>> input{opts.input_name};
+    success = recompress(input, output, opts);
+  } else if (ends_with(opts.input_name, "gz")) {
+    champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>> input{opts.input_name};
+    success = recompress(input, output, opts);
+  } else if (ends_with(opts.input_name, "bz2")) {
+    champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t> input{opts.input_name};
+    success = recompress(input, output, opts);
+  } else {
+    std::ifstream input{opts.input_name, std::ios::binary};
+    success = recompress(input, output, opts);
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}